@@ -0,0 +1,132 @@
+/**
+ * @file
+ * Measure associative and commutative matching on hard cases.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "match/Matcher.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::match::Matcher;
+
+/**
+ * Time a workload, and print the rate at which it produces matches.
+ * @param name		The name to print.
+ * @param work		The workload.  It returns the number of matches.
+ */
+template<class Work>
+static void timed(std::string const& name, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	size_t matches = work();
+	auto stop = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << name << ": " << seconds << " s, "
+			<< matches / seconds / 1e6 << " M matches/s, "
+			<< matches << " matches" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto spec = fact.get_property_specification_builder()
+			->set_associative(true)->set_commutative(true)->get();
+	auto list = [&](std::vector<pTerm> const& elements) {
+		return fact.get_list(loc, spec, elements);
+	};
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm y = fact.get_variable(loc, "y", fact.TRUE, fact.ANY);
+	pTerm z = fact.get_variable(loc, "z", fact.TRUE, fact.ANY);
+	pTerm f = fact.get_symbol_literal("f");
+
+	// Count every match, repeating the search a number of times.
+	auto all = [&](pTerm pattern, pTerm subject, size_t times) {
+		return [&, pattern, subject, times]() {
+			size_t matches = 0;
+			for (size_t round = 0; round < times; ++round) {
+				for (auto const& binds : matcher.match(pattern, subject)) {
+					(void) binds;
+					++matches;
+				} // Visit every match.
+			} // Repeat the search.
+			return matches;
+		};
+	};
+
+	// Every way to split sixteen distinct elements in two: 2^16 - 2 matches.
+	std::vector<pTerm> distinct;
+	for (unsigned index = 0; index < 16; ++index) {
+		distinct.push_back(fact.get_integer_literal(index));
+	} // Make the elements.
+	timed("split distinct", all(list({ x, y }), list(distinct), scale));
+
+	// A repeated variable over a multiset with many copies of few elements.
+	std::vector<pTerm> copies;
+	for (unsigned index = 0; index < 48; ++index) {
+		copies.push_back(fact.get_integer_literal(index % 4));
+	} // Make the elements.
+	timed("repeated variable", all(list({ x, x, y }), list(copies),
+			10 * scale));
+
+	// Many applications that each pick one element, and a variable for the
+	// rest.
+	std::vector<pTerm> pattern, subject;
+	for (unsigned index = 0; index < 8; ++index) {
+		pTerm value = fact.get_integer_literal(index);
+		pattern.push_back(fact.apply(loc, f, fact.get_variable(loc,
+				"v" + std::to_string(index), fact.TRUE, fact.ANY)));
+		subject.push_back(fact.apply(loc, f, value));
+		subject.push_back(value);
+	} // Make the elements.
+	pattern.push_back(x);
+	timed("applications", all(list(pattern), list(subject), scale));
+
+	// A constant that is missing is found before anything is enumerated.
+	std::vector<pTerm> wide;
+	for (unsigned index = 0; index < 1000; ++index) {
+		wide.push_back(fact.get_integer_literal(index));
+	} // Make the elements.
+	pTerm wide_subject = list(wide);
+	pTerm missing = list({ fact.get_integer_literal(5000), x, y });
+	timed("missing constant", [&]() {
+		size_t attempts = 0;
+		for (size_t round = 0; round < 1000 * scale; ++round) {
+			attempts += matcher.match(missing, wide_subject).empty();
+		} // Make the attempts.
+		return attempts;
+	});
+
+	// Only the first match of three variables over a wide list.
+	pTerm three = list({ x, y, z });
+	timed("first of three", [&]() {
+		size_t matches = 0;
+		for (size_t round = 0; round < 1000 * scale; ++round) {
+			matches += matcher.match(three, wide_subject).first().have_match();
+		} // Make the attempts.
+		return matches;
+	});
+	return 0;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file
+ * Compare making short-lived terms on the heap and in an arena.
+ *
+ * Each round builds a batch of intermediate terms, keeps them all alive until
+ * the end of the round, and then drops them, as a rewrite step would.
+ *
+ * Usage: `arena_bench [rounds [terms-per-round]]`.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+
+/**
+ * Build one round of terms.
+ * @param fact	The factory.
+ * @param round	The round number, used to make the terms distinct.
+ * @param count	The number of terms to build.
+ */
+static void round_of(TermFactoryImpl const& fact, unsigned round,
+		unsigned count) {
+	std::vector<pTerm> keep;
+	keep.reserve(count);
+	pTerm op = fact.get_symbol_literal("f");
+	for (unsigned index = 0; index < count; ++index) {
+		pTerm value = fact.get_integer_literal(
+				static_cast<int64_t>(round) * count + index);
+		pTerm map = fact.get_static_map(Loc::get_internal(), value, op);
+		keep.push_back(fact.apply(Loc::get_internal(), op, map));
+	} // Build all terms.
+}
+
+int main(int argc, char* argv[]) {
+	unsigned rounds = 20;
+	unsigned count = 50000;
+	if (argc > 1) rounds = std::atoi(argv[1]);
+	if (argc > 2) count = std::atoi(argv[2]);
+	TermFactoryImpl fact;
+
+	std::cout << "Rounds: " << rounds << ", terms per round: " << count
+			<< std::endl;
+	auto start = std::chrono::steady_clock::now();
+	for (unsigned round = 0; round < rounds; ++round) {
+		round_of(fact, round, count);
+	} // Run all heap rounds.
+	auto stop = std::chrono::steady_clock::now();
+	double heap = std::chrono::duration<double>(stop - start).count();
+	std::cout << "heap:  " << heap << " s" << std::endl;
+
+	start = std::chrono::steady_clock::now();
+	for (unsigned round = 0; round < rounds; ++round) {
+		TermFactoryImpl::ArenaScope scope(fact);
+		round_of(fact, round, count);
+	} // Run all arena rounds.
+	stop = std::chrono::steady_clock::now();
+	double arena = std::chrono::duration<double>(stop - start).count();
+	std::cout << "arena: " << arena << " s (" << heap / arena << "x)"
+			<< std::endl;
+	return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * @file
+ * Measure commutative matching against wide lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "match/Matcher.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::match::Matcher;
+
+/**
+ * Time a number of match attempts, and print the time each took.
+ * @param name		The name to print.
+ * @param attempts	The number of attempts the workload makes.
+ * @param work		The workload.  It returns the number of matches.
+ */
+template<class Work>
+static void timed(std::string const& name, size_t attempts, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	size_t matches = work();
+	auto stop = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << name << ": " << seconds << " s, "
+			<< seconds / attempts * 1e6 << " us/attempt, "
+			<< matches << " matches" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	size_t attempts = 1000 * scale;
+	TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto spec = fact.get_property_specification_builder()
+			->set_commutative(true)->get();
+	auto list = [&](std::vector<pTerm> const& elements) {
+		return fact.get_list(loc, spec, elements);
+	};
+	auto variable = [&](std::string const& name, pTerm type) {
+		return fact.get_variable(loc, name, fact.TRUE, type);
+	};
+
+	// Count the matches of a pattern, a number of times.
+	auto all = [&](pTerm pattern, pTerm subject, size_t times) {
+		return [&, pattern, subject, times]() {
+			size_t matches = 0;
+			for (size_t round = 0; round < times; ++round) {
+				for (auto const& binds : matcher.match(pattern, subject)) {
+					(void) binds;
+					++matches;
+				} // Visit every match.
+			} // Repeat the search.
+			return matches;
+		};
+	};
+
+	// A wide operator with many constant arguments and a few variables, in
+	// a different order in the subject.
+	const size_t width = 256;
+	std::vector<pTerm> pattern, subject;
+	for (size_t index = 0; index < width; ++index) {
+		pTerm value = fact.get_integer_literal(index);
+		subject.push_back(value);
+		pattern.push_back(index % 64 == 0 ? variable("v" +
+				std::to_string(index), fact.ANY) : value);
+	} // Make the arguments.
+	std::reverse(subject.begin(), subject.end());
+	pTerm wide = list(subject);
+	timed("constants and four variables", attempts, all(list(pattern), wide,
+			attempts));
+
+	// A constant that is missing is found before anything is enumerated.
+	pattern[1] = fact.get_integer_literal(-1);
+	timed("missing constant", attempts, all(list(pattern), wide, attempts));
+
+	// Typed variables are confined to the bucket for their type.
+	std::vector<pTerm> typed, mixed;
+	for (size_t index = 0; index < 16; ++index) {
+		typed.push_back(variable("i" + std::to_string(index), fact.INTEGER));
+		mixed.push_back(fact.get_integer_literal(index));
+		mixed.push_back(fact.get_string_literal(std::to_string(index)));
+	} // Make the arguments.
+	for (size_t index = 0; index < 16; ++index) {
+		typed.push_back(fact.get_string_literal(std::to_string(index)));
+	} // Make the constant arguments.
+	timed("typed variables, first match", attempts, [&]() {
+		size_t matches = 0;
+		pTerm pattern = list(typed), subject = list(mixed);
+		for (size_t round = 0; round < attempts; ++round) {
+			matches += matcher.match(pattern, subject).first().have_match();
+		} // Make the attempts.
+		return matches;
+	});
+
+	// Applications with constant operators pair up without backtracking.
+	std::vector<pTerm> apps, calls;
+	for (size_t index = 0; index < 64; ++index) {
+		pTerm op = fact.get_symbol_literal("f" + std::to_string(index));
+		apps.push_back(fact.apply(loc, op, variable("a" +
+				std::to_string(index), fact.ANY)));
+		calls.push_back(fact.apply(loc, op, fact.get_integer_literal(index)));
+	} // Make the arguments.
+	std::reverse(calls.begin(), calls.end());
+	timed("applications", attempts, all(list(apps), list(calls), attempts));
+
+	// Every permutation of eight variables over eight arguments: 8! matches.
+	std::vector<pTerm> vars(subject.begin(), subject.begin() + 8);
+	std::vector<pTerm> eight;
+	for (size_t index = 0; index < 8; ++index) {
+		eight.push_back(variable("p" + std::to_string(index), fact.ANY));
+	} // Make the variables.
+	timed("every permutation", scale, all(list(eight), list(vars), scale));
+	return 0;
+}
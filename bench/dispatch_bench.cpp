@@ -0,0 +1,101 @@
+/**
+ * @file
+ * Measure equality and ordering, which dispatch on the kind of a term.
+ *
+ * Equal terms are built by two factories, so equality cannot be decided by
+ * address and must walk the terms.  The terms are then sorted.
+ *
+ * Usage: `dispatch_bench [scale]`.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+
+/**
+ * Time a workload.
+ * @param name		The name to print.
+ * @param work		The workload.
+ */
+template<class Work>
+static void timed(std::string const& name, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	work();
+	auto stop = std::chrono::steady_clock::now();
+	std::cout << name << ": "
+			<< std::chrono::duration<double>(stop - start).count() << " s"
+			<< std::endl;
+}
+
+/**
+ * Build a term that mixes several kinds.
+ * @param fact	The factory.
+ * @param seed	Distinguishes the terms.
+ * @return	The term.
+ */
+static pTerm build(TermFactory const& fact, unsigned seed) {
+	pTerm op = fact.get_symbol_literal("f");
+	pTerm term = fact.get_variable(Loc::get_internal(), "x", fact.TRUE,
+			fact.ANY);
+	for (unsigned depth = 0; depth < 20; ++depth) {
+		pTerm leaf = fact.get_integer_literal(seed * 31 + depth % 3);
+		pTerm map = fact.get_static_map(Loc::get_internal(), leaf, term);
+		term = fact.apply(Loc::get_internal(), op, map);
+	} // Build a deep term.
+	return term;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	TermFactoryImpl first;
+	TermFactoryImpl second;
+	std::vector<pTerm> left, right;
+	for (unsigned index = 0; index < 1000; ++index) {
+		left.push_back(build(first, index));
+		right.push_back(build(second, index));
+	} // Make the terms.
+
+	timed("equality", [&]() {
+		size_t equal = 0;
+		for (unsigned round = 0; round < 200 * scale; ++round) {
+			for (size_t index = 0; index < left.size(); ++index) {
+				equal += *left[index] == *right[index];
+			} // Compare all pairs.
+		} // Repeat.
+		if (equal != 200 * scale * left.size()) std::cout << "mismatch ";
+	});
+
+	timed("ordering", [&]() {
+		for (unsigned round = 0; round < 200 * scale; ++round) {
+			std::vector<pTerm> terms(left);
+			std::reverse(terms.begin(), terms.end());
+			std::sort(terms.begin(), terms.end(),
+					[](pTerm const& a, pTerm const& b) { return *a < *b; });
+		} // Repeat.
+	});
+	return 0;
+}
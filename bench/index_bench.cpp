@@ -0,0 +1,128 @@
+/**
+ * @file
+ * Measure finding candidate lambdas in large rule sets.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "match/Matcher.h"
+#include "match/RuleIndex.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::match::Matcher;
+using elision::match::RuleIndex;
+
+/**
+ * Time a number of operations, and print the time each took.
+ * @param name		The name to print.
+ * @param count		The number of operations the workload makes.
+ * @param work		The workload.  It returns a count to print.
+ */
+template<class Work>
+static void timed(std::string const& name, size_t count, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	size_t result = work();
+	auto stop = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << name << ": " << seconds << " s, "
+			<< seconds / count * 1e6 << " us each, "
+			<< result << " found" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	size_t lookups = 10000 * scale;
+	TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto spec = fact.get_property_specification_builder()->get();
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+
+	// Rules of the form fN.(%($x, K)) and fN.(%(K, $x)), with a hundred
+	// operators, and a few that apply to anything.
+	auto make_rule = [&](size_t index) {
+		pTerm op = fact.get_symbol_literal("f" + std::to_string(index % 100));
+		pTerm value = fact.get_integer_literal(index / 200);
+		std::vector<pTerm> args = index % 2 ? std::vector<pTerm>{ x, value } :
+				std::vector<pTerm>{ value, x };
+		return fact.get_lambda(loc, fact.apply(loc, op,
+				fact.get_list(loc, spec, args)), value, fact.TRUE);
+	};
+	std::vector<pTerm> subjects;
+	for (size_t index = 0; index < 1024; ++index) {
+		pTerm op = fact.get_symbol_literal("f" + std::to_string(index % 100));
+		subjects.push_back(fact.apply(loc, op, fact.get_list(loc, spec,
+				std::vector<pTerm>{ fact.get_integer_literal(index % 7),
+				fact.get_integer_literal(index % 5) })));
+	} // Make the subjects.
+
+	for (size_t size = 1000; size <= 100000; size *= 10) {
+		std::cout << "-- " << size << " rules" << std::endl;
+		std::vector<pLambda> rules;
+		for (size_t index = 0; index < size; ++index) {
+			rules.push_back(make_rule(index));
+		} // Make the rules.
+		for (size_t index = 0; index < 4; ++index) {
+			rules.push_back(fact.get_lambda(loc, x, x, fact.TRUE));
+		} // Add catch-all rules.
+		RuleIndex index;
+		timed("insert", rules.size(), [&]() {
+			for (auto const& rule : rules) index.insert(rule);
+			return index.size();
+		});
+		timed("lookup", lookups, [&]() {
+			size_t found = 0;
+			for (size_t round = 0; round < lookups; ++round) {
+				found += index.candidates(subjects[round & 1023]).size();
+			} // Look up the subjects.
+			return found;
+		});
+		timed("lookup and match", lookups, [&]() {
+			size_t found = 0;
+			for (size_t round = 0; round < lookups; ++round) {
+				pTerm const& subject = subjects[round & 1023];
+				for (auto const& rule : index.candidates(subject)) {
+					found += matcher.match(rule->get_lhs(), subject).have_match();
+				} // Try each candidate.
+			} // Look up the subjects.
+			return found;
+		});
+		size_t trials = lookups / (size / 100);
+		timed("match every rule", trials, [&]() {
+			size_t found = 0;
+			for (size_t round = 0; round < trials; ++round) {
+				pTerm const& subject = subjects[round & 1023];
+				for (auto const& rule : rules) {
+					found += matcher.match(rule->get_lhs(), subject).have_match();
+				} // Try each rule.
+			} // Try the subjects.
+			return found;
+		});
+		timed("erase", rules.size(), [&]() {
+			for (auto const& rule : rules) index.erase(rule);
+			return index.size();
+		});
+	} // Try each size.
+	return 0;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file
+ * Measure the small integer paths: literals from the preallocated table,
+ * comparison, and conversion to strings.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+#include "Integer.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+
+/**
+ * Time a workload.
+ * @param name		The name to print.
+ * @param work		The workload.
+ */
+template<class Work>
+static void timed(std::string const& name, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	work();
+	auto stop = std::chrono::steady_clock::now();
+	std::cout << name << ": "
+			<< std::chrono::duration<double>(stop - start).count() << " s"
+			<< std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	unsigned size = 2000000 * scale;
+	TermFactoryImpl fact;
+	size_t total = 0;
+
+	timed("literals in table", [&]() {
+		for (unsigned index = 0; index < size; ++index) {
+			total += fact.get_integer_literal(index % 1024)->get_depth();
+		} // Make literals.
+	});
+	timed("literals interned", [&]() {
+		for (unsigned index = 0; index < size; ++index) {
+			total += fact.get_integer_literal(2048 + index % 1024)->get_depth();
+		} // Make literals.
+	});
+
+	std::vector<Integer> compact;
+	std::vector<eint_t> wide;
+	for (unsigned index = 0; index < 1024; ++index) {
+		compact.emplace_back(static_cast<int64_t>(index * 7919));
+		wide.emplace_back(index * 7919);
+	} // Make values.
+	timed("compare compact", [&]() {
+		for (unsigned index = 0; index < size; ++index) {
+			total += compact[index % 1024] < compact[(index * 31) % 1024];
+		} // Compare values.
+	});
+	timed("compare eint", [&]() {
+		for (unsigned index = 0; index < size; ++index) {
+			total += wide[index % 1024] < wide[(index * 31) % 1024];
+		} // Compare values.
+	});
+	timed("string compact", [&]() {
+		for (unsigned index = 0; index < size / 4; ++index) {
+			total += eint_to_string(compact[index % 1024], 16).size();
+		} // Convert values.
+	});
+	timed("string eint", [&]() {
+		for (unsigned index = 0; index < size / 4; ++index) {
+			auto const& value = wide[index % 1024];
+			std::ostringstream out;
+			out << "0x" << std::uppercase << std::hex << value;
+			total += out.str().size();
+		} // Convert values.
+	});
+	std::cout << "  " << total << std::endl;
+	return 0;
+}
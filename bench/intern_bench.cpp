@@ -0,0 +1,128 @@
+/**
+ * @file
+ * Measure how term construction scales when many threads share one factory.
+ *
+ * Each worker builds a stream of terms.  Some are shared by all workers (the
+ * same symbols and small integers), and some are private to a worker, so both
+ * the hit and the miss paths of the intern table are exercised.  Symbols and
+ * variables are built from their names, so the atom table is exercised too;
+ * private names are new in every run, since atoms are never removed.
+ *
+ * Workers wait at a gate until all have started, so only the work is timed.
+ * With no shared lock on the common path, the speedup should stay close to
+ * the number of threads (an efficiency near one) up to the number of cores.
+ * Rows with more threads than cores are marked, since they cannot scale.
+ *
+ * Usage: `intern_bench [max-threads [terms-per-thread]]`.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+
+/**
+ * Build terms on one thread.
+ * @param fact		The shared factory.
+ * @param run		The index of this run, to make private names new.
+ * @param worker	The index of this worker.
+ * @param count		The number of terms to build.
+ * @param ready		Count of workers waiting at the gate.
+ * @param go		The gate, opened when all workers are ready.
+ */
+static void build(TermFactory const& fact, unsigned run, unsigned worker,
+		unsigned count, std::atomic<unsigned>& ready,
+		std::atomic<bool> const& go) {
+	++ready;
+	while (!go.load()) std::this_thread::yield();
+	std::vector<pTerm> keep;
+	keep.reserve(1024);
+	pTerm op = fact.get_symbol_literal("f");
+	for (unsigned index = 0; index < count; ++index) {
+		// Shared by all workers.
+		pTerm common = fact.get_integer_literal(index % 64);
+		// Private to this worker.
+		pTerm mine = fact.get_integer_literal(
+				static_cast<int64_t>(worker) * count + index);
+		pTerm map = fact.get_static_map(Loc::get_internal(), common, mine);
+		pTerm app = fact.apply(Loc::get_internal(), op, map);
+		// Names shared by all workers, and names private to this one.
+		std::string suffix = std::to_string(index % 64);
+		fact.get_symbol_literal("s" + suffix);
+		std::string name = "v" + std::to_string(run) + "_" +
+				std::to_string(worker) + "_" + suffix;
+		if (index % 64 == 0) name += "_" + std::to_string(index);
+		fact.get_variable(Loc::get_internal(), name, fact.TRUE, fact.ANY);
+		// Keep a sliding window alive so some lookups hit.
+		if (keep.size() < 1024) keep.push_back(app);
+		else keep[index % 1024] = app;
+	} // Build all terms.
+}
+
+int main(int argc, char* argv[]) {
+	unsigned max_threads = std::thread::hardware_concurrency();
+	if (max_threads == 0) max_threads = 1;
+	unsigned count = 100000;
+	if (argc > 1) max_threads = std::atoi(argv[1]);
+	if (argc > 2) count = std::atoi(argv[2]);
+
+	unsigned cores = std::thread::hardware_concurrency();
+	std::cout << "Terms per thread: " << count << ", cores: " << cores
+			<< std::endl;
+	std::cout << std::setw(8) << "threads" << std::setw(14) << "seconds"
+			<< std::setw(16) << "terms/second" << std::setw(10) << "speedup"
+			<< std::setw(12) << "efficiency" << std::endl;
+	double base = 0.0;
+	unsigned run = 0;
+	for (unsigned threads = 1; threads <= max_threads; threads *= 2, ++run) {
+		elision::term::basic::TermFactoryImpl fact;
+		std::atomic<unsigned> ready(0);
+		std::atomic<bool> go(false);
+		std::vector<std::thread> workers;
+		for (unsigned worker = 0; worker < threads; ++worker) {
+			workers.push_back(std::thread(build, std::cref(fact), run,
+					worker, count, std::ref(ready), std::cref(go)));
+		} // Start all workers.
+		while (ready.load() < threads) std::this_thread::yield();
+		auto start = std::chrono::steady_clock::now();
+		go.store(true);
+		for (auto& worker : workers) worker.join();
+		auto stop = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(stop - start).count();
+		// Each iteration makes six terms.
+		double rate = 6.0 * threads * count / seconds;
+		if (threads == 1) base = rate;
+		std::cout << std::setw(8) << threads << std::setw(14) << seconds
+				<< std::setw(16) << static_cast<uint64_t>(rate)
+				<< std::setw(10) << std::setprecision(3) << rate / base
+				<< std::setw(12) << rate / base / threads
+				<< std::setprecision(6)
+				<< (cores != 0 && threads > cores ? "  (more than cores)" : "")
+				<< std::endl;
+	} // Try each thread count.
+	return 0;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * Compare catenating and slicing large lists held in trees with the same
+ * work done by copying.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::term::store::TermStoreFactory;
+
+/**
+ * Time a workload.
+ * @param name		The name to print.
+ * @param work		The workload.
+ */
+template<class Work>
+static void timed(std::string const& name, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	work();
+	auto stop = std::chrono::steady_clock::now();
+	std::cout << name << ": "
+			<< std::chrono::duration<double>(stop - start).count() << " s"
+			<< std::endl;
+}
+
+/**
+ * Rotate a large list many times by slicing it and catenating the pieces,
+ * as rewriting an associative operator does.
+ * @param fact		The factory.
+ * @param size		The number of elements.
+ * @param rounds	The number of rotations.
+ * @return	The final list.
+ */
+static pList rotate(TermFactory const& fact, unsigned size, unsigned rounds) {
+	std::vector<pTerm> elts;
+	for (unsigned index = 0; index < size; ++index) {
+		elts.push_back(fact.get_integer_literal(index));
+	} // Make the elements.
+	auto spec = fact.get_property_specification_builder()
+			->set_associative(true)->get();
+	pList list = fact.get_list(Loc::get_internal(), spec, std::move(elts));
+	for (unsigned round = 0; round < rounds; ++round) {
+		size_t cut = (round * 7919) % size;
+		pList head = fact.slice(Loc::get_internal(), list, 0, cut);
+		pList tail = fact.slice(Loc::get_internal(), list, cut, size);
+		list = fact.catenate(Loc::get_internal(), tail, head);
+	} // Rotate many times.
+	return list;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	unsigned size = 100000 * scale;
+	TermFactoryImpl basic;
+	TermStoreFactory stored;
+	pList first, second;
+
+	timed("rotate tree", [&]() {
+		first = rotate(basic, size, 200);
+	});
+	timed("rotate copy", [&]() {
+		second = rotate(stored, size, 200);
+	});
+	if (!(*first == *second)) std::cout << "mismatch" << std::endl;
+	return 0;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file
+ * Measure the rate of syntactic match attempts.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "match/Matcher.h"
+#include "match/Program.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::match::Context;
+using elision::match::Matcher;
+using elision::match::Program;
+
+/**
+ * Time a number of match attempts, and print the rate.
+ * @param name		The name to print.
+ * @param attempts	The number of attempts the workload makes.
+ * @param work		The workload.  It returns the number of matches.
+ */
+template<class Work>
+static void timed(std::string const& name, size_t attempts, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	size_t matches = work();
+	auto stop = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << name << ": " << seconds << " s, "
+			<< attempts / seconds / 1e6 << " M attempts/s, "
+			<< matches << " matches" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	size_t attempts = 1000000 * scale;
+	TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	Context context;
+
+	// Make subjects of the form f.(%(i, j)) and g.(%(i, j)).
+	auto spec = fact.get_property_specification_builder()->get();
+	pTerm f = fact.get_symbol_literal("f");
+	pTerm g = fact.get_symbol_literal("g");
+	auto pair = [&](pTerm op, pTerm first, pTerm second) {
+		return fact.apply(loc, op, fact.get_list(loc, spec,
+				std::vector<pTerm>{ first, second }));
+	};
+	std::vector<pTerm> subjects;
+	for (unsigned index = 0; index < 1024; ++index) {
+		pTerm first = fact.get_integer_literal(index % 32);
+		pTerm second = fact.get_integer_literal(index / 32);
+		subjects.push_back(pair(index % 2 ? f : g, first, second));
+	} // Make the subjects.
+
+	// Make the patterns.
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm y = fact.get_variable(loc, "y", fact.TRUE, fact.INTEGER);
+	pTerm two = pair(f, x, y);
+	pTerm same = pair(f, x, x);
+	pTerm fixed = pair(f, x, fact.get_integer_literal(7));
+	pTerm deep = pair(f, pair(f, x, y), y);
+
+	auto attempt = [&](pTerm const& pattern) {
+		return [&, pattern]() {
+			size_t matches = 0;
+			for (size_t index = 0; index < attempts; ++index) {
+				context.clear();
+				matches += matcher.try_match(pattern, subjects[index & 1023],
+						context);
+			} // Make all attempts.
+			return matches;
+		};
+	};
+	timed("variable", attempts, attempt(x));
+	timed("two variables", attempts, attempt(two));
+	timed("repeated variable", attempts, attempt(same));
+	timed("fixed argument", attempts, attempt(fixed));
+	timed("too deep", attempts, attempt(deep));
+
+	// The same patterns, compiled first.
+	auto run = [&](pTerm const& pattern) {
+		std::shared_ptr<Program> program(new Program(fact, pattern));
+		return [&, program]() {
+			size_t matches = 0;
+			for (size_t index = 0; index < attempts; ++index) {
+				context.clear();
+				matches += program->run(fact, subjects[index & 1023], context);
+			} // Make all attempts.
+			return matches;
+		};
+	};
+	timed("compiled variable", attempts, run(x));
+	timed("compiled two variables", attempts, run(two));
+	timed("compiled repeated variable", attempts, run(same));
+	timed("compiled fixed argument", attempts, run(fixed));
+	timed("compiled too deep", attempts, run(deep));
+
+	// The cost of compiling each pattern.
+	std::vector<pTerm> patterns = { x, two, same, fixed, deep };
+	timed("compile", attempts / 10, [&]() {
+		size_t compiled = 0;
+		for (size_t index = 0; index < attempts / 10; ++index) {
+			compiled += Program(fact, patterns[index % 5]).size() > 0;
+		} // Compile the patterns.
+		return compiled;
+	});
+
+	// Rewrite with a lambda, which includes building the result.
+	pLambda swap = fact.get_lambda(loc, two, pair(g, y, x), fact.TRUE);
+	timed("apply lambda", attempts / 10, [&]() {
+		size_t matches = 0;
+		for (size_t index = 0; index < attempts / 10; ++index) {
+			pTerm const& subject = subjects[index & 1023];
+			matches += fact.apply(loc, swap, subject) != subject;
+		} // Apply the lambda.
+		return matches;
+	});
+	return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file
+ * Measure writing a deep term, along with the memory used to do it.
+ *
+ * Usage: `print_bench [depth]`.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sys/resource.h>
+
+using namespace elision;
+using namespace elision::term;
+
+int main(int argc, char* argv[]) {
+	unsigned depth = 4000;
+	if (argc > 1) depth = std::atoi(argv[1]);
+	elision::term::basic::TermFactoryImpl fact;
+	pTerm op = fact.get_symbol_literal("f");
+	pTerm term = fact.get_integer_literal(0);
+	for (unsigned level = 1; level <= depth; ++level) {
+		term = fact.apply(Loc::get_internal(), op,
+				fact.get_static_map(Loc::get_internal(),
+						fact.get_integer_literal(level), term));
+	} // Build a deep term.
+
+	auto start = std::chrono::steady_clock::now();
+	size_t length = term->to_string().size();
+	auto stop = std::chrono::steady_clock::now();
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	std::cout << "characters: " << length << std::endl;
+	std::cout << "seconds: "
+			<< std::chrono::duration<double>(stop - start).count() << std::endl;
+	std::cout << "peak memory (kB): " << usage.ru_maxrss << std::endl;
+	return 0;
+}
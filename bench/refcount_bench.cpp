@@ -0,0 +1,111 @@
+/**
+ * @file
+ * Measure the cost of passing term handles around.
+ *
+ * Three workloads are timed: copying handles, rebuilding a term with the
+ * term modifier (which copies handles at every level), and making terms.
+ *
+ * Usage: `refcount_bench [scale]`.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/TermModifier.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::term::basic::TermModifier;
+
+/**
+ * Time a workload.
+ * @param name		The name to print.
+ * @param work		The workload.
+ */
+template<class Work>
+static void timed(std::string const& name, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	work();
+	auto stop = std::chrono::steady_clock::now();
+	std::cout << name << ": "
+			<< std::chrono::duration<double>(stop - start).count() << " s"
+			<< std::endl;
+}
+
+/**
+ * Run all workloads against one factory.
+ * @param fact	The factory.
+ * @param scale	The scale factor for the workloads.
+ */
+static void run(TermFactoryImpl const& fact, unsigned scale) {
+	// Copy handles.
+	std::vector<pTerm> terms;
+	for (unsigned index = 0; index < 1000; ++index) {
+		terms.push_back(fact.get_integer_literal(index));
+	} // Make some terms.
+	timed("  copy handles", [&]() {
+		size_t sum = 0;
+		for (unsigned index = 0; index < 10000000 * scale; ++index) {
+			pTerm copy = terms[index % terms.size()];
+			sum += copy->get_kind();
+		} // Copy many handles.
+		if (sum == 1) std::cout << sum;
+	});
+
+	// Rebuild a deep term.
+	pTerm op = fact.get_symbol_literal("f");
+	pTerm body = fact.get_variable(Loc::get_internal(), "x", fact.TRUE,
+			fact.ANY);
+	for (unsigned depth = 0; depth < 100; ++depth) {
+		body = fact.apply(Loc::get_internal(), op, body);
+	} // Build a deep term.
+	TermModifier modifier(fact);
+	timed("  rebuild terms", [&]() {
+		for (unsigned index = 0; index < 2000 * scale; ++index) {
+			modifier.substitute(BindMap().extend(Atom("x"),
+					terms[index % terms.size()]), body);
+		} // Rebuild many times.
+	});
+
+	// Make terms.
+	timed("  make terms", [&]() {
+		for (unsigned index = 0; index < 200000 * scale; ++index) {
+			fact.get_static_map(Loc::get_internal(),
+					fact.get_integer_literal(index), op);
+		} // Make many terms.
+	});
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	// Some libraries skip atomic operations until a second thread has been
+	// started.  Start one so the shared case is measured honestly.
+	std::thread([]() {}).join();
+	std::cout << "Shared factory (atomic counts)" << std::endl;
+	TermFactoryImpl shared;
+	run(shared, scale);
+	std::cout << "Thread-confined factory (plain counts)" << std::endl;
+	TermFactoryImpl confined(PLAIN_COUNT);
+	run(confined, scale);
+	return 0;
+}
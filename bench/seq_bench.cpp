@@ -0,0 +1,68 @@
+/**
+ * @file
+ * Measure chains of omits and inserts on immutable sequences.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "Seq.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+
+/**
+ * Make a chain of edits, each applied to the result of the one before, and
+ * print the time each edit took.  If edits cost time in the length of the
+ * chain, the time per edit grows with the chain; if they are logarithmic,
+ * it stays nearly flat.
+ * @param edits		The number of edits.
+ */
+static void chain(size_t edits) {
+	std::vector<int> start(1000);
+	for (size_t index = 0; index < start.size(); ++index) {
+		start[index] = index;
+	} // Make the elements.
+	Seq<int> seq(start);
+	Seq<int> two(std::vector<int>{ -1, -2 });
+	unsigned state = 12345;
+	size_t total = 0;
+	auto begin = std::chrono::steady_clock::now();
+	for (size_t round = 0; round < edits; ++round) {
+		state = state * 1103515245u + 12345u;
+		if (state & 1) {
+			seq = seq.omit((state >> 8) % seq.size());
+		} else {
+			seq = seq.insert((state >> 8) % (seq.size() + 1), two);
+		}
+		total += seq.at(seq.size() / 2);
+	} // Edit the sequence.
+	auto stop = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(stop - begin).count();
+	std::cout << edits << " edits: " << seconds << " s, "
+			<< seconds / edits * 1e6 << " us/edit (" << seq.size()
+			<< " elements, check " << total << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	for (size_t edits = 1000; edits <= 64000 * scale; edits *= 4) {
+		chain(edits);
+	} // Run longer and longer chains.
+	return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file
+ * Measure associative matching against long lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "match/Matcher.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::match::Matcher;
+
+/**
+ * Time a number of match attempts, and print the time each took.
+ * @param name		The name to print.
+ * @param attempts	The number of attempts the workload makes.
+ * @param work		The workload.  It returns the number of matches.
+ */
+template<class Work>
+static void timed(std::string const& name, size_t attempts, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	size_t matches = work();
+	auto stop = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(stop - start).count();
+	std::cout << name << ": " << seconds << " s, "
+			<< seconds / attempts * 1e6 << " us/attempt, "
+			<< matches << " matches" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	size_t attempts = 100 * scale;
+	TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto spec = fact.get_property_specification_builder()
+			->set_associative(true)->get();
+	auto list = [&](std::vector<pTerm> const& elements) {
+		return fact.get_list(loc, spec, elements);
+	};
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm y = fact.get_variable(loc, "y", fact.TRUE, fact.ANY);
+	pTerm z = fact.get_variable(loc, "z", fact.TRUE, fact.ANY);
+
+	// Make a subject of 10^5 elements, and one made of the same half twice.
+	const size_t size = 100000;
+	std::vector<pTerm> elements, halves;
+	for (size_t index = 0; index < size; ++index) {
+		elements.push_back(fact.get_integer_literal(index));
+		halves.push_back(fact.get_integer_literal(index % (size / 2)));
+	} // Make the elements.
+	pTerm subject = list(elements);
+	pTerm twice = list(halves);
+
+	// Count the matches of a pattern, a number of times.
+	auto all = [&](pTerm pattern, pTerm subject, size_t times) {
+		return [&, pattern, subject, times]() {
+			size_t matches = 0;
+			for (size_t round = 0; round < times; ++round) {
+				for (auto const& binds : matcher.match(pattern, subject)) {
+					(void) binds;
+					++matches;
+				} // Visit every match.
+			} // Repeat the search.
+			return matches;
+		};
+	};
+	timed("prefix", attempts, all(list({ elements[0], x }), subject,
+			attempts));
+	timed("prefix and suffix", attempts, all(list({ elements[0], x,
+			elements[size - 1] }), subject, attempts));
+	timed("middle", attempts, all(list({ x, elements[size / 2], y }),
+			subject, attempts));
+	timed("missing", attempts, all(list({ x, fact.get_integer_literal(-1),
+			y }), subject, attempts));
+	timed("repeated", attempts, all(list({ x, x }), twice, attempts));
+	timed("every split", 1, all(list({ x, y }), subject, 1));
+	timed("first of three", attempts, [&]() {
+		size_t matches = 0;
+		pTerm pattern = list({ x, y, z });
+		for (size_t round = 0; round < attempts; ++round) {
+			matches += matcher.match(pattern, subject).first().have_match();
+		} // Make the attempts.
+		return matches;
+	});
+	return 0;
+}
@@ -0,0 +1,152 @@
+/**
+ * @file
+ * Compare the columnar term store with the basic terms on a large knowledge
+ * base.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "term/Dispatch.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::term::store::TermStoreFactory;
+using elision::term::store::term_id;
+
+/**
+ * Time a workload.
+ * @param name		The name to print.
+ * @param work		The workload.
+ */
+template<class Work>
+static void timed(std::string const& name, Work work) {
+	auto start = std::chrono::steady_clock::now();
+	work();
+	auto stop = std::chrono::steady_clock::now();
+	std::cout << name << ": "
+			<< std::chrono::duration<double>(stop - start).count() << " s"
+			<< std::endl;
+}
+
+/**
+ * Build a knowledge base of applications that share many subterms.
+ * @param fact	The factory.
+ * @param size	The number of facts.
+ * @return	A list of all the facts.
+ */
+static pTerm build(TermFactory const& fact, unsigned size) {
+	std::vector<pTerm> ops;
+	for (unsigned index = 0; index < 64; ++index) {
+		ops.push_back(fact.get_symbol_literal("op" + std::to_string(index)));
+	} // Make the operators.
+	std::vector<pTerm> facts;
+	pTerm last = fact.get_integer_literal(0);
+	for (unsigned index = 0; index < size; ++index) {
+		pTerm leaf = fact.get_integer_literal(index);
+		pTerm map = fact.get_static_map(Loc::get_internal(), leaf, last);
+		last = fact.apply(Loc::get_internal(), ops[index % ops.size()], map);
+		if (index % 16 == 15) {
+			facts.push_back(last);
+			last = leaf;
+		}
+	} // Make the facts.
+	auto spec = fact.get_property_specification_builder()->get();
+	return fact.get_list(Loc::get_internal(), spec, std::move(facts));
+}
+
+/**
+ * Count the distinct subterms of a term by walking the interfaces.
+ */
+struct Count {
+	std::unordered_set<ITerm const*> seen;
+
+	void operator()(pTerm const& term) {
+		if (seen.insert(term.get()).second) dispatch(*term, *this);
+	}
+	void operator()(IApply const& term) {
+		(*this)(term.get_operator());
+		(*this)(term.get_argument());
+	}
+	void operator()(IStaticMap const& term) {
+		(*this)(term.get_domain());
+		(*this)(term.get_codomain());
+	}
+	void operator()(IList const& term) {
+		(*this)(term.get_property_specification());
+		for (auto const& elt : term) (*this)(elt);
+	}
+	void operator()(ITerm const&) {
+		// Leaves have no children to count.
+	}
+};
+
+int main(int argc, char* argv[]) {
+	unsigned scale = 1;
+	if (argc > 1) scale = std::atoi(argv[1]);
+	unsigned size = 400000 * scale;
+	TermFactoryImpl basic_one, basic_two;
+	TermStoreFactory store_one, store_two;
+	pTerm basic_first, basic_second, store_first, store_second;
+
+	timed("make basic", [&]() {
+		basic_first = build(basic_one, size);
+		basic_second = build(basic_two, size);
+	});
+	timed("make store", [&]() {
+		store_first = build(store_one, size);
+		store_second = build(store_two, size);
+	});
+
+	size_t count = 0;
+	timed("walk basic", [&]() {
+		for (unsigned round = 0; round < 5; ++round) {
+			Count counter;
+			counter(basic_first);
+			count = counter.seen.size();
+		} // Repeat.
+	});
+	std::cout << "  " << count << " distinct terms" << std::endl;
+	timed("walk store", [&]() {
+		term_id root = store_one.id_of(store_first);
+		for (unsigned round = 0; round < 5; ++round) {
+			count = 0;
+			store_one.get_store().walk(root,
+					[&](term_id) { ++count; return true; });
+		} // Repeat.
+	});
+	std::cout << "  " << count << " distinct terms" << std::endl;
+
+	timed("equality basic", [&]() {
+		if (!(*basic_first == *basic_second)) std::cout << "mismatch ";
+	});
+	timed("equality store", [&]() {
+		term_id first = store_one.id_of(store_first);
+		term_id second = store_two.id_of(store_second);
+		if (!store_one.get_store().equal(first, store_two.get_store(),
+				second)) {
+			std::cout << "mismatch ";
+		}
+	});
+	return 0;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file
+ * Implement the region allocator.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "Arena.h"
+#include <new>
+
+namespace elision {
+
+Arena::Arena(size_t chunk_size, RefPolicy policy) : RefCounted(policy),
+		chunk_size_(chunk_size) {
+	// Nothing to do.
+}
+
+Arena::~Arena() {
+	while (head_ != nullptr) {
+		Chunk* next = head_->next;
+		::operator delete(head_);
+		head_ = next;
+	} // Free all chunks.
+}
+
+void*
+Arena::refill(size_t size, size_t align) {
+	// Leave room for the header and for aligning the first allocation.
+	size_t need = sizeof(Chunk) + size + align;
+	size_t bytes = need > chunk_size_ ? need : chunk_size_;
+	Chunk* chunk = static_cast<Chunk*>(::operator new(bytes));
+	++chunks_;
+	char* start = reinterpret_cast<char*>(chunk + 1);
+	char* limit = reinterpret_cast<char*>(chunk) + bytes;
+	char* place = reinterpret_cast<char*>(
+			(reinterpret_cast<uintptr_t>(start) + align - 1) & ~(align - 1));
+	if (need > chunk_size_ && head_ != nullptr) {
+		// An oversized request gets its own chunk.  Link it behind the
+		// current chunk so the remainder of the current chunk stays in use.
+		chunk->next = head_->next;
+		head_->next = chunk;
+	} else {
+		chunk->next = head_;
+		head_ = chunk;
+		next_ = place + size;
+		limit_ = limit;
+	}
+	used_ += size;
+	return place;
+}
+
+} /* namespace elision */
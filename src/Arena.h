@@ -0,0 +1,194 @@
+#ifndef ARENA_H_
+#define ARENA_H_
+
+/**
+ * @file
+ * Provide a region (bump) allocator whose memory is released all at once.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "RefCounted.h"
+
+namespace elision {
+
+/**
+ * Allocate memory by advancing a pointer through large chunks obtained from
+ * the heap.  Individual allocations are never returned; all chunks are freed
+ * together when the arena is destroyed.  This makes allocation very cheap and
+ * avoids fragmenting the heap with many small, short-lived objects.
+ *
+ * Objects placed in an arena must still be destroyed by their owners, since
+ * the arena knows nothing about them.
+ *
+ * An arena is not thread-safe.  Only one thread may allocate from it, though
+ * with `ATOMIC_COUNT` references to the arena may be dropped, and the arena
+ * destroyed, on any thread.
+ */
+class Arena : public RefCounted {
+public:
+	/**
+	 * Make a new, empty arena.  No memory is obtained until the first
+	 * allocation.
+	 * @param chunk_size	The size of each chunk obtained from the heap.
+	 * @param policy		How references to the arena are counted.
+	 */
+	explicit Arena(size_t chunk_size = 64 * 1024,
+			RefPolicy policy = ATOMIC_COUNT);
+
+	/// Release all memory held by this arena.
+	~Arena();
+
+	/**
+	 * Allocate memory from the arena.  Requests larger than a chunk get a
+	 * chunk of their own.
+	 * @param size	The number of bytes required.
+	 * @param align	The required alignment, which must be a power of two.
+	 * @return	The allocated memory.
+	 */
+	inline void* allocate(size_t size, size_t align) {
+		char* place = reinterpret_cast<char*>(
+				(reinterpret_cast<uintptr_t>(next_) + align - 1) & ~(align - 1));
+		if (place + size > limit_ || next_ == nullptr) {
+			return refill(size, align);
+		}
+		next_ = place + size;
+		used_ += size;
+		return place;
+	}
+
+	/**
+	 * Give back the most recent allocation.  If the provided memory is not
+	 * the most recent allocation nothing happens, and the memory is simply
+	 * held until the arena is destroyed.
+	 * @param place	The memory to give back.
+	 * @param size	The size requested when the memory was allocated.
+	 */
+	inline void rewind(void* place, size_t size) {
+		if (static_cast<char*>(place) + size == next_) {
+			next_ = static_cast<char*>(place);
+			used_ -= size;
+		}
+	}
+
+	/**
+	 * Get the number of bytes handed out by this arena.
+	 * @return	The bytes allocated, not counting alignment padding.
+	 */
+	inline size_t get_used() const {
+		return used_;
+	}
+
+	/**
+	 * Get the number of chunks obtained from the heap.
+	 * @return	The number of chunks.
+	 */
+	inline size_t get_chunks() const {
+		return chunks_;
+	}
+
+private:
+	/// Header at the start of every chunk, linking the chunks together.
+	struct Chunk {
+		Chunk* next;
+	};
+
+	/**
+	 * Obtain a new chunk and allocate from it.
+	 * @param size	The number of bytes required.
+	 * @param align	The required alignment.
+	 * @return	The allocated memory.
+	 */
+	void* refill(size_t size, size_t align);
+
+	size_t chunk_size_;
+	Chunk* head_ = nullptr;
+	char* next_ = nullptr;
+	char* limit_ = nullptr;
+	size_t used_ = 0;
+	size_t chunks_ = 0;
+};
+
+/**
+ * A standard allocator that obtains memory from an arena.  The allocator
+ * holds a reference to the arena, so the arena lives at least as long as
+ * anything allocated through it by a standard container or smart pointer.
+ * Deallocation does nothing; the memory is freed with the arena.
+ *
+ * @param T	The type to allocate.
+ */
+template<class T>
+class ArenaAllocator {
+public:
+	typedef T value_type;
+
+	/**
+	 * Make a new allocator.
+	 * @param arena	The arena to allocate from.
+	 */
+	explicit ArenaAllocator(boost::intrusive_ptr<Arena> const& arena) :
+		arena_(arena) {
+		// Nothing to do.
+	}
+
+	/**
+	 * Make an allocator for one type from an allocator for another.
+	 * @param other	The other allocator.
+	 */
+	template<class U>
+	ArenaAllocator(ArenaAllocator<U> const& other) : arena_(other.arena_) {
+		// Nothing to do.
+	}
+
+	/**
+	 * Allocate storage for some number of objects.
+	 * @param count	The number of objects.
+	 * @return	The storage.
+	 */
+	inline T* allocate(size_t count) {
+		return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+	}
+
+	/**
+	 * Release storage.  This does nothing, since it may be called on a
+	 * thread other than the one allocating from the arena.
+	 * @param place	The storage.
+	 * @param count	The number of objects.
+	 */
+	inline void deallocate(T* place, size_t count) {
+		(void)place;
+		(void)count;
+	}
+
+	template<class U>
+	inline bool operator==(ArenaAllocator<U> const& other) const {
+		return arena_ == other.arena_;
+	}
+
+	template<class U>
+	inline bool operator!=(ArenaAllocator<U> const& other) const {
+		return arena_ != other.arena_;
+	}
+
+private:
+	template<class U> friend class ArenaAllocator;
+	boost::intrusive_ptr<Arena> arena_;
+};
+
+} /* namespace elision */
+
+#endif /* ARENA_H_ */
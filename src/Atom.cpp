@@ -0,0 +1,177 @@
+/**
+ * @file
+ * Implement the global table of atoms.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "Atom.h"
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace elision {
+
+namespace {
+
+/**
+ * The table of names.  Names are found by identifier through a directory of
+ * fixed-size chunks.  A chunk never moves once it is made, and an entry is
+ * published before its identifier is handed out, so readers need no lock.
+ *
+ * Identifiers are found by name through an index split into shards by the
+ * hash of the name, each with its own lock, so threads interning different
+ * names rarely wait on each other.  In front of that, each thread keeps a
+ * small cache of the names it has recently seen, so interning a name again
+ * takes no lock at all.
+ */
+class AtomTable {
+public:
+	/// The number of names in each chunk.
+	static constexpr uint32_t CHUNK_BITS = 12;
+	static constexpr uint32_t CHUNK_SIZE = 1u << CHUNK_BITS;
+
+	/// The number of chunks in the directory.
+	static constexpr uint32_t CHUNKS = 1u << 16;
+
+	/// The number of shards in the index.  This must be a power of two.
+	static constexpr size_t SHARDS = 64;
+
+	/// The number of entries in each thread's cache.  A power of two.
+	static constexpr size_t CACHED = 256;
+
+	/**
+	 * Get the only instance.  The empty name is always atom zero.
+	 * @return	The table.
+	 */
+	static AtomTable& get() {
+		static AtomTable* table = new AtomTable();
+		return *table;
+	}
+
+	uint32_t intern(std::string const& name) {
+		size_t hash = std::hash<std::string>()(name);
+		Cached& slot = cache()[hash & (CACHED - 1)];
+		if (slot.live && slot.hash == hash && this->name(slot.id) == name) {
+			return slot.id;
+		}
+		Shard& shard = shards_[hash & (SHARDS - 1)];
+		std::lock_guard<std::mutex> guard(shard.lock);
+		auto found = shard.index.find(name);
+		if (found == shard.index.end()) {
+			uint32_t id = size_.fetch_add(1, std::memory_order_relaxed);
+			if (id >= CHUNK_SIZE * CHUNKS) {
+				size_.store(CHUNK_SIZE * CHUNKS, std::memory_order_relaxed);
+				throw std::length_error("The atom table is full.");
+			}
+			// Keys of an unordered map do not move, so the entry can refer
+			// to the key directly.
+			found = shard.index.emplace(name, id).first;
+			chunk_for(id)[id & (CHUNK_SIZE - 1)] = &found->first;
+		}
+		slot.hash = hash;
+		slot.id = found->second;
+		slot.live = true;
+		return found->second;
+	}
+
+	bool find(std::string const& name, uint32_t& id) {
+		Shard& shard = shards_[std::hash<std::string>()(name) & (SHARDS - 1)];
+		std::lock_guard<std::mutex> guard(shard.lock);
+		auto found = shard.index.find(name);
+		if (found == shard.index.end()) return false;
+		id = found->second;
+		return true;
+	}
+
+	inline std::string const& name(uint32_t id) const {
+		return *directory_[id >> CHUNK_BITS].load(std::memory_order_acquire)
+				[id & (CHUNK_SIZE - 1)];
+	}
+
+private:
+	AtomTable() {
+		for (auto& chunk : directory_) {
+			chunk.store(nullptr, std::memory_order_relaxed);
+		} // Clear the directory.
+		size_.store(0, std::memory_order_relaxed);
+		intern("");
+	}
+
+	/// A part of the index, with its own lock.
+	struct Shard {
+		std::mutex lock;	//< Guard for index.
+		std::unordered_map<std::string, uint32_t> index;	//< Names.
+	};
+
+	/// An entry in a thread's cache of recently interned names.
+	struct Cached {
+		size_t hash = 0;	//< Hash of the name.
+		uint32_t id = 0;	//< Identifier of the name.
+		bool live = false;	//< Whether the entry is in use.
+	};
+
+	/**
+	 * Get this thread's cache.  There is only one table, so the cache
+	 * needs no owner.
+	 * @return	The cache.
+	 */
+	static Cached* cache() {
+		static thread_local Cached entries[CACHED];
+		return entries;
+	}
+
+	/**
+	 * Get the chunk holding an identifier, making it if necessary.  Two
+	 * threads may race to make the same chunk; the loser discards its own.
+	 * @param id	The identifier.
+	 * @return	The chunk.
+	 */
+	std::string const** chunk_for(uint32_t id) {
+		auto& place = directory_[id >> CHUNK_BITS];
+		std::string const** chunk = place.load(std::memory_order_acquire);
+		if (chunk != nullptr) return chunk;
+		std::string const** fresh = new std::string const*[CHUNK_SIZE];
+		if (place.compare_exchange_strong(chunk, fresh,
+				std::memory_order_acq_rel)) {
+			return fresh;
+		}
+		delete[] fresh;
+		return chunk;
+	}
+
+	Shard shards_[SHARDS];
+	std::atomic<uint32_t> size_;
+	std::atomic<std::string const**> directory_[CHUNKS];
+};
+
+} /* anonymous namespace */
+
+Atom::Atom(std::string const& name) : id_(AtomTable::get().intern(name)) {
+	// Nothing to do.
+}
+
+bool
+Atom::find(std::string const& name, Atom& atom) {
+	return AtomTable::get().find(name, atom.id_);
+}
+
+std::string const&
+Atom::get_name() const {
+	return AtomTable::get().name(id_);
+}
+
+} /* namespace elision */
@@ -0,0 +1,131 @@
+#ifndef ATOM_H_
+#define ATOM_H_
+
+/**
+ * @file
+ * Provide interned names for symbols and variables.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace elision {
+
+/**
+ * A name held in a global, process-wide table.  Each distinct name is stored
+ * once and given a 32-bit identifier, so comparing and hashing names are
+ * integer operations, and a term holding a name holds only the identifier.
+ * The name itself is found again with `get_name`.
+ *
+ * Names are never removed from the table, so the table should hold names
+ * (of symbols, variables, and binds) and not arbitrary data.  Interning is
+ * safe from any thread, and getting the name of an atom does not lock.
+ *
+ * Atoms are ordered by identifier, which depends on the order in which names
+ * were first interned.  Use the names if a stable order is needed.
+ */
+class Atom {
+public:
+	/// Make the atom for the empty name.
+	Atom() : id_(0) {}
+
+	/**
+	 * Get the atom for a name, adding the name to the table if necessary.
+	 * @param name	The name.
+	 */
+	explicit Atom(std::string const& name);
+
+	/**
+	 * Get the atom for a name only if the name is already in the table.
+	 * This does not add to the table, and so is the right choice when
+	 * looking a name up.
+	 * @param name	The name.
+	 * @param atom	The atom, which is set only if it is found.
+	 * @return	True iff the name is in the table.
+	 */
+	static bool find(std::string const& name, Atom& atom);
+
+	/**
+	 * Get an atom from its identifier.  The identifier must have come from
+	 * `get_id`.
+	 * @param id	The identifier.
+	 * @return	The atom.
+	 */
+	static inline Atom from_id(uint32_t id) {
+		Atom atom;
+		atom.id_ = id;
+		return atom;
+	}
+
+	/**
+	 * Get the identifier of this atom.
+	 * @return	The identifier.
+	 */
+	inline uint32_t get_id() const {
+		return id_;
+	}
+
+	/**
+	 * Get the name of this atom.  The reference remains valid for the life
+	 * of the program.
+	 * @return	The name.
+	 */
+	std::string const& get_name() const;
+
+	inline bool operator==(Atom const& other) const {
+		return id_ == other.id_;
+	}
+
+	inline bool operator!=(Atom const& other) const {
+		return id_ != other.id_;
+	}
+
+	inline bool operator<(Atom const& other) const {
+		return id_ < other.id_;
+	}
+
+private:
+	uint32_t id_;
+};
+
+/**
+ * Compare two atoms by their names.  Equal atoms are detected without
+ * looking at the names.
+ * @param first		The first atom.
+ * @param second	The second atom.
+ * @return	True iff the first name is less than the second.
+ */
+inline bool name_less(Atom const& first, Atom const& second) {
+	return first != second && first.get_name() < second.get_name();
+}
+
+} /* namespace elision */
+
+namespace std {
+
+/// Hash an atom by its identifier.
+template<>
+struct hash<elision::Atom> {
+	inline size_t operator()(elision::Atom const& atom) const {
+		return atom.get_id();
+	}
+};
+
+} /* namespace std */
+
+#endif /* ATOM_H_ */
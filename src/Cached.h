@@ -0,0 +1,128 @@
+#ifndef CACHED_H_
+#define CACHED_H_
+
+/**
+ * @file
+ * Provide a compact, thread-safe cache for a value computed on first use.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace elision {
+
+/**
+ * Hold a value that is computed the first time it is requested.  The
+ * computation is not stored; it is provided each time the value is
+ * requested, typically as a lambda that calls a member function.  This
+ * keeps the cache down to the value itself plus one byte of state, and
+ * avoids allocating a closure on the heap.
+ *
+ * ~~~{.cpp}
+ * Cached<std::vector<pTerm>> elements_;
+ *
+ * std::vector<pTerm> const& get_elements() const {
+ *   return elements_.get([this]() { return make_elements(); });
+ * }
+ * ~~~
+ *
+ * The value is computed at most once, even if several threads request it at
+ * the same time; the others wait for the first to finish.  If the computation
+ * throws, the cache is left empty and the exception is propagated.  The
+ * computation must not request the same value, or it will wait forever.
+ *
+ * @param T	The type of the value.  It must be default-constructible.
+ */
+template<typename T>
+class Cached {
+public:
+	/// Make a new, empty cache.
+	Cached() = default;
+
+	Cached(Cached const&) = delete;
+	Cached& operator=(Cached const&) = delete;
+
+	/**
+	 * Get the value, computing it if necessary.
+	 * @param compute	A function taking no arguments that computes the value.
+	 * @return	The value.
+	 */
+	template<class Compute>
+	inline T const& get(Compute compute) const {
+		if (state_.load(std::memory_order_acquire) != READY) {
+			fill(compute);
+		}
+		return value_;
+	}
+
+	/**
+	 * Store the value directly.  This must only be done before the cache is
+	 * shared with other threads, typically in a constructor.
+	 * @param value	The value.
+	 */
+	inline void set(T const& value) {
+		value_ = value;
+		state_.store(READY, std::memory_order_release);
+	}
+
+	/**
+	 * Determine whether the value has been computed.
+	 * @return	True iff the value is available.
+	 */
+	inline bool has_value() const {
+		return state_.load(std::memory_order_acquire) == READY;
+	}
+
+private:
+	/// The states of the cache.
+	enum : uint8_t { EMPTY, BUSY, READY };
+
+	/**
+	 * Compute the value, or wait for another thread to compute it.
+	 * @param compute	The computation.
+	 */
+	template<class Compute>
+	void fill(Compute& compute) const {
+		for (;;) {
+			uint8_t state = EMPTY;
+			if (state_.compare_exchange_strong(state, BUSY,
+					std::memory_order_acquire)) {
+				try {
+					value_ = compute();
+				} catch (...) {
+					state_.store(EMPTY, std::memory_order_release);
+					throw;
+				}
+				state_.store(READY, std::memory_order_release);
+				return;
+			}
+			if (state == READY) {
+				return;
+			}
+			// Another thread is computing the value.
+			std::this_thread::yield();
+		} // Loop until the value is available.
+	}
+
+	mutable T value_{};
+	mutable std::atomic<uint8_t> state_{EMPTY};
+};
+
+} /* namespace elision */
+
+#endif /* CACHED_H_ */
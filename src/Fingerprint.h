@@ -0,0 +1,289 @@
+#ifndef FINGERPRINT_H_
+#define FINGERPRINT_H_
+
+/**
+ * @file
+ * Provide 128-bit structural fingerprints, and a builder for them.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include "elision.h"
+#include "Atom.h"
+#include "Integer.h"
+
+namespace elision {
+
+/**
+ * A 128-bit fingerprint.  Equal values have equal fingerprints, and unequal
+ * values have equal fingerprints only with negligible probability, so a
+ * fingerprint can stand in for a value as a cache key, and a difference in
+ * fingerprints proves the values differ.
+ */
+struct Fingerprint {
+	/// The low 64 bits.
+	uint64_t low = 0;
+	/// The high 64 bits.
+	uint64_t high = 0;
+
+	inline bool operator==(Fingerprint const& other) const {
+		return low == other.low && high == other.high;
+	}
+
+	inline bool operator!=(Fingerprint const& other) const {
+		return low != other.low || high != other.high;
+	}
+
+	inline bool operator<(Fingerprint const& other) const {
+		return high < other.high || (high == other.high && low < other.low);
+	}
+};
+
+/**
+ * Build a fingerprint from a sequence of words.  The order of the words
+ * matters.  Each piece of data added is framed (strings carry their length,
+ * integers their sign and limb count), so different sequences of pieces do
+ * not collide by running together.
+ *
+ * ~~~{.cpp}
+ * Fingerprint print = Fingerprinter(kind).add(name).add(child).get();
+ * ~~~
+ *
+ * The mixing follows the body and finalization of MurmurHash3 (x64, 128 bit),
+ * taking one 64-bit word at a time.
+ */
+class Fingerprinter {
+public:
+	/**
+	 * Start a new fingerprint.
+	 * @param seed	A value to distinguish different kinds of data.
+	 */
+	explicit Fingerprinter(uint64_t seed = 0) :
+		first_(seed ^ 0x6a09e667f3bcc908ULL),
+		second_(seed ^ 0xbb67ae8584caa73bULL) {
+		// Nothing to do.
+	}
+
+	/**
+	 * Add a word.
+	 * @param word	The word.
+	 * @return	This builder.
+	 */
+	inline Fingerprinter& add(uint64_t word) {
+		uint64_t one = word * C1;
+		one = rotl(one, 31) * C2;
+		first_ ^= one;
+		first_ = (rotl(first_, 27) + second_) * 5 + 0x52dce729;
+		uint64_t two = rotl(word, 33) * C2;
+		two = rotl(two, 33) * C1;
+		second_ ^= two;
+		second_ = (rotl(second_, 31) + first_) * 5 + 0x38495ab5;
+		++count_;
+		return *this;
+	}
+
+	/**
+	 * Add another fingerprint, typically that of a child.
+	 * @param print	The fingerprint.
+	 * @return	This builder.
+	 */
+	inline Fingerprinter& add(Fingerprint const& print) {
+		return add(print.low).add(print.high);
+	}
+
+	/**
+	 * Add a string, preceded by its length.
+	 * @param text	The string.
+	 * @return	This builder.
+	 */
+	inline Fingerprinter& add(std::string const& text) {
+		add(static_cast<uint64_t>(text.size()));
+		size_t index = 0;
+		for (; index + 8 <= text.size(); index += 8) {
+			uint64_t word;
+			std::memcpy(&word, text.data() + index, 8);
+			add(word);
+		} // Add all full words.
+		if (index < text.size()) {
+			uint64_t word = 0;
+			std::memcpy(&word, text.data() + index, text.size() - index);
+			add(word);
+		}
+		return *this;
+	}
+
+	/**
+	 * Add the name held by an atom.  This is the same as adding the name, so
+	 * the fingerprint does not depend on the order in which names were
+	 * interned.
+	 * @param atom	The atom.
+	 * @return	This builder.
+	 */
+	inline Fingerprinter& add(Atom const& atom) {
+		return add(atom.get_name());
+	}
+
+	/**
+	 * Add an integer.  The binary representation is used directly, so no
+	 * conversion to text is needed.
+	 * @param value	The integer.
+	 * @return	This builder.
+	 */
+	inline Fingerprinter& add_integer(eint_t const& value) {
+#ifdef HAVE_BOOST_CPP_INT
+		auto const& backend = value.backend();
+		add(static_cast<uint64_t>(value.sign()));
+		add(static_cast<uint64_t>(backend.size()));
+		for (unsigned index = 0; index < backend.size(); ++index) {
+			add(static_cast<uint64_t>(backend.limbs()[index]));
+		} // Add all limbs.
+#else
+		add(static_cast<uint64_t>(value));
+#endif
+		return *this;
+	}
+
+	/**
+	 * Add an integer.  Small values are added directly, and give the same
+	 * fingerprint as the same value held as an `eint_t`.
+	 * @param value	The integer.
+	 * @return	This builder.
+	 */
+	inline Fingerprinter& add_integer(Integer const& value) {
+		if (!value.is_small()) return add_integer(value.get_big());
+		int64_t small = value.get_small();
+#ifdef HAVE_BOOST_CPP_INT
+		// Match the sign, the limb count, and the single limb.
+		add(static_cast<uint64_t>((small > 0) - (small < 0)));
+		add(static_cast<uint64_t>(1));
+		add(static_cast<uint64_t>(small < 0 ? -small : small));
+#else
+		add(static_cast<uint64_t>(small));
+#endif
+		return *this;
+	}
+
+	/**
+	 * Finish the fingerprint.  The builder may be used further.
+	 * @return	The fingerprint of everything added so far.
+	 */
+	inline Fingerprint get() const {
+		uint64_t first = first_ ^ count_;
+		uint64_t second = second_ ^ count_;
+		first += second;
+		second += first;
+		first = fmix(first);
+		second = fmix(second);
+		first += second;
+		second += first;
+		Fingerprint print;
+		print.low = first;
+		print.high = second;
+		return print;
+	}
+
+private:
+	static constexpr uint64_t C1 = 0x87c37b91114253d5ULL;
+	static constexpr uint64_t C2 = 0x4cf5ad432745937fULL;
+
+	static inline uint64_t rotl(uint64_t word, int shift) {
+		return (word << shift) | (word >> (64 - shift));
+	}
+
+	static inline uint64_t fmix(uint64_t word) {
+		word ^= word >> 33;
+		word *= 0xff51afd7ed558ccdULL;
+		word ^= word >> 33;
+		word *= 0xc4ceb9fe1a85ec53ULL;
+		word ^= word >> 33;
+		return word;
+	}
+
+	uint64_t first_;
+	uint64_t second_;
+	uint64_t count_ = 0;
+};
+
+/**
+ * A fingerprint of a sequence that can be joined with the fingerprint of
+ * another sequence without visiting either one again.  Each half is a
+ * polynomial in the fingerprints of the items, so the print of a sequence
+ * split into pieces is found from the prints of the pieces.  This lets a
+ * tree of items keep a print in each node.
+ *
+ * ~~~{.cpp}
+ * SequencePrint print;
+ * for (auto const& item : items) print.append(SequencePrint(item));
+ * ~~~
+ */
+class SequencePrint {
+public:
+	/// Make the print of the empty sequence.
+	SequencePrint() : power_low_(1), power_high_(1) {}
+
+	/**
+	 * Make the print of a sequence of one item.
+	 * @param item	The fingerprint of the item.
+	 */
+	explicit SequencePrint(Fingerprint const& item) : sum_(item),
+			power_low_(P_LOW), power_high_(P_HIGH) {}
+
+	/**
+	 * Append another sequence to this one.
+	 * @param next	The print of the sequence that follows.
+	 * @return	This print.
+	 */
+	inline SequencePrint& append(SequencePrint const& next) {
+		sum_.low = sum_.low * next.power_low_ + next.sum_.low;
+		sum_.high = sum_.high * next.power_high_ + next.sum_.high;
+		power_low_ *= next.power_low_;
+		power_high_ *= next.power_high_;
+		return *this;
+	}
+
+	/**
+	 * Get the combined fingerprint of the items.  This is not framed, so add
+	 * it to a `Fingerprinter` along with the length of the sequence.
+	 * @return	The fingerprint.
+	 */
+	inline Fingerprint const& get() const {
+		return sum_;
+	}
+
+private:
+	static constexpr uint64_t P_LOW = 0x9e3779b97f4a7c15ULL;
+	static constexpr uint64_t P_HIGH = 0xc2b2ae3d27d4eb4fULL;
+
+	Fingerprint sum_;
+	// The multipliers raised to the length of the sequence.
+	uint64_t power_low_;
+	uint64_t power_high_;
+};
+
+} /* namespace elision */
+
+namespace std {
+template <> struct hash<elision::Fingerprint> {
+	size_t operator()(elision::Fingerprint const& print) const {
+		return static_cast<size_t>(print.low);
+	}
+};
+} /* namespace std */
+
+#endif /* FINGERPRINT_H_ */
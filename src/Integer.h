@@ -0,0 +1,203 @@
+#ifndef INTEGER_H_
+#define INTEGER_H_
+
+/**
+ * @file
+ * Provide a compact integer that holds small values inline.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include "elision.h"
+
+namespace elision {
+
+/**
+ * Hold an unbounded integer in a single word.  Values that fit in 63 bits
+ * are stored inline, tagged by setting the low bit of the word; any other
+ * value is promoted to an `eint_t` on the heap, and the word holds the
+ * pointer.  Nearly every integer in a program is small, so this avoids the
+ * size of a big integer and the cost of its arithmetic in the common case.
+ *
+ * The representation is canonical: a value is promoted only if it does not
+ * fit, so two instances are equal exactly when both are small with the same
+ * word, or both are big with equal values.
+ */
+class Integer {
+public:
+	/// The largest value held inline.
+	static constexpr int64_t SMALL_MAX = (INT64_C(1) << 62) - 1;
+
+	/// The smallest value held inline.
+	static constexpr int64_t SMALL_MIN = -(INT64_C(1) << 62);
+
+	/// Make a new instance holding zero.
+	Integer() : word_(1) {}
+
+	/**
+	 * Make a new instance.
+	 * @param value	The value.
+	 */
+	explicit Integer(int64_t value) {
+		if (value >= SMALL_MIN && value <= SMALL_MAX) {
+			word_ = (static_cast<uint64_t>(value) << 1) | 1;
+		} else {
+			big_ = new eint_t(value);
+		}
+	}
+
+#ifdef HAVE_BOOST_CPP_INT
+	/**
+	 * Make a new instance.
+	 * @param value	The value.
+	 */
+	explicit Integer(eint_t const& value) {
+		if (value >= SMALL_MIN && value <= SMALL_MAX) {
+			word_ = (static_cast<uint64_t>(value.convert_to<int64_t>()) << 1)
+					| 1;
+		} else {
+			big_ = new eint_t(value);
+		}
+	}
+#endif
+
+	/**
+	 * Copy an instance.
+	 * @param other	The instance to copy.
+	 */
+	Integer(Integer const& other) {
+		if (other.is_small()) word_ = other.word_;
+		else big_ = new eint_t(*other.big_);
+	}
+
+	/**
+	 * Move an instance.  The original is left holding zero.
+	 * @param other	The instance to move.
+	 */
+	Integer(Integer&& other) noexcept : word_(other.word_) {
+		other.word_ = 1;
+	}
+
+	/**
+	 * Assign an instance.
+	 * @param other	The instance to assign.
+	 * @return	This instance.
+	 */
+	Integer& operator=(Integer other) noexcept {
+		std::swap(word_, other.word_);
+		return *this;
+	}
+
+	/// Deallocate this instance.
+	~Integer() {
+		if (!is_small()) delete big_;
+	}
+
+	/**
+	 * Determine whether the value is held inline.
+	 * @return	True iff the value fits in 63 bits.
+	 */
+	inline bool is_small() const {
+		return (word_ & 1) != 0;
+	}
+
+	/**
+	 * Get the value when it is held inline.  Only call this if `is_small`
+	 * is true.
+	 * @return	The value.
+	 */
+	inline int64_t get_small() const {
+		return static_cast<int64_t>(word_) >> 1;
+	}
+
+	/**
+	 * Get the value when it is on the heap.  Only call this if `is_small`
+	 * is false.
+	 * @return	The value.
+	 */
+	inline eint_t const& get_big() const {
+		return *big_;
+	}
+
+	/**
+	 * Get the value as an unbounded integer.
+	 * @return	The value.
+	 */
+	inline eint_t get() const {
+		return is_small() ? eint_t(get_small()) : *big_;
+	}
+
+	/**
+	 * Get the sign of the value.
+	 * @return	-1 if the value is negative, 0 if it is zero, and 1 if it is
+	 * 			positive.
+	 */
+	inline int sign() const {
+		if (is_small()) {
+			int64_t value = get_small();
+			return (value > 0) - (value < 0);
+		}
+		return *big_ < 0 ? -1 : 1;
+	}
+
+	inline bool operator==(Integer const& other) const {
+		if (is_small() || other.is_small()) return word_ == other.word_;
+		return *big_ == *other.big_;
+	}
+
+	inline bool operator!=(Integer const& other) const {
+		return !(*this == other);
+	}
+
+	inline bool operator<(Integer const& other) const {
+		if (is_small() && other.is_small()) {
+			return get_small() < other.get_small();
+		}
+		// A big value is beyond every small value.
+		if (is_small()) return *other.big_ > 0;
+		if (other.is_small()) return *big_ < 0;
+		return *big_ < *other.big_;
+	}
+
+private:
+	union {
+		/// The tagged value.  The low bit is set iff the value is inline.
+		uint64_t word_;
+		/// The value, when it is not inline.  Allocations are aligned, so
+		/// the low bit is clear.
+		eint_t* big_;
+	};
+};
+
+/**
+ * Convert an integer to a string in the specified base.  Small values are
+ * converted directly, without going through an unbounded integer.  The
+ * result is the same as for the `eint_t` form.
+ *
+ * @param value		The integer.
+ * @param base		The base, which must be 16, 10, 8, or 2.
+ * @param prefix	Whether or not to include the base prefix in the string.
+ * @return	The string, with any necessary base identifier.
+ * @throws	invalid_argument	If the base is incorrect.
+ */
+std::string eint_to_string(Integer const& value, uint16_t base,
+		bool prefix = true);
+
+} /* namespace elision */
+
+#endif /* INTEGER_H_ */
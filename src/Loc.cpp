@@ -18,98 +18,145 @@
  */
 
 #include "Loc.h"
-#include "Lazy.h"
+#include "Atom.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace elision {
 
-struct Loc::Impl {
-    std::string source_{""};
-    unsigned int line_ = 0;
-    unsigned int column_ = 0;
-    Lazy<std::string> strval_{};
-};
+namespace {
 
-Loc::Loc(const std::string& source, unsigned int line, unsigned int column)
-:pimpl_(new Impl) {
-    pimpl_->source_ = source;
-    pimpl_->line_ = line;
-    pimpl_->column_ = column;
-    pimpl_->strval_ = [this]() {
-        std::ostringstream str;
-        if (this->pimpl_->source_.length() > 0) {
-            str << this->pimpl_->source_ << ":"
-                    << this->pimpl_->line_ << ":"
-                    << this->pimpl_->column_;
-        }
-        std::string ret = str.str();
-        return ret;
-    };
-}
+/**
+ * The table of sources.  Each source is held as an atom, so its name is
+ * stored once; the table gives it a small index that fits in a packed
+ * location.  Entries never change once published, so reading the table does
+ * not lock.  Each thread remembers the last few sources it interned, so a
+ * parser making locations in one file does not lock either.
+ */
+class FileTable {
+public:
+    /// The number of sources, which is limited by the packing.
+    static constexpr uint32_t SIZE = UINT16_MAX;
 
-Loc::Loc(unsigned int line, unsigned int column) :pimpl_(new Impl) {
-    pimpl_->source_ = "(console)";
-    pimpl_->line_ = line;
-    pimpl_->column_ = column;
-    pimpl_->strval_ = [this]() {
-        std::ostringstream str;
-        if (this->pimpl_->source_.length() > 0) {
-            str << this->pimpl_->source_ << ":"
-                    << this->pimpl_->line_ << ":"
-                    << this->pimpl_->column_;
-        }
-        std::string ret = str.str();
-        return ret;
-    };
-}
+    static FileTable& get() {
+        static FileTable* table = new FileTable();
+        return *table;
+    }
 
-Loc::Loc(Loc const& loc) {
-    pimpl_->source_ = loc.pimpl_->source_;
-    pimpl_->line_ = loc.pimpl_->line_;
-    pimpl_->column_ = loc.pimpl_->column_;
-    pimpl_->strval_ = [this]() {
-        std::ostringstream str;
-        if (this->pimpl_->source_.length() > 0) {
-            str << this->pimpl_->source_ << ":"
-                    << this->pimpl_->line_ << ":"
-                    << this->pimpl_->column_;
+    uint16_t intern(std::string const& source) {
+        Atom atom(source);
+        Cached& slot = cache()[atom.get_id() & (CACHED - 1)];
+        if (slot.live && slot.atom == atom) return slot.file;
+        std::lock_guard<std::mutex> guard(lock_);
+        auto found = index_.find(atom);
+        if (found == index_.end()) {
+            if (size_ == SIZE) {
+                throw std::length_error("The file table is full.");
+            }
+            uint16_t file = static_cast<uint16_t>(size_++);
+            files_[file].store(atom.get_id(), std::memory_order_release);
+            found = index_.emplace(atom, file).first;
         }
-        std::string ret = str.str();
-        return ret;
+        slot.atom = atom;
+        slot.file = found->second;
+        slot.live = true;
+        return found->second;
+    }
+
+    inline std::string const& name(uint16_t file) const {
+        return Atom::from_id(files_[file].load(std::memory_order_acquire))
+                .get_name();
+    }
+
+private:
+    FileTable() {
+        for (auto& file : files_) file.store(0, std::memory_order_relaxed);
+        // These must match the well-known indices in Loc.
+        intern("");
+        intern("(console)");
+    }
+
+    /// The number of entries in each thread's cache.  A power of two.
+    static constexpr uint32_t CACHED = 16;
+
+    /// An entry in a thread's cache of recently interned sources.
+    struct Cached {
+        Atom atom;          //< The source.
+        uint16_t file = 0;  //< Its index.
+        bool live = false;  //< Whether the entry is in use.
     };
-}
 
-Loc::~Loc() {}
+    /**
+     * Get this thread's cache.  There is only one table, so the cache
+     * needs no owner.
+     * @return  The cache.
+     */
+    static Cached* cache() {
+        static thread_local Cached entries[CACHED];
+        return entries;
+    }
+
+    std::mutex lock_;
+    std::unordered_map<Atom, uint16_t> index_;
+    uint32_t size_ = 0;
+    /// The sources, by index.  The extra last entry is for Loc::NO_FILE,
+    /// which is never handed out, and so names the empty source.
+    std::atomic<uint32_t> files_[SIZE + 1];
+};
+
+} /* anonymous namespace */
+
+// Definitions for the masks, which std::min takes by reference.
+constexpr uint64_t Loc::COLUMN_MASK;
+constexpr uint64_t Loc::LINE_MASK;
+
+Loc::Loc(const std::string& source, unsigned int line, unsigned int column) {
+    pack(source.empty() ? INTERNAL_FILE : FileTable::get().intern(source),
+            line, column);
+}
 
-std::string& Loc::get_source() { return pimpl_->source_; }
+Loc::Loc(unsigned int line, unsigned int column) {
+    pack(CONSOLE_FILE, line, column);
+}
 
-unsigned int Loc::get_line() { return pimpl_->line_; }
+void
+Loc::pack(uint16_t file, unsigned int line, unsigned int column) {
+    uint64_t clamped_line = std::min<uint64_t>(line, LINE_MASK);
+    uint64_t clamped_column = std::min<uint64_t>(column, COLUMN_MASK);
+    packed_ = (static_cast<uint64_t>(file) << (COLUMN_BITS + LINE_BITS)) |
+            (clamped_line << COLUMN_BITS) | clamped_column;
+}
 
-unsigned int Loc::get_column() { return pimpl_->column_; }
+Locus
+Loc::get(std::string const& source, unsigned int line, unsigned int column) {
+    return Locus(Loc(source, line, column));
+}
 
-bool
-Loc::operator==(Loc const& other) const {
-    return pimpl_->source_ == other.pimpl_->source_ &&
-            pimpl_->line_ == other.pimpl_->line_ &&
-            pimpl_->column_ == other.pimpl_->column_;
+Locus
+Loc::get(unsigned int line, unsigned int column) {
+    return Locus(Loc(line, column));
 }
 
-bool
-Loc::operator!=(Loc const& other) const {
-    return !(*this == other);
+std::string const&
+Loc::get_source() const {
+    return FileTable::get().name(get_file());
 }
 
 Loc::operator
 std::string() const {
-	return pimpl_->strval_;
+    if (is_internal()) return "";
+    std::ostringstream str;
+    str << get_source() << ":" << get_line() << ":" << get_column();
+    return str.str();
 }
 
 Locus
 Loc::get_internal() {
-	static Lazy<Locus> ret([](){
-		return std::shared_ptr<Loc const>(new Loc(""));
-	});
-    return ret;
+    return Locus(Loc(""));
 }
 
 } /* namespace elision */
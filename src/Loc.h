@@ -21,15 +21,22 @@
  */
 
 #include "elision.h"
+#include <cstdint>
 #include <string>
-#include <memory>
 
 namespace elision {
 
-class Loc;
-/// Shorthand for a pointer to a location.
-typedef std::shared_ptr<Loc const> Locus;
+class Locus;
 
+/**
+ * Whether a factory records the locations of the terms it makes.  A factory
+ * that drops locations makes every term with the internal location, which
+ * suits production runs that never report source positions.
+ */
+enum LocPolicy {
+    KEEP_LOCATIONS,	//< Record the location given for each term.
+    DROP_LOCATIONS	//< Use the internal location for every term.
+};
 
 /**
  * Every term can have an associated location, which tells where the term
@@ -40,15 +47,21 @@ typedef std::shared_ptr<Loc const> Locus;
  * Every term has an associated location that is provided during construction.
  * To make a location, do one of the following.
  *   - If the location is from @c file with line number @c line and column
- *     number @c column, then invoke <tt>Loc(file, line, column)</tt>.
+ *     number @c column, then invoke <tt>Loc::get(file, line, column)</tt>.
  *   - If the location is from a console session with line number @c line and
- *     column number @c column, then invoke <tt>Loc(line, column)</tt>.
+ *     column number @c column, then invoke <tt>Loc::get(line, column)</tt>.
  *   - If the term is being created as part of an internal process (such as
  *     the root type) or otherwise has no associated location, then get the
  *     internal location via <tt>Loc::get_internal()</tt>.
+ *
+ * @section packing Packing
+ * A location is a single packed word: the index of the source in a global
+ * file table, the line, and the column.  Each source name is stored once, no
+ * matter how many locations refer to it, and locations are copied by value.
+ * Lines past 2^32-1 and columns past 2^16-1 are clamped.
  */
 class Loc {
-private:
+public:
     /**
      * Initialize a new instance.  Note that both the line and column numbers
      * are one-based, so zero can be used to indicate that the respective
@@ -69,13 +82,6 @@ private:
      */
     Loc(unsigned int line = 0, unsigned int column = 0);
 
-public:
-    /**
-     * Copy constructor.
-     * @param loc       Another location.
-     */
-    Loc(Loc const& loc);
-
     /**
      * Factory method to get a pointer to a location instance.
      * @param source    The source.  This should be the file name for files,
@@ -84,34 +90,31 @@ public:
      * @param line      The source line number.  If none is known, use zero.
      * @param column    The source column.  If none is known, use zero.
      */
-    inline static Locus get(std::string const& source,
-    		unsigned int line = 0, unsigned int column = 0) {
-    	Locus ret(new Loc(source, line, column));
-    	return ret;
-    }
+    static Locus get(std::string const& source,
+    		unsigned int line = 0, unsigned int column = 0);
 
     /**
      * Factory method to get a pointer to a console location instance.
      * @param line      The source line number.  If none is known, use zero.
      * @param column    The source column.  If none is known, use zero.
      */
-    inline static Locus get(unsigned int line = 0,
-    		unsigned int column = 0) {
-    	Locus ret(new Loc(line, column));
-    	return ret;
-    }
+    static Locus get(unsigned int line = 0, unsigned int column = 0);
 
     /**
      * Compare two locations.
      * @return  True iff the locations are the same, and false otherwise.
      */
-    bool operator==(Loc const& other) const;
+    inline bool operator==(Loc const& other) const {
+        return packed_ == other.packed_;
+    }
 
     /**
      * Compare two locations.
      * @return  False iff the locations are the same, and true otherwise.
      */
-    bool operator!=(Loc const& other) const;
+    inline bool operator!=(Loc const& other) const {
+        return packed_ != other.packed_;
+    }
 
     /**
      * Get this location instance as a string.  The resulting string has the
@@ -124,39 +127,123 @@ public:
      */
     operator std::string() const;
 
-    /// Deallocate this instance.
-    virtual ~Loc();
-
     /**
      * Get the source.  This will be the filename, the empty string (for
      * an internal location), or the special string <tt>(console)</tt> for
      * a console location.
      * @return  The source name.
      */
-    std::string& get_source();
+    std::string const& get_source() const;
 
     /**
      * Get the line number, if provided.  Returns zero if none.
      * @return  The one-based line number.
      */
-    unsigned int get_line();
+    inline unsigned int get_line() const {
+        return static_cast<unsigned int>(packed_ >> COLUMN_BITS);
+    }
 
     /**
      * Get the column number, if known.  Returns zero if not known.
      * @return  The one-based column number.
      */
-    unsigned int get_column();
+    inline unsigned int get_column() const {
+        return static_cast<unsigned int>(packed_ & COLUMN_MASK);
+    }
+
+    /**
+     * Determine whether this is the internal location.
+     * @return  True iff the source is the empty string.
+     */
+    inline bool is_internal() const {
+        return get_file() == INTERNAL_FILE;
+    }
 
     /**
-     * Get the special internal location.
-     * This is much faster than using <tt>Loc("")</tt>, since it only constructs
-     * the first time.
+     * Get the special internal location.  This costs nothing to make.
      */
     static Locus get_internal();
 
 private:
-    struct Impl;
-    std::unique_ptr<Impl> pimpl_;
+    friend class Locus;
+
+    static constexpr unsigned COLUMN_BITS = 16;
+    static constexpr unsigned LINE_BITS = 32;
+    static constexpr uint64_t COLUMN_MASK = (UINT64_C(1) << COLUMN_BITS) - 1;
+    static constexpr uint64_t LINE_MASK = (UINT64_C(1) << LINE_BITS) - 1;
+
+    /// Indices of the well-known sources in the file table.
+    static constexpr uint16_t INTERNAL_FILE = 0;
+    static constexpr uint16_t CONSOLE_FILE = 1;
+
+    /// The index that marks the absence of any location.
+    static constexpr uint16_t NO_FILE = UINT16_MAX;
+
+    /**
+     * Pack the parts of a location.
+     * @param file      The index of the source in the file table.
+     * @param line      The line.
+     * @param column    The column.
+     */
+    void pack(uint16_t file, unsigned int line, unsigned int column);
+
+    inline uint16_t get_file() const {
+        return static_cast<uint16_t>(packed_ >> (COLUMN_BITS + LINE_BITS));
+    }
+
+    /// The file, line, and column, from most to least significant.
+    uint64_t packed_;
+};
+
+
+/**
+ * A handle for a location.  This used to be a shared pointer, and it still
+ * behaves like one, but it holds the packed location by value.  A default
+ * handle is null.
+ */
+class Locus {
+public:
+    /// Make a null handle.
+    Locus() {
+        loc_.pack(Loc::NO_FILE, 0, 0);
+    }
+
+    /**
+     * Make a handle for a location.
+     * @param loc       The location.
+     */
+    Locus(Loc const& loc) : loc_(loc) {}
+
+    inline Loc const& operator*() const {
+        return loc_;
+    }
+
+    inline Loc const* operator->() const {
+        return &loc_;
+    }
+
+    inline Loc const* get() const {
+        return &loc_;
+    }
+
+    /**
+     * Determine whether the handle refers to a location.
+     * @return  True iff the handle is not null.
+     */
+    inline explicit operator bool() const {
+        return loc_.get_file() != Loc::NO_FILE;
+    }
+
+    inline bool operator==(Locus const& other) const {
+        return loc_ == other.loc_;
+    }
+
+    inline bool operator!=(Locus const& other) const {
+        return loc_ != other.loc_;
+    }
+
+private:
+    Loc loc_;
 };
 
 } /* namespace elision */
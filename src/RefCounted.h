@@ -0,0 +1,168 @@
+#ifndef REFCOUNTED_H_
+#define REFCOUNTED_H_
+
+/**
+ * @file
+ * Provide an intrusive reference count for use with `boost::intrusive_ptr`.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <boost/intrusive_ptr.hpp>
+
+namespace elision {
+
+/**
+ * Specify how the references to an object are counted.
+ *
+ *   - `ATOMIC_COUNT` uses atomic read-modify-write operations, so references
+ *     may be taken and dropped on any thread.  This is the default.
+ *   - `PLAIN_COUNT` uses ordinary loads and stores.  This is cheaper, but
+ *     the object and everything referring to it must stay on one thread.
+ */
+enum RefPolicy {
+	ATOMIC_COUNT, PLAIN_COUNT
+};
+
+/**
+ * Base class for objects that carry their own reference count.  Hold such
+ * objects with `boost::intrusive_ptr`; the hooks below let it find the count.
+ * When the last reference is dropped, `dispose` is invoked.  By default this
+ * deletes the object, but subclasses may do otherwise.
+ *
+ * The counting policy is chosen per object, and may be changed until the
+ * first reference is taken.
+ */
+class RefCounted {
+public:
+	/**
+	 * Add a reference.
+	 */
+	inline void retain() const {
+		if (policy_ == ATOMIC_COUNT) {
+			count_.fetch_add(1, std::memory_order_relaxed);
+		} else {
+			count_.store(count_.load(std::memory_order_relaxed) + 1,
+					std::memory_order_relaxed);
+		}
+	}
+
+	/**
+	 * Drop a reference, and dispose of this object if it was the last.
+	 */
+	inline void release() const {
+		if (policy_ == ATOMIC_COUNT) {
+			if (count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				dispose();
+			}
+		} else {
+			uint32_t count = count_.load(std::memory_order_relaxed) - 1;
+			count_.store(count, std::memory_order_relaxed);
+			if (count == 0) {
+				dispose();
+			}
+		}
+	}
+
+	/**
+	 * Add a reference, unless the count has already reached zero and the
+	 * object is being disposed of.  This lets a cache that holds uncounted
+	 * pointers hand out references safely.
+	 * @return	True iff a reference was added.
+	 */
+	inline bool retain_if_live() const {
+		uint32_t count = count_.load(std::memory_order_relaxed);
+		if (policy_ == PLAIN_COUNT) {
+			if (count == 0) return false;
+			count_.store(count + 1, std::memory_order_relaxed);
+			return true;
+		}
+		while (count != 0) {
+			if (count_.compare_exchange_weak(count, count + 1,
+					std::memory_order_relaxed)) {
+				return true;
+			}
+		} // Retry until the count is stable.
+		return false;
+	}
+
+	/**
+	 * Get the current number of references.  This is only a snapshot if
+	 * other threads hold references.
+	 * @return	The reference count.
+	 */
+	inline uint32_t get_ref_count() const {
+		return count_.load(std::memory_order_relaxed);
+	}
+
+	/**
+	 * Get the counting policy for this object.
+	 * @return	The policy.
+	 */
+	inline RefPolicy get_ref_policy() const {
+		return policy_;
+	}
+
+protected:
+	/**
+	 * Initialize the count.  No references are held.
+	 * @param policy	How references are counted.
+	 */
+	explicit RefCounted(RefPolicy policy = ATOMIC_COUNT) : policy_(policy) {
+		// Nothing to do.
+	}
+
+	RefCounted(RefCounted const&) = delete;
+	RefCounted& operator=(RefCounted const&) = delete;
+
+	/// Deallocate this instance.
+	virtual ~RefCounted() = default;
+
+	/**
+	 * Change the counting policy.  This must be done before any reference is
+	 * taken.
+	 * @param policy	How references are counted.
+	 */
+	inline void set_ref_policy(RefPolicy policy) {
+		policy_ = policy;
+	}
+
+	/**
+	 * Dispose of this object once the last reference is gone.
+	 */
+	virtual void dispose() const {
+		delete this;
+	}
+
+private:
+	mutable std::atomic<uint32_t> count_{0};
+	RefPolicy policy_;
+};
+
+/// Hook used by `boost::intrusive_ptr` to add a reference.
+inline void intrusive_ptr_add_ref(RefCounted const* object) {
+	object->retain();
+}
+
+/// Hook used by `boost::intrusive_ptr` to drop a reference.
+inline void intrusive_ptr_release(RefCounted const* object) {
+	object->release();
+}
+
+} /* namespace elision */
+
+#endif /* REFCOUNTED_H_ */
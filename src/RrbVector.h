@@ -0,0 +1,589 @@
+#ifndef RRBVECTOR_H_
+#define RRBVECTOR_H_
+
+/**
+ * @file
+ * Provide a persistent vector with fast catenation and slicing.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <atomic>
+#include <boost/intrusive_ptr.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace elision {
+
+/**
+ * The measure used by an `RrbVector` when none is requested.  It holds
+ * nothing.
+ */
+template<class T>
+struct NoMeasure {
+	struct value_type {};
+	static inline value_type identity() { return value_type(); }
+	static inline value_type of(T const&) { return value_type(); }
+	static inline value_type combine(value_type const&, value_type const&) {
+		return value_type();
+	}
+};
+
+/**
+ * A persistent vector held as a relaxed radix balanced tree.  Every
+ * operation returns a new vector and leaves the original alone; the two
+ * share all the nodes the operation did not touch.  Catenating, slicing,
+ * inserting, and omitting take time logarithmic in the size, and finding an
+ * element by position takes time logarithmic in the size with a small base.
+ *
+ * Leaves hold up to `WIDTH` adjacent elements, and are handed out as runs by
+ * `get_chunk`, so walking the vector touches memory in order.  Each inner
+ * node holds up to `WIDTH` children of equal height and the running sizes
+ * of its children.  A tree built in one piece is dense, and a position is
+ * found from its digits alone; after catenation some nodes are not full, and
+ * the running sizes correct the first guess by a few steps.
+ *
+ * Each node also holds a measure of its elements, which the owner of the
+ * vector can use to keep a summary (such as a hash) that is updated along
+ * with the tree rather than recomputed.  The measure is a monoid given by
+ * the `Measure` class, which provides a `value_type`, an `identity`, the
+ * measure `of` one element, and a `combine` operation that is associative.
+ *
+ * Nodes carry an atomic reference count, so vectors may be shared between
+ * threads.
+ *
+ * @param T			The element type.
+ * @param Measure	The measure kept in each node.
+ */
+template<class T, class Measure = NoMeasure<T>>
+class RrbVector {
+public:
+	/// The type of the measure.
+	typedef typename Measure::value_type measure_type;
+
+	/// The number of bits of a position used at each level.
+	static constexpr unsigned BITS = 5;
+
+	/// The largest number of elements in a leaf, or children in a node.
+	static constexpr unsigned WIDTH = 1u << BITS;
+
+	class const_iterator;
+
+	/// Make an empty vector.
+	RrbVector() : size_(0) {}
+
+	/**
+	 * Make a vector holding a sequence of elements.  The tree is dense.
+	 * @param first	The first element.
+	 * @param last	One past the last element.
+	 */
+	template<class Iter>
+	RrbVector(Iter first, Iter last) : size_(0) {
+		std::vector<Ptr> level;
+		while (first != last) {
+			Leaf* leaf = new Leaf();
+			Ptr hold(leaf);
+			while (first != last && leaf->count < WIDTH) {
+				leaf->items[leaf->count++] = *first;
+				++first;
+			} // Fill the leaf.
+			leaf->measure = measure_items(leaf->items, leaf->count);
+			size_ += leaf->count;
+			level.push_back(hold);
+		} // Make all leaves.
+		uint8_t height = 0;
+		while (level.size() > 1) {
+			++height;
+			std::vector<Ptr> upper;
+			for (size_t index = 0; index < level.size(); index += WIDTH) {
+				size_t stop = std::min<size_t>(index + WIDTH, level.size());
+				upper.push_back(make_branch(height, level.data() + index,
+						level.data() + stop));
+			} // Make the next level.
+			level.swap(upper);
+		} // Build levels until there is one root.
+		if (!level.empty()) root_ = level[0];
+	}
+
+	/**
+	 * Get the number of elements.
+	 * @return	The number of elements.
+	 */
+	inline size_t size() const {
+		return size_;
+	}
+
+	/**
+	 * Determine whether the vector is empty.
+	 * @return	True iff there are no elements.
+	 */
+	inline bool empty() const {
+		return size_ == 0;
+	}
+
+	/**
+	 * Get the height of the tree.  An empty vector or a single leaf has
+	 * height zero.
+	 * @return	The height.
+	 */
+	inline unsigned get_height() const {
+		return root_ ? root_->height : 0;
+	}
+
+	/**
+	 * Get the measure of all the elements.
+	 * @return	The measure.
+	 */
+	inline measure_type get_measure() const {
+		return root_ ? root_->measure : Measure::identity();
+	}
+
+	/**
+	 * Determine whether two vectors share the same tree.  If so, they are
+	 * certainly equal.
+	 * @param other	The other vector.
+	 * @return	True iff the trees are the same.
+	 */
+	inline bool is_same(RrbVector const& other) const {
+		return root_ == other.root_;
+	}
+
+	/**
+	 * Get an element.  The position is not checked.
+	 * @param position	The zero-based position.
+	 * @return	The element.
+	 */
+	inline T const& operator[](size_t position) const {
+		size_t offset = position;
+		Leaf const* leaf = find(offset);
+		return leaf->items[offset];
+	}
+
+	/**
+	 * Get an element.
+	 * @param position	The zero-based position.
+	 * @return	The element.
+	 * @throws	std::out_of_range	If the position is out of range.
+	 */
+	inline T const& at(size_t position) const {
+		if (position >= size_) {
+			throw std::out_of_range("The position is past the end.");
+		}
+		return (*this)[position];
+	}
+
+	/**
+	 * Get the run of adjacent elements that starts at a position and ends
+	 * at the end of its leaf.
+	 * @param position	The zero-based position, which must be less than the
+	 * 					size.
+	 * @return	The first element and one past the last element of the run.
+	 */
+	inline std::pair<T const*, T const*> get_chunk(size_t position) const {
+		size_t offset = position;
+		Leaf const* leaf = find(offset);
+		return std::make_pair(leaf->items + offset, leaf->items + leaf->count);
+	}
+
+	/**
+	 * Make the vector holding the elements of this vector followed by those
+	 * of another.
+	 * @param other	The other vector.
+	 * @return	The new vector.
+	 */
+	RrbVector catenate(RrbVector const& other) const {
+		if (other.empty()) return *this;
+		if (empty()) return other;
+		Ptr left, right;
+		join(root_, other.root_, left, right);
+		RrbVector result;
+		result.size_ = size_ + other.size_;
+		if (right) {
+			Ptr pair[] = { left, right };
+			result.root_ = make_branch(left->height + 1, pair, pair + 2);
+		} else {
+			result.root_ = left;
+		}
+		return result;
+	}
+
+	/**
+	 * Make the vector holding a range of the elements of this vector.
+	 * @param from	The position of the first element to keep.
+	 * @param to	One past the position of the last element to keep.
+	 * @return	The new vector.
+	 * @throws	std::out_of_range	If the range is not within the vector.
+	 */
+	RrbVector slice(size_t from, size_t to) const {
+		if (from > to || to > size_) {
+			throw std::out_of_range("The slice is not within the vector.");
+		}
+		RrbVector result;
+		if (from == to) return result;
+		Ptr node = slice_node(root_, from, to);
+		// Drop any chain of single children at the top.
+		while (node->height > 0 && node->count == 1) {
+			node = branch(node).children[0];
+		} // Shorten the tree.
+		result.root_ = node;
+		result.size_ = to - from;
+		return result;
+	}
+
+	/**
+	 * Make the vector with an element inserted.
+	 * @param position	The position of the new element.  It may be the size,
+	 * 					to add the element at the end.
+	 * @param value		The new element.
+	 * @return	The new vector.
+	 */
+	RrbVector insert(size_t position, T const& value) const {
+		RrbVector one(&value, &value + 1);
+		return slice(0, position).catenate(one).catenate(
+				slice(position, size_));
+	}
+
+	/**
+	 * Make the vector with an element removed.
+	 * @param position	The position of the element to remove.
+	 * @return	The new vector.
+	 */
+	RrbVector omit(size_t position) const {
+		if (position >= size_) {
+			throw std::out_of_range("The position is past the end.");
+		}
+		return slice(0, position).catenate(slice(position + 1, size_));
+	}
+
+	/**
+	 * Make the vector with an element added at the end.
+	 * @param value	The new element.
+	 * @return	The new vector.
+	 */
+	inline RrbVector push_back(T const& value) const {
+		return catenate(RrbVector(&value, &value + 1));
+	}
+
+	inline const_iterator begin() const;
+	inline const_iterator end() const;
+
+private:
+	struct Node;
+	typedef boost::intrusive_ptr<Node> Ptr;
+
+	/// The part common to leaves and inner nodes.
+	struct Node {
+		explicit Node(uint8_t the_height) : height(the_height), count(0) {}
+
+		std::atomic<uint32_t> refs{0};
+		/// Zero for a leaf.  The children of a node are one lower.
+		uint8_t height;
+		/// The number of elements in a leaf, or children in a node.
+		uint8_t count;
+		measure_type measure;
+
+		friend inline void intrusive_ptr_add_ref(Node* node) {
+			node->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		friend inline void intrusive_ptr_release(Node* node) {
+			if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				if (node->height == 0) delete static_cast<Leaf*>(node);
+				else delete static_cast<Branch*>(node);
+			}
+		}
+	};
+
+	struct Leaf : Node {
+		Leaf() : Node(0) {}
+		T items[WIDTH];
+	};
+
+	struct Branch : Node {
+		explicit Branch(uint8_t the_height) : Node(the_height) {}
+		Ptr children[WIDTH];
+		/// The number of elements in this child and all before it.
+		size_t sizes[WIDTH];
+	};
+
+	static inline Leaf const& leaf(Ptr const& node) {
+		return *static_cast<Leaf const*>(node.get());
+	}
+
+	static inline Branch const& branch(Ptr const& node) {
+		return *static_cast<Branch const*>(node.get());
+	}
+
+	static inline size_t size_of(Ptr const& node) {
+		return node->height == 0 ? node->count
+				: branch(node).sizes[node->count - 1];
+	}
+
+	static measure_type measure_items(T const* first, size_t count) {
+		measure_type measure = Measure::identity();
+		for (size_t index = 0; index < count; ++index) {
+			measure = Measure::combine(measure, Measure::of(first[index]));
+		} // Combine all elements.
+		return measure;
+	}
+
+	/**
+	 * Make a leaf from a run of elements.
+	 * @param first	The first element.
+	 * @param last	One past the last element.
+	 * @return	The leaf.
+	 */
+	static Ptr make_leaf(T const* first, T const* last) {
+		Leaf* node = new Leaf();
+		Ptr hold(node);
+		node->count = static_cast<uint8_t>(last - first);
+		std::copy(first, last, node->items);
+		node->measure = measure_items(node->items, node->count);
+		return hold;
+	}
+
+	/**
+	 * Make an inner node from a run of children of equal height.
+	 * @param height	The height of the node.
+	 * @param first		The first child.
+	 * @param last		One past the last child.
+	 * @return	The node.
+	 */
+	static Ptr make_branch(uint8_t height, Ptr const* first, Ptr const* last) {
+		Branch* node = new Branch(height);
+		Ptr hold(node);
+		size_t total = 0;
+		measure_type measure = Measure::identity();
+		for (; first != last; ++first) {
+			total += size_of(*first);
+			measure = Measure::combine(measure, (*first)->measure);
+			node->children[node->count] = *first;
+			node->sizes[node->count] = total;
+			++node->count;
+		} // Add all children.
+		node->measure = measure;
+		return hold;
+	}
+
+	/**
+	 * Find the leaf holding a position.
+	 * @param offset	The position, which is replaced by the position within
+	 * 					the leaf.
+	 * @return	The leaf.
+	 */
+	inline Leaf const* find(size_t& offset) const {
+		Node const* node = root_.get();
+		while (node->height > 0) {
+			Branch const* inner = static_cast<Branch const*>(node);
+			// No child holds more than WIDTH^height elements, so the digit at
+			// this level is never past the right child.
+			unsigned shift = BITS * inner->height;
+			size_t slot = shift < 64 ? offset >> shift : 0;
+			if (slot >= inner->count) slot = inner->count - 1;
+			while (inner->sizes[slot] <= offset) ++slot;
+			if (slot > 0) offset -= inner->sizes[slot - 1];
+			node = inner->children[slot].get();
+		} // Descend to the leaf.
+		return static_cast<Leaf const*>(node);
+	}
+
+	/**
+	 * Join two trees.  The result is one tree, or two trees of equal height
+	 * that belong side by side, with the height of the taller input.
+	 * @param first		The first tree.
+	 * @param second	The second tree.
+	 * @param left		The first result.
+	 * @param right		The second result, or null if there is only one.
+	 */
+	static void join(Ptr const& first, Ptr const& second, Ptr& left,
+			Ptr& right) {
+		Ptr items[WIDTH + 1];
+		size_t count = 0;
+		if (first->height == second->height) {
+			right.reset();
+			if (first->count + second->count > WIDTH) {
+				// Both are kept as they are, and so are shared.
+				left = first;
+				right = second;
+			} else if (first->height == 0) {
+				T merged[WIDTH];
+				std::copy(leaf(first).items, leaf(first).items + first->count,
+						merged);
+				std::copy(leaf(second).items,
+						leaf(second).items + second->count,
+						merged + first->count);
+				left = make_leaf(merged, merged + first->count + second->count);
+			} else {
+				for (size_t index = 0; index < first->count; ++index) {
+					items[count++] = branch(first).children[index];
+				} // Take the children of the first.
+				for (size_t index = 0; index < second->count; ++index) {
+					items[count++] = branch(second).children[index];
+				} // Take the children of the second.
+				left = make_branch(first->height, items, items + count);
+			}
+			return;
+		}
+		Ptr lower, upper;
+		bool dense_left = first->height > second->height;
+		if (dense_left) {
+			// Join the second tree to the rightmost child of the first.
+			Branch const& inner = branch(first);
+			join(inner.children[inner.count - 1], second, lower, upper);
+			for (size_t index = 0; index + 1 < inner.count; ++index) {
+				items[count++] = inner.children[index];
+			} // Keep the other children.
+			items[count++] = lower;
+			if (upper) items[count++] = upper;
+		} else {
+			// Join the first tree to the leftmost child of the second.
+			Branch const& inner = branch(second);
+			join(first, inner.children[0], lower, upper);
+			items[count++] = lower;
+			if (upper) items[count++] = upper;
+			for (size_t index = 1; index < inner.count; ++index) {
+				items[count++] = inner.children[index];
+			} // Keep the other children.
+		}
+		uint8_t height = std::max(first->height, second->height);
+		if (count <= WIDTH) {
+			left = make_branch(height, items, items + count);
+			right.reset();
+		} else {
+			// Keep the full node on the side the trees were joined from.
+			size_t split = dense_left ? WIDTH : count - WIDTH;
+			left = make_branch(height, items, items + split);
+			right = make_branch(height, items + split, items + count);
+		}
+	}
+
+	/**
+	 * Make a tree of the same height holding a range of a tree.
+	 * @param node	The tree.
+	 * @param from	The position of the first element to keep.
+	 * @param to	One past the position of the last element to keep, which
+	 * 				must be more than `from`.
+	 * @return	The new tree.
+	 */
+	static Ptr slice_node(Ptr const& node, size_t from, size_t to) {
+		if (from == 0 && to == size_of(node)) return node;
+		if (node->height == 0) {
+			return make_leaf(leaf(node).items + from, leaf(node).items + to);
+		}
+		Branch const& inner = branch(node);
+		Ptr items[WIDTH];
+		size_t count = 0;
+		size_t start = 0;
+		for (size_t index = 0; index < inner.count && start < to; ++index) {
+			size_t stop = inner.sizes[index];
+			if (stop > from) {
+				items[count++] = slice_node(inner.children[index],
+						from > start ? from - start : 0,
+						std::min(to, stop) - start);
+			}
+			start = stop;
+		} // Keep the children that overlap the range.
+		return make_branch(node->height, items, items + count);
+	}
+
+	Ptr root_;
+	size_t size_;
+};
+
+/**
+ * Iterate over the elements of a vector, one leaf at a time.
+ */
+template<class T, class Measure>
+class RrbVector<T, Measure>::const_iterator :
+		public std::iterator<std::forward_iterator_tag, T const> {
+public:
+	/// Make an iterator that points nowhere.
+	const_iterator() : vector_(nullptr), position_(0), at_(nullptr),
+		stop_(nullptr) {}
+
+	/**
+	 * Make an iterator to a position in a vector.
+	 * @param vector	The vector.
+	 * @param position	The position, which may be the size of the vector.
+	 */
+	const_iterator(RrbVector const* vector, size_t position) :
+			vector_(vector), position_(position), at_(nullptr),
+			stop_(nullptr) {
+		load();
+	}
+
+	inline T const& operator*() const {
+		return *at_;
+	}
+
+	inline T const* operator->() const {
+		return at_;
+	}
+
+	inline const_iterator& operator++() {
+		++position_;
+		if (++at_ == stop_) load();
+		return *this;
+	}
+
+	inline const_iterator operator++(int) {
+		const_iterator old(*this);
+		++*this;
+		return old;
+	}
+
+	inline bool operator==(const_iterator const& other) const {
+		return position_ == other.position_;
+	}
+
+	inline bool operator!=(const_iterator const& other) const {
+		return position_ != other.position_;
+	}
+
+private:
+	/// Fetch the leaf holding the current position, if there is one.
+	inline void load() {
+		if (position_ < vector_->size()) {
+			auto chunk = vector_->get_chunk(position_);
+			at_ = chunk.first;
+			stop_ = chunk.second;
+		}
+	}
+
+	RrbVector const* vector_;
+	size_t position_;
+	T const* at_;
+	T const* stop_;
+};
+
+template<class T, class Measure>
+inline typename RrbVector<T, Measure>::const_iterator
+RrbVector<T, Measure>::begin() const {
+	return const_iterator(this, 0);
+}
+
+template<class T, class Measure>
+inline typename RrbVector<T, Measure>::const_iterator
+RrbVector<T, Measure>::end() const {
+	return const_iterator(this, size_);
+}
+
+} /* namespace elision */
+
+#endif /* RRBVECTOR_H_ */
@@ -3,7 +3,7 @@
 
 /**
  * @file
- * TODO: Describe purpose of file.
+ * Provide an immutable sequence with cheap omission and insertion.
  *
  * @author sprowell@gmail.com
  *
@@ -20,18 +20,19 @@
  * @endverbatim
  */
 
-#include <vector>
+#include <algorithm>
 #include <cstddef>
-
-#define D(msg_m) std::cout << msg_m << std::flush;
-#define P(msg_m) std::cout << msg_m << std::flush << std::endl;
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
 namespace elision {
 
 template<typename T, typename Alloc>
 class Seq;
 
-template<typename T, typename Alloc>
+template<typename T, typename Alloc = std::allocator<T> >
 struct seq {
 	typedef std::shared_ptr<Seq<T, Alloc> const> type;
 };
@@ -39,56 +40,335 @@ struct seq {
 /**
  * Provide an immutable sequence data structure that has fast insertion and
  * deletion (creating new instances).
+ *
+ * Elements are held in blocks that are never changed once they are filled,
+ * and that are shared by every sequence derived from the one that made them.
+ * A sequence is a balanced (AVL) tree of pieces, each of which is a run of
+ * consecutive elements in one block; an in-order walk visits the pieces in
+ * order.  Nodes are never changed once made, so a derived sequence shares
+ * every node of the original that its edit did not touch.  An edit splits
+ * the tree at most twice and joins the parts back together, so it makes
+ * O(log n) new nodes for n pieces, and a chain of k edits costs O(k log k)
+ * rather than the O(k^2) of copying a flat list of pieces.  Omitting an
+ * element splits at most one piece, and inserting a sequence splits at most
+ * one piece and adds one block, so no edit copies elements of the original.
+ * Iteration walks pointers through each piece in turn.
+ *
  * @param T		The type stored in the data structure.
  * @param Alloc	The allocator for elements.
  */
 template<typename T, typename Alloc = std::allocator<T> >
 class Seq {
-	/* A note on indexing.
-	 *
-	 * index  					what
-	 * 0      					backing.at(0)
-	 * 1      					backing.at(1)
-	 * ...
-	 * insert 					inserted.at(0)
-	 * insert+1					inserted.at(1)
-	 * ...
-	 * insert+inserted_length	backing.at(insert)
-	 * insert+inserted_length+1	backing.at(insert+1)
-	 * ...
-	 *
-	 * If index < insert then backing.at(index).
-	 * If index < insert+inserted_length then inserted.at(index-insert).
-	 * Otherwise inserted.at(index-inserted_length);
-	 */
-
 public:
-	typedef typename Alloc::const_reference const_reference;
-	typedef typename Alloc::const_pointer const_pointer;
+	typedef T const& const_reference;
+	typedef typename std::allocator_traits<Alloc>::const_pointer const_pointer;
 	typedef Alloc allocator_type;
 	typedef T value_type;
 	typedef size_t size_type;
 	typedef ptrdiff_t difference_type;
 
 private:
-	allocator_type alloc_;		//< Allocator for elements of the sequence.
-	size_t length_;				//< Length of sequence.
-	std::function<T (size_t)> fetch_ = [](size_t index) -> T {
-		throw new std::logic_error("fetch uninitialized");
+	typedef std::allocator_traits<Alloc> traits;
+
+	/**
+	 * A block of elements.  The elements are constructed with the allocator
+	 * when the block is made, and the block lives as long as some piece
+	 * refers to it.
+	 */
+	struct Block {
+		template<typename InputIter>
+		Block(InputIter first, size_t length, Alloc const& alloc) :
+				alloc_(alloc), data_(traits::allocate(alloc_, length)),
+				capacity_(length), length_(0) {
+			try {
+				for (; length_ < length; ++length_, ++first) {
+					traits::construct(alloc_, data_ + length_, *first);
+				} // Construct all elements.
+			} catch (...) {
+				destroy();
+				throw;
+			}
+		}
+
+		~Block() {
+			destroy();
+		}
+
+		void destroy() {
+			for (size_t index = 0; index < length_; ++index) {
+				traits::destroy(alloc_, data_ + index);
+			} // Destroy all elements.
+			traits::deallocate(alloc_, data_, capacity_);
+		}
+
+		Alloc alloc_;
+		typename traits::pointer data_;
+		size_t capacity_;	//< The number of elements allocated.
+		size_t length_;		//< The number of elements constructed.
+	};
+
+	/// A run of consecutive elements in a block.  Runs are never empty.
+	struct Piece {
+		T const* first;						//< The first element of the run.
+		T const* last;						//< One past the last element.
+		std::shared_ptr<Block const> block;	//< The block holding the run.
+
+		/// Get the number of elements in the run.
+		inline size_t size() const { return last - first; }
 	};
 
+	struct Node;
+	typedef std::shared_ptr<Node const> node_ptr;
+
+	/// A node of the tree, holding one piece.
+	struct Node {
+		Node(node_ptr const& left, Piece const& piece, node_ptr const& right) :
+				left(left), right(right), piece(piece),
+				length(length_of(left) + piece.size() + length_of(right)),
+				height(1 + std::max(height_of(left), height_of(right))) {
+			// Nothing to do.
+		}
+
+		/**
+		 * Get the number of elements in a tree.
+		 * @param node	The tree, which may be empty.
+		 * @return	The number of elements.
+		 */
+		static inline size_t length_of(node_ptr const& node) {
+			return node ? node->length : 0;
+		}
+
+		/**
+		 * Get the height of a tree.
+		 * @param node	The tree, which may be empty.
+		 * @return	The height, which is zero for an empty tree.
+		 */
+		static inline unsigned height_of(node_ptr const& node) {
+			return node ? node->height : 0;
+		}
+
+		node_ptr left;		//< The pieces before this one.
+		node_ptr right;		//< The pieces after this one.
+		Piece piece;		//< The piece.
+		size_t length;		//< The number of elements in this tree.
+		unsigned height;	//< The height of this tree.
+	};
+
+	typedef typename traits::template rebind_alloc<Block> block_alloc;
+	typedef typename traits::template rebind_alloc<Node> node_alloc;
+
+	allocator_type alloc_;	//< Allocator for elements of the sequence.
+	node_ptr root_;			//< The tree of pieces.
+
 	/**
-	 * Make a new instance, with a single element omitted.  Constant time.
-	 * @param backing	The elements of the sequence.
-	 * @param omit		Zero-based index of the element to omit.
-	 * @param alloc		Allocator for the elements.
-	 * @throws std::range_error	The index is out of range.
+	 * Make a new block from elements.  A single piece covering the block is
+	 * returned.
+	 * @param first		The first element.
+	 * @param length	The number of elements, which must not be zero.
+	 * @return	A piece holding all of the new elements.
+	 */
+	template<typename InputIter>
+	Piece add_block(InputIter first, size_t length) const {
+		std::shared_ptr<Block const> block = std::allocate_shared<Block>(
+				block_alloc(alloc_), first, length, alloc_);
+		return Piece{ block->data_, block->data_ + length, block };
+	}
+
+	/**
+	 * Start this sequence with one block holding the given elements.
+	 * @param first		The first element.
+	 * @param length	The number of elements.
+	 */
+	template<typename InputIter>
+	void fill(InputIter first, size_t length) {
+		if (length > 0) {
+			root_ = make(nullptr, add_block(first, length), nullptr);
+		}
+	}
+
+	/**
+	 * Make a node.  The two trees must differ in height by at most one.
+	 * @param left		The pieces before the piece.
+	 * @param piece		The piece.
+	 * @param right		The pieces after the piece.
+	 * @return	The new node.
+	 */
+	node_ptr make(node_ptr const& left, Piece const& piece,
+			node_ptr const& right) const {
+		return std::allocate_shared<Node>(node_alloc(alloc_), left, piece,
+				right);
+	}
+
+	/**
+	 * Rotate a tree so that its right child becomes the root.
+	 * @param node	The tree.
+	 * @return	The rotated tree.
+	 */
+	node_ptr rotate_left(node_ptr const& node) const {
+		node_ptr const& right = node->right;
+		return make(make(node->left, node->piece, right->left), right->piece,
+				right->right);
+	}
+
+	/**
+	 * Rotate a tree so that its left child becomes the root.
+	 * @param node	The tree.
+	 * @return	The rotated tree.
+	 */
+	node_ptr rotate_right(node_ptr const& node) const {
+		node_ptr const& left = node->left;
+		return make(left->left, left->piece, make(left->right, node->piece,
+				node->right));
+	}
+
+	/**
+	 * Join two trees with a piece between them, when the left tree is the
+	 * taller by more than one.  The right spine of the left tree is
+	 * descended until the right tree fits, and the path back is rebalanced.
+	 * @param left		The pieces before the piece.
+	 * @param piece		The piece.
+	 * @param right		The pieces after the piece.
+	 * @return	The balanced tree.
+	 */
+	node_ptr join_right(node_ptr const& left, Piece const& piece,
+			node_ptr const& right) const {
+		unsigned outer = Node::height_of(left->left);
+		if (Node::height_of(left->right) <= Node::height_of(right) + 1) {
+			node_ptr mid = make(left->right, piece, right);
+			if (mid->height <= outer + 1) {
+				return make(left->left, left->piece, mid);
+			}
+			return rotate_left(make(left->left, left->piece,
+					rotate_right(mid)));
+		}
+		node_ptr mid = join_right(left->right, piece, right);
+		node_ptr top = make(left->left, left->piece, mid);
+		return mid->height <= outer + 1 ? top : rotate_left(top);
+	}
+
+	/**
+	 * Join two trees with a piece between them, when the right tree is the
+	 * taller by more than one.  This mirrors `join_right`.
+	 * @param left		The pieces before the piece.
+	 * @param piece		The piece.
+	 * @param right		The pieces after the piece.
+	 * @return	The balanced tree.
+	 */
+	node_ptr join_left(node_ptr const& left, Piece const& piece,
+			node_ptr const& right) const {
+		unsigned outer = Node::height_of(right->right);
+		if (Node::height_of(right->left) <= Node::height_of(left) + 1) {
+			node_ptr mid = make(left, piece, right->left);
+			if (mid->height <= outer + 1) {
+				return make(mid, right->piece, right->right);
+			}
+			return rotate_right(make(rotate_left(mid), right->piece,
+					right->right));
+		}
+		node_ptr mid = join_left(left, piece, right->left);
+		node_ptr top = make(mid, right->piece, right->right);
+		return mid->height <= outer + 1 ? top : rotate_right(top);
+	}
+
+	/**
+	 * Join two trees with a piece between them.  This makes new nodes only
+	 * along one spine of the taller tree, so it is logarithmic.
+	 * @param left		The pieces before the piece.
+	 * @param piece		The piece.
+	 * @param right		The pieces after the piece.
+	 * @return	The balanced tree.
+	 */
+	node_ptr join(node_ptr const& left, Piece const& piece,
+			node_ptr const& right) const {
+		unsigned lh = Node::height_of(left);
+		unsigned rh = Node::height_of(right);
+		if (lh > rh + 1) return join_right(left, piece, right);
+		if (rh > lh + 1) return join_left(left, piece, right);
+		return make(left, piece, right);
+	}
+
+	/**
+	 * Join two trees.
+	 * @param left		The pieces first.
+	 * @param right		The pieces after.
+	 * @return	The balanced tree.
+	 */
+	node_ptr join(node_ptr const& left, node_ptr const& right) const {
+		if (!left) return right;
+		if (!right) return left;
+		Piece first;
+		node_ptr rest;
+		split_first(right, first, rest);
+		return join(left, first, rest);
+	}
+
+	/**
+	 * Remove the first piece of a tree.
+	 * @param node		The tree, which must not be empty.
+	 * @param first		Set to the first piece.
+	 * @param rest		Set to the tree of the remaining pieces.
 	 */
-	Seq(typename seq<T,Alloc>::type backing, size_t omit, Alloc const& alloc=Alloc()) :
-			alloc_(alloc), length_(backing->size()) {
-		fetch_ = [backing, omit](size_t pos) {
-			return pos < omit ? backing->at(pos) : backing->at(pos + 1);
-		};
+	void split_first(node_ptr const& node, Piece& first, node_ptr& rest) const {
+		if (!node->left) {
+			first = node->piece;
+			rest = node->right;
+			return;
+		}
+		node_ptr left;
+		split_first(node->left, first, left);
+		rest = join(left, node->piece, node->right);
+	}
+
+	/**
+	 * Split a tree into the elements before an index and the elements from
+	 * it on.  A piece that straddles the index is split in two.  The results
+	 * must not be the tree being split.
+	 * @param node		The tree.
+	 * @param index		The index, which must be at most the length.
+	 * @param before	Set to the elements before the index.
+	 * @param after		Set to the remaining elements.
+	 */
+	void split(node_ptr const& node, size_t index, node_ptr& before,
+			node_ptr& after) const {
+		if (index == 0) {
+			before.reset();
+			after = node;
+			return;
+		}
+		if (index == node->length) {
+			before = node;
+			after.reset();
+			return;
+		}
+		size_t left = Node::length_of(node->left);
+		Piece const& piece = node->piece;
+		if (index <= left) {
+			node_ptr tail;
+			split(node->left, index, before, tail);
+			after = join(tail, piece, node->right);
+		} else if (index >= left + piece.size()) {
+			node_ptr head;
+			split(node->right, index - left - piece.size(), head, after);
+			before = join(node->left, piece, head);
+		} else {
+			T const* cut = piece.first + (index - left);
+			before = join(node->left, Piece{ piece.first, cut, piece.block },
+					nullptr);
+			after = join(nullptr, Piece{ cut, piece.last, piece.block },
+					node->right);
+		}
+	}
+
+	/**
+	 * Copy the elements of a tree to the end of a vector.
+	 * @param node		The tree, which may be empty.
+	 * @param into		The vector.
+	 */
+	static void collect(Node const* node, std::vector<T>& into) {
+		for (; node != nullptr; node = node->right.get()) {
+			collect(node->left.get(), into);
+			into.insert(into.end(), node->piece.first, node->piece.last);
+		} // Walk down the right spine.
 	}
 
 public:
@@ -99,30 +379,17 @@ public:
 	 * @param backing	The elements of the sequence.  The vector is copied.
 	 * @param alloc		Allocator for the elements.
 	 */
-	Seq(std::vector<T> const backing, Alloc const& alloc=Alloc()) :
-			alloc_(alloc), length_(backing.size()) {
-		fetch_ = [backing](size_t pos) {
-			return backing.at(pos);
-		};
-	}
-
-	/**
-	 * Copy construct a new instance.
-	 * @param that		The sequence to copy.
-	 */
-	Seq(typename seq<T,Alloc>::type that) : alloc_(that->alloc_), length_(that->length_),
-			fetch_(that->fetch) {
-		// Nothing to do.
+	Seq(std::vector<T> const& backing, Alloc const& alloc=Alloc()) :
+			alloc_(alloc) {
+		fill(backing.begin(), backing.size());
 	}
 
 	/**
 	 * Make a new empty sequence.
 	 * @param alloc		Allocator for the elements.
 	 */
-	Seq(Alloc const& alloc = Alloc()) : alloc_(alloc), length_(0) {
-		fetch_ = [](size_t pos) {
-			throw new std::range_error("index out of range");
-		};
+	Seq(Alloc const& alloc = Alloc()) : alloc_(alloc) {
+		// Nothing to do.
 	}
 
 	/**
@@ -131,12 +398,9 @@ public:
 	 * @param x			The element to repeat.
 	 * @param alloc		The allocator.
 	 */
-	Seq(size_type n, T const& x, Alloc const& alloc=Alloc()) : alloc_(alloc),
-			length_(n) {
-		auto vec = std::shared_ptr<std::vector<T> >(new std::vector<T>(n, x, alloc));
-		fetch_ = [vec](size_t pos) {
-			return vec->at(pos);
-		};
+	Seq(size_type n, T const& x, Alloc const& alloc=Alloc()) : alloc_(alloc) {
+		std::vector<T> repeat(n, x);
+		fill(repeat.begin(), n);
 	}
 
 	/**
@@ -147,17 +411,9 @@ public:
 	 */
 	template<typename InputIter>
 	Seq(InputIter first, InputIter last, Alloc const& alloc = Alloc()) :
-			alloc_(alloc), length_(0) {
-		auto vec = std::shared_ptr<std::vector<T> >(new std::vector<T>(first,last, alloc));
-		length_ = vec->size();
-		fetch_ = [vec](size_t pos) {
-			return vec->at(pos);
-		};
-	}
-
-	/// Deallocate this instance.
-	virtual ~Seq() {
-		clear();
+			alloc_(alloc) {
+		std::vector<T> elements(first, last);
+		fill(elements.begin(), elements.size());
 	}
 
 	/**
@@ -170,26 +426,46 @@ public:
 	 * Get an iterator pointing to the first element of the sequence.
 	 * @return	Iterator to first element.
 	 */
-	const_iterator begin() const { return const_iterator(0, fetch_); }
+	const_iterator begin() const {
+		return const_iterator(root_.get());
+	}
 
 	/**
 	 * Get an iterator pointing one past the last element of the sequence.
 	 * @return	Iterator just past the end of the sequence.
 	 */
-	const_iterator end() const { return const_iterator(length_, fetch_); }
+	const_iterator end() const {
+		return const_iterator(nullptr);
+	}
 
 	/**
-	 * Get an element from the sequence.
+	 * Get an element from the sequence.  This is logarithmic in the number
+	 * of pieces.
 	 * @param index		Zero-based index of the element.
 	 * @return	The requested element.
 	 * @throws std::range_error	The index is out of bounds.
 	 */
-	T const& at(size_t index) const { return fetch_(index); }
+	T const& at(size_t index) const {
+		if (index >= size()) throw std::range_error("index out of range");
+		Node const* node = root_.get();
+		while (true) {
+			size_t left = Node::length_of(node->left);
+			if (index < left) {
+				node = node->left.get();
+				continue;
+			}
+			index -= left;
+			if (index < node->piece.size()) return node->piece.first[index];
+			index -= node->piece.size();
+			node = node->right.get();
+		} // Descend to the piece holding the element.
+	}
 
 	/**
 	 * Clear the content of this sequence.
 	 */
 	void clear() {
+		root_.reset();
 	}
 
 	/**
@@ -202,32 +478,46 @@ public:
 	 * Get the number of elements in this sequence.
 	 * @return	The number of elements in this sequence.
 	 */
-	size_type size() const { return length_; }
+	size_type size() const { return Node::length_of(root_); }
 
 	/**
 	 * Construct a new sequence from this sequence, omitting the specified
-	 * element.  This is a constant-time operation.
+	 * element.  No elements are copied, and the new sequence shares all but
+	 * O(log n) of the nodes of this one.
 	 * @param index		Zero-based index of element to omit.
 	 * @return	New sequence.
 	 * @throws std::range_error		The index if out of bounds.
 	 */
-	Seq<T> omit(size_t index) const {
-		Seq<T> ret(*this, index);
+	Seq omit(size_t index) const {
+		if (index >= size()) throw std::range_error("index out of range");
+		node_ptr before, after, gone, rest;
+		split(root_, index, before, after);
+		split(after, 1, gone, rest);
+		Seq ret(alloc_);
+		ret.root_ = join(before, rest);
 		return ret;
 	}
 
-//	/**
-//	 * Construct a new sequence from this sequence by inserting all elements
-//	 * of another sequence into this one.
-//	 * @param start		Zero-based index of the first inserted element.
-//	 * @param data		The sequence ot insert.
-//	 * @return	The new sequence.
-//	 * @throws std::range_error		The index if out of bounds.
-//	 */
-//	Seq<T> insert(size_t start, Seq<T> const& data) const {
-//		Seq<T> ret(*this, start, data);
-//		return ret;
-//	}
+	/**
+	 * Construct a new sequence from this sequence by inserting all elements
+	 * of another sequence into this one.  The inserted elements are copied
+	 * once into a new block; the elements of this sequence are not copied,
+	 * and the new sequence shares all but O(log n) of the nodes of this one.
+	 * @param start		Zero-based index of the first inserted element.  This
+	 * 					may be the size of this sequence to append.
+	 * @param data		The sequence to insert.
+	 * @return	The new sequence.
+	 * @throws std::range_error		The index if out of bounds.
+	 */
+	Seq insert(size_t start, Seq const& data) const {
+		if (start > size()) throw std::range_error("index out of range");
+		if (data.empty()) return *this;
+		node_ptr before, after;
+		split(root_, start, before, after);
+		Seq ret(alloc_);
+		ret.root_ = join(before, add_block(data.begin(), data.size()), after);
+		return ret;
+	}
 
 	/**
 	 * Get the elements of this sequence as a new vector that is constructed
@@ -235,55 +525,82 @@ public:
 	 * @return	The elements of this sequence.
 	 */
 	std::vector<T> elements() const {
-		std::vector<T> ret(begin(), end());
+		std::vector<T> ret;
+		ret.reserve(size());
+		collect(root_.get(), ret);
 		return ret;
 	}
 
 	/**
-	 * Implement an iterator.
-	 * @param T		Type of element stored in the sequence.
+	 * Implement an iterator.  The iterator walks a pointer through each piece
+	 * in turn, keeping the path to the next piece, and is invalidated when
+	 * the sequence is destroyed.
 	 */
-	class const_iterator : public std::iterator<std::forward_iterator_tag, T> {
+	class const_iterator {
 	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef T value_type;
+		typedef ptrdiff_t difference_type;
+		typedef T const* pointer;
+		typedef T const& reference;
+
 		/**
 		 * Make a new instance.
-		 * @param pos		Zero-based index of the iterator.
-		 * @param data		The sequence.  This is passed as a pointer, and is
-		 * 					never freed by this object.
+		 * @param root		The tree of pieces to walk, or null for the end.
 		 */
-		const_iterator(size_t pos, std::function<T (size_t)> fetch) :
-				pos_(pos), fetch_(fetch) {
-			// Nothing to do.
+		explicit const_iterator(Node const* root) : here_(nullptr),
+				last_(nullptr) {
+			descend(root);
+			next_piece();
+		}
+		const_iterator & operator++() {
+			if (++here_ == last_) next_piece();
+			return *this;
+		}
+		const_iterator operator++(int) {
+			const_iterator ret(*this);
+			operator++();
+			return ret;
 		}
-		const_iterator & operator++() { ++pos_; return *this; }
-		const_iterator & operator++(int) { ++pos_; return *this; }
-		T const& operator*() const { return fetch_(pos_); }
-		T const* operator->() const { return &fetch_(pos_); }
+		T const& operator*() const { return *here_; }
+		T const* operator->() const { return here_; }
 		bool operator==(const_iterator const& other) const {
-			return pos_ == other.pos_;
+			return here_ == other.here_;
 		}
 		bool operator!=(const_iterator const& other) const {
-			return !operator==(other);
+			return here_ != other.here_;
 		}
 
 	private:
-		size_t pos_;
-		std::function<T (size_t)> fetch_;
+		/**
+		 * Push a node and its left spine onto the path.
+		 * @param node	The node, which may be null.
+		 */
+		void descend(Node const* node) {
+			for (; node != nullptr; node = node->left.get()) {
+				path_.push_back(node);
+			} // Walk down the left spine.
+		}
+
+		/// Move to the first element of the next piece, if any.
+		void next_piece() {
+			if (path_.empty()) {
+				here_ = last_ = nullptr;
+				return;
+			}
+			Node const* node = path_.back();
+			path_.pop_back();
+			here_ = node->piece.first;
+			last_ = node->piece.last;
+			descend(node->right.get());
+		}
+
+		std::vector<Node const*> path_;	//< Nodes with pieces still to come.
+		T const* here_;					//< The current element.
+		T const* last_;					//< One past the end of its piece.
 	};
 };
 
-template<typename T>
-bool operator==(typename Seq<T>::const_iterator const& first,
-		typename Seq<T>::const_iterator const& second) {
-	return first.operator==(second);
-}
-
-template<typename T>
-bool operator!=(typename Seq<T>::const_iterator const& first,
-		typename Seq<T>::const_iterator const& second) {
-	return first.operator!=(second);
-}
-
 } /* namespace elision */
 
 #endif /* SEQ_H_ */
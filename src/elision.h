@@ -102,7 +102,7 @@
  * @param term_m	The term.
  */
 #define TERM_CAST(type_m, term_m) \
-	std::dynamic_pointer_cast<type_m const>(term_m)
+	boost::dynamic_pointer_cast<type_m const>(term_m)
 
 /**
  * This is the namespace for all Elision-specific code.  It includes types,
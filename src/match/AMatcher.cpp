@@ -0,0 +1,257 @@
+/**
+ * @file
+ * Implement matching for associative lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <match/AMatcher.h>
+#include <match/AcMatcher.h>
+#include <match/Matcher.h>
+#include <term/IVariable.h>
+#include <algorithm>
+
+namespace elision {
+namespace match {
+
+using namespace elision::term;
+
+namespace {
+
+/// A block that is not in the vector.
+constexpr size_t NONE = static_cast<size_t>(-1);
+
+/**
+ * Determine whether a term is a list with given properties.
+ * @param term	The term.
+ * @param spec	The properties.
+ * @return	True iff the term is a list with the properties.
+ */
+inline bool is_nested(pTerm const& term, IPropertySpecification const& spec) {
+	return term->get_kind() == LIST_KIND && Matcher::same(
+			*kind_cast<IList>(*term).get_property_specification(), spec);
+}
+
+} /* anonymous namespace */
+
+AMatcher::AMatcher(TermFactory const& fact, pList const& subject,
+		pTerm const& identity) : fact_(fact), subject_(subject),
+				identity_(identity), least_(identity == nullptr ? 1 : 0),
+				chunk_start_(0), chunk_(nullptr, nullptr), started_(false),
+				done_(false) {}
+
+std::unique_ptr<Choice>
+AMatcher::make(TermFactory const& fact, IList const& pattern,
+		pList const& subject, Context const& context) {
+	pPropertySpecification spec = pattern.get_property_specification();
+	pTerm identity;
+	if (spec->has_identity()) identity = spec->get_identity().get();
+
+	// The subject is used as it is, unless it holds a nested list to flatten.
+	pList flat = subject;
+	for (size_t position = 0; position < subject->size(); ) {
+		ElementSpan span = subject->get_chunk(position);
+		if (std::any_of(span.begin(), span.end(), [&spec](pTerm const& term) {
+			return is_nested(term, *spec);
+		})) {
+			std::vector<pTerm> elements;
+			AcMatcher::flatten(*subject, *spec, elements);
+			flat = fact.get_list(Loc::get_internal(), spec, std::move(elements));
+			break;
+		}
+		position += span.size();
+	} // Look for nested lists.
+	std::unique_ptr<AMatcher> am(new AMatcher(fact, flat, identity));
+
+	// Each unbound variable starts a new block.  Any other element, or the
+	// elements a bound variable is bound to, are added to the current block.
+	std::vector<pTerm> parts;
+	AcMatcher::flatten(pattern, *spec, parts);
+	am->blocks_.push_back(Block{ nullptr, NONE, 0, 0, 0, 0, false,
+		Fingerprint() });
+	for (auto const& part : parts) {
+		if (part->get_kind() != VARIABLE_KIND) {
+			am->fixed_.push_back(part);
+			continue;
+		}
+		Atom name = kind_cast<IVariable>(*part).get_atom();
+		pTerm const* bound = context.find(name);
+		if (bound == nullptr) {
+			size_t repeat = NONE;
+			for (size_t index = 1; index < am->blocks_.size(); ++index) {
+				if (kind_cast<IVariable>(*am->blocks_[index].gap).get_atom() ==
+						name) {
+					repeat = index;
+					break;
+				}
+			} // Look for an earlier occurrence.
+			am->blocks_.push_back(Block{ part, repeat, am->fixed_.size(),
+				0, 0, 0, false, Fingerprint() });
+		} else if (is_nested(*bound, *spec)) {
+			AcMatcher::flatten(kind_cast<IList>(**bound), *spec, am->fixed_);
+		} else if (identity == nullptr || !Matcher::same(**bound, *identity)) {
+			am->fixed_.push_back(*bound);
+		}
+	} // Sort the pattern elements.
+
+	// Find the length of each block, the least the pattern needs from its
+	// start on, and the fingerprint to look for when placing it.
+	size_t end = am->fixed_.size();
+	size_t tail = 0;
+	for (size_t index = am->blocks_.size(); index > 0; --index) {
+		Block& block = am->blocks_[index - 1];
+		block.length = end - block.first;
+		end = block.first;
+		if (block.length > 0) {
+			pTerm const& lead = am->fixed_[block.first];
+			block.keyed = !lead->get_summary().has_variables();
+			block.key = lead->get_fingerprint();
+		}
+		tail += block.length;
+		block.tail = tail;
+		tail += am->least_;
+	} // Measure the blocks.
+
+	// The first block starts the subject and the last ends it.
+	size_t size = flat->size();
+	Block& first = am->blocks_.front();
+	Block& last = am->blocks_.back();
+	if (size < first.tail) return nullptr;
+	if (am->blocks_.size() == 1 && size != first.length) return nullptr;
+	if (!am->fits(first, 0)) return nullptr;
+	last.start = size - last.length;
+	if (!am->fits(last, last.start)) return nullptr;
+	return std::unique_ptr<Choice>(std::move(am));
+}
+
+bool
+AMatcher::next(Context& context) {
+	if (done_) return false;
+	bool found = solve(started_);
+	started_ = true;
+	if (!found) {
+		done_ = true;
+		return false;
+	}
+
+	// Bind the variables, and match the fixed elements with variables first.
+	for (size_t index = 1; index < blocks_.size(); ++index) {
+		Block const& before = blocks_[index - 1];
+		context.push(blocks_[index].gap,
+				make_term(before.start + before.length, blocks_[index].start));
+	} // Add every variable.
+	for (auto const& block : blocks_) {
+		for (size_t index = 0; index < block.length; ++index) {
+			pTerm const& pattern = fixed_[block.first + index];
+			if (pattern->get_summary().has_variables()) {
+				context.push(pattern, at(block.start + index));
+			}
+		} // Add every fixed element with variables.
+	} // Add every block.
+	return true;
+}
+
+bool
+AMatcher::solve(bool resume) {
+	// The first and last blocks never move, so only those between are
+	// placed.
+	size_t last = blocks_.size() - 1;
+	size_t index = 1;
+	bool fresh = true;
+	if (resume) {
+		if (last <= 1) return false;
+		index = last - 1;
+		fresh = false;
+	}
+	for (;;) {
+		if (index >= last) {
+			Block const& block = blocks_[last];
+			if (last == 0 || block.repeat == NONE ||
+					gap_length(last) == gap_length(block.repeat)) {
+				return true;
+			}
+			if (last <= 1) return false;
+			index = last - 1;
+			fresh = false;
+		} else if (place(index, fresh)) {
+			++index;
+			fresh = true;
+		} else if (index == 1) {
+			return false;
+		} else {
+			--index;
+			fresh = false;
+		}
+	} // Search for a solution.
+}
+
+bool
+AMatcher::place(size_t index, bool fresh) {
+	Block& block = blocks_[index];
+	Block const& before = blocks_[index - 1];
+	size_t lowest = before.start + before.length + least_;
+	size_t highest = subject_->size() - block.tail;
+
+	// A repeated variable takes a run as long as it took before.
+	if (block.repeat != NONE) {
+		if (!fresh) return false;
+		size_t start = before.start + before.length + gap_length(block.repeat);
+		if (start > highest || !fits(block, start)) return false;
+		block.start = start;
+		return true;
+	}
+	for (size_t start = fresh ? lowest : block.start + 1; start <= highest;
+			++start) {
+		if (block.keyed && at(start)->get_fingerprint() != block.key) {
+			continue;
+		}
+		if (fits(block, start)) {
+			block.start = start;
+			return true;
+		}
+	} // Search for a position.
+	return false;
+}
+
+bool
+AMatcher::fits(Block const& block, size_t start) const {
+	for (size_t index = 0; index < block.length; ++index) {
+		if (!Matcher::could_match(fixed_[block.first + index],
+				at(start + index))) {
+			return false;
+		}
+	} // Check every fixed element.
+	return true;
+}
+
+pTerm const&
+AMatcher::at(size_t position) const {
+	if (position < chunk_start_ || position >= chunk_start_ + chunk_.size()) {
+		chunk_ = subject_->get_chunk(position);
+		chunk_start_ = position;
+	}
+	return chunk_[position - chunk_start_];
+}
+
+pTerm
+AMatcher::make_term(size_t from, size_t to) const {
+	if (from == to) return identity_;
+	if (to == from + 1) return at(from);
+	if (to - from == subject_->size()) return subject_;
+	return fact_.slice(Loc::get_internal(), subject_, from, to);
+}
+
+} /* namespace match */
+} /* namespace elision */
@@ -0,0 +1,162 @@
+#ifndef AMATCHER_H_
+#define AMATCHER_H_
+
+/**
+ * @file
+ * Define matching for associative lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <memory>
+#include <vector>
+#include <match/Context.h>
+#include <Fingerprint.h>
+#include <term/IList.h>
+#include <term/TermFactory.h>
+
+namespace elision {
+namespace match {
+
+/**
+ * Enumerate the ways an associative list pattern matches a subject list with
+ * the same properties.  Grouping does not matter but order does, so the
+ * subject is a sequence of elements, and the pattern elements take
+ * contiguous runs of it, in order:
+ *   - a variable takes any non-empty run, which it binds as a single
+ *     element or as a list with the same properties; if the properties give
+ *     an identity, the variable may instead take nothing and bind the
+ *     identity;
+ *   - any other element takes exactly one element, which it must match.
+ * Nested lists with the same properties are flattened first.
+ *
+ * The pattern is read as blocks of fixed elements separated by variables,
+ * where a variable already bound counts as the fixed elements it is bound
+ * to.  The first block must start the subject and the last must end it, so
+ * both are checked once.  The blocks between are placed from left to right,
+ * each at the first position after the previous block where it fits,
+ * leaving room for the least the rest of the pattern needs; a fixed element
+ * without variables fits only an equal element, judged first by
+ * fingerprint, and any other only an element it could match.  A variable
+ * that occurs again must take a run of the same length, which fixes the
+ * position of the next block.
+ *
+ * Solutions are produced one at a time, as the alternatives of a `Choice`,
+ * and each is handed to the matcher as goals.  A run bound to a variable is
+ * a slice of the subject, so it shares the subject's storage.
+ */
+class AMatcher : public Choice {
+public:
+	/**
+	 * Prepare to match a pattern list against a subject list.
+	 * @param fact		The factory to use to build the lists to bind.
+	 * @param pattern	The pattern list.
+	 * @param subject	The subject list.  It must have the same properties as
+	 * 					the pattern.
+	 * @param context	The context, whose binds are respected.
+	 * @return	The alternatives, or null if there certainly are none.
+	 */
+	static std::unique_ptr<Choice> make(term::TermFactory const& fact,
+			term::IList const& pattern, term::pList const& subject,
+			Context const& context);
+
+	/**
+	 * Add the goals of the next solution.
+	 * @param context	The context.
+	 * @return	True if there was another solution.
+	 */
+	bool next(Context& context);
+
+private:
+	/// A run of fixed pattern elements, and the variable before it.
+	struct Block {
+		term::pTerm gap;	//< The variable before the block, or null.
+		size_t repeat;		//< An earlier block with the same variable.
+		size_t first;		//< The position of the first fixed element.
+		size_t length;		//< The number of fixed elements.
+		size_t tail;		//< The least needed from the block's start on.
+		size_t start;		//< The position in the subject.
+		bool keyed;			//< True iff the first element has no variables.
+		Fingerprint key;	//< The fingerprint of the first element, if keyed.
+	};
+
+	AMatcher(term::TermFactory const& fact, term::pList const& subject,
+			term::pTerm const& identity);
+
+	/**
+	 * Find the next solution.
+	 * @param resume	False to find the first solution, and true to find
+	 * 					the one after the last found.
+	 * @return	True if there was a solution.
+	 */
+	bool solve(bool resume);
+
+	/**
+	 * Move a block to its first or next position.
+	 * @param index	The block.
+	 * @param fresh	True for the first position, and false for the next.
+	 * @return	False if there are no more positions.
+	 */
+	bool place(size_t index, bool fresh);
+
+	/**
+	 * Determine whether a block fits at a position in the subject.
+	 * @param block		The block.
+	 * @param start		The position.
+	 * @return	True iff each fixed element could match its element.
+	 */
+	bool fits(Block const& block, size_t start) const;
+
+	/**
+	 * Get the length of the run taken by the variable before a block.
+	 * @param index	The block, which must not be the first.
+	 * @return	The length of the run.
+	 */
+	inline size_t gap_length(size_t index) const {
+		Block const& before = blocks_[index - 1];
+		return blocks_[index].start - before.start - before.length;
+	}
+
+	/**
+	 * Get a subject element.
+	 * @param position	The zero-based position.
+	 * @return	The element.
+	 */
+	term::pTerm const& at(size_t position) const;
+
+	/**
+	 * Make the term to bind to a variable.
+	 * @param from	The position of the first element of the run.
+	 * @param to	One past the position of the last element.
+	 * @return	The term.
+	 */
+	term::pTerm make_term(size_t from, size_t to) const;
+
+	term::TermFactory const& fact_;
+	term::pList subject_;				//< The flattened subject.
+	term::pTerm identity_;				//< The identity, or null.
+	size_t least_;						//< The shortest run a variable takes.
+	std::vector<term::pTerm> fixed_;	//< The fixed pattern elements.
+	std::vector<Block> blocks_;
+	mutable size_t chunk_start_;		//< Position of the cached run.
+	mutable term::ElementSpan chunk_;	//< The cached run of elements.
+	bool started_;
+	bool done_;
+};
+
+} /* namespace match */
+} /* namespace elision */
+
+#endif /* AMATCHER_H_ */
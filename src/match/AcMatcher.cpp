@@ -0,0 +1,361 @@
+/**
+ * @file
+ * Implement matching for associative and commutative lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <match/AcMatcher.h>
+#include <match/Matcher.h>
+#include <term/IVariable.h>
+#include <algorithm>
+
+namespace elision {
+namespace match {
+
+using namespace elision::term;
+
+namespace {
+
+/// A position that is not in the vector.
+constexpr size_t NONE = static_cast<size_t>(-1);
+
+/**
+ * Order terms by fingerprint.
+ * @param first		The first term.
+ * @param second	The second term.
+ * @return	True iff the first fingerprint is less than the second.
+ */
+inline bool by_print(pTerm const& first, pTerm const& second) {
+	return first->get_fingerprint() < second->get_fingerprint();
+}
+
+/**
+ * Find a term among terms sorted by fingerprint.
+ * @param terms	The terms.
+ * @param term	The term to find.
+ * @return	The position of the term, or `NONE`.
+ */
+size_t find(std::vector<pTerm> const& terms, pTerm const& term) {
+	auto here = std::lower_bound(terms.begin(), terms.end(), term, by_print);
+	for (; here != terms.end() && (*here)->feq(*term); ++here) {
+		if (Matcher::same(**here, *term)) return here - terms.begin();
+	} // Search the terms with the same fingerprint.
+	return NONE;
+}
+
+/**
+ * Find the greatest common divisor of two counts.
+ * @param first		The first count.
+ * @param second	The second count.
+ * @return	The greatest common divisor.
+ */
+size_t gcd(size_t first, size_t second) {
+	while (second != 0) {
+		size_t rest = first % second;
+		first = second;
+		second = rest;
+	} // Reduce.
+	return first;
+}
+
+} /* anonymous namespace */
+
+AcMatcher::AcMatcher(TermFactory const& fact,
+		pPropertySpecification const& spec) : fact_(fact), spec_(spec),
+				started_(false), done_(false) {
+	if (spec->has_identity()) identity_ = spec->get_identity().get();
+}
+
+void
+AcMatcher::flatten(IList const& list, IPropertySpecification const& spec,
+		std::vector<pTerm>& elements) {
+	for (auto const& element : list) {
+		if (element->get_kind() == LIST_KIND) {
+			auto const& inner = kind_cast<IList>(*element);
+			if (Matcher::same(*inner.get_property_specification(), spec)) {
+				flatten(inner, spec, elements);
+				continue;
+			}
+		}
+		elements.push_back(element);
+	} // Add every element.
+}
+
+std::unique_ptr<Choice>
+AcMatcher::make(TermFactory const& fact, IList const& pattern,
+		IList const& subject, Context const& context) {
+	pPropertySpecification spec = pattern.get_property_specification();
+	std::unique_ptr<AcMatcher> ac(new AcMatcher(fact, spec));
+
+	// Count the distinct elements of the subject.
+	std::vector<pTerm> elements;
+	flatten(subject, *spec, elements);
+	std::sort(elements.begin(), elements.end(), by_print);
+	for (auto const& element : elements) {
+		if (!ac->elements_.empty() &&
+				Matcher::same(*ac->elements_.back(), *element)) {
+			++ac->remaining_.back();
+		} else {
+			ac->elements_.push_back(element);
+			ac->remaining_.push_back(1);
+		}
+	} // Count the elements.
+
+	// Take out a number of copies of a term, or fail.
+	auto take = [&ac](pTerm const& term, size_t times) {
+		size_t position = find(ac->elements_, term);
+		if (position == NONE || ac->remaining_[position] < times) return false;
+		ac->remaining_[position] -= times;
+		return true;
+	};
+
+	// Constants take their elements at once, and the other pattern elements
+	// are sorted into variables and single elements.
+	std::vector<pTerm> parts;
+	flatten(pattern, *spec, parts);
+	for (auto const& part : parts) {
+		if (!part->get_summary().has_variables()) {
+			if (!take(part, 1)) return nullptr;
+		} else if (part->get_kind() == VARIABLE_KIND) {
+			Atom name = kind_cast<IVariable>(*part).get_atom();
+			auto var = std::find_if(ac->vars_.begin(), ac->vars_.end(),
+					[name](Var const& var) {
+				return kind_cast<IVariable>(*var.pattern).get_atom() == name;
+			});
+			if (var == ac->vars_.end()) ac->vars_.push_back(Var{ part, 1 });
+			else ++var->times;
+		} else {
+			ac->singles_.push_back(Single{ part, {}, false });
+		}
+	} // Sort the pattern elements.
+
+	// Variables that are already bound take what they are bound to.
+	for (size_t index = 0; index < ac->vars_.size(); ) {
+		Var const& var = ac->vars_[index];
+		pTerm const* bound = context.find(
+				kind_cast<IVariable>(*var.pattern).get_atom());
+		if (bound == nullptr) {
+			++index;
+			continue;
+		}
+		std::vector<pTerm> taken;
+		if ((*bound)->get_kind() == LIST_KIND && Matcher::same(
+				*kind_cast<IList>(**bound).get_property_specification(),
+				*spec)) {
+			flatten(kind_cast<IList>(**bound), *spec, taken);
+		} else if (ac->identity_ == nullptr ||
+				!Matcher::same(**bound, *ac->identity_)) {
+			taken.push_back(*bound);
+		}
+		for (auto const& term : taken) {
+			if (!take(term, var.times)) return nullptr;
+		} // Take the bound elements.
+		ac->vars_.erase(ac->vars_.begin() + index);
+	} // Handle bound variables.
+
+	// Find the candidates for each single element, and place the most
+	// constrained first.  Equal singles end up adjacent.
+	for (auto& single : ac->singles_) {
+		for (size_t position = 0; position < ac->elements_.size();
+				++position) {
+			if (ac->remaining_[position] > 0 && Matcher::could_match(
+					single.pattern, ac->elements_[position])) {
+				single.candidates.push_back(position);
+			}
+		} // Check every element.
+		if (single.candidates.empty()) return nullptr;
+	} // Find candidates.
+	std::sort(ac->singles_.begin(), ac->singles_.end(),
+			[](Single const& first, Single const& second) {
+		if (first.candidates.size() != second.candidates.size()) {
+			return first.candidates.size() < second.candidates.size();
+		}
+		return by_print(first.pattern, second.pattern);
+	});
+	for (size_t index = 1; index < ac->singles_.size(); ++index) {
+		ac->singles_[index].repeat = Matcher::same(
+				*ac->singles_[index - 1].pattern, *ac->singles_[index].pattern);
+	} // Mark repeated singles.
+
+	// Check that the counts can work out at all.
+	size_t left = 0;
+	for (size_t count : ac->remaining_) left += count;
+	size_t least = ac->singles_.size();
+	if (ac->vars_.empty()) {
+		if (left != least) return nullptr;
+	} else {
+		std::stable_sort(ac->vars_.begin(), ac->vars_.end(),
+				[](Var const& first, Var const& second) {
+			return first.times > second.times;
+		});
+		size_t divisor = 0;
+		for (auto const& var : ac->vars_) {
+			if (ac->identity_ == nullptr) least += var.times;
+			divisor = gcd(divisor, var.times);
+		} // Total the variables.
+		if (left < least) return nullptr;
+		if (ac->singles_.empty() && divisor > 1) {
+			for (size_t count : ac->remaining_) {
+				if (count % divisor != 0) return nullptr;
+			} // Check every element.
+		}
+	}
+	size_t decisions = ac->singles_.size();
+	if (ac->vars_.size() > 1) {
+		decisions += (ac->vars_.size() - 1) * ac->elements_.size();
+	}
+	ac->values_.assign(decisions, 0);
+	return std::unique_ptr<Choice>(std::move(ac));
+}
+
+bool
+AcMatcher::next(Context& context) {
+	if (done_) return false;
+	bool found = solve(started_);
+	started_ = true;
+	if (!found) {
+		done_ = true;
+		return false;
+	}
+
+	// Bind the variables, and match the singles first.
+	size_t singles = singles_.size();
+	size_t distinct = elements_.size();
+	std::vector<size_t> amounts(distinct);
+	for (size_t var = 0; var < vars_.size(); ++var) {
+		for (size_t position = 0; position < distinct; ++position) {
+			amounts[position] = var + 1 < vars_.size()
+					? values_[singles + var * distinct + position]
+					: remaining_[position] / vars_[var].times;
+		} // Get the amount of each element.
+		context.push(vars_[var].pattern, make_term(amounts));
+	} // Add every variable.
+	for (size_t index = 0; index < singles; ++index) {
+		Single const& single = singles_[index];
+		context.push(single.pattern,
+				elements_[single.candidates[values_[index]]]);
+	} // Add every single.
+	return true;
+}
+
+bool
+AcMatcher::solve(bool resume) {
+	size_t count = values_.size();
+	size_t position = 0;
+	bool fresh = true;
+	if (resume) {
+		if (count == 0) return false;
+		position = count - 1;
+		fresh = false;
+	}
+	for (;;) {
+		if (position == count) {
+			if (complete()) return true;
+			if (count == 0) return false;
+			position = count - 1;
+			fresh = false;
+		} else if (decide(position, fresh)) {
+			fresh = acceptable(position);
+			if (fresh) ++position;
+		} else if (position == 0) {
+			return false;
+		} else {
+			--position;
+			fresh = false;
+		}
+	} // Search for a solution.
+}
+
+bool
+AcMatcher::decide(size_t position, bool fresh) {
+	size_t singles = singles_.size();
+	if (position < singles) {
+		// Give the single an element no earlier than an equal single got.
+		Single const& single = singles_[position];
+		size_t index = 0;
+		if (!fresh) {
+			++remaining_[single.candidates[values_[position]]];
+			index = values_[position] + 1;
+		} else if (single.repeat) {
+			index = values_[position - 1];
+		}
+		for (; index < single.candidates.size(); ++index) {
+			size_t element = single.candidates[index];
+			if (remaining_[element] > 0) {
+				values_[position] = index;
+				--remaining_[element];
+				return true;
+			}
+		} // Search for an element.
+		return false;
+	}
+
+	// Give the variable one more copy of the element for each occurrence.
+	size_t distinct = elements_.size();
+	size_t element = (position - singles) % distinct;
+	size_t times = vars_[(position - singles) / distinct].times;
+	size_t amount = 0;
+	if (!fresh) {
+		remaining_[element] += values_[position] * times;
+		amount = values_[position] + 1;
+	}
+	if (amount * times > remaining_[element]) return false;
+	values_[position] = amount;
+	remaining_[element] -= amount * times;
+	return true;
+}
+
+bool
+AcMatcher::acceptable(size_t position) const {
+	size_t singles = singles_.size();
+	if (position < singles || identity_ != nullptr) return true;
+
+	// Once a variable has been offered every element, it must have some.
+	size_t distinct = elements_.size();
+	if ((position - singles) % distinct + 1 < distinct) return true;
+	size_t first = position + 1 - distinct;
+	for (size_t index = first; index <= position; ++index) {
+		if (values_[index] > 0) return true;
+	} // Check the variable's amounts.
+	return false;
+}
+
+bool
+AcMatcher::complete() const {
+	if (vars_.empty()) return true;
+	size_t times = vars_.back().times;
+	size_t total = 0;
+	for (size_t count : remaining_) {
+		if (count % times != 0) return false;
+		total += count;
+	} // Check every element.
+	return total > 0 || identity_ != nullptr;
+}
+
+pTerm
+AcMatcher::make_term(std::vector<size_t> const& amounts) const {
+	std::vector<pTerm> elements;
+	for (size_t position = 0; position < amounts.size(); ++position) {
+		elements.insert(elements.end(), amounts[position],
+				elements_[position]);
+	} // Collect the elements.
+	if (elements.empty()) return identity_;
+	if (elements.size() == 1) return elements[0];
+	return fact_.get_list(Loc::get_internal(), spec_, std::move(elements));
+}
+
+} /* namespace match */
+} /* namespace elision */
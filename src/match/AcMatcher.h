@@ -0,0 +1,167 @@
+#ifndef ACMATCHER_H_
+#define ACMATCHER_H_
+
+/**
+ * @file
+ * Define matching for associative and commutative lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <memory>
+#include <vector>
+#include <match/Context.h>
+#include <term/IList.h>
+#include <term/TermFactory.h>
+
+namespace elision {
+namespace match {
+
+/**
+ * Enumerate the ways an associative and commutative list pattern matches a
+ * subject list with the same properties.  Order and grouping do not matter,
+ * so the subject is a multiset of elements, and the pattern elements divide
+ * it among themselves:
+ *   - an element without variables takes one equal element;
+ *   - a variable takes any non-empty multiset of elements, which it binds
+ *     as a single element or as a list with the same properties; if the
+ *     properties give an identity, the variable may instead take nothing
+ *     and bind the identity;
+ *   - any other element takes one element, which it must then match.
+ * Nested lists with the same properties are flattened first.
+ *
+ * The subject elements are sorted by fingerprint and counted, once.  The
+ * elements without variables, and the variables already bound, are then
+ * removed from the counts, so a missing constant fails before anything is
+ * enumerated.  Each remaining pattern element that is neither is given the
+ * subject elements it could match, judged by kind, depth, and constant
+ * operator; and the pattern elements with the fewest candidates are placed
+ * first.
+ *
+ * A variable that occurs `k` times must take a multiset that occurs `k`
+ * times in what is left.  The solutions are enumerated by choosing, for
+ * each variable but the last and each distinct element, how many copies it
+ * takes; the last variable takes whatever is left, provided that divides
+ * evenly.  Variables are ordered so the last has the fewest occurrences,
+ * and a subject that the occurrence counts cannot divide is rejected at
+ * once.
+ *
+ * Solutions are produced one at a time, as the alternatives of a `Choice`,
+ * and each is handed to the matcher as goals.
+ */
+class AcMatcher : public Choice {
+public:
+	/**
+	 * Prepare to match a pattern list against a subject list.
+	 * @param fact		The factory to use to build the lists to bind.
+	 * @param pattern	The pattern list.
+	 * @param subject	The subject list.  It must have the same properties as
+	 * 					the pattern.
+	 * @param context	The context, whose binds are respected.
+	 * @return	The alternatives, or null if there certainly are none.
+	 */
+	static std::unique_ptr<Choice> make(term::TermFactory const& fact,
+			term::IList const& pattern, term::IList const& subject,
+			Context const& context);
+
+	/**
+	 * Add the goals of the next solution.
+	 * @param context	The context.
+	 * @return	True if there was another solution.
+	 */
+	bool next(Context& context);
+
+	/**
+	 * Add the elements of a list to a vector, flattening any elements that
+	 * are lists with the same properties.
+	 * @param list		The list.
+	 * @param spec		The properties.
+	 * @param elements	The vector to add to.
+	 */
+	static void flatten(term::IList const& list,
+			term::IPropertySpecification const& spec,
+			std::vector<term::pTerm>& elements);
+
+private:
+	/// A pattern element that takes exactly one subject element.
+	struct Single {
+		term::pTerm pattern;
+		std::vector<size_t> candidates;	//< Distinct elements it could match.
+		bool repeat;	//< True iff it equals the previous single.
+	};
+
+	/// A variable and the number of times it occurs.
+	struct Var {
+		term::pTerm pattern;
+		size_t times;
+	};
+
+	AcMatcher(term::TermFactory const& fact,
+			term::pPropertySpecification const& spec);
+
+	/**
+	 * Find the next solution.
+	 * @param resume	False to find the first solution, and true to find
+	 * 					the one after the last found.
+	 * @return	True if there was a solution.
+	 */
+	bool solve(bool resume);
+
+	/**
+	 * Move a decision to its first or next value, applying it to the
+	 * remaining counts.
+	 * @param position	The decision.
+	 * @param fresh		True for the first value, and false for the next.
+	 * @return	False if there are no more values.
+	 */
+	bool decide(size_t position, bool fresh);
+
+	/**
+	 * Determine whether the decisions up to a position can still lead to a
+	 * solution.
+	 * @param position	The last decision made.
+	 * @return	True iff the decisions are acceptable.
+	 */
+	bool acceptable(size_t position) const;
+
+	/**
+	 * Determine whether the last variable can take what is left.
+	 * @return	True iff the decisions are a solution.
+	 */
+	bool complete() const;
+
+	/**
+	 * Make the term to bind to a variable.
+	 * @param amounts	The number of copies of each distinct element.
+	 * @return	The term.
+	 */
+	term::pTerm make_term(std::vector<size_t> const& amounts) const;
+
+	term::TermFactory const& fact_;
+	term::pPropertySpecification spec_;
+	term::pTerm identity_;				//< The identity, or null.
+	std::vector<term::pTerm> elements_;	//< Distinct subject elements.
+	std::vector<size_t> remaining_;		//< Copies not yet taken.
+	std::vector<Single> singles_;
+	std::vector<Var> vars_;
+	std::vector<size_t> values_;		//< The value of each decision.
+	bool started_;
+	bool done_;
+};
+
+} /* namespace match */
+} /* namespace elision */
+
+#endif /* ACMATCHER_H_ */
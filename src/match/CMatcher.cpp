@@ -0,0 +1,224 @@
+/**
+ * @file
+ * Implement matching for commutative lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <match/CMatcher.h>
+#include <match/Matcher.h>
+#include <term/IVariable.h>
+#include <algorithm>
+#include <utility>
+
+namespace elision {
+namespace match {
+
+using namespace elision::term;
+
+std::unique_ptr<Choice>
+CMatcher::make(TermFactory const& fact, IList const& pattern,
+		IList const& subject, Context const& context) {
+	if (pattern.size() != subject.size()) return nullptr;
+	std::unique_ptr<CMatcher> cm(new CMatcher());
+
+	// Sort the subject elements into buckets, and count equal elements.
+	typedef std::pair<Key, pTerm> entry_t;
+	std::vector<entry_t> sorted;
+	sorted.reserve(subject.size());
+	for (auto const& element : subject) {
+		sorted.push_back(entry_t(Key(*element), element));
+	} // Key the elements.
+	std::sort(sorted.begin(), sorted.end(),
+			[](entry_t const& first, entry_t const& second) {
+		return first.first < second.first;
+	});
+	for (auto const& entry : sorted) {
+		if (!cm->elements_.empty() && !(cm->keys_.back() < entry.first) &&
+				Matcher::same(*cm->elements_.back(), *entry.second)) {
+			++cm->remaining_.back();
+		} else {
+			cm->keys_.push_back(entry.first);
+			cm->elements_.push_back(entry.second);
+			cm->remaining_.push_back(1);
+		}
+	} // Count the elements.
+
+	// Constants and bound variables take their elements at once.
+	for (auto const& part : pattern) {
+		if (!part->get_summary().has_variables()) {
+			if (!cm->take(part)) return nullptr;
+			continue;
+		}
+		if (part->get_kind() == VARIABLE_KIND) {
+			pTerm const* bound = context.find(
+					kind_cast<IVariable>(*part).get_atom());
+			if (bound != nullptr) {
+				if (!cm->take(*bound)) return nullptr;
+				continue;
+			}
+		}
+		cm->singles_.push_back(Single{ part, {}, false });
+	} // Sort the pattern elements.
+
+	// Find the candidates for each single, and place the most constrained
+	// first.  Equal singles end up adjacent.
+	for (auto& single : cm->singles_) {
+		cm->find_candidates(fact, single);
+		if (single.candidates.empty()) return nullptr;
+	} // Find candidates.
+	std::sort(cm->singles_.begin(), cm->singles_.end(),
+			[](Single const& first, Single const& second) {
+		if (first.candidates.size() != second.candidates.size()) {
+			return first.candidates.size() < second.candidates.size();
+		}
+		return first.pattern->get_fingerprint() <
+				second.pattern->get_fingerprint();
+	});
+	for (size_t index = 1; index < cm->singles_.size(); ++index) {
+		cm->singles_[index].repeat = Matcher::same(
+				*cm->singles_[index - 1].pattern, *cm->singles_[index].pattern);
+	} // Mark repeated singles.
+	cm->values_.assign(cm->singles_.size(), 0);
+	return std::unique_ptr<Choice>(std::move(cm));
+}
+
+bool
+CMatcher::next(Context& context) {
+	if (done_) return false;
+	bool found = solve(started_);
+	started_ = true;
+	if (!found) {
+		done_ = true;
+		return false;
+	}
+	for (size_t index = 0; index < singles_.size(); ++index) {
+		Single const& single = singles_[index];
+		context.push(single.pattern,
+				elements_[single.candidates[values_[index]]]);
+	} // Add every single.
+	return true;
+}
+
+bool
+CMatcher::take(pTerm const& term) {
+	Key key(*term);
+	auto here = std::lower_bound(keys_.begin(), keys_.end(), key);
+	for (; here != keys_.end() && !(key < *here); ++here) {
+		size_t position = here - keys_.begin();
+		if (remaining_[position] > 0 &&
+				Matcher::same(*elements_[position], *term)) {
+			--remaining_[position];
+			return true;
+		}
+	} // Search the elements with the same key.
+	return false;
+}
+
+void
+CMatcher::find_candidates(TermFactory const& fact, Single& single) const {
+	pTerm const& pattern = single.pattern;
+	TermKind kind = pattern->get_kind();
+	pTerm type = pattern->get_type();
+	Fingerprint print = type->get_fingerprint();
+
+	// A term variable matches a term literal against the type of the term
+	// it holds, so only its kind narrows the search.
+	bool typed = !type->get_summary().has_variables() &&
+			!Matcher::same(*type, *fact.ANY);
+	if (kind == TERM_VARIABLE_KIND) {
+		kind = TERM_LITERAL_KIND;
+		typed = false;
+	}
+
+	// A variable may match any kind.  Anything else is confined to the
+	// bucket for its kind, and its type if that is fixed.
+	auto first = keys_.begin();
+	auto last = keys_.end();
+	if (kind != VARIABLE_KIND) {
+		first = std::lower_bound(first, last, kind,
+				[](Key const& key, TermKind kind) { return key.kind < kind; });
+		last = std::upper_bound(first, last, kind,
+				[](TermKind kind, Key const& key) { return kind < key.kind; });
+		if (typed) {
+			first = std::lower_bound(first, last, print,
+					[](Key const& key, Fingerprint const& print) {
+				return key.type < print;
+			});
+			last = std::upper_bound(first, last, print,
+					[](Fingerprint const& print, Key const& key) {
+				return print < key.type;
+			});
+		}
+	}
+	for (auto here = first; here != last; ++here) {
+		size_t position = here - keys_.begin();
+		if (typed && here->type != print) continue;
+		if (remaining_[position] > 0 &&
+				Matcher::could_match(pattern, elements_[position])) {
+			single.candidates.push_back(position);
+		}
+	} // Check the elements in the bucket.
+}
+
+bool
+CMatcher::solve(bool resume) {
+	size_t count = values_.size();
+	size_t position = 0;
+	bool fresh = true;
+	if (resume) {
+		if (count == 0) return false;
+		position = count - 1;
+		fresh = false;
+	}
+	for (;;) {
+		if (position == count) {
+			return true;
+		} else if (decide(position, fresh)) {
+			++position;
+			fresh = true;
+		} else if (position == 0) {
+			return false;
+		} else {
+			--position;
+			fresh = false;
+		}
+	} // Search for a solution.
+}
+
+bool
+CMatcher::decide(size_t position, bool fresh) {
+	// Give the single an element no earlier than an equal single got.
+	Single const& single = singles_[position];
+	size_t index = 0;
+	if (!fresh) {
+		++remaining_[single.candidates[values_[position]]];
+		index = values_[position] + 1;
+	} else if (single.repeat) {
+		index = values_[position - 1];
+	}
+	for (; index < single.candidates.size(); ++index) {
+		size_t element = single.candidates[index];
+		if (remaining_[element] > 0) {
+			values_[position] = index;
+			--remaining_[element];
+			return true;
+		}
+	} // Search for an element.
+	return false;
+}
+
+} /* namespace match */
+} /* namespace elision */
@@ -0,0 +1,150 @@
+#ifndef CMATCHER_H_
+#define CMATCHER_H_
+
+/**
+ * @file
+ * Define matching for commutative lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <memory>
+#include <vector>
+#include <match/Context.h>
+#include <term/IList.h>
+#include <term/TermFactory.h>
+#include <Fingerprint.h>
+
+namespace elision {
+namespace match {
+
+/**
+ * Enumerate the ways a commutative list pattern matches a subject list with
+ * the same properties.  Order does not matter but grouping does, so each
+ * pattern element takes exactly one subject element, and the lists must
+ * have the same length.
+ *
+ * The subject elements are sorted once by kind, then type, then
+ * fingerprint, and equal elements are counted together; the elements of a
+ * kind, or of a kind and type, are then adjacent buckets.  The pattern
+ * elements without variables, and the variables already bound, are looked
+ * up by key and take their elements first, so a missing constant fails
+ * before anything is enumerated.  Each other pattern element is given the
+ * distinct subject elements it could match, found in the bucket for its
+ * kind and type, and the pattern elements with the fewest candidates are
+ * placed first.  Only those elements are backtracked over, and equal
+ * pattern elements take their elements in order, so no solution is found
+ * twice.
+ *
+ * Solutions are produced one at a time, as the alternatives of a `Choice`,
+ * and each is handed to the matcher as goals.
+ */
+class CMatcher : public Choice {
+public:
+	/**
+	 * Prepare to match a pattern list against a subject list.
+	 * @param fact		The factory that made the terms.
+	 * @param pattern	The pattern list.
+	 * @param subject	The subject list.  It must have the same properties as
+	 * 					the pattern.
+	 * @param context	The context, whose binds are respected.
+	 * @return	The alternatives, or null if there certainly are none.
+	 */
+	static std::unique_ptr<Choice> make(term::TermFactory const& fact,
+			term::IList const& pattern, term::IList const& subject,
+			Context const& context);
+
+	/**
+	 * Add the goals of the next solution.
+	 * @param context	The context.
+	 * @return	True if there was another solution.
+	 */
+	bool next(Context& context);
+
+private:
+	/// The order in which subject elements are kept.
+	struct Key {
+		term::TermKind kind;
+		Fingerprint type;
+		Fingerprint print;
+
+		/**
+		 * Make the key of a term.
+		 * @param term	The term.
+		 */
+		explicit Key(term::ITerm const& term) : kind(term.get_kind()),
+				type(term.get_type()->get_fingerprint()),
+				print(term.get_fingerprint()) {}
+
+		inline bool operator<(Key const& other) const {
+			if (kind != other.kind) return kind < other.kind;
+			if (type != other.type) return type < other.type;
+			return print < other.print;
+		}
+	};
+
+	/// A pattern element that takes an element by matching it.
+	struct Single {
+		term::pTerm pattern;
+		std::vector<size_t> candidates;	//< Distinct elements it could match.
+		bool repeat;	//< True iff it equals the previous single.
+	};
+
+	CMatcher() : started_(false), done_(false) {}
+
+	/**
+	 * Take a copy of an element equal to a term.
+	 * @param term	The term.
+	 * @return	True if there was a copy to take.
+	 */
+	bool take(term::pTerm const& term);
+
+	/**
+	 * Find the distinct subject elements a pattern element could match.
+	 * @param fact		The factory that made the terms.
+	 * @param single	The pattern element, whose candidates are set.
+	 */
+	void find_candidates(term::TermFactory const& fact, Single& single) const;
+
+	/**
+	 * Find the next solution.
+	 * @param resume	False to find the first solution, and true to find
+	 * 					the one after the last found.
+	 * @return	True if there was a solution.
+	 */
+	bool solve(bool resume);
+
+	/**
+	 * Move a single to its first or next candidate, applying it to the
+	 * remaining counts.
+	 * @param position	The single.
+	 * @param fresh		True for the first candidate, and false for the next.
+	 * @return	False if there are no more candidates.
+	 */
+	bool decide(size_t position, bool fresh);
+
+	std::vector<Key> keys_;				//< The key of each distinct element.
+	std::vector<term::pTerm> elements_;	//< Distinct subject elements.
+	std::vector<size_t> remaining_;		//< Copies not yet taken.
+	std::vector<Single> singles_;
+	std::vector<size_t> values_;		//< The candidate each single takes.
+	bool started_;
+	bool done_;
+};
+
+} /* namespace match */
+} /* namespace elision */
+
+#endif /* CMATCHER_H_ */
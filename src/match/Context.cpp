@@ -20,18 +20,53 @@
 #include <match/Context.h>
 
 namespace elision {
-namespace term {
-namespace basic {
+namespace match {
 
-Context::Context() {
-	// TODO Auto-generated constructor stub
+Context::Context(term::BindMap const& binds) {
+	for (auto const& entry : binds) bind(entry.first, entry.second);
+}
+
+bool
+Context::choose(std::unique_ptr<Choice> choice) {
+	ChoicePoint point;
+	point.choice = std::move(choice);
+	point.mark = mark();
+	point.goals.reserve(goals_.size());
+	for (size_t index = 0; index < goals_.size(); ++index) {
+		point.goals.push_back(goals_[index]);
+	} // Save the goals.
+	choices_.push_back(std::move(point));
+	return retry();
+}
+
+bool
+Context::backtrack() {
+	while (!choices_.empty()) {
+		if (retry()) return true;
+	} // Search for an alternative.
+	goals_.clear();
+	return false;
+}
 
+bool
+Context::retry() {
+	ChoicePoint& point = choices_.back();
+	goals_.clear();
+	for (auto const& goal : point.goals) goals_.push(goal);
+	undo(point.mark);
+	if (point.choice->next(*this)) return true;
+	choices_.pop_back();
+	return false;
 }
 
-Context::~Context() {
-	// TODO Auto-generated destructor stub
+term::BindMap
+Context::get_map() const {
+	term::BindMap map;
+	for (size_t index = 0; index < binds_.size(); ++index) {
+		map = map.extend(binds_[index].name, binds_[index].term);
+	} // Add every bind.
+	return map;
 }
 
-} /* namespace basic */
-} /* namespace term */
+} /* namespace match */
 } /* namespace elision */
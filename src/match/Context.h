@@ -20,21 +20,280 @@
  * @endverbatim
  */
 
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Atom.h"
+#include "term/ITerm.h"
+#include "term/BindMap.h"
+
 namespace elision {
-namespace term {
-namespace basic {
+namespace match {
 
 /**
- * 
+ * A stack that holds its first few entries inline, and only goes to the heap
+ * when it grows past them.  Popped entries are reset, so they release
+ * anything they hold.
+ */
+template<class T, size_t N>
+class InlineStack {
+public:
+	/// Make an empty stack.
+	InlineStack() : size_(0) {}
+
+	inline size_t size() const {
+		return size_;
+	}
+
+	inline bool empty() const {
+		return size_ == 0;
+	}
+
+	inline T& operator[](size_t index) {
+		return index < N ? inline_[index] : spill_[index - N];
+	}
+
+	inline T const& operator[](size_t index) const {
+		return index < N ? inline_[index] : spill_[index - N];
+	}
+
+	inline T& back() {
+		return operator[](size_ - 1);
+	}
+
+	inline void push(T const& item) {
+		if (size_ < N) inline_[size_] = item;
+		else spill_.push_back(item);
+		++size_;
+	}
+
+	inline void pop() {
+		--size_;
+		if (size_ < N) inline_[size_] = T();
+		else spill_.pop_back();
+	}
+
+	/**
+	 * Pop entries until the stack holds a given number.
+	 * @param size	The number of entries to keep.
+	 */
+	inline void truncate(size_t size) {
+		while (size_ > size) pop();
+	}
+
+	inline void clear() {
+		truncate(0);
+	}
+
+private:
+	T inline_[N];
+	std::vector<T> spill_;
+	size_t size_;
+};
+
+class Context;
+
+/**
+ * The alternatives at a point where a match can go more than one way; for
+ * example, the ways to divide the elements of a list among the variables of
+ * a pattern.  The alternatives are generated one at a time, when the search
+ * comes back to this point after the previous alternative failed or its
+ * match was used.
+ */
+class Choice {
+public:
+	virtual ~Choice() = default;
+
+	/**
+	 * Add the goals and binds of the next alternative to a context.  The
+	 * context holds the goals and binds it had when the choice was made.
+	 * @param context	The context.
+	 * @return	True if there was another alternative, and false if none
+	 * 			remain.
+	 */
+	virtual bool next(Context& context) = 0;
+};
+
+/**
+ * Hold the state of a match in progress: the binds made so far, the pairs
+ * of pattern and subject that remain to be matched, and the choice points
+ * to come back to.  The binds and goals are held in inline stacks, so
+ * matching a pattern with a few variables does not touch the heap until the
+ * binds are turned into a map.
+ *
+ * Binds are kept in the order they were made, so that a matcher can mark
+ * the stack and later undo every bind made after the mark.  A choice point
+ * records the mark and the remaining goals, so backtracking to it restores
+ * both and asks its choice for the next alternative.  A context can be
+ * reused for many matches; use `clear` between them.
  */
 class Context {
 public:
-	Context();
-	virtual ~Context();
+	/// A variable name and the term bound to it.
+	struct Bind {
+		Atom name;
+		term::pTerm term;
+	};
+
+	/// A pattern and the subject it must match.
+	struct Goal {
+		term::pTerm pattern;
+		term::pTerm subject;
+	};
+
+	/// Make an empty context.
+	Context() = default;
+
+	/**
+	 * Make a context that starts with the binds of a map.
+	 * @param binds	The binds.
+	 */
+	explicit Context(term::BindMap const& binds);
+
+	/**
+	 * Find the term bound to a name.
+	 * @param name	The name.
+	 * @return	The bound term, or null if the name is not bound.
+	 */
+	inline term::pTerm const* find(Atom name) const {
+		for (size_t index = binds_.size(); index > 0; --index) {
+			Bind const& bind = binds_[index - 1];
+			if (bind.name == name) return &bind.term;
+		} // Search the binds, newest first.
+		return nullptr;
+	}
+
+	/**
+	 * Bind a name to a term.  The name must not already be bound.
+	 * @param name	The name.
+	 * @param term	The term.
+	 */
+	inline void bind(Atom name, term::pTerm const& term) {
+		binds_.push(Bind{ name, term });
+	}
+
+	/**
+	 * Get a mark that can later be used to undo binds.
+	 * @return	The mark.
+	 */
+	inline size_t mark() const {
+		return binds_.size();
+	}
+
+	/**
+	 * Undo every bind made since a mark was taken.
+	 * @param mark	The mark.
+	 */
+	inline void undo(size_t mark) {
+		binds_.truncate(mark);
+	}
+
+	/**
+	 * Get the number of binds.
+	 * @return	The number of binds.
+	 */
+	inline size_t size() const {
+		return binds_.size();
+	}
+
+	/**
+	 * Get a bind, in the order the binds were made.
+	 * @param index	The zero-based index.
+	 * @return	The bind.
+	 */
+	inline Bind const& operator[](size_t index) const {
+		return binds_[index];
+	}
+
+	/**
+	 * Add a goal.  Goals are taken newest first.
+	 * @param pattern	The pattern.
+	 * @param subject	The subject.
+	 */
+	inline void push(term::pTerm const& pattern, term::pTerm const& subject) {
+		goals_.push(Goal{ pattern, subject });
+	}
+
+	/**
+	 * Take the newest goal.
+	 * @param goal	The goal taken.
+	 * @return	True if there was a goal, and false if none remain.
+	 */
+	inline bool pop(Goal& goal) {
+		if (goals_.empty()) return false;
+		goal = goals_.back();
+		goals_.pop();
+		return true;
+	}
+
+	/// Discard every remaining goal.
+	inline void drop_goals() {
+		goals_.clear();
+	}
+
+	/**
+	 * Make a choice point, and add the first of its alternatives.  If there
+	 * is none, the choice point is discarded.
+	 * @param choice	The alternatives.
+	 * @return	True if there was an alternative, and false if not.
+	 */
+	bool choose(std::unique_ptr<Choice> choice);
+
+	/**
+	 * Go back to the newest choice point that has another alternative, and
+	 * add that alternative.  Exhausted choice points are discarded.  If
+	 * there are none left, the goals are discarded too.
+	 * @return	True if there was an alternative, and false if not.
+	 */
+	bool backtrack();
+
+	/**
+	 * Get the number of choice points.
+	 * @return	The number of choice points.
+	 */
+	inline size_t choices() const {
+		return choices_.size();
+	}
+
+	/// Discard every choice point.
+	inline void drop_choices() {
+		choices_.clear();
+	}
+
+	/// Discard every bind, goal, and choice point.
+	inline void clear() {
+		binds_.clear();
+		goals_.clear();
+		choices_.clear();
+	}
+
+	/**
+	 * Make a map holding the binds.
+	 * @return	The map.
+	 */
+	term::BindMap get_map() const;
+
+private:
+	/// A choice, and what to restore before each of its alternatives.
+	struct ChoicePoint {
+		std::unique_ptr<Choice> choice;
+		std::vector<Goal> goals;
+		size_t mark;
+	};
+
+	/**
+	 * Restore the state saved by the newest choice point and add its next
+	 * alternative, discarding it if there is none.
+	 * @return	True if there was an alternative, and false if not.
+	 */
+	bool retry();
+
+	InlineStack<Bind, 8> binds_;
+	InlineStack<Goal, 16> goals_;
+	std::vector<ChoicePoint> choices_;
 };
 
-} /* namespace basic */
-} /* namespace term */
+} /* namespace match */
 } /* namespace elision */
 
 #endif /* CONTEXT_H_ */
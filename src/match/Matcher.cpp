@@ -1,6 +1,6 @@
 /**
  * @file
- * TODO: Describe purpose of file.
+ * Implement syntactic matching.
  *
  * @author sprowell@gmail.com
  *
@@ -18,17 +18,232 @@
  */
 
 #include <match/Matcher.h>
+#include <match/AMatcher.h>
+#include <match/AcMatcher.h>
+#include <match/CMatcher.h>
+#include <term/IApply.h>
+#include <term/ILambda.h>
+#include <term/IList.h>
+#include <term/ILiteral.h>
+#include <term/ISpecialForm.h>
+#include <term/IStaticMap.h>
+#include <term/IVariable.h>
 
 namespace elision {
 namespace match {
 
-Matcher::Matcher() {
-	// TODO Auto-generated constructor stub
+using namespace elision::term;
 
+Matcher::Matcher(TermFactory const& fact) : fact_(fact) {
 }
 
-Matcher::~Matcher() {
-	// TODO Auto-generated destructor stub
+bool
+Matcher::try_match(pTerm const& pattern, pTerm const& subject,
+		Context& context) const {
+	NOTNULL(pattern);
+	NOTNULL(subject);
+	context.drop_goals();
+	context.drop_choices();
+	context.push(pattern, subject);
+	return run(context);
+}
+
+bool
+Matcher::run(Context& context) const {
+	Context::Goal goal;
+	while (context.pop(goal)) {
+		if (step(goal.pattern, goal.subject, context)) continue;
+		if (!context.backtrack()) return false;
+	} // Work through all goals.
+	return true;
+}
+
+bool
+Matcher::next_match(Context& context) const {
+	return context.backtrack() && run(context);
+}
+
+Result
+Matcher::match(pTerm const& pattern, pTerm const& subject,
+		BindMap const& binds) const {
+	NOTNULL(pattern);
+	NOTNULL(subject);
+	Context context(binds);
+	context.push(pattern, subject);
+	return match(std::move(context));
+}
+
+Result
+Matcher::match(Context&& context) const {
+	return Result(*this, std::move(context));
+}
+
+bool
+Matcher::step(pTerm const& pattern, pTerm const& subject,
+		Context& context) const {
+	// A pattern without variables matches only itself.  A pattern with
+	// variables must be matched even against itself, so that its variables
+	// are bound and checked against earlier binds.
+	TermSummary summary = pattern->get_summary();
+	if (!summary.has_variables()) {
+		return pattern == subject || same(*pattern, *subject);
+	}
+
+	// Variables bind, and everything else must agree with the subject on
+	// kind and type, and be no deeper, before the children are tried.
+	TermKind kind = pattern->get_kind();
+	switch (kind) {
+	case VARIABLE_KIND: {
+		auto const& var = kind_cast<IVariable>(*pattern);
+		if (!step_type(pattern->get_type(), subject->get_type(), context)) {
+			return false;
+		}
+		return bind(var.get_atom(), var.get_guard(), subject, context);
+	}
+
+	case TERM_VARIABLE_KIND: {
+		// Term variables bind term literals of the right underlying type.
+		if (subject->get_kind() != TERM_LITERAL_KIND) return false;
+		auto const& var = kind_cast<ITermVariable>(*pattern);
+		pTerm term = kind_cast<ITermLiteral>(*subject).get_term();
+		if (!step_type(var.get_term_type(), term->get_type(), context)) {
+			return false;
+		}
+		return bind(var.get_atom(), fact_.TRUE, subject, context);
+	}
+
+	default:
+		break;
+	} // Handle variables.
+	if (kind != subject->get_kind()) return false;
+	if (kind != LIST_KIND && summary.get_depth() > subject->get_depth()) {
+		return false;
+	}
+	if (!step_type(pattern->get_type(), subject->get_type(), context)) {
+		return false;
+	}
+
+	switch (kind) {
+	case APPLY_KIND: {
+		auto const& papp = kind_cast<IApply>(*pattern);
+		auto const& sapp = kind_cast<IApply>(*subject);
+		return goal(papp.get_operator(), sapp.get_operator(), context) &&
+				goal(papp.get_argument(), sapp.get_argument(), context);
+	}
+
+	case LIST_KIND: {
+		auto const& plist = kind_cast<IList>(*pattern);
+		auto const& slist = kind_cast<IList>(*subject);
+		auto spec = plist.get_property_specification();
+		if (!same(*spec, *slist.get_property_specification())) return false;
+		if (spec->has_flags(IPropertySpecification::ASSOCIATIVE |
+				IPropertySpecification::COMMUTATIVE)) {
+			// Try each way of dividing the subject among the pattern.
+			auto choice = AcMatcher::make(fact_, plist, slist, context);
+			return choice != nullptr && context.choose(std::move(choice));
+		}
+		if (spec->has_flags(IPropertySpecification::ASSOCIATIVE)) {
+			// Try each way of dividing the subject into runs.
+			auto choice = AMatcher::make(fact_, plist, kind_cast<IList>(subject),
+					context);
+			return choice != nullptr && context.choose(std::move(choice));
+		}
+		if (spec->has_flags(IPropertySpecification::COMMUTATIVE)) {
+			// Try each way of pairing the elements.
+			auto choice = CMatcher::make(fact_, plist, slist, context);
+			return choice != nullptr && context.choose(std::move(choice));
+		}
+		if (plist.size() != slist.size()) return false;
+		if (summary.get_depth() > subject->get_depth()) return false;
+		auto here = slist.begin();
+		for (auto const& element : plist) {
+			if (!goal(element, *here, context)) return false;
+			++here;
+		} // Add every element.
+		return true;
+	}
+
+	case LAMBDA_KIND: {
+		auto const& plambda = kind_cast<ILambda>(*pattern);
+		auto const& slambda = kind_cast<ILambda>(*subject);
+		return goal(plambda.get_lhs(), slambda.get_lhs(), context) &&
+				goal(plambda.get_rhs(), slambda.get_rhs(), context) &&
+				goal(plambda.get_guard(), slambda.get_guard(), context);
+	}
+
+	case STATIC_MAP_KIND: {
+		auto const& pmap = kind_cast<IStaticMap>(*pattern);
+		auto const& smap = kind_cast<IStaticMap>(*subject);
+		return goal(pmap.get_domain(), smap.get_domain(), context) &&
+				goal(pmap.get_codomain(), smap.get_codomain(), context);
+	}
+
+	case SPECIAL_FORM_KIND: {
+		auto const& pform = kind_cast<ISpecialForm>(*pattern);
+		auto const& sform = kind_cast<ISpecialForm>(*subject);
+		return goal(pform.get_tag(), sform.get_tag(), context) &&
+				goal(pform.get_content(), sform.get_content(), context);
+	}
+
+	case TERM_LITERAL_KIND: {
+		return goal(kind_cast<ITermLiteral>(*pattern).get_term(),
+				kind_cast<ITermLiteral>(*subject).get_term(), context);
+	}
+
+	default:
+		// Anything else must simply be equal.
+		return same(*pattern, *subject);
+	} // Switch on the pattern kind.
+}
+
+bool
+Matcher::could_match(pTerm const& pattern, pTerm const& subject) {
+	if (!pattern->get_summary().has_variables()) {
+		return same(*pattern, *subject);
+	}
+	TermKind kind = pattern->get_kind();
+	if (kind == VARIABLE_KIND) return true;
+	if (kind == TERM_VARIABLE_KIND) {
+		return subject->get_kind() == TERM_LITERAL_KIND;
+	}
+	if (kind != subject->get_kind()) return false;
+	if (kind == LIST_KIND) return true;
+	if (pattern->get_depth() > subject->get_depth()) return false;
+	if (kind == APPLY_KIND) {
+		// Most applications are told apart by a constant operator.
+		pTerm op = kind_cast<IApply>(*pattern).get_operator();
+		if (!op->get_summary().has_variables()) {
+			return same(*op, *kind_cast<IApply>(*subject).get_operator());
+		}
+	}
+	return true;
+}
+
+bool
+Matcher::step_type(pTerm const& pattern, pTerm const& subject,
+		Context& context) const {
+	if (pattern == fact_.ANY) return true;
+	if (!pattern->get_summary().has_variables()) {
+		return pattern == subject || same(*pattern, *subject) ||
+				same(*pattern, *fact_.ANY);
+	}
+	context.push(pattern, subject);
+	return true;
+}
+
+bool
+Matcher::bind(Atom name, pTerm const& guard, pTerm const& subject,
+		Context& context) const {
+	// A variable already bound must match the same term again.
+	pTerm const* bound = context.find(name);
+	if (bound != nullptr) return same(**bound, *subject);
+	context.bind(name, subject);
+	if (guard->is_true()) return true;
+
+	// Evaluate the guard with every bind made so far.
+	pTerm value = fact_.apply(Loc::get_internal(),
+			fact_.get_binding(Loc::get_internal(), context.get_map()), guard);
+	return value->is_true();
 }
 
 } /* namespace match */
@@ -20,18 +20,179 @@
  * @endverbatim
  */
 
+#include <match/Context.h>
+#include <match/Result.h>
+#include <term/TermFactory.h>
+
 namespace elision {
 namespace match {
 
 /**
  * Perform constrained matching on two terms.
+ *
+ * A pattern matches a subject if the variables of the pattern can be bound
+ * so that the pattern becomes equal to the subject.  A variable matches any
+ * subject whose type matches the variable's type, provided the variable's
+ * guard is true once the variable is bound; a variable that appears more
+ * than once must match equal subjects each time.  Types are matched just as
+ * terms are, and a type of `ANY` matches every type.
+ *
+ * Each pattern is checked against its subject before anything is bound:
+ *   - a pattern without variables matches only an equal subject, which is
+ *     decided by comparing fingerprints before the terms;
+ *   - otherwise the kinds must agree, the pattern must be no deeper than
+ *     the subject, and a constant type must equal the subject's type;
+ *   - lists must have equal property specifications, and lists that are
+ *     matched element by element must have equal lengths.
+ * Only then are the children tried: those without variables are compared at
+ * once, and the rest are added as goals.  Goals and binds are held in
+ * a `Context`, so matching does not use the heap unless the pattern has
+ * many variables or a guard must be evaluated.
+ *
+ * Lists that are both associative and commutative are matched as multisets
+ * by `AcMatcher`, lists that are only associative are matched as sequences
+ * by `AMatcher`, and lists that are only commutative are matched by pairing
+ * their elements in any order by `CMatcher`.  Other lists are matched
+ * element by element.
+ *
+ * Where a match can go more than one way, a `Choice` is pushed on the
+ * context, and the search comes back to it when the rest of the match fails
+ * or the next match is wanted.  A `Result` resumes the search each time it
+ * is advanced, so only the matches that are used are ever found.
  */
 class Matcher {
 public:
-	Matcher();
-	virtual ~Matcher();
+	/**
+	 * Make a new matcher.
+	 * @param fact	The factory that made the terms to match.  It is used to
+	 * 				evaluate guards.
+	 */
+	explicit Matcher(term::TermFactory const& fact);
+
+	/**
+	 * Try to match a pattern against a subject, stopping at the first match.
+	 * Any binds already in the context are respected, and on success the
+	 * context holds the binds of the match, along with the choice points
+	 * needed to find the next one with `next_match`.  On failure the binds
+	 * in the context are not meaningful.
+	 * @param pattern	The pattern.
+	 * @param subject	The subject.
+	 * @param context	The context.
+	 * @return	True iff the pattern matches the subject.
+	 */
+	bool try_match(term::pTerm const& pattern, term::pTerm const& subject,
+			Context& context) const;
+
+	/**
+	 * Match the goals in a context, stopping at the first match.  The goals
+	 * are matched newest first, and the search backtracks to the choice
+	 * points in the context as needed.
+	 * @param context	The context.
+	 * @return	True iff there is a match.
+	 */
+	bool run(Context& context) const;
+
+	/**
+	 * Find the next match, after `try_match` or `run` has found one, by
+	 * resuming the search from the newest choice point.
+	 * @param context	The context.
+	 * @return	True iff there is another match.
+	 */
+	bool next_match(Context& context) const;
+
+	/**
+	 * Match a pattern against a subject.  Nothing is matched until the
+	 * result is asked for a match.
+	 * @param pattern	The pattern.
+	 * @param subject	The subject.
+	 * @param binds		Binds that any match must respect.
+	 * @return	The matches.
+	 */
+	Result match(term::pTerm const& pattern, term::pTerm const& subject,
+			term::BindMap const& binds = term::BindMap()) const;
+
+	/**
+	 * Match the goals in a context.  Nothing is matched until the result is
+	 * asked for a match.
+	 * @param context	The context, which the result takes over.
+	 * @return	The matches.
+	 */
+	Result match(Context&& context) const;
+
+	/**
+	 * Determine whether two terms are equal, trying the cheap tests first.
+	 * @param first		The first term.
+	 * @param second	The second term.
+	 * @return	True iff the terms are equal.
+	 */
+	static inline bool same(term::ITerm const& first,
+			term::ITerm const& second) {
+		return &first == &second || (first.feq(second) && first == second);
+	}
+
+	/**
+	 * Make the quick checks that rule out a match, without binding anything.
+	 * If this is false, the pattern certainly does not match the subject.
+	 * @param pattern	The pattern.
+	 * @param subject	The subject.
+	 * @return	False if the pattern cannot match the subject.
+	 */
+	static bool could_match(term::pTerm const& pattern,
+			term::pTerm const& subject);
+
+private:
+	/**
+	 * Match one goal, adding any goals for its children.
+	 * @param pattern	The pattern.
+	 * @param subject	The subject.
+	 * @param context	The context.
+	 * @return	False if the goal certainly cannot match.
+	 */
+	bool step(term::pTerm const& pattern, term::pTerm const& subject,
+			Context& context) const;
+
+	/**
+	 * Match the type of a pattern against the type of its subject.  Types
+	 * that need no matching are checked at once, and the rest are added as
+	 * goals.
+	 * @param pattern	The pattern type.
+	 * @param subject	The subject type.
+	 * @param context	The context.
+	 * @return	False if the types certainly cannot match.
+	 */
+	bool step_type(term::pTerm const& pattern, term::pTerm const& subject,
+			Context& context) const;
+
+	/**
+	 * Bind a variable to a subject.
+	 * @param name		The name of the variable.
+	 * @param guard		The guard of the variable.
+	 * @param subject	The subject.
+	 * @param context	The context.
+	 * @return	False if the variable cannot be bound to the subject.
+	 */
+	bool bind(Atom name, term::pTerm const& guard, term::pTerm const& subject,
+			Context& context) const;
 
+	/**
+	 * Match a child of a pattern against the child of its subject.  A child
+	 * without variables is compared at once, and any other is added as a
+	 * goal.
+	 * @param pattern	The pattern child.
+	 * @param subject	The subject child.
+	 * @param context	The context.
+	 * @return	False if the children certainly cannot match.
+	 */
+	static inline bool goal(term::pTerm const& pattern,
+			term::pTerm const& subject, Context& context) {
+		if (!pattern->get_summary().has_variables()) {
+			return same(*pattern, *subject);
+		}
+		context.push(pattern, subject);
+		return true;
+	}
 
+	term::TermFactory const& fact_;
 };
 
 } /* namespace match */
@@ -0,0 +1,271 @@
+/**
+ * @file
+ * Implement patterns compiled into instructions for matching.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <match/Program.h>
+#include <term/IApply.h>
+#include <term/IList.h>
+#include <term/IVariable.h>
+#include <algorithm>
+
+namespace elision {
+namespace match {
+
+using namespace elision::term;
+
+Program::Program(TermFactory const& fact, pTerm const& pattern) :
+		pattern_(pattern), registers_(1),
+		signature_(0), deferred_(0) {
+	NOTNULL(pattern);
+	signature_ = deferred_signature(pattern);
+	compile(fact, pattern, 0);
+}
+
+bool
+Program::run(TermFactory const& fact, pTerm const& subject,
+		Context& context) const {
+	NOTNULL(subject);
+	Matcher matcher(fact);
+	if (context.size() != 0) {
+		return matcher.try_match(pattern_, subject, context);
+	}
+	context.drop_goals();
+	context.drop_choices();
+	pTerm inline_registers[INLINE_REGISTERS];
+	std::vector<pTerm> spill;
+	pTerm* regs = inline_registers;
+	if (registers_ > INLINE_REGISTERS) {
+		spill.resize(registers_);
+		regs = spill.data();
+	}
+	regs[0] = subject;
+	for (auto const& in : code_) {
+		switch (in.op) {
+		case KIND:
+			if (regs[in.reg]->get_kind() != static_cast<TermKind>(in.arg)) {
+				return false;
+			}
+			break;
+
+		case DEPTH:
+			if (regs[in.reg]->get_depth() < in.arg) return false;
+			break;
+
+		case SAME:
+			if (!Matcher::same(*constants_[in.arg], *regs[in.reg])) return false;
+			break;
+
+		case TYPE:
+			if (!Matcher::same(*constants_[in.arg],
+					*regs[in.reg]->get_type())) {
+				return false;
+			}
+			break;
+
+		case OPERATOR:
+			regs[in.arg] = kind_cast<IApply>(*regs[in.reg]).get_operator();
+			break;
+
+		case ARGUMENT:
+			regs[in.arg] = kind_cast<IApply>(*regs[in.reg]).get_argument();
+			break;
+
+		case LIST: {
+			auto const& list = kind_cast<IList>(*regs[in.reg]);
+			auto const& plist = kind_cast<IList>(*constants_[in.arg]);
+			if (list.size() != plist.size() || !Matcher::same(
+					*plist.get_property_specification(),
+					*list.get_property_specification())) {
+				return false;
+			}
+			break;
+		}
+
+		case ELEMENTS: {
+			uint32_t at = in.arg;
+			for (auto const& element : kind_cast<IList>(*regs[in.reg])) {
+				regs[at++] = element;
+			} // Load every element.
+			break;
+		}
+
+		case BIND:
+			context.bind(names_[in.arg], regs[in.reg]);
+			break;
+
+		case COMPARE:
+			if (!Matcher::same(*context[in.arg].term, *regs[in.reg])) {
+				return false;
+			}
+			break;
+
+		case GUARD: {
+			Locus loc = Loc::get_internal();
+			pTerm value = fact.apply(loc,
+					fact.get_binding(loc, context.get_map()),
+					constants_[in.arg]);
+			if (!value->is_true()) return false;
+			break;
+		}
+
+		case DEFER:
+			context.push(constants_[in.arg], regs[in.reg]);
+			break;
+		}
+	} // Run every instruction.
+	return deferred_ == 0 || matcher.run(context);
+}
+
+std::ostream&
+Program::write(std::ostream& out) const {
+	static char const* const names[] = {
+		"KIND", "DEPTH", "SAME", "TYPE", "OPERATOR", "ARGUMENT", "LIST",
+		"ELEMENTS", "BIND", "COMPARE", "GUARD", "DEFER",
+	};
+	for (auto const& in : code_) {
+		out << names[in.op] << ' ' << in.reg << ' ' << in.arg << std::endl;
+	} // Write every instruction.
+	return out;
+}
+
+bool
+Program::defers(pTerm const& pattern) const {
+	if (pattern->get_type()->get_summary().has_variables()) return true;
+	switch (pattern->get_kind()) {
+	case VARIABLE_KIND:
+	case APPLY_KIND:
+		return false;
+
+	case LIST_KIND: {
+		auto spec = kind_cast<IList>(*pattern).get_property_specification();
+		return spec->has_flags(IPropertySpecification::ASSOCIATIVE) ||
+				spec->has_flags(IPropertySpecification::COMMUTATIVE);
+	}
+
+	default:
+		return true;
+	}
+}
+
+uint32_t
+Program::deferred_signature(pTerm const& pattern) const {
+	TermSummary summary = pattern->get_summary();
+	if (!summary.has_variables()) return 0;
+	if (defers(pattern)) return summary.get_signature();
+	uint32_t signature = 0;
+	switch (pattern->get_kind()) {
+	case APPLY_KIND: {
+		auto const& apply = kind_cast<IApply>(*pattern);
+		signature |= deferred_signature(apply.get_operator());
+		signature |= deferred_signature(apply.get_argument());
+		break;
+	}
+
+	case LIST_KIND:
+		for (auto const& element : kind_cast<IList>(*pattern)) {
+			signature |= deferred_signature(element);
+		} // Check every element.
+		break;
+
+	default:
+		break;
+	}
+	return signature;
+}
+
+void
+Program::compile(TermFactory const& fact, pTerm const& pattern,
+		uint32_t reg) {
+	// A part without variables matches only itself, and a part the
+	// instructions cannot decide is left to the matcher.
+	if (!pattern->get_summary().has_variables()) {
+		emit(SAME, reg, constant(pattern));
+		return;
+	}
+	if (defers(pattern)) {
+		emit(DEFER, reg, constant(pattern));
+		++deferred_;
+		return;
+	}
+
+	// Variables bind the first time they are seen, and compare after that.
+	// The matcher takes children last to first, so the binds are made in the
+	// same order here.
+	TermKind kind = pattern->get_kind();
+	if (kind == VARIABLE_KIND) {
+		auto const& var = kind_cast<IVariable>(*pattern);
+		Atom name = var.get_atom();
+		if ((TermSummary::signature_of(name) & signature_) != 0) {
+			emit(DEFER, reg, constant(pattern));
+			++deferred_;
+			return;
+		}
+		compile_type(fact, pattern->get_type(), reg);
+		auto here = std::find(names_.begin(), names_.end(), name);
+		if (here != names_.end()) {
+			emit(COMPARE, reg, here - names_.begin());
+			return;
+		}
+		emit(BIND, reg, names_.size());
+		names_.push_back(name);
+		if (!var.get_guard()->is_true()) {
+			emit(GUARD, 0, constant(var.get_guard()));
+		}
+		return;
+	}
+	emit(KIND, reg, kind);
+	if (kind == LIST_KIND) {
+		auto const& list = kind_cast<IList>(*pattern);
+		compile_type(fact, pattern->get_type(), reg);
+		emit(LIST, reg, constant(pattern));
+		emit(DEPTH, reg, pattern->get_depth());
+		uint32_t first = registers_;
+		registers_ += list.size();
+		emit(ELEMENTS, reg, first);
+		for (size_t index = list.size(); index > 0; --index) {
+			compile(fact, list[index - 1], first + index - 1);
+		} // Compile every element.
+		return;
+	}
+	auto const& apply = kind_cast<IApply>(*pattern);
+	emit(DEPTH, reg, pattern->get_depth());
+	compile_type(fact, pattern->get_type(), reg);
+	uint32_t op = registers_++;
+	uint32_t arg = registers_++;
+	emit(OPERATOR, reg, op);
+	emit(ARGUMENT, reg, arg);
+	compile(fact, apply.get_argument(), arg);
+	compile(fact, apply.get_operator(), op);
+}
+
+void
+Program::compile_type(TermFactory const& fact, pTerm const& type,
+		uint32_t reg) {
+	if (type != fact.ANY && !Matcher::same(*type, *fact.ANY)) {
+		emit(TYPE, reg, constant(type));
+	}
+}
+
+uint32_t
+Program::constant(pTerm const& term) {
+	constants_.push_back(term);
+	return constants_.size() - 1;
+}
+
+} /* namespace match */
+} /* namespace elision */
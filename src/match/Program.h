@@ -0,0 +1,199 @@
+#ifndef PROGRAM_H_
+#define PROGRAM_H_
+
+/**
+ * @file
+ * Define patterns compiled into instructions for matching.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include <match/Matcher.h>
+#include <term/TermFactory.h>
+
+namespace elision {
+namespace match {
+
+/**
+ * A pattern compiled, once, into a sequence of instructions that match it
+ * against a subject.  Matching a pattern tree decides again, on every
+ * attempt, which checks each part of the pattern needs; the program has
+ * made those decisions already, so running it only makes the checks.
+ *
+ * The subject and the subterms taken from it are held in numbered
+ * registers, and register zero holds the subject.  The instructions are:
+ *   - `KIND r k`: the term in `r` must have kind `k`;
+ *   - `DEPTH r d`: the term in `r` must be at least `d` deep;
+ *   - `SAME r c`: the term in `r` must equal the constant `c`;
+ *   - `TYPE r c`: the type of the term in `r` must equal the constant `c`;
+ *   - `OPERATOR r s` and `ARGUMENT r s`: load a part of the application in
+ *     `r` into `s`;
+ *   - `LIST r c`: the list in `r` must have the properties and length of
+ *     the list `c`;
+ *   - `ELEMENTS r s`: load the elements of the list in `r` into `s` and the
+ *     registers after it;
+ *   - `BIND r n`: bind the name `n` to the term in `r`;
+ *   - `COMPARE r b`: the term in `r` must equal the term of the bind `b`;
+ *   - `GUARD c`: the guard `c` must be true given the binds so far;
+ *   - `DEFER r c`: leave the pattern `c` and the term in `r` to a
+ *     `Matcher`.
+ * Each instruction is a check or a load, there are no jumps, and the first
+ * failed check ends the run.
+ *
+ * Whatever a syntactic match cannot decide alone is deferred: lists that
+ * are associative or commutative, kinds such as lambdas and term
+ * variables, and terms whose types hold variables.  A variable that might
+ * also occur in a deferred part, judged by the signatures of the deferred
+ * parts, is deferred too, so every name is bound in only one place.  Once
+ * the instructions are done, the deferred goals are matched by the
+ * matcher, which may backtrack among them.
+ */
+class Program {
+public:
+	/**
+	 * Compile a pattern.
+	 * @param fact		A factory for the pattern.  It is used only while
+	 * 					compiling, and is not kept.
+	 * @param pattern	The pattern.
+	 */
+	Program(term::TermFactory const& fact, term::pTerm const& pattern);
+
+	/**
+	 * Match the pattern against a subject, stopping at the first match.  On
+	 * success, the context holds the binds of the match.  On failure the
+	 * binds in the context are not meaningful.  If the context already
+	 * holds binds, the pattern is matched by the matcher instead.  Further
+	 * matches are found by `Matcher::next_match` on the context.
+	 * @param fact		The factory used to match and to evaluate guards.
+	 * @param subject	The subject.
+	 * @param context	The context.
+	 * @return	True iff the pattern matches the subject.
+	 */
+	bool run(term::TermFactory const& fact, term::pTerm const& subject,
+			Context& context) const;
+
+	/**
+	 * Get the pattern.
+	 * @return	The pattern.
+	 */
+	inline term::pTerm const& get_pattern() const {
+		return pattern_;
+	}
+
+	/**
+	 * Get the number of instructions.
+	 * @return	The number of instructions.
+	 */
+	inline size_t size() const {
+		return code_.size();
+	}
+
+	/**
+	 * Get the number of instructions that defer to the matcher.
+	 * @return	The number of deferred goals.
+	 */
+	inline size_t deferred() const {
+		return deferred_;
+	}
+
+	/**
+	 * Write the instructions, one per line, for debugging.
+	 * @param out	The stream to write.
+	 * @return	The stream.
+	 */
+	std::ostream& write(std::ostream& out) const;
+
+private:
+	/// The operations.
+	enum Op : uint8_t {
+		KIND, DEPTH, SAME, TYPE, OPERATOR, ARGUMENT, LIST, ELEMENTS, BIND,
+		COMPARE, GUARD, DEFER,
+	};
+
+	/// An instruction: an operation, a register, and an operand.
+	struct Instruction {
+		Op op;
+		uint32_t reg;
+		uint32_t arg;
+	};
+
+	/// Registers held on the stack while running.
+	static constexpr size_t INLINE_REGISTERS = 16;
+
+	/**
+	 * Determine whether a part of the pattern must be left to the matcher.
+	 * @param pattern	The part, which has variables.
+	 * @return	True iff the part is deferred.
+	 */
+	bool defers(term::pTerm const& pattern) const;
+
+	/**
+	 * Find the signature of the names in the parts that are deferred.
+	 * @param pattern	The pattern.
+	 * @return	The union of the signatures of the deferred parts.
+	 */
+	uint32_t deferred_signature(term::pTerm const& pattern) const;
+
+	/**
+	 * Compile a part of the pattern.
+	 * @param fact		The factory.
+	 * @param pattern	The part.
+	 * @param reg		The register that will hold its subject.
+	 */
+	void compile(term::TermFactory const& fact, term::pTerm const& pattern,
+			uint32_t reg);
+
+	/**
+	 * Compile the check of a type.
+	 * @param fact	The factory.
+	 * @param type	The pattern type, which has no variables.
+	 * @param reg	The register that will hold the subject.
+	 */
+	void compile_type(term::TermFactory const& fact, term::pTerm const& type,
+			uint32_t reg);
+
+	/**
+	 * Add a constant.
+	 * @param term	The constant.
+	 * @return	Its index.
+	 */
+	uint32_t constant(term::pTerm const& term);
+
+	/**
+	 * Add an instruction.
+	 * @param op	The operation.
+	 * @param reg	The register.
+	 * @param arg	The operand.
+	 */
+	inline void emit(Op op, uint32_t reg, uint32_t arg) {
+		code_.push_back(Instruction{ op, reg, arg });
+	}
+
+	term::pTerm pattern_;
+	std::vector<Instruction> code_;
+	std::vector<term::pTerm> constants_;
+	std::vector<Atom> names_;			//< The names bound, in order.
+	uint32_t registers_;				//< The number of registers used.
+	uint32_t signature_;				//< The signature of deferred parts.
+	size_t deferred_;
+};
+
+} /* namespace match */
+} /* namespace elision */
+
+#endif /* PROGRAM_H_ */
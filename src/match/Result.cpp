@@ -18,36 +18,98 @@
  */
 
 #include <match/Result.h>
+#include <match/Matcher.h>
+#include <limits>
 
 namespace elision {
 namespace match {
 
-Result::Result() {
-	// TODO Auto-generated constructor stub
-}
+/**
+ * The state of a search: the context to resume from, and the match found
+ * last.
+ */
+struct Result::Search {
+	Search(Matcher const& the_matcher, Context&& the_context) :
+		matcher(the_matcher), context(std::move(the_context)),
+		limit(std::numeric_limits<size_t>::max()), count(0),
+		started(false), found(false) {}
+
+	/**
+	 * Find the next match.
+	 * @return	True if there was another match.
+	 */
+	bool advance() {
+		if (count >= limit) {
+			found = false;
+		} else if (!started) {
+			found = matcher.run(context);
+		} else {
+			found = matcher.next_match(context);
+		}
+		started = true;
+		if (found) {
+			current = context.get_map();
+			++count;
+		}
+
+		// Release the search as soon as it cannot go on.
+		if (!found || count >= limit) context.clear();
+		return found;
+	}
+
+	/**
+	 * Find the first match, if it has not been found.
+	 */
+	inline void start() {
+		if (!started) advance();
+	}
 
-Result::~Result() {
-	// TODO Auto-generated destructor stub
+	Matcher matcher;
+	Context context;
+	map_t current;
+	size_t limit;
+	size_t count;
+	bool started;
+	bool found;
+};
+
+Result::Result(Matcher const& matcher, Context&& context) :
+	search_(std::make_shared<Search>(matcher, std::move(context))) {
 }
 
 bool
 Result::have_match() const {
-	return false;
+	search_->start();
+	return search_->count > 0;
 }
 
-Result::const_iterator::const_iterator() {
+Result&
+Result::limit(size_t count) {
+	search_->limit = count;
+	return *this;
 }
 
 Result::const_iterator
 Result::begin() const {
-	return *(new Result::const_iterator());
+	search_->start();
+	return search_->found ? const_iterator(search_) : end();
 }
 
-Result::const_iterator
-Result::end() const {
-	return *(new Result::const_iterator());
+Result::const_iterator&
+Result::const_iterator::operator++() {
+	if (!search_->advance()) search_.reset();
+	return *this;
 }
 
+Result::map_t const&
+Result::const_iterator::operator*() const {
+	return search_->current;
+}
+
+Result::map_t const*
+Result::const_iterator::operator->() const {
+	return &search_->current;
+}
 
 } /* namespace match */
 } /* namespace elision */
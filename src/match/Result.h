@@ -20,29 +20,47 @@
  * @endverbatim
  */
 
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <term/IBinding.h>
 
 namespace elision {
 namespace match {
 
+class Context;
+class Matcher;
 
 /**
  * Get the results of a match.  This class provides methods to check whether
  * there are any matches (`empty`) and to iterate over the matches
  * (`begin` and `end`).  Since the matches are generated on demand, there is
  * no way to get the count of matches //a priori//.
+ *
+ * Nothing is matched until a match is asked for.  Each step of the iterator
+ * then resumes the search from the choice point where the last match was
+ * found, so a caller that stops early never pays for the rest of the
+ * search.  To stop even earlier, use `limit` before iterating; once the
+ * limit is reached the search state is released at once.  With `first`
+ * only one match is ever sought.
+ *
+ * The matches can be visited only once.  Copies of a result share the
+ * search, as do all of its iterators, so advancing one advances them all.
  */
 class Result {
 public:
-	/// Deallocate this instance.
-	virtual ~Result();
+	/**
+	 * The type for the returned matches.
+	 */
+	typedef elision::term::IBinding::map_t map_t;
 
 	/**
 	 * Determine if there are any matches available.  If this returns true, then
-	 * the iterator is guaranteed to return at least one match.
+	 * the iterator is guaranteed to return at least one match.  This finds
+	 * the first match, if it has not been found.
 	 * @return	True if there are any matches.  False if there are not.
 	 */
-	virtual bool have_match() const;
+	bool have_match() const;
 
 	/**
 	 * Determine if there are any matches available.  If this returns false,
@@ -52,46 +70,81 @@ public:
 	bool empty() const { return !have_match(); }
 
 	/**
-	 * The type for the returned matches.
+	 * Stop after a number of matches have been found.  This must be used
+	 * before iterating.
+	 * @param count	The most matches to find.
+	 * @return	This result.
 	 */
-	typedef elision::term::IBinding::map_t map_t;
+	Result& limit(size_t count);
 
 	/**
-	 * Implement an iterator over matches.
+	 * Stop after the first match is found.
+	 * @return	This result.
 	 */
-	class const_iterator : public std::iterator<std::forward_iterator_tag, map_t> {
+	inline Result& first() {
+		return limit(1);
+	}
+
+	/// The search for matches.
+	struct Search;
+
+	/**
+	 * Implement an iterator over matches.  This is a single-pass iterator.
+	 */
+	class const_iterator : public std::iterator<std::input_iterator_tag, map_t> {
 	public:
 		/**
-		 * Make a new instance.
+		 * Make a new instance that points past the last match.
 		 */
-		const_iterator();
+		const_iterator() = default;
+
+		/**
+		 * Make a new instance that points to the current match of a search.
+		 * @param search	The search.
+		 */
+		explicit const_iterator(std::shared_ptr<Search> const& search) :
+			search_(search) {}
+
 		const_iterator & operator++();
-		const_iterator & operator++(int);
 		map_t const& operator*() const;
 		map_t const* operator->() const;
-		bool operator==(const_iterator const& other) const;
+		inline bool operator==(const_iterator const& other) const {
+			return search_ == other.search_;
+		}
 		bool operator!=(const_iterator const& other) const {
 			return !operator==(other);
 		}
 
 	private:
+		std::shared_ptr<Search> search_;
 	};
 
 	/**
-	 * Get an iterator pointing to the first match, if any.
+	 * Get an iterator pointing to the first match, if any.  This finds the
+	 * first match, if it has not been found.
 	 * @return	An iterator.
 	 */
-	virtual const_iterator begin() const;
+	const_iterator begin() const;
 
 	/**
 	 * Get an iterator pointing past the last match, if any.
 	 * @return	An iterator.
 	 */
-	virtual const_iterator end() const;
+	inline const_iterator end() const {
+		return const_iterator();
+	}
 
 private:
 	friend class Matcher;
-	Result();
+
+	/**
+	 * Make a result that searches for the matches of the goals in a context.
+	 * @param matcher	The matcher to use.
+	 * @param context	The context, which is taken over.
+	 */
+	Result(Matcher const& matcher, Context&& context);
+
+	std::shared_ptr<Search> search_;
 };
 
 } /* namespace match */
@@ -0,0 +1,204 @@
+/**
+ * @file
+ * Implement an index that finds the rules that might rewrite a term.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <match/RuleIndex.h>
+#include <match/Matcher.h>
+#include <term/IApply.h>
+#include <term/IList.h>
+#include <algorithm>
+
+namespace elision {
+namespace match {
+
+using namespace elision::term;
+
+RuleIndex::RuleIndex() : size_(0), serial_(0) {}
+
+void
+RuleIndex::insert(pLambda const& rule) {
+	NOTNULL(rule);
+	std::vector<Symbol> symbols;
+	encode(rule->get_lhs(), symbols);
+	Node* node = &root_;
+	for (auto const& symbol : symbols) {
+		std::unique_ptr<Node>& next = symbol.shape == STAR ? node->star :
+				node->children[symbol];
+		if (next == nullptr) next.reset(new Node());
+		node = next.get();
+	} // Follow the string, adding nodes.
+	node->rules.push_back(Entry{ serial_++, rule });
+	++size_;
+}
+
+bool
+RuleIndex::erase(pLambda const& rule) {
+	NOTNULL(rule);
+	std::vector<Symbol> symbols;
+	encode(rule->get_lhs(), symbols);
+	std::vector<Node*> path{ &root_ };
+	for (auto const& symbol : symbols) {
+		Node* node = path.back();
+		Node* next = nullptr;
+		if (symbol.shape == STAR) {
+			next = node->star.get();
+		} else {
+			auto found = node->children.find(symbol);
+			if (found != node->children.end()) next = found->second.get();
+		}
+		if (next == nullptr) return false;
+		path.push_back(next);
+	} // Follow the string.
+	auto& rules = path.back()->rules;
+	auto here = std::find_if(rules.begin(), rules.end(),
+			[&rule](Entry const& entry) {
+		return Matcher::same(*entry.rule, *rule);
+	});
+	if (here == rules.end()) return false;
+	rules.erase(here);
+	--size_;
+
+	// Remove the nodes left empty, from the end of the string back.
+	for (size_t index = symbols.size(); index > 0 && path[index]->empty();
+			--index) {
+		Node& parent = *path[index - 1];
+		if (symbols[index - 1].shape == STAR) parent.star.reset();
+		else parent.children.erase(symbols[index - 1]);
+	} // Prune the path.
+	return true;
+}
+
+std::vector<pLambda>
+RuleIndex::candidates(pTerm const& subject) const {
+	NOTNULL(subject);
+	std::vector<pTerm> pending{ subject };
+	std::vector<Entry const*> found;
+	collect(root_, pending, found);
+	std::sort(found.begin(), found.end(),
+			[](Entry const* first, Entry const* second) {
+		return first->serial < second->serial;
+	});
+	std::vector<pLambda> rules;
+	rules.reserve(found.size());
+	for (auto entry : found) rules.push_back(entry->rule);
+	return rules;
+}
+
+void
+RuleIndex::encode(pTerm const& pattern, std::vector<Symbol>& symbols) {
+	TermKind kind = pattern->get_kind();
+	switch (kind) {
+	case VARIABLE_KIND:
+	case TERM_VARIABLE_KIND:
+		symbols.push_back(Symbol{ kind, STAR, 0, Fingerprint() });
+		return;
+
+	case APPLY_KIND: {
+		auto const& apply = kind_cast<IApply>(*pattern);
+		symbols.push_back(Symbol{ kind, NODE, 2, Fingerprint() });
+		encode(apply.get_operator(), symbols);
+		encode(apply.get_argument(), symbols);
+		return;
+	}
+
+	case LIST_KIND: {
+		// Only lists matched element by element index their elements.
+		auto const& list = kind_cast<IList>(*pattern);
+		auto spec = list.get_property_specification();
+		if (spec->has_flags(IPropertySpecification::ASSOCIATIVE) ||
+				spec->has_flags(IPropertySpecification::COMMUTATIVE)) {
+			symbols.push_back(Symbol{ kind, OPAQUE, 0,
+				spec->get_fingerprint() });
+			return;
+		}
+		symbols.push_back(Symbol{ kind, NODE, list.size(),
+			spec->get_fingerprint() });
+		for (auto const& element : list) encode(element, symbols);
+		return;
+	}
+
+	default:
+		break;
+	} // Handle the kinds with children.
+	if (pattern->get_summary().has_variables()) {
+		symbols.push_back(Symbol{ kind, OPAQUE, 0, Fingerprint() });
+	} else {
+		symbols.push_back(Symbol{ kind, LEAF, 0, pattern->get_fingerprint() });
+	}
+}
+
+void
+RuleIndex::collect(Node const& node, std::vector<pTerm>& pending,
+		std::vector<Entry const*>& found) {
+	if (pending.empty()) {
+		for (auto const& entry : node.rules) found.push_back(&entry);
+		return;
+	}
+	pTerm term = pending.back();
+	pending.pop_back();
+
+	// A wildcard skips the subterm.
+	if (node.star != nullptr) collect(*node.star, pending, found);
+	if (node.children.empty()) {
+		pending.push_back(term);
+		return;
+	}
+
+	// Follow the edges keyed by the subterm.
+	TermKind kind = term->get_kind();
+	Node const* next;
+	if (kind == APPLY_KIND) {
+		next = child(node, Symbol{ kind, NODE, 2, Fingerprint() });
+		if (next != nullptr) {
+			auto const& apply = kind_cast<IApply>(*term);
+			pending.push_back(apply.get_argument());
+			pending.push_back(apply.get_operator());
+			collect(*next, pending, found);
+			pending.resize(pending.size() - 2);
+		}
+	} else if (kind == LIST_KIND) {
+		auto const& list = kind_cast<IList>(*term);
+		Fingerprint print = list.get_property_specification()->get_fingerprint();
+		next = child(node, Symbol{ kind, OPAQUE, 0, print });
+		if (next != nullptr) collect(*next, pending, found);
+		next = child(node, Symbol{ kind, NODE, list.size(), print });
+		if (next != nullptr) {
+			size_t base = pending.size();
+			pending.resize(base + list.size());
+			size_t index = pending.size();
+			for (auto const& element : list) pending[--index] = element;
+			collect(*next, pending, found);
+			pending.resize(base);
+		}
+	} else {
+		next = child(node, Symbol{ kind, LEAF, 0, term->get_fingerprint() });
+		if (next != nullptr) collect(*next, pending, found);
+		next = child(node, Symbol{ kind, OPAQUE, 0, Fingerprint() });
+		if (next != nullptr) collect(*next, pending, found);
+	}
+	pending.push_back(term);
+}
+
+RuleIndex::Node const*
+RuleIndex::child(Node const& node, Symbol const& symbol) {
+	auto found = node.children.find(symbol);
+	return found == node.children.end() ? nullptr : found->second.get();
+}
+
+} /* namespace match */
+} /* namespace elision */
@@ -0,0 +1,185 @@
+#ifndef RULEINDEX_H_
+#define RULEINDEX_H_
+
+/**
+ * @file
+ * Define an index that finds the rules that might rewrite a term.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <term/ILambda.h>
+#include <Fingerprint.h>
+
+namespace elision {
+namespace match {
+
+/**
+ * Index a collection of lambdas by the shape of their patterns, so the
+ * lambdas whose patterns might match a subject are found without trying
+ * every lambda.  This is a discrimination tree.
+ *
+ * Each pattern is read in preorder as a string of symbols, and the strings
+ * are stored in a tree that shares their common prefixes:
+ *   - a variable is a wildcard, which stands for a whole subterm;
+ *   - an application is a node whose operator and argument follow;
+ *   - a list matched element by element is a node, keyed by its properties
+ *     and length, whose elements follow;
+ *   - a list that is associative or commutative is keyed only by its
+ *     properties, and its elements are not indexed;
+ *   - any other term is keyed by its fingerprint if it has no variables,
+ *     and only by its kind if it does.
+ * Types and guards are not indexed.
+ *
+ * A lookup walks the subject in preorder along the tree, following each
+ * edge the current subterm could take: the wildcard edge, which skips the
+ * subterm, and the edges keyed by the subterm itself.  The work depends on
+ * the size of the subject and the number of candidates, not the number of
+ * lambdas.  Every lambda that matches is a candidate, but candidates may
+ * still fail to match, so they must be tried.  Candidates are returned in
+ * the order the lambdas were added.
+ *
+ * Lambdas can be added and removed at any time.
+ */
+class RuleIndex {
+public:
+	/// Make an empty index.
+	RuleIndex();
+
+	/**
+	 * Add a lambda.  A lambda may be added more than once.
+	 * @param rule	The lambda.
+	 */
+	void insert(term::pLambda const& rule);
+
+	/**
+	 * Remove a lambda.  If it was added more than once, the oldest copy is
+	 * removed.
+	 * @param rule	The lambda.
+	 * @return	True if the lambda was found and removed.
+	 */
+	bool erase(term::pLambda const& rule);
+
+	/**
+	 * Find the lambdas whose patterns might match a subject.
+	 * @param subject	The subject.
+	 * @return	The candidates, in the order they were added.
+	 */
+	std::vector<term::pLambda> candidates(term::pTerm const& subject) const;
+
+	/**
+	 * Get the number of lambdas in the index.
+	 * @return	The number of lambdas.
+	 */
+	inline size_t size() const {
+		return size_;
+	}
+
+	/**
+	 * Determine whether the index is empty.
+	 * @return	True iff there are no lambdas.
+	 */
+	inline bool empty() const {
+		return size_ == 0;
+	}
+
+private:
+	/// How a symbol relates to the symbols after it.
+	enum Shape {
+		STAR,		//< A wildcard.
+		NODE,		//< The children follow.
+		LEAF,		//< A term without variables, keyed by fingerprint.
+		OPAQUE,		//< A term whose children are not indexed.
+	};
+
+	/// One step of the preorder string of a pattern.
+	struct Symbol {
+		term::TermKind kind;
+		Shape shape;
+		size_t arity;		//< The number of children that follow a node.
+		Fingerprint print;	//< The fingerprint of a leaf, or properties.
+
+		inline bool operator==(Symbol const& other) const {
+			return kind == other.kind && shape == other.shape &&
+					arity == other.arity && print == other.print;
+		}
+	};
+
+	/// Hash a symbol.
+	struct SymbolHash {
+		inline size_t operator()(Symbol const& symbol) const {
+			return static_cast<size_t>(symbol.print.low) * 31 +
+					(symbol.arity * 8 + symbol.shape) * 64 + symbol.kind;
+		}
+	};
+
+	/// A lambda, and when it was added.
+	struct Entry {
+		size_t serial;
+		term::pLambda rule;
+	};
+
+	/// A node of the tree.  The string to a node is the path to it.
+	struct Node {
+		std::unique_ptr<Node> star;		//< The wildcard child.
+		std::unordered_map<Symbol, std::unique_ptr<Node>, SymbolHash>
+			children;
+		std::vector<Entry> rules;		//< The lambdas whose string ends here.
+
+		inline bool empty() const {
+			return star == nullptr && children.empty() && rules.empty();
+		}
+	};
+
+	/**
+	 * Add the preorder string of a pattern to a vector.
+	 * @param pattern	The pattern.
+	 * @param symbols	The vector to add to.
+	 */
+	static void encode(term::pTerm const& pattern,
+			std::vector<Symbol>& symbols);
+
+	/**
+	 * Collect the lambdas below a node that might match the pending
+	 * subterms.
+	 * @param node		The node.
+	 * @param pending	The subterms still to walk, the next last.  This is
+	 * 					restored before returning.
+	 * @param found		The vector to add the candidates to.
+	 */
+	static void collect(Node const& node, std::vector<term::pTerm>& pending,
+			std::vector<Entry const*>& found);
+
+	/**
+	 * Find the child of a node along an edge.
+	 * @param node		The node.
+	 * @param symbol	The edge.
+	 * @return	The child, or null if there is no such edge.
+	 */
+	static Node const* child(Node const& node, Symbol const& symbol);
+
+	Node root_;
+	size_t size_;
+	size_t serial_;
+};
+
+} /* namespace match */
+} /* namespace elision */
+
+#endif /* RULEINDEX_H_ */
@@ -59,7 +59,7 @@ public:
 	void consume_whitespace();
 	void peek_and_consume(std::wstring str);
 
-	std::shared_ptr<Loc> loc() const;
+	Locus loc() const;
 
 	bool is_at_eof() const;
 
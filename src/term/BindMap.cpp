@@ -0,0 +1,204 @@
+/**
+ * @file
+ * Implement the persistent map from variable names to bound terms.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "BindMap.h"
+#include <algorithm>
+#include <new>
+
+namespace elision {
+namespace term {
+
+//======================================================================
+// Nodes.
+//======================================================================
+
+BindMap::Ptr
+BindMap::Node::copy(Node const* old, uint32_t datamap, uint32_t nodemap,
+		uint32_t bit, value_type const* entry, Ptr const* child) {
+	size_t entries = __builtin_popcount(datamap);
+	size_t children = __builtin_popcount(nodemap);
+	void* place = ::operator new(sizeof(Node) + entries * sizeof(value_type)
+			+ children * sizeof(Ptr));
+	Node* node = new (place) Node(datamap, nodemap);
+
+	// Every fragment but the replaced one comes from the old node.  None of
+	// these copies can throw.
+	value_type* next_entry = node->entries();
+	for (uint32_t rest = datamap; rest != 0; rest &= rest - 1) {
+		uint32_t here = rest & (~rest + 1);
+		new (next_entry++) value_type(here == bit && entry != nullptr ? *entry
+				: old->entries()[old->entry_index(here)]);
+	} // Copy all binds.
+	Ptr* next_child = node->children();
+	for (uint32_t rest = nodemap; rest != 0; rest &= rest - 1) {
+		uint32_t here = rest & (~rest + 1);
+		new (next_child++) Ptr(here == bit && child != nullptr ? *child
+				: old->children()[old->child_index(here)]);
+	} // Copy all children.
+	return Ptr(node);
+}
+
+void
+BindMap::Node::destroy(Node const* node) {
+	uint32_t entries = node->entry_count();
+	uint32_t children = node->child_count();
+	for (uint32_t index = 0; index < entries; ++index) {
+		node->entries()[index].~value_type();
+	} // Destroy all binds.
+	for (uint32_t index = 0; index < children; ++index) {
+		node->children()[index].~Ptr();
+	} // Destroy all children.
+	node->~Node();
+	::operator delete(const_cast<Node*>(node));
+}
+
+BindMap::Ptr
+BindMap::insert(Node const* node, uint32_t hash, unsigned shift,
+		value_type const& entry, bool& added) {
+	uint32_t datamap = node == nullptr ? 0 : node->datamap;
+	uint32_t nodemap = node == nullptr ? 0 : node->nodemap;
+	uint32_t bit = 1u << ((hash >> shift) & MASK);
+	if (datamap & bit) {
+		value_type const& old = node->entries()[node->entry_index(bit)];
+		if (old.first == entry.first) {
+			// Replace the bind, unless it is already there.
+			if (old.second == entry.second) return Ptr(node);
+			return Node::copy(node, datamap, nodemap, bit, &entry, nullptr);
+		}
+		// Two names share this fragment, so push both down into a child.
+		added = true;
+		Ptr child = merge(old, hash_of(old.first), entry, hash, shift + BITS);
+		return Node::copy(node, datamap & ~bit, nodemap | bit, bit, nullptr,
+				&child);
+	}
+	if (nodemap & bit) {
+		Node const* old = node->children()[node->child_index(bit)].get();
+		Ptr child = insert(old, hash, shift + BITS, entry, added);
+		if (child.get() == old) return Ptr(node);
+		return Node::copy(node, datamap, nodemap, bit, nullptr, &child);
+	}
+	added = true;
+	return Node::copy(node, datamap | bit, nodemap, bit, &entry, nullptr);
+}
+
+BindMap::Ptr
+BindMap::merge(value_type const& first, uint32_t first_hash,
+		value_type const& second, uint32_t second_hash, unsigned shift) {
+	// The hashes differ, so they must differ in some fragment.
+	uint32_t first_bit = 1u << ((first_hash >> shift) & MASK);
+	uint32_t second_bit = 1u << ((second_hash >> shift) & MASK);
+	if (first_bit == second_bit) {
+		Ptr child = merge(first, first_hash, second, second_hash,
+				shift + BITS);
+		return Node::copy(nullptr, 0, first_bit, first_bit, nullptr, &child);
+	}
+	Ptr half = Node::copy(nullptr, first_bit, 0, first_bit, &first, nullptr);
+	return Node::copy(half.get(), first_bit | second_bit, 0, second_bit,
+			&second, nullptr);
+}
+
+//======================================================================
+// Maps.
+//======================================================================
+
+BindMap
+BindMap::extend(Atom name, pTerm term) const {
+	NOTNULL(term);
+	bool added = false;
+	BindMap ret;
+	ret.root_ = insert(root_.get(), hash_of(name), 0,
+			value_type(name, term), added);
+	ret.size_ = size_ + (added ? 1 : 0);
+	ret.signature_ = signature_ | TermSummary::signature_of(name);
+	return ret;
+}
+
+std::vector<BindMap::value_type const*>
+BindMap::sorted() const {
+	std::vector<value_type const*> binds;
+	binds.reserve(size_);
+	for (auto const& entry : *this) binds.push_back(&entry);
+	std::sort(binds.begin(), binds.end(),
+			[](value_type const* first, value_type const* second) {
+		return name_less(first->first, second->first);
+	});
+	return binds;
+}
+
+bool
+BindMap::operator==(BindMap const& other) const {
+	if (root_ == other.root_) return true;
+	if (size_ != other.size_ || signature_ != other.signature_) return false;
+	for (auto const& entry : *this) {
+		pTerm const* found = other.find(entry.first);
+		if (found == nullptr) return false;
+		if (*found != entry.second && !(**found == *entry.second)) {
+			return false;
+		}
+	} // Loop over all binds.
+	return true;
+}
+
+bool
+BindMap::operator<(BindMap const& other) const {
+	auto mine = sorted();
+	auto theirs = other.sorted();
+	return std::lexicographical_compare(mine.begin(), mine.end(),
+			theirs.begin(), theirs.end(),
+			[](value_type const* first, value_type const* second) {
+		if (first->first != second->first) {
+			return name_less(first->first, second->first);
+		}
+		return *first->second < *second->second;
+	});
+}
+
+//======================================================================
+// Iteration.
+//======================================================================
+
+BindMap::const_iterator::const_iterator(Node const* root) : depth_(0),
+		here_(nullptr), limit_(nullptr) {
+	if (root == nullptr) return;
+	path_[depth_++] = Frame{ root, 0 };
+	here_ = root->entries();
+	limit_ = here_ + root->entry_count();
+	if (here_ == limit_) advance();
+}
+
+void
+BindMap::const_iterator::advance() {
+	while (depth_ > 0) {
+		Frame& top = path_[depth_ - 1];
+		if (top.next < top.node->child_count()) {
+			Node const* child = top.node->children()[top.next++].get();
+			path_[depth_++] = Frame{ child, 0 };
+			here_ = child->entries();
+			limit_ = here_ + child->entry_count();
+			if (here_ != limit_) return;
+		} else {
+			--depth_;
+		}
+	} // Search for a node with binds.
+	here_ = nullptr;
+	limit_ = nullptr;
+}
+
+} /* namespace term */
+} /* namespace elision */
@@ -0,0 +1,349 @@
+#ifndef BINDMAP_H_
+#define BINDMAP_H_
+
+/**
+ * @file
+ * Define the persistent map from variable names to bound terms.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <atomic>
+#include <boost/intrusive_ptr.hpp>
+#include <cstdint>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "Atom.h"
+#include "ITerm.h"
+
+namespace elision {
+namespace term {
+
+/**
+ * An immutable map from variable names to terms, held as a hash array mapped
+ * trie.  Extending a map returns a new map and leaves the original alone;
+ * the two share every node the extension did not touch, so a matcher can
+ * extend the binds along one branch and simply drop them to backtrack.
+ *
+ * Each node holds a bitmap of the hash fragments that end at a bind in that
+ * node, and another of the fragments that continue into a child node, with
+ * the binds and the children packed in order after the node.  A map with few
+ * binds is a single node holding them inline.  Both lookup and extension
+ * touch one node for each five bits of hash that are needed to tell the
+ * names apart, which is a single node for small maps.
+ *
+ * The hash of a name is a bijection of its atom identifier, so two different
+ * names always differ somewhere in their hashes and no collision handling is
+ * needed.
+ *
+ * The map also keeps the union of the summary signatures of its names, so
+ * that a substitution can skip the subterms that hold none of them.
+ *
+ * Nodes carry an atomic reference count, so maps may be shared between
+ * threads.  Iteration visits the binds in hash order; use `sorted` to visit
+ * them in order by name.
+ */
+class BindMap {
+private:
+	struct Node;
+
+public:
+	/// The type of a bind.
+	typedef std::pair<Atom, pTerm> value_type;
+
+	class const_iterator;
+
+	/// Make an empty map.
+	BindMap() : size_(0), signature_(0) {}
+
+	/**
+	 * Get the number of binds in this map.
+	 * @return	The number of binds.
+	 */
+	inline size_t size() const {
+		return size_;
+	}
+
+	/**
+	 * Determine whether this map is empty.
+	 * @return	True iff there are no binds.
+	 */
+	inline bool empty() const {
+		return size_ == 0;
+	}
+
+	/**
+	 * Get the union of the signatures of the names bound by this map.
+	 * @return	The signature.
+	 */
+	inline uint32_t get_signature() const {
+		return signature_;
+	}
+
+	/**
+	 * Find the term bound to a name.  This never throws.
+	 * @param name	The name.
+	 * @return	The bound term, or null if the name is not bound.  The pointer
+	 * 			is valid as long as this map is.
+	 */
+	inline pTerm const* find(Atom name) const {
+		uint32_t hash = hash_of(name);
+		Node const* node = root_.get();
+		while (node != nullptr) {
+			uint32_t bit = 1u << (hash & MASK);
+			if (node->datamap & bit) {
+				value_type const& entry = node->entries()[node->entry_index(bit)];
+				return entry.first == name ? &entry.second : nullptr;
+			}
+			if (!(node->nodemap & bit)) break;
+			node = node->children()[node->child_index(bit)].get();
+			hash >>= BITS;
+		} // Descend to the name.
+		return nullptr;
+	}
+
+	/**
+	 * Determine whether a name is bound.
+	 * @param name	The name.
+	 * @return	True iff the name is bound.
+	 */
+	inline bool contains(Atom name) const {
+		return find(name) != nullptr;
+	}
+
+	/**
+	 * Make a new map that binds a name to a term, replacing any bind for the
+	 * name.  This map is not changed.
+	 * @param name	The name.
+	 * @param term	The term.
+	 * @return	The new map.
+	 */
+	BindMap extend(Atom name, pTerm term) const;
+
+	/**
+	 * Get the binds of this map in order by name.
+	 * @return	The binds.  The pointers are valid as long as this map is.
+	 */
+	std::vector<value_type const*> sorted() const;
+
+	/**
+	 * Determine whether two maps bind the same names to equal terms.
+	 * @param other	The other map.
+	 * @return	True iff the maps are equal.
+	 */
+	bool operator==(BindMap const& other) const;
+
+	inline bool operator!=(BindMap const& other) const {
+		return !operator==(other);
+	}
+
+	/**
+	 * Order maps by their binds, in order by name.
+	 * @param other	The other map.
+	 * @return	True iff this map is less than the other.
+	 */
+	bool operator<(BindMap const& other) const;
+
+	/**
+	 * Get an iterator to the first bind.
+	 * @return	The iterator.
+	 */
+	const_iterator begin() const;
+
+	/**
+	 * Get an iterator past the last bind.
+	 * @return	The iterator.
+	 */
+	const_iterator end() const;
+
+private:
+	/// The number of bits of hash used at each level.
+	static constexpr unsigned BITS = 5;
+
+	/// The mask for one fragment of hash.
+	static constexpr uint32_t MASK = (1u << BITS) - 1;
+
+	/// The most levels a trie can have.
+	static constexpr unsigned LEVELS = (32 + BITS - 1) / BITS;
+
+	typedef boost::intrusive_ptr<Node const> Ptr;
+
+	/**
+	 * A node of the trie.  The binds and then the children are stored
+	 * directly after the node, in order of their hash fragments.
+	 */
+	struct alignas(value_type) Node {
+		mutable std::atomic<uint32_t> refs;
+		uint32_t datamap;	//< Fragments that end at a bind.
+		uint32_t nodemap;	//< Fragments that continue into a child.
+
+		Node(uint32_t data, uint32_t nodes) :
+			refs(0), datamap(data), nodemap(nodes) {}
+
+		inline uint32_t entry_count() const {
+			return __builtin_popcount(datamap);
+		}
+
+		inline uint32_t child_count() const {
+			return __builtin_popcount(nodemap);
+		}
+
+		inline uint32_t entry_index(uint32_t bit) const {
+			return __builtin_popcount(datamap & (bit - 1));
+		}
+
+		inline uint32_t child_index(uint32_t bit) const {
+			return __builtin_popcount(nodemap & (bit - 1));
+		}
+
+		inline value_type* entries() const {
+			return reinterpret_cast<value_type*>(
+					const_cast<Node*>(this) + 1);
+		}
+
+		inline Ptr* children() const {
+			return reinterpret_cast<Ptr*>(entries() + entry_count());
+		}
+
+		/**
+		 * Make a node, copying the binds and children of another node except
+		 * at one fragment.
+		 * @param old		The node to copy, or null for none.
+		 * @param datamap	The fragments of the new node's binds.
+		 * @param nodemap	The fragments of the new node's children.
+		 * @param bit		The fragment to replace.
+		 * @param entry		The bind to place at the fragment, if any.
+		 * @param child		The child to place at the fragment, if any.
+		 * @return	The new node.
+		 */
+		static Ptr copy(Node const* old, uint32_t datamap, uint32_t nodemap,
+				uint32_t bit, value_type const* entry, Ptr const* child);
+
+		/**
+		 * Destroy a node whose last reference is gone.
+		 * @param node	The node.
+		 */
+		static void destroy(Node const* node);
+
+		friend inline void intrusive_ptr_add_ref(Node const* node) {
+			node->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		friend inline void intrusive_ptr_release(Node const* node) {
+			if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				destroy(node);
+			}
+		}
+	};
+
+	/**
+	 * Get the hash of a name.  This is a bijection on identifiers.
+	 * @param name	The name.
+	 * @return	The hash.
+	 */
+	static inline uint32_t hash_of(Atom name) {
+		return name.get_id() * UINT32_C(0x9E3779B1);
+	}
+
+	static Ptr insert(Node const* node, uint32_t hash, unsigned shift,
+			value_type const& entry, bool& added);
+
+	static Ptr merge(value_type const& first, uint32_t first_hash,
+			value_type const& second, uint32_t second_hash, unsigned shift);
+
+	Ptr root_;
+	uint32_t size_;
+	uint32_t signature_;
+};
+
+/**
+ * Iterate over the binds of a map.  The iterator walks the binds held in
+ * each node, then descends into its children, keeping the path in a fixed
+ * array.
+ */
+class BindMap::const_iterator {
+public:
+	typedef std::forward_iterator_tag iterator_category;
+	typedef BindMap::value_type value_type;
+	typedef ptrdiff_t difference_type;
+	typedef value_type const* pointer;
+	typedef value_type const& reference;
+
+	inline value_type const& operator*() const {
+		return *here_;
+	}
+
+	inline value_type const* operator->() const {
+		return here_;
+	}
+
+	inline const_iterator& operator++() {
+		if (++here_ == limit_) advance();
+		return *this;
+	}
+
+	inline const_iterator operator++(int) {
+		const_iterator ret(*this);
+		operator++();
+		return ret;
+	}
+
+	inline bool operator==(const_iterator const& other) const {
+		return here_ == other.here_;
+	}
+
+	inline bool operator!=(const_iterator const& other) const {
+		return here_ != other.here_;
+	}
+
+private:
+	friend class BindMap;
+
+	/// A node on the path, and the next of its children to visit.
+	struct Frame {
+		Node const* node;
+		uint32_t next;
+	};
+
+	/**
+	 * Make an iterator at the first bind under a node.
+	 * @param root	The node, or null for the end.
+	 */
+	explicit const_iterator(Node const* root);
+
+	/// Move to the binds of the next node that has any.
+	void advance();
+
+	Frame path_[LEVELS];
+	unsigned depth_;
+	value_type const* here_;
+	value_type const* limit_;
+};
+
+inline BindMap::const_iterator
+BindMap::begin() const {
+	return const_iterator(root_.get());
+}
+
+inline BindMap::const_iterator
+BindMap::end() const {
+	return const_iterator(nullptr);
+}
+
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* BINDMAP_H_ */
@@ -0,0 +1,161 @@
+#ifndef DISPATCH_H_
+#define DISPATCH_H_
+
+/**
+ * @file
+ * Dispatch on the kind of a term, without dynamic type information.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/ITerm.h"
+#include "term/ILiteral.h"
+#include "term/IVariable.h"
+#include "term/IBinding.h"
+#include "term/ILambda.h"
+#include "term/IList.h"
+#include "term/IPropertySpecification.h"
+#include "term/ISpecialForm.h"
+#include "term/IApply.h"
+#include "term/IStaticMap.h"
+
+namespace elision {
+namespace term {
+
+/**
+ * Pass a term to the handler overload for its kind.  The term is passed as
+ * the interface for its kind (for example, an `IApply const&` for
+ * `APPLY_KIND`), and the root is passed as an `ITerm const&`.  The handler
+ * is typically a small struct with one `operator()` for each kind of
+ * interest, plus one taking `ITerm const&` (or a template) for the rest.
+ * Since the handler's type is known, the compiler can inline the overloads.
+ *
+ * ~~~{.cpp}
+ * struct Size {
+ *   size_t operator()(IList const& list) const {
+ *     return list.size();
+ *   }
+ *   size_t operator()(ITerm const&) const { return 1; }
+ * };
+ * size_t size = dispatch(*term, Size());
+ * ~~~
+ *
+ * @param term		The term.
+ * @param handler	The handler.
+ * @return	The result of the handler.
+ */
+template<class Handler>
+inline auto dispatch(ITerm const& term, Handler&& handler)
+-> decltype(handler(term)) {
+	switch (term.get_kind()) {
+	case SYMBOL_LITERAL_KIND:
+		return handler(kind_cast<ISymbolLiteral>(term));
+	case STRING_LITERAL_KIND:
+		return handler(kind_cast<IStringLiteral>(term));
+	case INTEGER_LITERAL_KIND:
+		return handler(kind_cast<IIntegerLiteral>(term));
+	case FLOAT_LITERAL_KIND:
+		return handler(kind_cast<IFloatLiteral>(term));
+	case BIT_STRING_LITERAL_KIND:
+		return handler(kind_cast<IBitStringLiteral>(term));
+	case BOOLEAN_LITERAL_KIND:
+		return handler(kind_cast<IBooleanLiteral>(term));
+	case TERM_LITERAL_KIND:
+		return handler(kind_cast<ITermLiteral>(term));
+	case VARIABLE_KIND:
+		return handler(kind_cast<IVariable>(term));
+	case TERM_VARIABLE_KIND:
+		return handler(kind_cast<ITermVariable>(term));
+	case BINDING_KIND:
+		return handler(kind_cast<IBinding>(term));
+	case LAMBDA_KIND:
+		return handler(kind_cast<ILambda>(term));
+	case LIST_KIND:
+		return handler(kind_cast<IList>(term));
+	case PROPERTY_SPECIFICATION_KIND:
+		return handler(kind_cast<IPropertySpecification>(term));
+	case SPECIAL_FORM_KIND:
+		return handler(kind_cast<ISpecialForm>(term));
+	case APPLY_KIND:
+		return handler(kind_cast<IApply>(term));
+	case STATIC_MAP_KIND:
+		return handler(kind_cast<IStaticMap>(term));
+	case ROOT_KIND:
+	default:
+		return handler(term);
+	} // Switch on kind.
+}
+
+/**
+ * A term visitor that dispatches on kind.  Subclasses pass themselves as the
+ * template argument and provide `visit_kind` overloads for the kinds they
+ * care about.  Every other kind goes to the default here, which returns the
+ * term unchanged.  Because the subclass is known, the calls are resolved at
+ * compile time rather than through the vtable.
+ *
+ * ~~~{.cpp}
+ * class Swap : public KindVisitor<Swap> {
+ * public:
+ *   using KindVisitor<Swap>::visit_kind;
+ *   pTerm visit_kind(pTerm const& term, IApply const& apply) {
+ *     return fact.apply(apply.get_loc(), apply.get_argument(),
+ *         apply.get_operator());
+ *   }
+ * };
+ * ~~~
+ *
+ * @param Derived	The subclass.
+ */
+template<class Derived>
+class KindVisitor : public TermVisitor {
+public:
+	/// Deallocate this instance.
+	virtual ~KindVisitor() = default;
+
+	/**
+	 * Visit a term, passing it to the subclass's handler for its kind.
+	 * @param term	The term.
+	 * @return	The result of the handler.
+	 */
+	pTerm visit(pTerm term) {
+		return dispatch(*term, Call{static_cast<Derived&>(*this), term});
+	}
+
+	/**
+	 * Handle any kind the subclass does not.
+	 * @param term	The term.
+	 * @return	The term, unchanged.
+	 */
+	template<class Face>
+	inline pTerm visit_kind(pTerm const& term, Face const&) {
+		return term;
+	}
+
+private:
+	// Forward the interface from dispatch, along with the handle.
+	struct Call {
+		Derived& self;
+		pTerm const& term;
+		template<class Face>
+		inline pTerm operator()(Face const& face) const {
+			return self.visit_kind(term, face);
+		}
+	};
+};
+
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* DISPATCH_H_ */
@@ -49,7 +49,7 @@ public:
 };
 
 /// Shorthand for an apply pointer.
-typedef std::shared_ptr<IApply const> pApply;
+typedef boost::intrusive_ptr<IApply const> pApply;
 
 } /* namespace term */
 } /* namespace elision */
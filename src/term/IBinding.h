@@ -21,7 +21,8 @@
  */
 
 #include "ITerm.h"
-#include <map>
+#include "Atom.h"
+#include "BindMap.h"
 
 namespace elision {
 namespace term {
@@ -34,18 +35,23 @@ namespace term {
  *
  * For performance, bindings are constants.  If you need to match on bindings,
  * they you need to transform them into some other kind of term.
+ *
+ * Variable names are held as atoms, and the binds are held in a persistent
+ * map keyed by atom, so a binding can be extended cheaply and the result
+ * shares structure with the original.  Use `BindMap::sorted` to visit the
+ * binds in order by name.
  */
 class IBinding : public virtual ITerm {
 public:
 	/// Type for the map used and returned by a binding instance.
-	typedef std::map<std::string, pTerm> const map_t;
+	typedef BindMap map_t;
 
 	/**
 	 * Get the non-abstract content of this binding as a map.  The returned
-	 * map is copied.
+	 * map shares its nodes with the binding, so this does not copy the binds.
 	 * @return	The concrete binds in this binding.
 	 */
-	virtual std::shared_ptr<map_t> get_map() const = 0;
+	virtual map_t get_map() const = 0;
 
 	/**
 	 * Get the term bound to the named variable, if any.  If none, then an
@@ -62,10 +68,26 @@ public:
 	 * @return	True iff this binding binds the variable name concretely.
 	 */
 	virtual bool has_bind(std::string const& name) const = 0;
+
+	/**
+	 * Get the term bound to the variable with the given name, if any.  If
+	 * none, then an exception is thrown.
+	 * @param	name	The variable name.
+	 * @return	The bound value.
+	 * @throws	std::out_of_range	The variable name is not concretely bound.
+	 */
+	virtual pTerm get_bind(Atom name) const = 0;
+
+	/**
+	 * Determine if this binding contains a bind for the given variable name.
+	 * @param	name	The variable name.
+	 * @return	True iff this binding binds the variable name concretely.
+	 */
+	virtual bool has_bind(Atom name) const = 0;
 };
 
 /// Shorthand for a binding pointer.
-typedef std::shared_ptr<IBinding const> pBinding;
+typedef boost::intrusive_ptr<IBinding const> pBinding;
 
 } /* namespace term */
 } /* namespace elision */
@@ -57,7 +57,7 @@ public:
 };
 
 /// Shorthand for a lambda pointer.
-typedef std::shared_ptr<ILambda const> pLambda;
+typedef boost::intrusive_ptr<ILambda const> pLambda;
 
 } /* namespace term */
 } /* namespace elision */
@@ -22,10 +22,51 @@
 
 #include "ITerm.h"
 #include "IPropertySpecification.h"
+#include <iterator>
+#include <vector>
 
 namespace elision {
 namespace term {
 
+/**
+ * A run of list elements that are adjacent in memory.  A span does not own
+ * the elements; it is valid as long as the list it came from.
+ */
+class ElementSpan {
+public:
+	/**
+	 * Make a new instance.
+	 * @param first	The first element.
+	 * @param last	One past the last element.
+	 */
+	ElementSpan(pTerm const* first, pTerm const* last) :
+		first_(first), last_(last) {}
+
+	inline pTerm const* begin() const {
+		return first_;
+	}
+
+	inline pTerm const* end() const {
+		return last_;
+	}
+
+	inline size_t size() const {
+		return last_ - first_;
+	}
+
+	inline bool empty() const {
+		return first_ == last_;
+	}
+
+	inline pTerm const& operator[](size_t index) const {
+		return first_[index];
+	}
+
+private:
+	pTerm const* first_;
+	pTerm const* last_;
+};
+
 /**
  * A list consists of a collection of terms and an algebraic property
  * specification.
@@ -42,11 +83,37 @@ public:
 	 */
 	virtual pPropertySpecification get_property_specification() const = 0;
 
+	class const_iterator;
+
 	/**
-	 * Get all the elements of this list.
+	 * Get all the elements of this list.  This copies the elements, so to
+	 * read them iterate over the list instead.
 	 * @return	The elements of this list.
 	 */
-	virtual std::vector<pTerm> get_elements() const = 0;
+	inline std::vector<pTerm> get_elements() const;
+
+	/**
+	 * Get the run of adjacent elements that starts at a position.  The run
+	 * is never empty, and may stop before the end of the list, in which case
+	 * the next run starts where this one stops.  No elements are copied.
+	 * @param position	The zero-based position, which must be less than the
+	 * 					size of the list.
+	 * @return	The run of elements.
+	 */
+	virtual ElementSpan get_chunk(size_t position) const = 0;
+
+	/**
+	 * Get an iterator to the first element.  Iteration walks the runs given
+	 * by `get_chunk`, so no elements are copied.
+	 * @return	The iterator.
+	 */
+	inline const_iterator begin() const;
+
+	/**
+	 * Get an iterator past the last element.
+	 * @return	The iterator.
+	 */
+	inline const_iterator end() const;
 
 	/**
 	 * Get an element from this list, by apparent position.
@@ -63,8 +130,85 @@ public:
 	virtual size_t size() const = 0;
 };
 
+/**
+ * Iterate over the elements of a list, one run of adjacent elements at a
+ * time.
+ */
+class IList::const_iterator :
+		public std::iterator<std::forward_iterator_tag, pTerm const> {
+public:
+	/// Make an iterator that points nowhere.
+	const_iterator() : list_(nullptr), position_(0), at_(nullptr),
+		stop_(nullptr) {}
+
+	/**
+	 * Make an iterator to a position in a list.
+	 * @param list		The list.
+	 * @param position	The position, which may be the size of the list.
+	 */
+	const_iterator(IList const* list, size_t position) : list_(list),
+			position_(position), at_(nullptr), stop_(nullptr) {
+		load();
+	}
+
+	inline pTerm const& operator*() const {
+		return *at_;
+	}
+
+	inline pTerm const* operator->() const {
+		return at_;
+	}
+
+	inline const_iterator& operator++() {
+		++position_;
+		if (++at_ == stop_) load();
+		return *this;
+	}
+
+	inline const_iterator operator++(int) {
+		const_iterator old(*this);
+		++*this;
+		return old;
+	}
+
+	inline bool operator==(const_iterator const& other) const {
+		return position_ == other.position_;
+	}
+
+	inline bool operator!=(const_iterator const& other) const {
+		return position_ != other.position_;
+	}
+
+private:
+	/// Fetch the run holding the current position, if there is one.
+	inline void load() {
+		if (position_ < list_->size()) {
+			ElementSpan span = list_->get_chunk(position_);
+			at_ = span.begin();
+			stop_ = span.end();
+		}
+	}
+
+	IList const* list_;
+	size_t position_;
+	pTerm const* at_;
+	pTerm const* stop_;
+};
+
+inline IList::const_iterator IList::begin() const {
+	return const_iterator(this, 0);
+}
+
+inline IList::const_iterator IList::end() const {
+	return const_iterator(this, size());
+}
+
+inline std::vector<pTerm> IList::get_elements() const {
+	return std::vector<pTerm>(begin(), end());
+}
+
 /// Shorthand for a list pointer.
-typedef std::shared_ptr<IList const> pList;
+typedef boost::intrusive_ptr<IList const> pList;
 
 } /* namespace term */
 } /* namespace elision */
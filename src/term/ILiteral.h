@@ -21,6 +21,8 @@
  */
 
 #include "ITerm.h"
+#include "Atom.h"
+#include "Integer.h"
 #include <stdint.h>
 
 namespace elision {
@@ -38,7 +40,7 @@ public:
 };
 
 /// Shorthand for a pointer to a literal.
-typedef std::shared_ptr<ILiteral const> pLiteral;
+typedef boost::intrusive_ptr<ILiteral const> pLiteral;
 
 
 /**
@@ -51,11 +53,18 @@ public:
 	 * Get the name of this symbol.
 	 * @return	The name of this symbol.
 	 */
-	virtual std::string const get_name() const = 0;
+	virtual std::string const& get_name() const = 0;
+
+	/**
+	 * Get the name of this symbol as an atom.  Prefer this to `get_name` to
+	 * compare or look up names.
+	 * @return	The name of this symbol.
+	 */
+	virtual elision::Atom get_atom() const = 0;
 };
 
 /// Shorthand for a symbol literal pointer.
-typedef std::shared_ptr<ISymbolLiteral const> pSymbolLiteral;
+typedef boost::intrusive_ptr<ISymbolLiteral const> pSymbolLiteral;
 
 
 /**
@@ -72,7 +81,7 @@ public:
 };
 
 /// Shorthand for a string literal pointer.
-typedef std::shared_ptr<IStringLiteral const> pStringLiteral;
+typedef boost::intrusive_ptr<IStringLiteral const> pStringLiteral;
 
 
 /**
@@ -87,10 +96,18 @@ public:
 	 * @return	The value of this integer literal.
 	 */
 	virtual elision::eint_t get_value() const = 0;
+
+	/**
+	 * Get the value of this integer literal in its compact form.  Prefer this
+	 * to `get_value` when the value is only compared, hashed, or printed, as
+	 * small values then avoid the unbounded integer entirely.
+	 * @return	The value of this integer literal.
+	 */
+	virtual elision::Integer const& get_integer() const = 0;
 };
 
 /// Shorthand for a integer literal pointer.
-typedef std::shared_ptr<IIntegerLiteral const> pIntegerLiteral;
+typedef boost::intrusive_ptr<IIntegerLiteral const> pIntegerLiteral;
 
 
 /**
@@ -138,7 +155,7 @@ public:
 };
 
 /// Shorthand for a float literal pointer.
-typedef std::shared_ptr<IFloatLiteral const> pFloatLiteral;
+typedef boost::intrusive_ptr<IFloatLiteral const> pFloatLiteral;
 
 
 /**
@@ -165,7 +182,7 @@ public:
 };
 
 /// Shorthand for a bit string literal pointer.
-typedef std::shared_ptr<IBitStringLiteral const> pBitStringLiteral;
+typedef boost::intrusive_ptr<IBitStringLiteral const> pBitStringLiteral;
 
 
 /**
@@ -182,7 +199,7 @@ public:
 };
 
 /// Shorthand for a boolean literal pointer.
-typedef std::shared_ptr<IBooleanLiteral const> pBooleanLiteral;
+typedef boost::intrusive_ptr<IBooleanLiteral const> pBooleanLiteral;
 
 
 /**
@@ -200,7 +217,7 @@ public:
 };
 
 /// Shorthand for a term literal pointer.
-typedef std::shared_ptr<ITermLiteral const> pTermLiteral;
+typedef boost::intrusive_ptr<ITermLiteral const> pTermLiteral;
 
 } /* namespace term */
 } /* namespace elision */
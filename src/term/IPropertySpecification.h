@@ -63,9 +63,46 @@ class IllegalPropertySpecification : public ElisionException {};
  *
  * Instances are applicable; applied to a typed list of atoms, they "overwrite"
  * the lists properties.
+ *
+ * # Flags
+ * The facts about a specification that do not depend on any binding (which
+ * properties are Boolean constants, and which are present at all) are packed
+ * into a word of flags when the specification is made, so checking them does
+ * not inspect any terms.
  */
 class IPropertySpecification : public virtual ITerm {
 public:
+	/// The type of the packed flags.
+	typedef uint16_t flags_type;
+
+	/// The flags of a property specification.
+	enum Flag : flags_type {
+		ASSOCIATIVE_KNOWN = 1 << 0,	//< Associativity is a Boolean constant.
+		ASSOCIATIVE = 1 << 1,		//< Associativity is true.
+		COMMUTATIVE_KNOWN = 1 << 2,	//< Commutativity is a Boolean constant.
+		COMMUTATIVE = 1 << 3,		//< Commutativity is true.
+		IDEMPOTENT_KNOWN = 1 << 4,	//< Idempotency is a Boolean constant.
+		IDEMPOTENT = 1 << 5,		//< Idempotency is true.
+		ABSORBER = 1 << 6,			//< An absorber is specified.
+		IDENTITY = 1 << 7,			//< An identity is specified.
+		MEMBERSHIP = 1 << 8,		//< Membership is specified.
+	};
+
+	/**
+	 * Get the flags of this specification.
+	 * @return	The flags.
+	 */
+	virtual flags_type get_flags() const = 0;
+
+	/**
+	 * Determine whether all of some flags are set.
+	 * @param flags	The flags.
+	 * @return	True iff every one of the flags is set.
+	 */
+	inline bool has_flags(flags_type flags) const {
+		return (get_flags() & flags) == flags;
+	}
+
 	/**
 	 * Get any associativity specification.
 	 * @return	The associativity specification.
@@ -107,43 +144,76 @@ public:
 	 * constant, return it.  If it is not, return the default.
 	 * @return	The associativity, or the provided default.
 	 */
-	virtual bool check_associative(bool def) const = 0;
+	inline bool check_associative(bool def) const {
+		return check(ASSOCIATIVE_KNOWN, ASSOCIATIVE, def);
+	}
 
 	/**
 	 * Check the commutativity specification.  If it is set to a Boolean
 	 * constant, return it.  If it is not, return the default.
-	 * @return	The associativity, or the provided default.
+	 * @return	The commutativity, or the provided default.
 	 */
-	virtual bool check_commutative(bool def) const = 0;
+	inline bool check_commutative(bool def) const {
+		return check(COMMUTATIVE_KNOWN, COMMUTATIVE, def);
+	}
 
 	/**
 	 * Check the idempotency specification.  If it is set to a Boolean
 	 * constant, return it.  If it is not, return the default.
-	 * @return	The associativity, or the provided default.
+	 * @return	The idempotency, or the provided default.
 	 */
-	virtual bool check_idempotent(bool def) const = 0;
+	inline bool check_idempotent(bool def) const {
+		return check(IDEMPOTENT_KNOWN, IDEMPOTENT, def);
+	}
 
 	/**
 	 * Determine if an absorber is specified.
 	 * @return	True if an absorber is specified, and false otherwise.
 	 */
-	virtual bool has_absorber() const = 0;
+	inline bool has_absorber() const {
+		return has_flags(ABSORBER);
+	}
 
 	/**
 	 * Determine if an identity is specified.
 	 * @return	True if an identity is specified, and false otherwise.
 	 */
-	virtual bool has_identity() const = 0;
+	inline bool has_identity() const {
+		return has_flags(IDENTITY);
+	}
 
 	/**
 	 * Determine if membership is specified.
 	 * @return	True if membership is specified, and false otherwise.
 	 */
-	virtual bool has_membership() const = 0;
+	inline bool has_membership() const {
+		return has_flags(MEMBERSHIP);
+	}
+
+	/**
+	 * Get the flags for a Boolean property.
+	 * @param value		The value of the property, which may be null.
+	 * @param known		The flag to set if the value is a Boolean constant.
+	 * @param set		The flag to set if the value is true.
+	 * @return	The flags.
+	 */
+	static inline flags_type flags_of(ITerm const* value, flags_type known,
+			flags_type set) {
+		if (value == nullptr) return 0;
+		if (value->is_true()) return known | set;
+		if (value->is_false()) return known;
+		return 0;
+	}
+
+private:
+	inline bool check(flags_type known, flags_type set, bool def) const {
+		flags_type flags = get_flags();
+		return (flags & known) ? (flags & set) != 0 : def;
+	}
 };
 
 /// Shorthand for a property specification pointer.
-typedef std::shared_ptr<IPropertySpecification const> pPropertySpecification;
+typedef boost::intrusive_ptr<IPropertySpecification const> pPropertySpecification;
 
 } /* namespace term */
 } /* namespace elision */
@@ -46,7 +46,7 @@ public:
 };
 
 /// Shorthand for a map pair pointer.
-typedef std::shared_ptr<IStaticMap const> pStaticMap;
+typedef boost::intrusive_ptr<IStaticMap const> pStaticMap;
 
 } /* namespace term */
 } /* namespace elision */
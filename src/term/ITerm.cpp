@@ -18,6 +18,7 @@
  */
 
 #include "ITerm.h"
+#include "basic/TermTable.h"
 
 namespace elision {
 namespace term {
@@ -28,8 +29,18 @@ bool operator==(ITerm const& first, ITerm const& second) {
 		return true;
 	}
 
-	// Check for simple inequality.
-	if (first.get_kind() != second.get_kind()) {
+	// Interned terms are unique, so distinct instances from the same table
+	// cannot be equal, unless the table keeps equal terms at different
+	// locations apart.
+	basic::TermTable const* table = first.get_table();
+	if (table != nullptr && table == second.get_table() &&
+			!table->keeps_locations()) {
+		return false;
+	}
+
+	// Check for simple inequality.  Equal terms have equal fingerprints, and
+	// the fingerprint covers the kind.
+	if (first.get_fingerprint() != second.get_fingerprint()) {
 		return false;
 	}
 
@@ -37,21 +48,25 @@ bool operator==(ITerm const& first, ITerm const& second) {
 	pTerm ftype = first.get_type();
 	pTerm stype = second.get_type();
 	if (ftype != stype) {
-		// Watch out for the root term.
-		if (ftype->is_root()) {
-			if (!stype->is_root()) {
+		// Watch out for the root term.  Each store has its own root, and
+		// all roots are equal; comparing their types would never end.
+		if (ftype->is_root() || stype->is_root()) {
+			if (ftype->is_root() != stype->is_root()) {
 				// The types do not match.
 				return false;
 			}
-		}
-		// At least one type is not the root.
-		if (*ftype != *stype) {
+		} else if (*ftype != *stype) {
 			// The types do not match.
 			return false;
 		}
 	}
 
-	// Now invoke the subclass method to determine the rest of the story.
+	// Now invoke the subclass method to determine the rest of the story.  A
+	// term held by a store can compare itself with any term, but other terms
+	// only understand their own implementation.
+	if (second.get_store() != nullptr) {
+		return second.is_equal(first);
+	}
 	return first.is_equal(second);
 }
 
@@ -22,6 +22,9 @@
 
 #include "elision.h"
 #include "Loc.h"
+#include "RefCounted.h"
+#include "Fingerprint.h"
+#include "TermSummary.h"
 
 namespace elision {
 namespace term {
@@ -45,9 +48,17 @@ enum TermKind {
 	SPECIAL_FORM_KIND, APPLY_KIND, ROOT_KIND, STATIC_MAP_KIND
 };
 
+namespace basic {
+class TermTable;
+} /* namespace basic */
+
+namespace store {
+class TermStore;
+} /* namespace store */
+
 class ITerm;
 /// Shorthand for a pointer to a term.
-typedef std::shared_ptr<ITerm const> pTerm;
+typedef boost::intrusive_ptr<ITerm const> pTerm;
 
 class TermVisitor {
 public:
@@ -57,8 +68,10 @@ public:
 
 /**
  * This is the public interface shared by all terms.
+ *
+ * Terms carry their own reference count, and are held by `pTerm` handles.
  */
-class ITerm {
+class ITerm : public RefCounted {
 public:
 	/// The type to use for the depth of a term.
 	typedef unsigned int depth_type;
@@ -83,6 +96,9 @@ public:
      * semantic information is available, this will not be optimum, but is
      * needed for debugging.  The basic structure of the returned string
      * should be Elision "source."
+     *
+     * The string is built each time this is called.  To write a large term,
+     * use a `TermPrinter` on a stream instead.
      * @return	The string representation of this term.
      */
 	virtual std::string to_string() const = 0;
@@ -98,19 +114,34 @@ public:
 		return to_string();
 	}
 
+	/**
+	 * Return the fingerprint of this term.  This is computed when the term
+	 * is made, from the kind, the type, the fingerprints of the children, and
+	 * the binary form of any literal content.  Terms that are equal have
+	 * equal fingerprints, and terms with equal fingerprints are equal except
+	 * with negligible probability.
+	 * @return	The fingerprint.
+	 */
+	virtual Fingerprint const& get_fingerprint() const = 0;
+
 	/**
 	 * Return the hash code for this particular term.  Terms that are equal
-	 * have equal hash codes.
+	 * have equal hash codes.  This is the low half of the fingerprint.
 	 * @return	The hash code.
 	 */
-	virtual size_t get_hash() const = 0;
+	inline size_t get_hash() const {
+		return static_cast<size_t>(get_fingerprint().low);
+	}
 
 	/**
 	 * Return the other hash code for this particular term.  Terms that are
-	 * equal have equal other hash codes.
+	 * equal have equal other hash codes.  This is the high half of the
+	 * fingerprint.
 	 * @return 	The other hash code.
 	 */
-	virtual size_t get_other_hash() const = 0;
+	inline size_t get_other_hash() const {
+		return static_cast<size_t>(get_fingerprint().high);
+	}
 
     /**
      * Get the de Bruijn index of this term.
@@ -155,6 +186,15 @@ public:
      */
 	virtual bool is_constant() const = 0;
 
+	/**
+	 * Get the summary of this term.  The summary is computed when the term is
+	 * made, and holds the depth, whether the term is constant or a metaterm,
+	 * and which variables the term might contain, so that these are found
+	 * without visiting the children.
+	 * @return	The summary of this term.
+	 */
+	virtual TermSummary get_summary() const = 0;
+
     /**
      * Get the location of this term's declaration.  This can be a location in
      * a source file, or some special location, depending on why the term was
@@ -188,6 +228,22 @@ public:
 	 */
 	virtual TermKind get_kind() const = 0;
 
+	/**
+	 * Get the table that interned this term, if any.  Two terms interned by
+	 * the same table that drops locations are equal if and only if they are
+	 * the same instance.
+	 * @return	The interning table, or null if this term is not interned.
+	 */
+	virtual basic::TermTable const* get_table() const = 0;
+
+	/**
+	 * Get the store that holds this term, if this term is a view of a term
+	 * in a `store::TermStore`.  Such terms compare themselves with terms of
+	 * any implementation, so the comparison operators defer to them.
+	 * @return	The store, or null if this term is not held by a store.
+	 */
+	virtual store::TermStore const* get_store() const = 0;
+
 	/**
 	 * Order two terms.
 	 * @param other	The other term.
@@ -197,13 +253,12 @@ public:
 
 	/**
 	 * Perform "fast equality" checking of this term against the provided
-	 * term.  Fast equality checking uses the hash codes of the two terms.
+	 * term.  Fast equality checking uses the fingerprints of the two terms.
 	 * @param other	The other term to compare this to.
-	 * @return	True iff the two terms hash equally, and false otherwise.
+	 * @return	True iff the two terms have the same fingerprint.
 	 */
 	bool feq(ITerm const& other) const {
-		return get_hash() == other.get_hash() &&
-				get_other_hash() == other.get_other_hash();
+		return get_fingerprint() == other.get_fingerprint();
 	}
 
 	/**
@@ -223,19 +278,60 @@ public:
 	 */
 	friend bool operator!=(ITerm const& first, ITerm const& second);
 
+protected:
+	/**
+	 * Record the interface that corresponds to this term's kind (for example,
+	 * `IApply` for `APPLY_KIND`).  Every concrete term must do this in its
+	 * constructor, so that `kind_cast` can reach the interface without
+	 * consulting dynamic type information.
+	 * @param face	This term, as a pointer to its kind's interface.
+	 */
+	inline void set_interface(void const* face) {
+		interface_ = face;
+	}
+
 private:
+	template<class Face> friend Face const& kind_cast(ITerm const& term);
+
 	/**
 	 * Compare this instance to another instance of the same class.  To
 	 * implement this make sure you first cast `other` to the correct class.
-	 * If the derived class where the implementation lives is `B`, then do
-	 * `dynamic_cast<B const&>(other)` and compare to `*this`.  Types have
-	 * already been checked.
+	 * Kinds and types have already been checked, so use `kind_cast` for
+	 * this rather than `dynamic_cast`.  If either term is held by a store,
+	 * the store's term is asked, so other implementations never see it.
 	 * @param other	The term to compare to.
 	 * @return	True iff the two are equal.
 	 */
 	virtual bool is_equal(ITerm const& other) const = 0;
+
+	// The interface for this term's kind, as recorded by the subclass.
+	void const* interface_ = nullptr;
 };
 
+/**
+ * Cast a term to the interface for its kind.  This is a static cast, so the
+ * caller must have checked the kind first; for example, only cast to `IApply`
+ * if `get_kind()` is `APPLY_KIND`.  The root has no interface, and must not
+ * be cast.
+ * @param term	The term.
+ * @return	The term as its kind's interface.
+ */
+template<class Face>
+inline Face const& kind_cast(ITerm const& term) {
+	return *static_cast<Face const*>(term.interface_);
+}
+
+/**
+ * Cast a term handle to a handle for the interface of its kind.  The same
+ * restrictions apply as for casting a reference.
+ * @param term	The term.
+ * @return	The term as its kind's interface.
+ */
+template<class Face>
+inline boost::intrusive_ptr<Face const> kind_cast(pTerm const& term) {
+	return boost::intrusive_ptr<Face const>(&kind_cast<Face>(*term));
+}
+
 /// Shorthand for using a term.
 
 } /* namespace term */
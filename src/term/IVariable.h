@@ -21,6 +21,7 @@
  */
 
 #include "ITerm.h"
+#include "Atom.h"
 
 namespace elision {
 namespace term {
@@ -35,7 +36,14 @@ public:
 	 * their name.
 	 * @return The variable name.
 	 */
-	virtual std::string const get_name() const = 0;
+	virtual std::string const& get_name() const = 0;
+
+	/**
+	 * Get the name of this variable as an atom.  Prefer this to `get_name`
+	 * to compare or look up names.
+	 * @return	The variable name.
+	 */
+	virtual elision::Atom get_atom() const = 0;
 
 	/**
 	 * Get the guard for this variable.  A guard specifies the conditions
@@ -51,7 +59,7 @@ public:
 };
 
 /// Shorthand for a variable pointer.
-typedef std::shared_ptr<IVariable const> pVariable;
+typedef boost::intrusive_ptr<IVariable const> pVariable;
 
 
 /**
@@ -66,7 +74,14 @@ public:
 	 * their name.
 	 * @return	The variable name.
 	 */
-	virtual std::string const get_name() const = 0;
+	virtual std::string const& get_name() const = 0;
+
+	/**
+	 * Get the name of this variable as an atom.  Prefer this to `get_name`
+	 * to compare or look up names.
+	 * @return	The variable name.
+	 */
+	virtual elision::Atom get_atom() const = 0;
 
 	/**
 	 * Get the underlying type for this term variable.  Term variables are
@@ -78,7 +93,7 @@ public:
 };
 
 /// Shorthand for a variable pointer.
-typedef std::shared_ptr<ITermVariable const> pTermVariable;
+typedef boost::intrusive_ptr<ITermVariable const> pTermVariable;
 
 } /* namespace term */
 } /* namespace elision */
@@ -83,6 +83,7 @@ public:
 	pSymbolLiteral MAP;			//< Simple access to the type for map pairs.
 	pSymbolLiteral SPECIAL_FORM;//< Simple access to the special form type.
 	pSymbolLiteral PROPERTIES;	//< Simple access to the type for property specs.
+	pSymbolLiteral BINDING;		//< Simple access to the type for bindings.
 	pSymbolLiteral TERM;		//< Simple access to the term marker.
 
 	//======================================================================
@@ -197,6 +198,19 @@ public:
 	virtual pLambda get_lambda(Locus loc, pTerm lhs, pTerm rhs,
 			pTerm guard) const = 0;
 
+	//======================================================================
+	// Make bindings.
+	//======================================================================
+
+	/**
+	 * Make a binding.  The binding shares the nodes of the map.
+	 * @param loc		The location.
+	 * @param binds		The binds.
+	 * @return	The binding.
+	 */
+	virtual pBinding get_binding(Locus loc,
+			IBinding::map_t const& binds) const = 0;
+
 	//======================================================================
 	// Make special forms.
 	//======================================================================
@@ -208,8 +222,51 @@ public:
 	// Make lists.
 	//======================================================================
 
+	/**
+	 * Make a list.  The elements are moved into the list, so building a list
+	 * never copies the element array.
+	 * @param loc		The location.
+	 * @param spec		The property specification.
+	 * @param elements	The elements.
+	 * @return	The list.
+	 */
 	virtual pList get_list(Locus loc, pPropertySpecification spec,
-			std::vector<pTerm>& elements) const = 0;
+			std::vector<pTerm>&& elements) const = 0;
+
+	/**
+	 * Make a list from a copy of some elements.
+	 * @param loc		The location.
+	 * @param spec		The property specification.
+	 * @param elements	The elements.
+	 * @return	The list.
+	 */
+	inline pList get_list(Locus loc, pPropertySpecification spec,
+			std::vector<pTerm> const& elements) const {
+		return get_list(loc, spec, std::vector<pTerm>(elements));
+	}
+
+	/**
+	 * Make the list holding the elements of one list followed by those of
+	 * another.  The result has the property specification of the first list.
+	 * @param loc		The location.
+	 * @param first		The first list.
+	 * @param second	The second list.
+	 * @return	The list.
+	 */
+	virtual pList catenate(Locus loc, pList first, pList second) const = 0;
+
+	/**
+	 * Make the list holding a range of the elements of a list.  The result
+	 * has the property specification of the list.
+	 * @param loc		The location.
+	 * @param list		The list.
+	 * @param from		The position of the first element to keep.
+	 * @param to		One past the position of the last element to keep.
+	 * @return	The list.
+	 * @throws	std::out_of_range	If the range is not within the list.
+	 */
+	virtual pList slice(Locus loc, pList list, size_t from,
+			size_t to) const = 0;
 
 	//======================================================================
 	// Handle application.
@@ -228,6 +285,18 @@ public:
 	 */
 	virtual std::unique_ptr<PropertySpecificationBuilder>
 	get_property_specification_builder() const = 0;
+
+	/**
+	 * Get the property specification that has every property specified by
+	 * a second specification, and every other property from a first.  This
+	 * is what applying the second specification to the first yields.
+	 * Factories remember the results, so this does not use a builder.
+	 * @param spec	The first specification.
+	 * @param by	The overriding specification.
+	 * @return	The merged specification.
+	 */
+	virtual pPropertySpecification override_properties(
+			pPropertySpecification spec, pPropertySpecification by) const = 0;
 };
 
 } /* namespace term */
@@ -28,22 +28,21 @@ TermModifier::TermModifier(TermFactory const& fact) : fact_(fact) {
 }
 
 pTerm
-TermModifier::substitute(std::map<std::string, pTerm> const& map,
-		pTerm target) const {
+TermModifier::substitute(IBinding::map_t const& map, pTerm target) const {
 	NOTNULL(target);
 
 	// Define the closure that instantiates variables as they are found.
-	auto closure = [this, map](pTerm term) -> pTerm {
+	auto closure = [this, &map](pTerm term) -> pTerm {
 		switch (term->get_kind()) {
 		case VARIABLE_KIND: {
 			// See if this is a variable that can be replaced right now.  If so, we
 			// are done.  We don't need to consider the type, because we are going
 			// to get that from the replacement.
-			pVariable var = TERM_CAST(IVariable, term);
-			auto search = map.find(var->get_name());
-			if (search != map.end()) {
+			auto const& var = kind_cast<IVariable>(*term);
+			pTerm const* search = map.find(var.get_atom());
+			if (search != nullptr) {
 				// Found this variable, so replace it now.
-				return search->second;
+				return *search;
 			}
 			break;
 		}
@@ -52,12 +51,12 @@ TermModifier::substitute(std::map<std::string, pTerm> const& map,
 			// See if this term variable can be replaced right now.  If so,
 			// then we have to construct a term literal, but in any case we
 			// are done.
-			pTermVariable tvar = TERM_CAST(ITermVariable, term);
-			auto search = map.find(tvar->get_name());
-			if (search != map.end()) {
+			auto const& tvar = kind_cast<ITermVariable>(*term);
+			pTerm const* search = map.find(tvar.get_atom());
+			if (search != nullptr) {
 				// Found the variable.  Build a term literal around the
 				// replacement and return the result.
-				return fact_.get_term_literal(tvar->get_loc(), search->second);
+				return fact_.get_term_literal(tvar.get_loc(), *search);
 			}
 			break;
 		}
@@ -67,8 +66,11 @@ TermModifier::substitute(std::map<std::string, pTerm> const& map,
 		return term;
 	};
 
+	// Only subterms that might hold one of the bound names are visited.
+	if (map.empty()) return target;
+
 	// Perform the replacement.
-	return rebuild(target, closure);
+	return rebuild(target, closure, map.get_signature());
 }
 
 pTerm
@@ -76,6 +78,19 @@ TermModifier::rebuild(pTerm target,
 		std::function<pTerm (pTerm)> closure) const {
 	NOTNULL(target);
 	NOTNULL(closure);
+	return rebuild(target, closure, 0);
+}
+
+pTerm
+TermModifier::rebuild(pTerm target,
+		std::function<pTerm (pTerm)> const& closure,
+		uint32_t signature) const {
+	NOTNULL(target);
+
+	// Skip a term that cannot contain any of the names of interest.
+	if (signature != 0 && !target->get_summary().may_contain(signature)) {
+		return target;
+	}
 
 	// See if the closure wants to replace this term immediately.
 	pTerm new_term = closure(target);
@@ -92,10 +107,10 @@ TermModifier::rebuild(pTerm target,
 	switch (target->get_kind()) {
 	case SYMBOL_LITERAL_KIND: {
 		// Compute a possibly new type.
-		pTerm new_type = rebuild(target->get_type(), closure);
+		pTerm new_type = rebuild(target->get_type(), closure, signature);
 		if ((target->get_type() != new_type)) {
-			pSymbolLiteral lit = TERM_CAST(ISymbolLiteral, target);
-			return fact_.get_symbol_literal(lit->get_loc(), lit->get_name(),
+			auto const& lit = kind_cast<ISymbolLiteral>(*target);
+			return fact_.get_symbol_literal(lit.get_loc(), lit.get_name(),
 					new_type);
 		}
 		break;
@@ -103,10 +118,10 @@ TermModifier::rebuild(pTerm target,
 
 	case STRING_LITERAL_KIND: {
 		// Compute a possibly new type.
-		pTerm new_type = rebuild(target->get_type(), closure);
+		pTerm new_type = rebuild(target->get_type(), closure, signature);
 		if ((target->get_type() != new_type)) {
-			pStringLiteral lit = TERM_CAST(IStringLiteral, target);
-			return fact_.get_string_literal(lit->get_loc(), lit->get_value(),
+			auto const& lit = kind_cast<IStringLiteral>(*target);
+			return fact_.get_string_literal(lit.get_loc(), lit.get_value(),
 					new_type);
 		}
 		break;
@@ -114,10 +129,10 @@ TermModifier::rebuild(pTerm target,
 
 	case INTEGER_LITERAL_KIND: {
 		// Compute a possibly new type.
-		pTerm new_type = rebuild(target->get_type(), closure);
+		pTerm new_type = rebuild(target->get_type(), closure, signature);
 		if ((target->get_type() != new_type)) {
-			pIntegerLiteral lit = TERM_CAST(IIntegerLiteral, target);
-			return fact_.get_integer_literal(lit->get_loc(), lit->get_value(),
+			auto const& lit = kind_cast<IIntegerLiteral>(*target);
+			return fact_.get_integer_literal(lit.get_loc(), lit.get_value(),
 					new_type);
 		}
 		break;
@@ -125,136 +140,192 @@ TermModifier::rebuild(pTerm target,
 
 	case FLOAT_LITERAL_KIND: {
 		// Compute a possibly new type.
-		pTerm new_type = rebuild(target->get_type(), closure);
+		pTerm new_type = rebuild(target->get_type(), closure, signature);
 		if ((target->get_type() != new_type)) {
-			pFloatLiteral lit = TERM_CAST(IFloatLiteral, target);
-			return fact_.get_float_literal(lit->get_loc(),
-					lit->get_significand(), lit->get_exponent(),
-					lit->get_radix(), new_type);
+			auto const& lit = kind_cast<IFloatLiteral>(*target);
+			return fact_.get_float_literal(lit.get_loc(),
+					lit.get_significand(), lit.get_exponent(),
+					lit.get_radix(), new_type);
 		}
 		break;
 	}
 
 	case BIT_STRING_LITERAL_KIND: {
 		// Compute a possibly new type.
-		pTerm new_type = rebuild(target->get_type(), closure);
+		pTerm new_type = rebuild(target->get_type(), closure, signature);
 		if ((target->get_type() != new_type)) {
-			pBitStringLiteral lit = TERM_CAST(IBitStringLiteral, target);
-			return fact_.get_bit_string_literal(lit->get_loc(),
-					lit->get_bits(), lit->get_length(), new_type);
+			auto const& lit = kind_cast<IBitStringLiteral>(*target);
+			return fact_.get_bit_string_literal(lit.get_loc(),
+					lit.get_bits(), lit.get_length(), new_type);
 		}
 		break;
 	}
 
 	case BOOLEAN_LITERAL_KIND: {
 		// Compute a possibly new type.
-		pTerm new_type = rebuild(target->get_type(), closure);
+		pTerm new_type = rebuild(target->get_type(), closure, signature);
 		if ((target->get_type() != new_type)) {
-			pBooleanLiteral lit = TERM_CAST(IBooleanLiteral, target);
-			return fact_.get_boolean_literal(lit->get_loc(), lit->get_value(),
+			auto const& lit = kind_cast<IBooleanLiteral>(*target);
+			return fact_.get_boolean_literal(lit.get_loc(), lit.get_value(),
 					new_type);
 		}
 		break;
 	}
 
 	case TERM_LITERAL_KIND: {
-		pTermLiteral lit = TERM_CAST(ITermLiteral, target);
-		pTerm term = lit->get_term();
-		pTerm new_term = rebuild(term, closure);
+		auto const& lit = kind_cast<ITermLiteral>(*target);
+		pTerm term = lit.get_term();
+		pTerm new_term = rebuild(term, closure, signature);
 		if (new_term != term) {
-			return fact_.get_term_literal(lit->get_loc(), new_term);
+			return fact_.get_term_literal(lit.get_loc(), new_term);
 		}
 		break;
 	}
 
 	case VARIABLE_KIND: {
 		// Compute a possibly new type.
-		pTerm new_type = rebuild(target->get_type(), closure);
-		pVariable var = TERM_CAST(IVariable, target);
-		pTerm guard = var->get_guard();
-		pTerm new_guard = rebuild(guard, closure);
+		pTerm new_type = rebuild(target->get_type(), closure, signature);
+		auto const& var = kind_cast<IVariable>(*target);
+		pTerm guard = var.get_guard();
+		pTerm new_guard = rebuild(guard, closure, signature);
 		if ((target->get_type() != new_type) || (guard != new_guard)) {
-			return fact_.get_variable(var->get_loc(), var->get_name(),
+			return fact_.get_variable(var.get_loc(), var.get_name(),
 					new_guard, new_type);
 		}
 		break;
 	}
 
 	case TERM_VARIABLE_KIND: {
-		pTermVariable var = TERM_CAST(ITermVariable, target);
-		pTerm term_type = var->get_term_type();
-		pTerm new_term_type = rebuild(term_type, closure);
+		auto const& var = kind_cast<ITermVariable>(*target);
+		pTerm term_type = var.get_term_type();
+		pTerm new_term_type = rebuild(term_type, closure, signature);
 		if (term_type != new_term_type) {
-			return fact_.get_term_variable(var->get_loc(), var->get_name(),
+			return fact_.get_term_variable(var.get_loc(), var.get_name(),
 					new_term_type);
 		}
 		break;
 	}
 
 	case BINDING_KIND: {
-		pBinding bind = TERM_CAST(IBinding, target);
-		// TODO Implement this.
+		// Rebuild the bound terms.  The new map extends the old one, so it
+		// shares every node that holds no changed bind.
+		auto const& binding = kind_cast<IBinding>(*target);
+		IBinding::map_t binds = binding.get_map();
+		IBinding::map_t new_binds = binds;
+		bool changed = false;
+		for (auto const& bind : binds) {
+			pTerm new_value = rebuild(bind.second, closure, signature);
+			if (new_value != bind.second) {
+				new_binds = new_binds.extend(bind.first, new_value);
+				changed = true;
+			}
+		} // Loop over the binds.
+		if (changed) {
+			return fact_.get_binding(binding.get_loc(), new_binds);
+		}
 		break;
 	}
 
 	case LAMBDA_KIND: {
-		pLambda mp = TERM_CAST(ILambda, target);
-		pTerm lhs = mp->get_lhs();
-		pTerm rhs = mp->get_rhs();
-		pTerm guard = mp->get_guard();
-		pTerm new_lhs = rebuild(lhs, closure);
-		pTerm new_rhs = rebuild(rhs, closure);
-		pTerm new_guard = rebuild(guard, closure);
+		auto const& mp = kind_cast<ILambda>(*target);
+		pTerm lhs = mp.get_lhs();
+		pTerm rhs = mp.get_rhs();
+		pTerm guard = mp.get_guard();
+		pTerm new_lhs = rebuild(lhs, closure, signature);
+		pTerm new_rhs = rebuild(rhs, closure, signature);
+		pTerm new_guard = rebuild(guard, closure, signature);
 		if (lhs != new_lhs || rhs != new_rhs || guard != new_guard) {
-			return fact_.get_lambda(mp->get_loc(), new_lhs, new_rhs, new_guard);
+			return fact_.get_lambda(mp.get_loc(), new_lhs, new_rhs, new_guard);
 		}
 		break;
 	}
 
 	case LIST_KIND: {
-		pList list = TERM_CAST(IList, target);
-		// TODO Implement this.
+		// Rebuild the property specification and the elements.
+		auto const& list = kind_cast<IList>(*target);
+		pTerm spec = list.get_property_specification();
+		pTerm new_spec = rebuild(spec, closure, signature);
+		bool changed = spec != new_spec;
+		std::vector<pTerm> elements;
+		elements.reserve(list.size());
+		for (pTerm const& element : list) {
+			pTerm new_element = rebuild(element, closure, signature);
+			changed |= new_element != element;
+			elements.push_back(new_element);
+		} // Loop over the elements.
+		if (changed) {
+			return fact_.get_list(list.get_loc(),
+					kind_cast<IPropertySpecification>(new_spec),
+					std::move(elements));
+		}
 		break;
 	}
 
 	case PROPERTY_SPECIFICATION_KIND: {
-		pPropertySpecification spec = TERM_CAST(IPropertySpecification, target);
-		// TODO Implement this.
+		// Rebuild each property that is specified.
+		auto const& spec = kind_cast<IPropertySpecification>(*target);
+		bool changed = false;
+		auto prop = [&](boost::optional<pTerm> value) {
+			if (value) {
+				pTerm new_value = rebuild(*value, closure, signature);
+				if (new_value != *value) {
+					changed = true;
+					value = new_value;
+				}
+			}
+			return value;
+		};
+		auto associative = prop(spec.get_associative());
+		auto commutative = prop(spec.get_commutative());
+		auto idempotent = prop(spec.get_idempotent());
+		auto absorber = prop(spec.get_absorber());
+		auto identity = prop(spec.get_identity());
+		auto membership = prop(spec.get_membership());
+		if (changed) {
+			auto builder = fact_.get_property_specification_builder();
+			return builder->set_associative(associative)->
+					set_commutative(commutative)->
+					set_idempotent(idempotent)->
+					set_absorber(absorber)->
+					set_identity(identity)->
+					set_membership(membership)->get();
+		}
 		break;
 	}
 
 	case SPECIAL_FORM_KIND: {
-		pSpecialForm sf = TERM_CAST(ISpecialForm, target);
-		pTerm tag = sf->get_tag();
-		pTerm content = sf->get_content();
-		pTerm new_tag = rebuild(tag, closure);
-		pTerm new_content = rebuild(content, closure);
+		auto const& sf = kind_cast<ISpecialForm>(*target);
+		pTerm tag = sf.get_tag();
+		pTerm content = sf.get_content();
+		pTerm new_tag = rebuild(tag, closure, signature);
+		pTerm new_content = rebuild(content, closure, signature);
 		if (tag != new_tag || content != new_content) {
-			return fact_.get_special_form(sf->get_loc(), new_tag, new_content);
+			return fact_.get_special_form(sf.get_loc(), new_tag, new_content);
 		}
 		break;
 	}
 
 	case APPLY_KIND: {
-		pApply apply = TERM_CAST(IApply, target);
-		pTerm op = apply->get_operator();
-		pTerm arg = apply->get_argument();
-		pTerm new_op = rebuild(op, closure);
-		pTerm new_arg = rebuild(arg, closure);
+		auto const& apply = kind_cast<IApply>(*target);
+		pTerm op = apply.get_operator();
+		pTerm arg = apply.get_argument();
+		pTerm new_op = rebuild(op, closure, signature);
+		pTerm new_arg = rebuild(arg, closure, signature);
 		if (op != new_op || arg != new_arg) {
-			return fact_.apply(apply->get_loc(), op, arg);
+			return fact_.apply(apply.get_loc(), new_op, new_arg);
 		}
 		break;
 	}
 
 	case STATIC_MAP_KIND: {
-		pStaticMap map = TERM_CAST(IStaticMap, target);
-		pTerm domain = map->get_domain();
-		pTerm codomain = map->get_codomain();
-		pTerm new_domain = rebuild(domain, closure);
-		pTerm new_codomain = rebuild(codomain, closure);
+		auto const& map = kind_cast<IStaticMap>(*target);
+		pTerm domain = map.get_domain();
+		pTerm codomain = map.get_codomain();
+		pTerm new_domain = rebuild(domain, closure, signature);
+		pTerm new_codomain = rebuild(codomain, closure, signature);
 		if (domain != new_domain || codomain != new_codomain) {
-			return fact_.get_static_map(map->get_loc(), domain, codomain);
+			return fact_.get_static_map(map.get_loc(), new_domain,
+					new_codomain);
 		}
 		break;
 	}
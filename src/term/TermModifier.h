@@ -23,7 +23,6 @@
 #include <ITerm.h>
 #include <TermFactory.h>
 #include <functional>
-#include <map>
 
 namespace elision {
 namespace term {
@@ -52,13 +51,15 @@ public:
 	 * method is intended for performance when rewriting terms based on binds
 	 * returned by matching.  Variable guards in the target are ignored.
 	 *
+	 * Subterms whose summaries show that they contain none of the bound
+	 * names are returned as they are, without being visited.
+	 *
 	 * @param map		The binds.
 	 * @param target	The term to rewrite.
 	 * @return	The possibly-new term.  If the term is not modified, then the
 	 * 			same input pointer is returned.
 	 */
-	pTerm substitute(std::map<std::string, pTerm> const& map,
-			pTerm target) const;
+	pTerm substitute(IBinding::map_t const& map, pTerm target) const;
 
 	/**
 	 * Perform general rebuilding of a term based on a provided closure.  This
@@ -80,6 +81,18 @@ public:
 	pTerm rebuild(pTerm target, std::function<pTerm (pTerm)> closure) const;
 
 private:
+	/**
+	 * Rebuild a term, skipping any subterm that cannot contain a variable
+	 * named in a signature.
+	 * @param target	The term to rebuild.
+	 * @param closure	The closure to perform rebuilding.
+	 * @param signature	The signature of the names of interest, or zero to
+	 * 					visit every subterm.
+	 * @return	The possibly-new term.
+	 */
+	pTerm rebuild(pTerm target, std::function<pTerm (pTerm)> const& closure,
+			uint32_t signature) const;
+
 	TermFactory const& fact_;
 };
 
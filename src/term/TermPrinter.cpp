@@ -0,0 +1,337 @@
+/**
+ * @file
+ * Implement writing terms to an output stream.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "TermPrinter.h"
+#include <algorithm>
+#include <sstream>
+#include <vector>
+
+namespace elision {
+namespace term {
+
+namespace {
+
+/**
+ * Determine whether a term has subterms written inside it, and so is worth
+ * labeling when it is shared.
+ * @param term	The term.
+ * @return	True iff the term is compound.
+ */
+inline bool is_compound(ITerm const& term) {
+	switch (term.get_kind()) {
+	case TERM_LITERAL_KIND:
+	case VARIABLE_KIND:
+	case BINDING_KIND:
+	case LAMBDA_KIND:
+	case LIST_KIND:
+	case PROPERTY_SPECIFICATION_KIND:
+	case SPECIAL_FORM_KIND:
+	case APPLY_KIND:
+	case STATIC_MAP_KIND:
+		return true;
+	default:
+		return false;
+	} // Switch on kind.
+}
+
+/**
+ * Pass each subterm that is written as part of a term, including a written
+ * type, to a function.
+ * @param Visit	The type of the function.
+ */
+template<class Visit>
+struct Subterms {
+	Visit visit;
+
+	void operator()(ILiteral const& term) {
+		visit(*term.get_type());
+	}
+	void operator()(ITermLiteral const& term) {
+		visit(*term.get_term());
+	}
+	void operator()(IVariable const& term) {
+		visit(*term.get_guard());
+		visit(*term.get_type());
+	}
+	void operator()(ITermVariable const& term) {
+		visit(*term.get_type());
+	}
+	void operator()(IBinding const& term) {
+		for (auto const& entry : term.get_map()) visit(*entry.second);
+	}
+	void operator()(ILambda const& term) {
+		visit(*term.get_lhs());
+		visit(*term.get_guard());
+		visit(*term.get_rhs());
+	}
+	void operator()(IList const& term) {
+		visit(*term.get_property_specification());
+		for (auto const& elt : term) visit(*elt);
+	}
+	void operator()(IPropertySpecification const& term) {
+		for (auto const& part : { term.get_associative(),
+				term.get_commutative(), term.get_idempotent(),
+				term.get_absorber(), term.get_identity(),
+				term.get_membership() }) {
+			if (part) visit(*part.get());
+		} // Visit all properties.
+	}
+	void operator()(ISpecialForm const& term) {
+		visit(*term.get_tag());
+		visit(*term.get_content());
+	}
+	void operator()(IApply const& term) {
+		visit(*term.get_operator());
+		visit(*term.get_argument());
+	}
+	void operator()(IStaticMap const& term) {
+		visit(*term.get_domain());
+		visit(*term.get_codomain());
+	}
+	void operator()(ITerm const&) {
+		// The root has no subterms.
+	}
+};
+
+} /* anonymous namespace */
+
+TermPrinter::TermPrinter(std::ostream& out, bool sharing) :
+		out_(out), sharing_(sharing) {
+	// Nothing to do.
+}
+
+std::ostream&
+TermPrinter::print(ITerm const& term) {
+	if (sharing_) {
+		count(term);
+	}
+	write(term);
+	return out_;
+}
+
+std::string
+TermPrinter::to_string(ITerm const& term, bool sharing) {
+	std::ostringstream out;
+	TermPrinter(out, sharing).print(term);
+	return out.str();
+}
+
+void
+TermPrinter::write(ITerm const& term) {
+	if (sharing_ && is_compound(term)) {
+		auto found = seen_.find(&term);
+		if (found != seen_.end() && found->second > 1) {
+			auto label = written_.find(&term);
+			if (label != written_.end()) {
+				out_ << '#' << label->second << '#';
+				return;
+			}
+			written_[&term] = ++labels_;
+			out_ << '#' << labels_ << '=';
+		}
+	}
+	dispatch(term, *this);
+}
+
+void
+TermPrinter::write_type(ITerm const& term) {
+	out_ << ": ";
+	write(*term.get_type());
+}
+
+void
+TermPrinter::count(ITerm const& term) {
+	if (is_compound(term) && ++seen_[&term] > 1) {
+		// The subterms have already been counted.
+		return;
+	}
+	struct Visit {
+		TermPrinter* printer;
+		void operator()(ITerm const& sub) { printer->count(sub); }
+	};
+	dispatch(term, Subterms<Visit>{Visit{this}});
+}
+
+void
+TermPrinter::operator()(ISymbolLiteral const& term) {
+	out_ << escape(term.get_name(), true);
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(IStringLiteral const& term) {
+	out_ << escape(term.get_value(), false);
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(IIntegerLiteral const& term) {
+	out_ << eint_to_string(term.get_integer(), preferred_radix, true);
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(IFloatLiteral const& term) {
+	uint8_t radix = term.get_radix();
+	out_ << eint_to_string(term.get_significand(), radix, true)
+			<< (radix == 16 ? "p" : "e")
+			<< eint_to_string(term.get_exponent(), radix, true);
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(IBitStringLiteral const& term) {
+	out_ << eint_to_string(term.get_bits(), 16, true) << "L"
+			<< eint_to_string(term.get_length(), 10, true);
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(IBooleanLiteral const& term) {
+	out_ << (term.get_value() ? "true" : "false");
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(ITermLiteral const& term) {
+	out_ << '<';
+	write(*term.get_term());
+	out_ << '>';
+}
+
+void
+TermPrinter::operator()(IVariable const& term) {
+	out_ << '$' << escape(term.get_name(), true) << "{ ";
+	write(*term.get_guard());
+	out_ << " }";
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(ITermVariable const& term) {
+	out_ << '$' << escape(term.get_name(), true);
+	write_type(term);
+}
+
+void
+TermPrinter::operator()(IBinding const& term) {
+	out_ << "{~ ";
+	// Write the binds in order by name, not by atom.
+	auto map = term.get_map();
+	bool first = true;
+	for (auto bind : map.sorted()) {
+		if (!first) out_ << ", ";
+		first = false;
+		out_ << escape(bind->first.get_name(), true) << "->";
+		write(*bind->second);
+	} // Write all the binds.
+	out_ << " }";
+}
+
+void
+TermPrinter::operator()(ILambda const& term) {
+	write(*term.get_lhs());
+	out_ << " ->{ ";
+	write(*term.get_guard());
+	out_ << " } ";
+	write(*term.get_rhs());
+}
+
+void
+TermPrinter::operator()(IList const& term) {
+	write(*term.get_property_specification());
+	out_ << '(';
+	bool first = true;
+	for (auto const& elt : term) {
+		if (!first) out_ << ", ";
+		first = false;
+		write(*elt);
+	} // Write all elements.
+	out_ << ')';
+}
+
+void
+TermPrinter::operator()(IPropertySpecification const& term) {
+	// Boolean-valued properties are written as a letter, possibly negated.
+	auto flag = [this](boost::optional<pTerm> const& value, char name) {
+		if (!value) return;
+		pTerm prop = value.get();
+		if (prop->is_true()) {
+			out_ << name;
+		} else if (prop->is_false()) {
+			out_ << '!' << name;
+		} else {
+			out_ << name << '[';
+			write(*prop);
+			out_ << ']';
+		}
+	};
+	out_ << '%';
+	flag(term.get_associative(), 'A');
+	flag(term.get_commutative(), 'C');
+	flag(term.get_idempotent(), 'I');
+	if (term.get_absorber()) {
+		out_ << "B[";
+		write(*term.get_absorber().get());
+		out_ << ']';
+	}
+	if (term.get_identity()) {
+		out_ << "D[";
+		write(*term.get_identity().get());
+		out_ << ']';
+	}
+	if (term.get_membership()) {
+		out_ << "E[";
+		write(*term.get_membership().get());
+		out_ << ']';
+	}
+}
+
+void
+TermPrinter::operator()(ISpecialForm const& term) {
+	out_ << "{: ";
+	write(*term.get_tag());
+	out_ << ' ';
+	write(*term.get_content());
+	out_ << " :}";
+}
+
+void
+TermPrinter::operator()(IApply const& term) {
+	write(*term.get_operator());
+	out_ << '.';
+	write(*term.get_argument());
+}
+
+void
+TermPrinter::operator()(IStaticMap const& term) {
+	write(*term.get_domain());
+	out_ << "=>";
+	write(*term.get_codomain());
+}
+
+void
+TermPrinter::operator()(ITerm const& term) {
+	// Only the root comes here.
+	(void)term;
+	out_ << "^ROOT";
+}
+
+} /* namespace term */
+} /* namespace elision */
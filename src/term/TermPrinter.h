@@ -0,0 +1,140 @@
+#ifndef TERMPRINTER_H_
+#define TERMPRINTER_H_
+
+/**
+ * @file
+ * Write terms to an output stream.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/Dispatch.h"
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+namespace elision {
+namespace term {
+
+/**
+ * Write terms to an output stream in a single pass, without building
+ * strings for the subterms.  The output is Elision "source," as produced by
+ * `ITerm::to_string`, which is implemented with this class.
+ *
+ * If sharing is enabled, compound terms that occur more than once (as the
+ * same instance) are written in full only the first time, marked with a
+ * label like `#1=`, and every later occurrence is written as the label alone,
+ * like `#1#`.  The size of the output is then proportional to the number of
+ * distinct subterms, rather than the size of the fully expanded term.  This
+ * form is meant for people, and cannot be parsed.
+ *
+ * A printer may be used for several terms.  With sharing enabled, labels
+ * carry over from one term to the next.
+ */
+class TermPrinter {
+public:
+	/**
+	 * Make a new printer.
+	 * @param out		The stream to receive the output.
+	 * @param sharing	Whether to label and reuse shared subterms.
+	 */
+	explicit TermPrinter(std::ostream& out, bool sharing = false);
+
+	/**
+	 * Write a term to the stream.
+	 * @param term	The term.
+	 * @return	The stream.
+	 */
+	std::ostream& print(ITerm const& term);
+
+	/**
+	 * Write a term to a string.
+	 * @param term		The term.
+	 * @param sharing	Whether to label and reuse shared subterms.
+	 * @return	The string.
+	 */
+	static std::string to_string(ITerm const& term, bool sharing = false);
+
+	/// @name Handlers for each kind; use `print` instead.
+	/// @{
+	void operator()(ISymbolLiteral const& term);
+	void operator()(IStringLiteral const& term);
+	void operator()(IIntegerLiteral const& term);
+	void operator()(IFloatLiteral const& term);
+	void operator()(IBitStringLiteral const& term);
+	void operator()(IBooleanLiteral const& term);
+	void operator()(ITermLiteral const& term);
+	void operator()(IVariable const& term);
+	void operator()(ITermVariable const& term);
+	void operator()(IBinding const& term);
+	void operator()(ILambda const& term);
+	void operator()(IList const& term);
+	void operator()(IPropertySpecification const& term);
+	void operator()(ISpecialForm const& term);
+	void operator()(IApply const& term);
+	void operator()(IStaticMap const& term);
+	void operator()(ITerm const& term);
+	/// @}
+
+private:
+	/**
+	 * Write a subterm, labeling it if it is shared.
+	 * @param term	The subterm.
+	 */
+	void write(ITerm const& term);
+
+	/**
+	 * Write the type of a term, preceded by a colon.
+	 * @param term	The term.
+	 */
+	void write_type(ITerm const& term);
+
+	/**
+	 * Count the occurrences of the compound subterms of a term, so that the
+	 * shared ones can be labeled.  Each distinct subterm is explored once.
+	 * @param term	The term.
+	 */
+	void count(ITerm const& term);
+
+	/// The output stream.
+	std::ostream& out_;
+
+	/// Whether to label shared subterms.
+	bool sharing_;
+
+	/// The number of labels assigned so far.
+	unsigned labels_ = 0;
+
+	/// The number of occurrences of each compound subterm.
+	std::unordered_map<ITerm const*, unsigned> seen_;
+
+	/// The labels of shared subterms already written.
+	std::unordered_map<ITerm const*, unsigned> written_;
+};
+
+/**
+ * Write a term to an output stream.
+ * @param out	The stream.
+ * @param term	The term.
+ * @return	The stream.
+ */
+inline std::ostream& operator<<(std::ostream& out, ITerm const& term) {
+	return TermPrinter(out).print(term);
+}
+
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* TERMPRINTER_H_ */
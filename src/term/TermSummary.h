@@ -0,0 +1,259 @@
+#ifndef TERMSUMMARY_H_
+#define TERMSUMMARY_H_
+
+/**
+ * @file
+ * Define the summary word computed for every term when it is made.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include <cstdint>
+#include "Atom.h"
+
+namespace elision {
+namespace term {
+
+/**
+ * A summary of a term, packed into one word and computed once from the
+ * summaries of the term's type and children.  This holds the depth, whether
+ * the term is constant, whether it is a metaterm, whether it contains any
+ * variables, whether any part of it was placed in an arena, and a signature
+ * of the names of the variables it contains.
+ *
+ * The signature sets one of 32 bits for each variable or term variable name
+ * found anywhere in the term, including its type and any guards.  If the
+ * signature of a term does not share a bit with the signature of a name,
+ * then the term certainly does not contain a variable with that name, and
+ * a matcher or rewriter can skip the whole term without visiting it.
+ *
+ * The word is laid out as follows.
+ * @verbatim
+ *  63          32 31   24 23          0
+ * +--------------+-------+-------------+
+ * |  signature   | flags |    depth    |
+ * +--------------+-------+-------------+
+ * @endverbatim
+ * Depths larger than `MAX_DEPTH` are held as `MAX_DEPTH`.  Depth is only used
+ * to rule out matches, and equal depths never rule out a match, so this is
+ * safe.
+ */
+class TermSummary {
+public:
+	/// The type to use for the depth of a term.
+	typedef unsigned int depth_type;
+
+	/// The largest depth that is held exactly.
+	static constexpr depth_type MAX_DEPTH = (1u << 24) - 1;
+
+	/// Make the summary of a leaf: depth zero, constant, and no variables.
+	TermSummary() : word_(static_cast<uint64_t>(CONSTANT) << FLAG_SHIFT) {}
+
+	/**
+	 * Get the signature bit for a variable name.
+	 * @param name	The name.
+	 * @return	A word with exactly one bit set.
+	 */
+	static inline uint32_t signature_of(Atom name) {
+		return 1u << ((name.get_id() * UINT32_C(0x9E3779B1)) >> 27);
+	}
+
+	/**
+	 * Get the depth of the term.
+	 * @return	The depth.
+	 */
+	inline depth_type get_depth() const {
+		return static_cast<depth_type>(word_ & MAX_DEPTH);
+	}
+
+	/**
+	 * Determine whether the term is constant.
+	 * @return	True iff the term is constant.
+	 */
+	inline bool is_constant() const {
+		return (get_flags() & CONSTANT) != 0;
+	}
+
+	/**
+	 * Determine whether the term is a metaterm; that is, whether it contains
+	 * a term variable.
+	 * @return	True iff the term is a metaterm.
+	 */
+	inline bool is_meta() const {
+		return (get_flags() & META) != 0;
+	}
+
+	/**
+	 * Determine whether the term contains any variables or term variables.
+	 * @return	True iff the term contains a variable.
+	 */
+	inline bool has_variables() const {
+		return (get_flags() & VARIABLE) != 0;
+	}
+
+	/**
+	 * Determine whether the term, or any part of it, was placed in an arena
+	 * when it was made.  If not, the whole term is on the heap.
+	 * @return	True iff some part of the term may be in an arena.
+	 */
+	inline bool in_arena() const {
+		return (get_flags() & ARENA) != 0;
+	}
+
+	/**
+	 * Get the signature of the names of the variables in the term.
+	 * @return	The signature.
+	 */
+	inline uint32_t get_signature() const {
+		return static_cast<uint32_t>(word_ >> SIGNATURE_SHIFT);
+	}
+
+	/**
+	 * Determine whether the term might contain a variable from a set of
+	 * names.  If this is false, the term certainly contains none of them.
+	 * @param signature	The union of the signatures of the names.
+	 * @return	True iff the term might contain one of the names.
+	 */
+	inline bool may_contain(uint32_t signature) const {
+		return (get_signature() & signature) != 0;
+	}
+
+	/**
+	 * Get the packed word.
+	 * @return	The word.
+	 */
+	inline uint64_t get_word() const {
+		return word_;
+	}
+
+	inline bool operator==(TermSummary const& other) const {
+		return word_ == other.word_;
+	}
+
+	inline bool operator!=(TermSummary const& other) const {
+		return word_ != other.word_;
+	}
+
+	/**
+	 * Raise the depth to at least the depth of another term.
+	 * @param other	The summary of the other term.
+	 * @return	This summary.
+	 */
+	inline TermSummary& add_depth(TermSummary const& other) {
+		if (other.get_depth() > get_depth()) set_depth(other.get_depth());
+		return *this;
+	}
+
+	/**
+	 * Make this summary non-constant if another term is not constant.
+	 * @param other	The summary of the other term.
+	 * @return	This summary.
+	 */
+	inline TermSummary& add_constant(TermSummary const& other) {
+		if (!other.is_constant()) {
+			word_ &= ~(static_cast<uint64_t>(CONSTANT) << FLAG_SHIFT);
+		}
+		return *this;
+	}
+
+	/**
+	 * Include the variables of another term in this summary.  Whether the
+	 * other term has parts in an arena is included too.
+	 * @param other	The summary of the other term.
+	 * @return	This summary.
+	 */
+	inline TermSummary& add_variables(TermSummary const& other) {
+		word_ |= other.word_ & ~((static_cast<uint64_t>(CONSTANT)
+				<< FLAG_SHIFT) | MAX_DEPTH);
+		return *this;
+	}
+
+	/**
+	 * Include a type in this summary.  The type contributes its depth and
+	 * its variables, but not whether it is constant.
+	 * @param type	The summary of the type.
+	 * @return	This summary.
+	 */
+	inline TermSummary& add_type(TermSummary const& type) {
+		return add_depth(type).add_variables(type);
+	}
+
+	/**
+	 * Include a child in this summary.  The child contributes its depth,
+	 * whether it is constant, and its variables.
+	 * @param child	The summary of the child.
+	 * @return	This summary.
+	 */
+	inline TermSummary& add_child(TermSummary const& child) {
+		return add_depth(child).add_constant(child).add_variables(child);
+	}
+
+	/**
+	 * Record that this term was placed in an arena.
+	 * @return	This summary.
+	 */
+	inline TermSummary& add_arena() {
+		word_ |= static_cast<uint64_t>(ARENA) << FLAG_SHIFT;
+		return *this;
+	}
+
+	/**
+	 * Record that this term is itself a variable.  This makes the summary
+	 * non-constant.
+	 * @param name	The name of the variable.
+	 * @param meta	True iff this is a term variable.
+	 * @return	This summary.
+	 */
+	inline TermSummary& add_variable(Atom name, bool meta) {
+		uint64_t flags = VARIABLE | (meta ? META : 0);
+		word_ &= ~(static_cast<uint64_t>(CONSTANT) << FLAG_SHIFT);
+		word_ |= flags << FLAG_SHIFT;
+		word_ |= static_cast<uint64_t>(signature_of(name)) << SIGNATURE_SHIFT;
+		return *this;
+	}
+
+	/**
+	 * Add one to the depth.
+	 * @return	This summary.
+	 */
+	inline TermSummary& deepen() {
+		if (get_depth() < MAX_DEPTH) set_depth(get_depth() + 1);
+		return *this;
+	}
+
+private:
+	/// The flags held in the word.
+	enum Flag : uint8_t {
+		CONSTANT = 1, META = 2, VARIABLE = 4, ARENA = 8
+	};
+
+	static constexpr unsigned FLAG_SHIFT = 24;
+	static constexpr unsigned SIGNATURE_SHIFT = 32;
+
+	inline uint8_t get_flags() const {
+		return static_cast<uint8_t>(word_ >> FLAG_SHIFT);
+	}
+
+	inline void set_depth(depth_type depth) {
+		word_ = (word_ & ~static_cast<uint64_t>(MAX_DEPTH)) | depth;
+	}
+
+	uint64_t word_;
+};
+
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* TERMSUMMARY_H_ */
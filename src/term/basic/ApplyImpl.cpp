@@ -27,25 +27,21 @@ ApplyImpl::ApplyImpl(Locus the_loc, pTerm the_operator, pTerm the_argument,
 		pTerm the_type) : TermImpl(the_loc, the_type),
 				operator_(the_operator),
 				argument_(the_argument) {
-	constant_ = [this]() {
-		return this->operator_->is_constant() &&
-			this->argument_->is_constant();
-	};
-	strval_ = [this]() {
-		return this->operator_->to_string() + "." +
-			this->argument_->to_string();
-	};
-	hash_ = [this]() {
-		return hash_combine(argument_, operator_);
-	};
-	other_hash_ = [this]() {
-		return other_hash_combine(operator_, argument_);
-	};
-	depth_ = [this, the_type]() {
-		depth_type depth = std::max(operator_->get_depth(),
-				argument_->get_depth());
-		return std::max(depth, the_type->get_depth()) + 1;
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+ApplyImpl::compute_fingerprint() const {
+	return start_fingerprint().add(operator_->get_fingerprint())
+			.add(argument_->get_fingerprint()).get();
+}
+
+TermSummary
+ApplyImpl::compute_summary() const {
+	return start_summary().add_child(operator_->get_summary())
+			.add_child(argument_->get_summary()).deepen();
 }
 
 
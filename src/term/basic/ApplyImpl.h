@@ -20,7 +20,6 @@
  * @endverbatim
  */
 
-#include "Lazy.h"
 #include "TermImpl.h"
 #include "term/IApply.h"
 
@@ -31,8 +30,10 @@ namespace basic {
 using namespace elision;
 using namespace elision::term;
 
-class ApplyImpl: public IApply, public TermImpl {
+class ApplyImpl final : public IApply, public TermImpl {
 public:
+	typedef IApply interface_type;
+
 	virtual ~ApplyImpl() = default;
 
 	inline pTerm get_operator() const {
@@ -43,41 +44,37 @@ public:
 		return argument_;
 	}
 
-	inline bool is_constant() const {
-		return constant_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(IApply, other);
-		return get_operator() == oth->get_operator() &&
-				get_argument() == oth->get_argument();
+		auto const& oth = impl_cast<ApplyImpl>(other);
+		return *operator_ == *oth.operator_ &&
+				*argument_ == *oth.argument_;
 	}
 
 	inline TermKind get_kind() const {
 		return APPLY_KIND;
 	}
 
-	virtual std::string to_string() const {
-		return strval_;
-	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IApply, other);
-		if (get_operator() < oth->get_operator()) return true;
-		else if (oth->get_operator() < get_operator()) return false;
-		else return get_argument() < oth->get_argument();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<ApplyImpl>(other);
+		if (operator_ < oth.operator_) return true;
+		else if (oth.operator_ < operator_) return false;
+		else return argument_ < oth.argument_;
 	}
 
 private:
 	friend class TermFactoryImpl;
 	ApplyImpl(Locus the_loc, pTerm op, pTerm argument, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	pTerm operator_;
 	pTerm argument_;
-	Lazy<bool> constant_;
-	Lazy<std::string> strval_;
 };
 
 
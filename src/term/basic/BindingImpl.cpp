@@ -18,58 +18,77 @@
  */
 
 #include "BindingImpl.h"
+#include <stdexcept>
 
 namespace elision {
 namespace term {
 namespace basic {
 
-BindingImpl::BindingImpl(Locus loc, BindingImpl::map_t* map, pTerm type) :
+BindingImpl::BindingImpl(Locus loc, BindingImpl::map_t const& map,
+		pTerm type) :
 		TermImpl(loc, type), map_(map) {
-	strval_ = [this]() {
-		std::string ret("{~ ");
-		for (auto elt : *map_) {
-			ret += escape(elt.first, true);
-			ret += "->";
-			ret += elt.second->to_string();
-		} // Add all the binds.
-		ret += " }";
-		return ret;
-	};
-	bool is_constant = true;
-	unsigned int depth = 0;
-	size_t hash = 0;
-	size_t other_hash = 1;
-	for (auto entry : *map_) {
-		is_constant = is_constant && entry.second->is_constant();
-		depth = std::max(depth, entry.second->get_depth());
-		hash = hash_combine(hash, entry.second);
-		other_hash = hash_combine(other_hash, entry.second);
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+BindingImpl::compute_fingerprint() const {
+	// The binds are added in order by name, so the fingerprint does not
+	// depend on the order in which the names were interned.
+	Fingerprinter print = start_fingerprint();
+	print.add(static_cast<uint64_t>(map_.size()));
+	for (auto bind : map_.sorted()) {
+		print.add(bind->first).add(bind->second->get_fingerprint());
+	} // Loop over all entries.
+	return print.get();
+}
+
+TermSummary
+BindingImpl::compute_summary() const {
+	// The depth of a binding does not include its type.
+	TermSummary summary;
+	summary.add_variables(type_->get_summary());
+	for (auto const& entry : map_) {
+		summary.add_child(entry.second->get_summary());
 	} // Loop over all entries.
-	constant_ = is_constant;
-	hash_ = hash;
-	other_hash_ = other_hash;
-	depth_ = depth + 1;
+	return summary.deepen();
 }
 
-std::shared_ptr<BindingImpl::map_t>
+BindingImpl::map_t
 BindingImpl::get_map() const {
 	return map_;
 }
 
 pTerm
 BindingImpl::get_bind(std::string const& name) const {
-	// Go and fetch the object related to this name.
-	return map_->at(name);
+	// A name that was never interned cannot be bound.
+	Atom atom;
+	if (!Atom::find(name, atom)) {
+		throw std::out_of_range("The name " + name + " is not bound.");
+	}
+	return get_bind(atom);
 }
 
 bool
 BindingImpl::has_bind(std::string const& name) const {
-	try {
-		map_->at(name);
-		return true;
-	} catch (std::out_of_range & e) {
-		return false;
+	Atom atom;
+	return Atom::find(name, atom) && has_bind(atom);
+}
+
+pTerm
+BindingImpl::get_bind(Atom name) const {
+	pTerm const* found = map_.find(name);
+	if (found == nullptr) {
+		throw std::out_of_range("The name " + name.get_name() +
+				" is not bound.");
 	}
+	return *found;
+}
+
+bool
+BindingImpl::has_bind(Atom name) const {
+	return map_.contains(name);
 }
 
 } /* namespace basic */
@@ -23,8 +23,6 @@
 #include "TermImpl.h"
 #include "term/IBinding.h"
 #include "term/ILambda.h"
-#include "Lazy.h"
-#include <memory>
 
 namespace elision {
 namespace term {
@@ -33,52 +31,50 @@ namespace basic {
 using namespace elision;
 using namespace elision::term;
 
-class BindingImpl: public IBinding, public TermImpl {
+class BindingImpl final : public IBinding, public TermImpl {
 public:
+	typedef IBinding interface_type;
+
 	virtual ~BindingImpl() = default;
 
-	virtual std::shared_ptr<map_t> get_map() const;
+	virtual map_t get_map() const;
 
 	virtual pTerm get_bind(std::string const& name) const;
 
 	virtual bool has_bind(std::string const& name) const;
 
-	inline bool is_constant() const {
-		return constant_;
-	}
+	virtual pTerm get_bind(Atom name) const;
+
+	virtual bool has_bind(Atom name) const;
 
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = dynamic_cast<IBinding const*>(&other);
-		return *get_map() == *oth->get_map();
+		auto const& oth = impl_cast<BindingImpl>(other);
+		return map_ == oth.map_;
 	}
 
 	inline TermKind get_kind() const {
 		return BINDING_KIND;
 	}
 
-	inline std::string to_string() const {
-		return strval_;
-	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IBinding, other);
-		// We have to compare all the items in the map.  This is complicated
-		// by the fact that the maps may have different keys, and we have to
-		// compare keys in a specific order.  So first we have to sort the
-		// keys, and then compare the keys in lexicographic order.  Fortunately
-		// this is how C++ stores its maps.  Hooray! (?)
-		return *map_ < *(oth->get_map());
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<BindingImpl>(other);
+		// The maps are compared bind by bind, in order by name.
+		return map_ < oth.map_;
 	}
 
 private:
 	friend class TermFactoryImpl;
-	BindingImpl(Locus the_loc, map_t* map, pTerm type);
-	std::shared_ptr<map_t> const map_;
-	Lazy<std::string> strval_;
-	Lazy<bool> constant_;
+	BindingImpl(Locus the_loc, map_t const& map, pTerm type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
+	map_t const map_;
 };
 
 } /* namespace basic */
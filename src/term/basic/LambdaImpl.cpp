@@ -18,6 +18,7 @@
  */
 
 #include <basic/LambdaImpl.h>
+#include <match/Program.h>
 
 namespace elision {
 namespace term {
@@ -26,21 +27,35 @@ namespace basic {
 LambdaImpl::LambdaImpl(Locus the_loc, pTerm the_lhs, pTerm the_rhs,
 		pTerm the_guard, pTerm the_type) : TermImpl(the_loc, the_type),
 				lhs_(the_lhs), rhs_(the_rhs), guard_(the_guard) {
-	strval_ = [this]() {
-		return lhs_->to_string() + " ->{ " + guard_->to_string() + " } " +
-				rhs_->to_string();
-	};
-	depth_ = [this, the_type]() {
-		// Depth does not depend on the guard.
-		return std::max(lhs_->get_depth(),
-				std::max(rhs_->get_depth(), the_type->get_depth())) + 1;
-	};
-	hash_ = [this]() {
-		return hash_combine(lhs_, rhs_);
-	};
-	other_hash_ = [this]() {
-		return other_hash_combine(lhs_, rhs_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+LambdaImpl::compute_fingerprint() const {
+	return start_fingerprint().add(lhs_->get_fingerprint())
+			.add(rhs_->get_fingerprint()).add(guard_->get_fingerprint()).get();
+}
+
+TermSummary
+LambdaImpl::compute_summary() const {
+	// Depth does not depend on the guard.
+	TermSummary guard = guard_->get_summary();
+	return start_summary().add_child(lhs_->get_summary())
+			.add_child(rhs_->get_summary()).add_constant(guard)
+			.add_variables(guard).deepen();
+}
+
+std::shared_ptr<match::Program const>
+LambdaImpl::get_program(TermFactory const& fact) const {
+	// Two threads may both compile the first time; either result will do.
+	auto program = std::atomic_load(&program_);
+	if (program == nullptr) {
+		program = std::make_shared<match::Program const>(fact, lhs_);
+		std::atomic_store(&program_, program);
+	}
+	return program;
 }
 
 } /* namespace basic */
@@ -22,17 +22,26 @@
 
 #include "TermImpl.h"
 #include "term/ILambda.h"
-#include <Lazy.h>
+#include <memory>
 
 namespace elision {
+namespace match {
+class Program;
+} /* namespace match */
+
 namespace term {
+
+class TermFactory;
+
 namespace basic {
 
 using namespace elision;
 using namespace elision::term;
 
-class LambdaImpl: public ILambda, public TermImpl {
+class LambdaImpl final : public ILambda, public TermImpl {
 public:
+	typedef ILambda interface_type;
+
 	virtual ~LambdaImpl() = default;
 
 	inline pTerm get_lhs() const {
@@ -47,46 +56,54 @@ public:
 		return guard_;
 	}
 
-	inline bool is_constant() const {
-		return lhs_->is_constant() && rhs_->is_constant() &&
-				guard_->is_constant();
-	}
+	/**
+	 * Get the left-hand side compiled for matching.  It is compiled the
+	 * first time it is asked for, and kept.  The program does not keep the
+	 * factory, so it may be run with any factory.
+	 * @param fact	A factory to compile with.
+	 * @return	The compiled left-hand side.
+	 */
+	std::shared_ptr<match::Program const> get_program(
+			TermFactory const& fact) const;
 
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = dynamic_cast<ILambda const*>(&other);
-		return *get_lhs() == *oth->get_lhs() &&
-				*get_rhs() == *oth->get_rhs() &&
-				*get_guard() == *oth->get_guard();
+		auto const& oth = impl_cast<LambdaImpl>(other);
+		return *lhs_ == *oth.lhs_ &&
+				*rhs_ == *oth.rhs_ &&
+				*guard_ == *oth.guard_;
 	}
 
 	inline TermKind get_kind() const {
 		return LAMBDA_KIND;
 	}
 
-	inline std::string to_string() const {
-		return strval_;
-	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(ILambda, other);
-		if (get_lhs() < oth->get_lhs()) return true;
-		else if (oth->get_lhs() < get_lhs()) return false;
-		else if (get_rhs() < oth->get_rhs()) return true;
-		else if (oth->get_rhs() < get_rhs()) return false;
-		else return get_guard() < oth->get_guard();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<LambdaImpl>(other);
+		if (lhs_ < oth.lhs_) return true;
+		else if (oth.lhs_ < lhs_) return false;
+		else if (rhs_ < oth.rhs_) return true;
+		else if (oth.rhs_ < rhs_) return false;
+		else return guard_ < oth.guard_;
 	}
 
 private:
 	friend class TermFactoryImpl;
 	LambdaImpl(Locus the_loc, pTerm the_lhs, pTerm the_rhs, pTerm the_gaurd,
 			pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	pTerm lhs_;
 	pTerm rhs_;
 	pTerm guard_;
-	Lazy<std::string> strval_;
+	// Compiled on first use, and shared by the threads that use it.
+	mutable std::shared_ptr<match::Program const> program_;
 };
 
 } /* namespace basic */
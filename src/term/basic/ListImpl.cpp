@@ -23,32 +23,64 @@ namespace elision {
 namespace term {
 namespace basic {
 
+constexpr size_t ListImpl::TREE_SIZE;
+
 ListImpl::ListImpl(Locus the_loc, pPropertySpecification the_spec,
-		std::vector<pTerm>& the_elements, pTerm the_type) :
-			TermImpl(the_loc, the_type), properties_(the_spec),
-			elements_(the_elements) {
-	strval_ = [this]() {
-		bool first = true;
-		std::string res = properties_->to_string() + "(";
-		for (auto i : elements_) {
-			res += (first ? "" : ", ") + i.get()->to_string();
-		} // Add all elements.
-		return res + ")";
-	};
-	bool constant = true;
-	unsigned int depth = std::max(the_type->get_depth(), the_spec->get_depth());
-	size_t hash = hash_combine(the_type, the_spec);
-	size_t other_hash = hash_combine(the_type, the_spec);
-	for (auto elt : elements_) {
-		constant = constant && elt.get()->is_constant();
-		depth = std::max(depth, elt.get()->get_depth());
-		hash = hash_combine(hash, elt);
-		other_hash = other_hash_combine(other_hash, elt);
+		std::vector<pTerm>&& the_elements, pTerm the_type) :
+			TermImpl(the_loc, the_type), properties_(the_spec) {
+	if (the_elements.size() > TREE_SIZE) {
+		tree_ = tree_type(std::make_move_iterator(the_elements.begin()),
+				std::make_move_iterator(the_elements.end()));
+	} else {
+		elements_ = std::move(the_elements);
+	}
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+ListImpl::ListImpl(Locus the_loc, pPropertySpecification the_spec,
+		tree_type&& the_elements, pTerm the_type) :
+			TermImpl(the_loc, the_type), properties_(the_spec) {
+	if (the_elements.size() > TREE_SIZE) {
+		tree_ = std::move(the_elements);
+	} else {
+		elements_.assign(the_elements.begin(), the_elements.end());
+	}
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+ElementMeasure::value_type
+ListImpl::measure() const {
+	// The tree keeps the measure of its elements.
+	if (is_tree()) return tree_.get_measure();
+	ElementMeasure::value_type measure = ElementMeasure::identity();
+	for (auto const& elt : elements_) {
+		measure = ElementMeasure::combine(measure, ElementMeasure::of(elt));
 	} // Iterate over contents.
-	constant_ = constant;
-	depth_ = depth;
-	hash_ = hash;
-	other_hash_ = other_hash;
+	return measure;
+}
+
+Fingerprint
+ListImpl::compute_fingerprint() const {
+	// The elements are added as a sequence print, which a tree keeps as it
+	// is built.
+	Fingerprinter print = start_fingerprint();
+	print.add(properties_->get_fingerprint());
+	print.add(static_cast<uint64_t>(size()));
+	print.add(measure().print.get());
+	return print.get();
+}
+
+TermSummary
+ListImpl::compute_summary() const {
+	// Only the elements decide whether the list is constant.
+	TermSummary properties = properties_->get_summary();
+	TermSummary summary = start_summary();
+	summary.add_depth(properties).add_variables(properties);
+	return summary.add_child(measure().summary);
 }
 
 } /* namespace basic */
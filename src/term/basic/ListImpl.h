@@ -20,74 +20,152 @@
  * @endverbatim
  */
 
-#include <Lazy.h>
 #include <basic/TermImpl.h>
 #include <IList.h>
+#include "RrbVector.h"
+#include <algorithm>
 #include <vector>
 
 namespace elision {
 namespace term {
 namespace basic {
 
-class ListImpl: public IList, public TermImpl {
+/**
+ * The measure kept in each node of the tree holding a large list: the
+ * summary and the sequence print of the elements below the node.  With
+ * these, the summary and fingerprint of a list made by catenating or
+ * slicing are found without visiting every element.
+ */
+struct ElementMeasure {
+	struct value_type {
+		TermSummary summary;
+		SequencePrint print;
+	};
+
+	static inline value_type identity() {
+		return value_type();
+	}
+
+	static inline value_type of(pTerm const& elt) {
+		value_type measure;
+		measure.summary.add_child(elt->get_summary());
+		measure.print = SequencePrint(elt->get_fingerprint());
+		return measure;
+	}
+
+	static inline value_type combine(value_type const& first,
+			value_type const& second) {
+		value_type measure = first;
+		measure.summary.add_child(second.summary);
+		measure.print.append(second.print);
+		return measure;
+	}
+};
+
+/**
+ * Implement a list.  Small lists hold their elements in a vector.  Lists
+ * with more than `TREE_SIZE` elements hold them in a persistent tree, so that
+ * lists made from them by catenation and slicing share most of their
+ * storage and are made in logarithmic time.
+ */
+class ListImpl final : public IList, public TermImpl {
 public:
+	typedef IList interface_type;
+
+	/// The persistent tree used for large lists.
+	typedef RrbVector<pTerm, ElementMeasure> tree_type;
+
+	/// Lists with more elements than this are held in a tree.
+	static constexpr size_t TREE_SIZE = 128;
+
 	virtual ~ListImpl() = default;
 
 	inline pPropertySpecification get_property_specification() const {
 		return properties_;
 	}
 
-	inline std::vector<pTerm> get_elements() const {
-		return elements_;
+	/// A small list is one run, and a large list has a run for each leaf.
+	inline ElementSpan get_chunk(size_t position) const {
+		if (is_tree()) {
+			auto chunk = tree_.get_chunk(position);
+			return ElementSpan(chunk.first, chunk.second);
+		}
+		return ElementSpan(elements_.data() + position,
+				elements_.data() + elements_.size());
 	}
 
 	inline pTerm operator[](size_t position) const {
-		return elements_[position];
+		return is_tree() ? tree_[position] : elements_[position];
 	}
 
 	inline size_t size() const {
-		return elements_.size();
+		return is_tree() ? tree_.size() : elements_.size();
+	}
+
+	/**
+	 * Determine whether the elements are held in a tree.
+	 * @return	True iff this is a large list.
+	 */
+	inline bool is_tree() const {
+		return !tree_.empty();
 	}
 
-	inline bool is_constant() const {
-		return constant_;
+	/**
+	 * Get the elements as a tree.  A large list shares its tree, and a small
+	 * list makes one.
+	 * @return	The tree.
+	 */
+	inline tree_type get_tree() const {
+		return is_tree() ? tree_ :
+				tree_type(elements_.begin(), elements_.end());
 	}
 
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = dynamic_cast<IList const*>(&other);
-		return get_property_specification() ==
-				oth->get_property_specification() &&
-				get_elements() == oth->get_elements();
+		auto const& oth = impl_cast<ListImpl>(other);
+		if (!(*properties_ == *oth.properties_) || size() != oth.size()) {
+			return false;
+		}
+		if (is_tree() && tree_.is_same(oth.tree_)) return true;
+		return std::equal(begin(), end(), oth.begin(),
+				[](pTerm const& first, pTerm const& second) {
+					return *first == *second;
+				});
 	}
 
 	inline TermKind get_kind() const {
 		return LIST_KIND;
 	}
 
-	virtual std::string to_string() const {
-		return strval_;
-	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IList, other);
-		if (get_property_specification() < oth->get_property_specification())
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<ListImpl>(other);
+		if (properties_ < oth.properties_)
 			return true;
-		else if (oth->get_property_specification() < get_property_specification())
+		else if (oth.properties_ < properties_)
 			return false;
-		else return get_elements() < oth->get_elements();
+		else return std::lexicographical_compare(begin(), end(),
+				oth.begin(), oth.end());
 	}
 
 private:
 	friend class TermFactoryImpl;
 	ListImpl(Locus the_loc, pPropertySpecification the_spec,
-			std::vector<pTerm>& the_elements, pTerm the_type);
+			std::vector<pTerm>&& the_elements, pTerm the_type);
+	ListImpl(Locus the_loc, pPropertySpecification the_spec,
+			tree_type&& the_elements, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
+	ElementMeasure::value_type measure() const;
 	pPropertySpecification properties_;
+	// Exactly one of these holds the elements, depending on the size.
 	std::vector<pTerm> elements_;
-	Lazy<std::string> strval_;
-	Lazy<bool> constant_;
+	tree_type tree_;
 };
 
 } /* namespace basic */
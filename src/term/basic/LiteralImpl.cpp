@@ -29,20 +29,21 @@ namespace basic {
 // Symbol literal.
 //======================================================================
 
-SymbolLiteralImpl::SymbolLiteralImpl(Locus the_loc, std::string the_name,
+SymbolLiteralImpl::SymbolLiteralImpl(Locus the_loc, Atom the_name,
 		pTerm the_type) : TermImpl(the_loc, the_type), name_(the_name) {
-	strval_ = [this]() {
-		return elision::escape(name_, true) + WITH_TYPE(type_);
-	};
-	depth_ = [this, the_type]() {
-		return the_type->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		return boost::hash<std::string>()(name_);
-	};
-	other_hash_ = [this]() {
-		return other_hash_combine(std::hash<std::string>()(name_), type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+SymbolLiteralImpl::compute_fingerprint() const {
+	return start_fingerprint().add(name_).get();
+}
+
+TermSummary
+SymbolLiteralImpl::compute_summary() const {
+	return start_summary();
 }
 
 //======================================================================
@@ -51,40 +52,41 @@ SymbolLiteralImpl::SymbolLiteralImpl(Locus the_loc, std::string the_name,
 
 StringLiteralImpl::StringLiteralImpl(Locus the_loc, std::string the_value,
 		pTerm the_type) : TermImpl(the_loc, the_type), value_(the_value) {
-	strval_ = [this]() {
-		return elision::escape(value_, false) + WITH_TYPE(type_);
-	};
-	depth_ = [this, the_type]() {
-		return the_type->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		return boost::hash<std::string>()(value_);
-	};
-	other_hash_ = [this]() {
-		return other_hash_combine(std::hash<std::string>()(value_), type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+StringLiteralImpl::compute_fingerprint() const {
+	return start_fingerprint().add(value_).get();
+}
+
+TermSummary
+StringLiteralImpl::compute_summary() const {
+	return start_summary();
 }
 
 //======================================================================
 // Integer literal.
 //======================================================================
 
-IntegerLiteralImpl::IntegerLiteralImpl(Locus the_loc, eint_t the_value,
-		pTerm the_type) : TermImpl(the_loc, the_type), value_(the_value) {
-	strval_ = [this]() {
-		return elision::eint_to_string(value_,
-				elision::preferred_radix, true) + WITH_TYPE(type_);
-	};
-	depth_ = [this, the_type]() {
-		return the_type->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		return boost::hash<std::string>()(strval_);
-	};
-	other_hash_ = [this]() {
-		size_t hash = std::hash<std::string>()(strval_);
-		return other_hash_combine(hash, type_);
-	};
+IntegerLiteralImpl::IntegerLiteralImpl(Locus the_loc, Integer the_value,
+		pTerm the_type) : TermImpl(the_loc, the_type),
+				value_(std::move(the_value)) {
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+IntegerLiteralImpl::compute_fingerprint() const {
+	return start_fingerprint().add_integer(value_).get();
+}
+
+TermSummary
+IntegerLiteralImpl::compute_summary() const {
+	return start_summary();
 }
 
 //======================================================================
@@ -103,22 +105,20 @@ FloatLiteralImpl::FloatLiteralImpl(Locus the_loc, eint_t the_significand,
 				"The radix is not an allowed value: " +
 				boost::lexical_cast<std::string>(the_radix));
 	}
-	strval_ = [this]() {
-		return elision::eint_to_string(significand_, radix_, true) +
-				(radix_ == 16 ? "p" : "e") +
-				elision::eint_to_string(exponent_, radix_, true) +
-				WITH_TYPE(type_);
-	};
-	depth_ = [this, the_type]() {
-		return the_type->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		return boost::hash<std::string>()(strval_);
-	};
-	other_hash_ = [this]() {
-		size_t hash = std::hash<std::string>()(strval_);
-		return other_hash_combine(hash, type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+FloatLiteralImpl::compute_fingerprint() const {
+	return start_fingerprint().add_integer(significand_)
+			.add_integer(exponent_).add(static_cast<uint64_t>(radix_)).get();
+}
+
+TermSummary
+FloatLiteralImpl::compute_summary() const {
+	return start_summary();
 }
 
 //======================================================================
@@ -128,21 +128,19 @@ FloatLiteralImpl::FloatLiteralImpl(Locus the_loc, eint_t the_significand,
 BitStringLiteralImpl::BitStringLiteralImpl(Locus the_loc, eint_t the_bits,
 		eint_t the_length, pTerm the_type) : TermImpl(the_loc, the_type),
 				bits_(the_bits), length_(the_length) {
-	strval_ = [this]() {
-		return elision::eint_to_string(bits_, 16, true) + "L" +
-				elision::eint_to_string(length_, 10, true) +
-				WITH_TYPE(type_);
-	};
-	depth_ = [this, the_type]() {
-		return the_type->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		return boost::hash<std::string>()(strval_);
-	};
-	other_hash_ = [this]() {
-		size_t hash = std::hash<std::string>()(strval_);
-		return other_hash_combine(hash, type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+BitStringLiteralImpl::compute_fingerprint() const {
+	return start_fingerprint().add_integer(bits_).add_integer(length_).get();
+}
+
+TermSummary
+BitStringLiteralImpl::compute_summary() const {
+	return start_summary();
 }
 
 //======================================================================
@@ -151,20 +149,19 @@ BitStringLiteralImpl::BitStringLiteralImpl(Locus the_loc, eint_t the_bits,
 
 BooleanLiteralImpl::BooleanLiteralImpl(Locus the_loc, bool the_value,
 		pTerm the_type) : TermImpl(the_loc, the_type), value_(the_value) {
-	strval_ = [this]() {
-		return std::string(value_ ? "true" : "false") + WITH_TYPE(type_);
-	};
-	depth_ = [this, the_type]() {
-		return the_type->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		size_t hash = value_ ? 1 : 0;
-		return hash_combine(hash, type_);
-	};
-	other_hash_ = [this]() {
-		size_t hash = value_ ? 18 : 23;
-		return other_hash_combine(hash, type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+BooleanLiteralImpl::compute_fingerprint() const {
+	return start_fingerprint().add(static_cast<uint64_t>(value_)).get();
+}
+
+TermSummary
+BooleanLiteralImpl::compute_summary() const {
+	return start_summary();
 }
 
 //======================================================================
@@ -173,18 +170,21 @@ BooleanLiteralImpl::BooleanLiteralImpl(Locus the_loc, bool the_value,
 
 TermLiteralImpl::TermLiteralImpl(Locus the_loc, pTerm the_term,
 		pTerm the_type) : TermImpl(the_loc, the_type), term_(the_term) {
-	strval_ = [this]() {
-		return "<" + term_->to_string() + ">";
-	};
-	depth_ = [this, the_type]() {
-		return std::max(term_->get_depth(), the_type->get_depth()) + 1;
-	};
-	hash_ = [this]() {
-		return hash_combine(term_->get_hash(), type_);
-	};
-	other_hash_ = [this]() {
-		return other_hash_combine(term_->get_other_hash(), type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+TermLiteralImpl::compute_fingerprint() const {
+	return start_fingerprint().add(term_->get_fingerprint()).get();
+}
+
+TermSummary
+TermLiteralImpl::compute_summary() const {
+	// The quoted term is constant, but it still holds its variables.
+	TermSummary term = term_->get_summary();
+	return start_summary().add_depth(term).add_variables(term);
 }
 
 } /* namespace basic */
@@ -22,7 +22,6 @@
 
 #include "TermImpl.h"
 #include "term/ILiteral.h"
-#include <Lazy.h>
 
 namespace elision {
 namespace term {
@@ -32,143 +31,135 @@ using namespace elision;
 using namespace elision::term;
 
 
-class SymbolLiteralImpl : public ISymbolLiteral, public TermImpl {
+class SymbolLiteralImpl final : public ISymbolLiteral, public TermImpl {
 public:
-	inline std::string const get_name() const {
-		return name_;
-	}
+	typedef ISymbolLiteral interface_type;
 
-	inline bool is_constant() const {
-		return true;
+	inline std::string const& get_name() const {
+		return name_.get_name();
 	}
 
-	inline std::string to_string() const {
-		return strval_;
+	inline Atom get_atom() const {
+		return name_;
 	}
 
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(ISymbolLiteral, other);
-		return get_name() == oth->get_name() &&
-				get_type() == oth->get_type();
+		auto const& oth = impl_cast<SymbolLiteralImpl>(other);
+		return name_ == oth.name_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(ISymbolLiteral, other);
-		return get_name() < oth->get_name() ||
-				get_type() < oth->get_type();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<SymbolLiteralImpl>(other);
+		return name_less(name_, oth.name_) ||
+				type_ < oth.type_;
 	}
 
 	inline TermKind get_kind() const {
 		return SYMBOL_LITERAL_KIND;
 	}
 
-	inline unsigned int get_depth() const {
-		return get_type()->get_depth();
-	}
 
 private:
 	friend class TermFactoryImpl;
-	SymbolLiteralImpl(Locus the_loc, std::string the_name, pTerm the_type);
-	std::string const name_;
-	Lazy<std::string> strval_;
+	SymbolLiteralImpl(Locus the_loc, Atom the_name, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
+	Atom const name_;
 };
 
 
-class StringLiteralImpl : public IStringLiteral, public TermImpl {
+class StringLiteralImpl final : public IStringLiteral, public TermImpl {
 public:
+	typedef IStringLiteral interface_type;
+
 	inline std::string const get_value() const {
 		return value_;
 	}
 
-	inline bool is_constant() const {
-		return true;
-	}
-
-	inline std::string to_string() const {
-		return strval_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(IStringLiteral, other);
-		return get_value() == oth->get_value() &&
-				get_type() == oth->get_type();
+		auto const& oth = impl_cast<StringLiteralImpl>(other);
+		return value_ == oth.value_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IStringLiteral, other);
-		return get_value() < oth->get_value() ||
-				get_type() < oth->get_type();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<StringLiteralImpl>(other);
+		return value_ < oth.value_ ||
+				type_ < oth.type_;
 	}
 
 	inline TermKind get_kind() const {
 		return STRING_LITERAL_KIND;
 	}
 
-	inline unsigned int get_depth() const {
-		return get_type()->get_depth();
-	}
 
 private:
 	friend class TermFactoryImpl;
 	StringLiteralImpl(Locus the_loc, std::string the_value, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	std::string const value_;
-	Lazy<std::string> strval_;
 };
 
 
-class IntegerLiteralImpl : public IIntegerLiteral, public TermImpl {
+class IntegerLiteralImpl final : public IIntegerLiteral, public TermImpl {
 public:
-	inline eint_t get_value() const {
-		return value_;
-	}
+	typedef IIntegerLiteral interface_type;
 
-	inline bool is_constant() const {
-		return true;
+	inline eint_t get_value() const {
+		return value_.get();
 	}
 
-	inline std::string to_string() const {
-		return strval_;
+	inline Integer const& get_integer() const {
+		return value_;
 	}
 
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(IIntegerLiteral, other);
-		return get_value() == oth->get_value() &&
-				get_type() == oth->get_type();
+		auto const& oth = impl_cast<IntegerLiteralImpl>(other);
+		return value_ == oth.value_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IIntegerLiteral, other);
-		return get_value() < oth->get_value() ||
-				get_type() < oth->get_type();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<IntegerLiteralImpl>(other);
+		return value_ < oth.value_ ||
+				type_ < oth.type_;
 	}
 
 	inline TermKind get_kind() const {
 		return INTEGER_LITERAL_KIND;
 	}
 
-	inline unsigned int get_depth() const {
-		return get_type()->get_depth();
-	}
 
 private:
 	friend class TermFactoryImpl;
-	IntegerLiteralImpl(Locus the_loc, eint_t the_value, pTerm the_type);
-	eint_t const value_;
-	Lazy<std::string> strval_;
+	IntegerLiteralImpl(Locus the_loc, Integer the_value, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
+	Integer const value_;
 };
 
 
-class FloatLiteralImpl : public IFloatLiteral, public TermImpl {
+class FloatLiteralImpl final : public IFloatLiteral, public TermImpl {
 public:
+	typedef IFloatLiteral interface_type;
+
 	inline eint_t get_significand() const {
 		return significand_;
 	}
@@ -181,21 +172,12 @@ public:
 		return radix_;
 	}
 
-	inline bool is_constant() const {
-		return true;
-	}
-
-	inline std::string to_string() const {
-		return strval_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
 		// TODO Really should check the computed values somehow.
-		auto oth = CAST(IFloatLiteral, other);
-		return (get_significand() == oth->get_significand()) &&
-				(get_exponent() == oth->get_exponent()) &&
-				(get_radix() == oth->get_radix()) &&
-				(get_type() == oth->get_type());
+		auto const& oth = impl_cast<FloatLiteralImpl>(other);
+		return (significand_ == oth.significand_) &&
+				(exponent_ == oth.exponent_) &&
+				(radix_ == oth.radix_);
 	}
 
 	inline bool operator<(ITerm const& other) const {
@@ -203,34 +185,37 @@ public:
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IFloatLiteral, other);
-		return (get_significand() < oth->get_significand()) ||
-				(get_exponent() < oth->get_exponent()) ||
-				(get_radix() < oth->get_radix()) ||
-				(get_type() < oth->get_type());
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<FloatLiteralImpl>(other);
+		return (significand_ < oth.significand_) ||
+				(exponent_ < oth.exponent_) ||
+				(radix_ < oth.radix_) ||
+				(type_ < oth.type_);
 	}
 
 	inline TermKind get_kind() const {
 		return FLOAT_LITERAL_KIND;
 	}
 
-	inline unsigned int get_depth() const {
-		return get_type()->get_depth();
-	}
 
 private:
 	friend class TermFactoryImpl;
 	FloatLiteralImpl(Locus the_loc, eint_t the_significand, eint_t the_exponent,
 			uint8_t the_radix, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	eint_t const significand_;
 	eint_t const exponent_;
 	uint8_t const radix_;
-	Lazy<std::string> strval_;
 };
 
 
-class BitStringLiteralImpl : public IBitStringLiteral, public TermImpl {
+class BitStringLiteralImpl final : public IBitStringLiteral, public TermImpl {
 public:
+	typedef IBitStringLiteral interface_type;
+
 	inline eint_t get_bits() const {
 		return bits_;
 	}
@@ -239,76 +224,64 @@ public:
 		return length_;
 	}
 
-	inline bool is_constant() const {
-		return true;
-	}
-
-	inline std::string to_string() const {
-		return strval_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(IBitStringLiteral, other);
-		return (get_bits() == oth->get_bits()) &&
-				(get_length() == oth->get_length()) &&
-				(get_type() == oth->get_type());
+		auto const& oth = impl_cast<BitStringLiteralImpl>(other);
+		return (bits_ == oth.bits_) &&
+				(length_ == oth.length_);
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IBitStringLiteral, other);
-		return get_bits() < oth->get_bits() ||
-				get_length() < oth->get_length() ||
-				get_type() < oth->get_type();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<BitStringLiteralImpl>(other);
+		return bits_ < oth.bits_ ||
+				length_ < oth.length_ ||
+				type_ < oth.type_;
 	}
 
 	inline TermKind get_kind() const {
 		return BIT_STRING_LITERAL_KIND;
 	}
 
-	inline unsigned int get_depth() const {
-		return get_type()->get_depth();
-	}
 
 private:
 	friend class TermFactoryImpl;
 	BitStringLiteralImpl(Locus the_loc, eint_t the_bits, eint_t the_length,
 			pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	eint_t const bits_;
 	eint_t const length_;
-	Lazy<std::string> strval_;
 };
 
 
-class BooleanLiteralImpl : public IBooleanLiteral, public TermImpl {
+class BooleanLiteralImpl final : public IBooleanLiteral, public TermImpl {
 public:
+	typedef IBooleanLiteral interface_type;
+
 	inline bool get_value() const {
 		return value_;
 	}
 
-	inline bool is_constant() const {
-		return true;
-	}
-
-	inline std::string to_string() const {
-		return strval_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(IBooleanLiteral, other);
-		return get_value() == oth->get_value() &&
-				get_type() == oth->get_type();
+		auto const& oth = impl_cast<BooleanLiteralImpl>(other);
+		return value_ == oth.value_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IBooleanLiteral, other);
-		return get_value() < oth->get_value() ||
-				get_type() < oth->get_type();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<BooleanLiteralImpl>(other);
+		return value_ < oth.value_ ||
+				type_ < oth.type_;
 	}
 
 	inline TermKind get_kind() const {
@@ -323,58 +296,51 @@ public:
 		return !value_;
 	}
 
-	inline unsigned int get_depth() const {
-		return get_type()->get_depth();
-	}
 
 private:
 	friend class TermFactoryImpl;
 	BooleanLiteralImpl(Locus the_loc, bool value, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	bool const value_;
-	Lazy<std::string> strval_;
 };
 
 
-class TermLiteralImpl : public ITermLiteral, public TermImpl {
+class TermLiteralImpl final : public ITermLiteral, public TermImpl {
 public:
+	typedef ITermLiteral interface_type;
+
 	inline pTerm get_term() const {
 		return term_;
 	}
 
-	inline bool is_constant() const {
-		return true;
-	}
-
-	inline std::string to_string() const {
-		return strval_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = dynamic_cast<TermLiteralImpl const&>(other);
-		return get_term() == oth.get_term();
+		auto const& oth = impl_cast<TermLiteralImpl>(other);
+		return *term_ == *oth.term_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(ITermLiteral, other);
-		return get_term() < oth->get_term();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<TermLiteralImpl>(other);
+		return term_ < oth.term_;
 	}
 
 	inline TermKind get_kind() const {
 		return TERM_LITERAL_KIND;
 	}
 
-	inline unsigned int get_depth() const {
-		return std::max(get_type()->get_depth(), get_term()->get_depth());
-	}
 
 private:
 	friend class TermFactoryImpl;
 	TermLiteralImpl(Locus the_loc, pTerm the_term, pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	pTerm term_;
-	Lazy<std::string> strval_;
 };
 
 } /* namespace basic */
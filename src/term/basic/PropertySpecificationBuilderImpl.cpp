@@ -18,23 +18,29 @@
  */
 
 #include <basic/PropertySpecificationBuilderImpl.h>
-#include <basic/PropertySpecificationImpl.h>
+#include <basic/TermFactoryImpl.h>
 
 namespace elision {
 namespace term {
 namespace basic {
 
 PropertySpecificationBuilderImpl::PropertySpecificationBuilderImpl(
-		pTerm TRUE, pTerm FALSE, pTerm type) : TRUE_(TRUE), FALSE_(FALSE),
-				type_(type) {
+		TermFactoryImpl const& fact, LocPolicy locs) : fact_(&fact),
+				TRUE_(fact.TRUE), FALSE_(fact.FALSE), type_(fact.PROPERTIES),
+				locs_(locs) {
+}
+
+PropertySpecificationBuilderImpl::PropertySpecificationBuilderImpl(
+		pTerm TRUE, pTerm FALSE, pTerm type, LocPolicy locs) : TRUE_(TRUE),
+				FALSE_(FALSE), type_(type), locs_(locs) {
 }
 
 pPropertySpecification
 PropertySpecificationBuilderImpl::get() {
-	auto ret = new PropertySpecificationImpl(loc_, associative_, commutative_,
-			idempotent_, absorber_, identity_, elements_, type_);
+	auto ret = fact_->get_property_specification(loc_, associative_,
+			commutative_, idempotent_, absorber_, identity_, elements_);
 	reset();
-	return std::shared_ptr<IPropertySpecification const>(ret);
+	return ret;
 }
 
 PropertySpecificationBuilder *
@@ -52,7 +58,7 @@ PropertySpecificationBuilderImpl::reset() {
 PropertySpecificationBuilder *
 PropertySpecificationBuilderImpl::set_loc(Locus loc) {
 	NOTNULL(loc);
-	loc_ = loc;
+	if (locs_ == KEEP_LOCATIONS) loc_ = loc;
 	return this;
 }
 
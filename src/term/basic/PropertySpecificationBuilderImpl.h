@@ -26,6 +26,8 @@ namespace elision {
 namespace term {
 namespace basic {
 
+class TermFactoryImpl;
+
 class PropertySpecificationBuilderImpl: public elision::term::PropertySpecificationBuilder {
 public:
 	/// Deallocate this instance.
@@ -72,18 +74,32 @@ public:
 	virtual PropertySpecificationBuilder * set_membership(
 			boost::optional<pTerm> value);
 
-private:
+protected:
 	friend class TermFactoryImpl;
+	/**
+	 * Make a new instance that builds specifications with a factory, which
+	 * interns them.
+	 * @param fact	The factory.
+	 * @param locs	Whether to record the location given by `set_loc`.
+	 */
+	PropertySpecificationBuilderImpl(TermFactoryImpl const& fact,
+			LocPolicy locs);
+
 	/**
 	 * Make a new instance.  The true and false values muse be specified so
 	 * that this class can turn simple Boolean values into terms without
-	 * needing access to a term factory.
+	 * needing access to a term factory.  There is no factory to intern the
+	 * result, so a subclass using this must override `get`.
 	 *
 	 * @param TRUE	The true value.
 	 * @param FALSE	The false value.
 	 * @param type	The type to use for property specifications.
+	 * @param locs	Whether to record the location given by `set_loc`.
 	 */
-	PropertySpecificationBuilderImpl(pTerm TRUE, pTerm FALSE, pTerm type);
+	PropertySpecificationBuilderImpl(pTerm TRUE, pTerm FALSE, pTerm type,
+			LocPolicy locs = KEEP_LOCATIONS);
+
+	TermFactoryImpl const* fact_ = nullptr;
 
 	pTerm TRUE_;
 	pTerm FALSE_;
@@ -95,6 +111,7 @@ private:
 	boost::optional<pTerm> elements_;
 	Locus loc_ = Loc::get_internal();
 	pTerm type_;
+	LocPolicy locs_;
 };
 
 } /* namespace basic */
@@ -22,137 +22,88 @@
 
 #include <basic/TermImpl.h>
 #include <IPropertySpecification.h>
-#include <Lazy.h>
 
 namespace elision {
 namespace term {
 namespace basic {
 
 /**
- * 
+ * Implement a property specification.  Each property is held as a term
+ * pointer that is null when the property is unspecified, and the flags are
+ * computed once, when the specification is made.  Specifications are
+ * interned by the factory, so equal specifications are the same instance.
  */
-class PropertySpecificationImpl: public IPropertySpecification, public TermImpl {
+class PropertySpecificationImpl final : public IPropertySpecification, public TermImpl {
 public:
+	typedef IPropertySpecification interface_type;
+
 	virtual ~PropertySpecificationImpl() = default;
 
 	inline boost::optional<pTerm> get_associative() const {
-		return associative_;
+		return optional(associative_);
 	}
 
 	inline boost::optional<pTerm> get_commutative() const {
-		return commutative_;
+		return optional(commutative_);
 	}
 
 	inline boost::optional<pTerm> get_idempotent() const {
-		return idempotent_;
+		return optional(idempotent_);
 	}
 
 	inline boost::optional<pTerm> get_absorber() const {
-		return absorber_;
+		return optional(absorber_);
 	}
 
 	inline boost::optional<pTerm> get_identity() const {
-		return identity_;
+		return optional(identity_);
 	}
 
 	inline boost::optional<pTerm> get_membership() const {
-		return elements_;
-	}
-
-	inline bool check_associative(bool def) const {
-		if (associative_) {
-			// The value is set.  Get it and see if it is a constant.
-			pTerm value = associative_.get();
-			if (value->is_true()) {
-				return true;
-			}
-			if (value->is_false()) {
-				return false;
-			}
-		}
-		return def;
-	}
-
-	inline bool check_commutative(bool def) const {
-		if (commutative_) {
-			// The value is set.  Get it and see if it is a constant.
-			pTerm value = commutative_.get();
-			if (value->is_true()) {
-				return true;
-			}
-			if (value->is_false()) {
-				return false;
-			}
-		}
-		return def;
-	}
-
-	inline bool check_idempotent(bool def) const {
-		if (idempotent_) {
-			// The value is set.  Get it and see if it is a constant.
-			pTerm value = commutative_.get();
-			if (value->is_true()) {
-				return true;
-			}
-			if (value->is_false()) {
-				return false;
-			}
-		}
-		return def;
-	}
-
-	inline bool has_absorber() const {
-		return absorber_.is_initialized();
-	}
-
-	inline bool has_identity() const {
-		return identity_.is_initialized();
+		return optional(elements_);
 	}
 
-	inline bool has_membership() const {
-		return elements_.is_initialized();
-	}
-
-	inline bool is_constant() const {
-		return constant_;
+	inline flags_type get_flags() const {
+		return flags_;
 	}
 
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(IPropertySpecification, other);
-		return associative_ == oth->get_associative() &&
-				commutative_ == oth->get_commutative() &&
-				idempotent_ == oth->get_idempotent() &&
-				absorber_ == oth->get_absorber() &&
-				identity_ == oth->get_identity() &&
-				elements_ == oth->get_membership();
+		auto const& oth = impl_cast<PropertySpecificationImpl>(other);
+		return flags_ == oth.flags_ &&
+				same(associative_, oth.associative_) &&
+				same(commutative_, oth.commutative_) &&
+				same(idempotent_, oth.idempotent_) &&
+				same(absorber_, oth.absorber_) &&
+				same(identity_, oth.identity_) &&
+				same(elements_, oth.elements_);
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() < other.get_kind()) return true;
-		auto oth = CAST(IPropertySpecification, other);
-		if (get_associative() < oth->get_associative()) return true;
-		else if (oth->get_associative() < get_associative()) return false;
-		else if (get_commutative() < oth->get_commutative()) return true;
-		else if (oth->get_commutative() < get_commutative()) return false;
-		else if (get_idempotent() < oth->get_idempotent()) return true;
-		else if (oth->get_idempotent() < get_idempotent()) return false;
-		else if (get_absorber() < oth->get_absorber()) return true;
-		else if (oth->get_absorber() < get_absorber()) return false;
-		else if (get_identity() < oth->get_identity()) return true;
-		else if (oth->get_identity() < get_identity()) return false;
-		else return (get_membership() < oth->get_membership());
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<PropertySpecificationImpl>(other);
+		if (associative_ < oth.associative_) return true;
+		else if (oth.associative_ < associative_) return false;
+		else if (commutative_ < oth.commutative_) return true;
+		else if (oth.commutative_ < commutative_) return false;
+		else if (idempotent_ < oth.idempotent_) return true;
+		else if (oth.idempotent_ < idempotent_) return false;
+		else if (absorber_ < oth.absorber_) return true;
+		else if (oth.absorber_ < absorber_) return false;
+		else if (identity_ < oth.identity_) return true;
+		else if (oth.identity_ < identity_) return false;
+		else return (elements_ < oth.elements_);
 	}
 
-	inline std::string to_string() const {
-		return strval_;
-	}
 
 	inline TermKind get_kind() const {
 		return PROPERTY_SPECIFICATION_KIND;
 	}
 
 private:
-	friend class PropertySpecificationBuilderImpl;
+	friend class TermFactoryImpl;
 	PropertySpecificationImpl(Locus the_loc,
 			boost::optional<pTerm> const& the_associative,
 			boost::optional<pTerm> const& the_commutative,
@@ -161,15 +112,24 @@ private:
 			boost::optional<pTerm> const& the_identity,
 			boost::optional<pTerm> const& the_elements,
 			pTerm the_type);
-	boost::optional<pTerm> associative_;
-	boost::optional<pTerm> commutative_;
-	boost::optional<pTerm> idempotent_;
-	boost::optional<pTerm> absorber_;
-	boost::optional<pTerm> identity_;
-	boost::optional<pTerm> elements_;
-	Lazy<std::string> strval_;
-	Lazy<bool> constant_;
-	Lazy<unsigned int> depth_;
+	static inline boost::optional<pTerm> optional(pTerm const& part) {
+		return part ? boost::optional<pTerm>(part) : boost::none;
+	}
+	// Parts are compared by value, since a part promoted out of an arena is
+	// a different instance of the same term.
+	static inline bool same(pTerm const& first, pTerm const& second) {
+		return first == second || (first && second && *first == *second);
+	}
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
+	flags_type compute_flags() const;
+	pTerm associative_;
+	pTerm commutative_;
+	pTerm idempotent_;
+	pTerm absorber_;
+	pTerm identity_;
+	pTerm elements_;
+	flags_type flags_;
 };
 
 } /* namespace basic */
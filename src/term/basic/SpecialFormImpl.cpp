@@ -26,19 +26,21 @@ namespace basic {
 SpecialFormImpl::SpecialFormImpl(Locus the_loc, pTerm the_tag,
 		pTerm the_content, pTerm the_type) : TermImpl(the_loc, the_type),
 				tag_(the_tag), content_(the_content) {
-	strval_ = [this]() {
-		return "{: " + tag_->to_string() + " " + content_->to_string() + " :}";
-	};
-	depth_ = [this]() {
-		return std::max(get_type()->get_depth(),
-				std::max(tag_->get_depth(), content_->get_depth())) + 1;
-	};
-	hash_ = [this]() {
-		return hash_combine(hash_combine(tag_, content_), type_);
-	};
-	other_hash_ = [this]() {
-		return other_hash_combine(other_hash_combine(type_, content_), tag_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+SpecialFormImpl::compute_fingerprint() const {
+	return start_fingerprint().add(tag_->get_fingerprint())
+			.add(content_->get_fingerprint()).get();
+}
+
+TermSummary
+SpecialFormImpl::compute_summary() const {
+	return start_summary().add_child(tag_->get_summary())
+			.add_child(content_->get_summary()).deepen();
 }
 
 } /* namespace basic */
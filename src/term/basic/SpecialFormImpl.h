@@ -22,14 +22,15 @@
 
 #include <basic/TermImpl.h>
 #include <ISpecialForm.h>
-#include <Lazy.h>
 
 namespace elision {
 namespace term {
 namespace basic {
 
-class SpecialFormImpl: public ISpecialForm, public TermImpl {
+class SpecialFormImpl final : public ISpecialForm, public TermImpl {
 public:
+	typedef ISpecialForm interface_type;
+
 	virtual ~SpecialFormImpl() = default;
 
 	inline pTerm get_tag() const {
@@ -40,39 +41,36 @@ public:
 		return content_;
 	}
 
-	inline bool is_constant() const {
-		return tag_->is_constant() && content_->is_constant();
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = dynamic_cast<ISpecialForm const*>(&other);
-		return *get_tag() == *oth->get_tag() &&
-				*get_content() == *oth->get_content();
+		auto const& oth = impl_cast<SpecialFormImpl>(other);
+		return *tag_ == *oth.tag_ &&
+				*content_ == *oth.content_;
 	}
 
 	inline TermKind get_kind() const {
 		return SPECIAL_FORM_KIND;
 	}
 
-	inline std::string to_string() const {
-		return strval_;
-	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() < other.get_kind()) return true;
-		auto oth = CAST(ISpecialForm, other);
-		if (get_tag() < oth->get_tag()) return true;
-		else if (oth->get_tag() < get_tag()) return false;
-		else return (get_content() < oth->get_content());
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<SpecialFormImpl>(other);
+		if (tag_ < oth.tag_) return true;
+		else if (oth.tag_ < tag_) return false;
+		else return (content_ < oth.content_);
 	}
 
 private:
 	friend class TermFactoryImpl;
 	SpecialFormImpl(Locus the_loc, pTerm the_tag, pTerm the_content,
 			pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	pTerm tag_;
 	pTerm content_;
-	Lazy<std::string> strval_;
 };
 
 } /* namespace basic */
@@ -26,19 +26,21 @@ namespace basic {
 StaticMapImpl::StaticMapImpl(Locus the_loc, pTerm the_domain,
 		pTerm the_codomain, pTerm the_type) : TermImpl(the_loc, the_type),
 				domain_(the_domain), codomain_(the_codomain) {
-	strval_ = [this]() {
-		return domain_->to_string() + "=>" + codomain_->to_string();
-	};
-	depth_ = [this]() {
-		return std::max(get_type()->get_depth(),
-				std::max(domain_->get_depth(), codomain_->get_depth())) + 1;
-	};
-	hash_ = [this]() {
-		return hash_combine(domain_, codomain_);
-	};
-	other_hash_ = [this]() {
-		return other_hash_combine(codomain_, domain_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+StaticMapImpl::compute_fingerprint() const {
+	return start_fingerprint().add(domain_->get_fingerprint())
+			.add(codomain_->get_fingerprint()).get();
+}
+
+TermSummary
+StaticMapImpl::compute_summary() const {
+	return start_summary().add_child(domain_->get_summary())
+			.add_child(codomain_->get_summary()).deepen();
 }
 
 } /* namespace basic */
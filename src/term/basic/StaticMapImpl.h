@@ -22,7 +22,6 @@
 
 #include "TermImpl.h"
 #include "term/IStaticMap.h"
-#include <Lazy.h>
 
 namespace elision {
 namespace term {
@@ -31,8 +30,10 @@ namespace basic {
 using namespace elision;
 using namespace elision::term;
 
-class StaticMapImpl: public IStaticMap, public TermImpl {
+class StaticMapImpl final : public IStaticMap, public TermImpl {
 public:
+	typedef IStaticMap interface_type;
+
 	virtual ~StaticMapImpl() = default;
 
 	inline pTerm get_domain() const {
@@ -43,41 +44,38 @@ public:
 		return codomain_;
 	}
 
-	inline bool is_constant() const {
-		return domain_->is_constant() && codomain_->is_constant();
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = dynamic_cast<IStaticMap const*>(&other);
-		return *get_domain() == *oth->get_domain() &&
-				*get_codomain() == *oth->get_codomain();
+		auto const& oth = impl_cast<StaticMapImpl>(other);
+		return *domain_ == *oth.domain_ &&
+				*codomain_ == *oth.codomain_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IStaticMap, other);
-		if (get_domain() < oth->get_domain()) return true;
-		else if (oth->get_domain() < get_domain()) return false;
-		else return get_codomain() < oth->get_codomain();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<StaticMapImpl>(other);
+		if (domain_ < oth.domain_) return true;
+		else if (oth.domain_ < domain_) return false;
+		else return codomain_ < oth.codomain_;
 	}
 
 	inline TermKind get_kind() const {
 		return STATIC_MAP_KIND;
 	}
 
-	inline std::string to_string() const {
-		return strval_;
-	}
 
 private:
 	friend class TermFactoryImpl;
 	StaticMapImpl(Locus the_loc, pTerm the_domain, pTerm the_codomain,
 			pTerm the_type);
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
 	pTerm domain_;
 	pTerm codomain_;
-	Lazy<std::string> strval_;
 };
 
 } /* namespace basic */
@@ -22,21 +22,23 @@
 #include "LambdaImpl.h"
 #include "ListImpl.h"
 #include "LiteralImpl.h"
-#include "LambdaImpl.h"
 #include "PropertySpecificationImpl.h"
 #include "PropertySpecificationBuilderImpl.h"
 #include "SpecialFormImpl.h"
 #include "StaticMapImpl.h"
 #include "VariableImpl.h"
 #include "TermFactoryImpl.h"
+#include "match/Matcher.h"
+#include "match/Program.h"
 #include <memory>
+#include <stdexcept>
 
 namespace elision {
 namespace term {
 namespace basic {
 
 class RootTerm;
-typedef std::shared_ptr<RootTerm const> Root;
+typedef boost::intrusive_ptr<RootTerm const> Root;
 
 /**
  * Provide a private implementation of the root term.
@@ -49,9 +51,9 @@ public:
 	 */
 	static pTerm fetch() {
 		// Make a new instance of myself.  This is static so we really, really
-		// only ever get one.  Just one.  Only one.  Note that we cannot use
-		// make_shared because the constructor is private.
-		static Root self = std::shared_ptr<RootTerm>(new RootTerm());
+		// only ever get one.  Just one.  Only one.  The root refers to
+		// itself, so it is never released.
+		static Root self = Root(new RootTerm());
 		// Make this instance its own type.
 		self.get()->me_ = self;
 		return self;
@@ -66,13 +68,15 @@ public:
 	inline unsigned int get_de_bruijn_index() const { return 0; }
 	inline unsigned int get_depth() const { return 0; }
 	inline bool is_meta_term() const { return false; }
+	inline TermSummary get_summary() const { return TermSummary(); }
 	inline Locus get_loc() const { return loc_; }
 	inline bool is_root() const { return true; }
 	inline bool is_true() const { return false; }
 	inline bool is_false() const { return false; }
 	inline TermKind get_kind() const { return ROOT_KIND; }
-	inline size_t get_hash() const { return 1; }
-	inline size_t get_other_hash() const { return 0xcafebabe; }
+	inline TermTable const* get_table() const { return nullptr; }
+	inline store::TermStore const* get_store() const { return nullptr; }
+	inline Fingerprint const& get_fingerprint() const { return print_; }
 	inline bool operator<(ITerm const& other) const {
 		return get_kind() < other.get_kind();
 	}
@@ -98,17 +102,39 @@ private:
 
 	/// Hold the internal loc for fast reference.
 	Locus loc_ = Loc::get_internal();
+
+	/// The fingerprint, which depends only on the kind.
+	Fingerprint const print_ = Fingerprinter(ROOT_KIND).get();
 };
 
+// Shorthand to make a shared pointer of the correct type with the provided
+// arguments.  Depends on names being the "usual" names.  The new term is
+// interned, so an existing equal term may be returned instead.
+#define MAKE(m_kind, ...) \
+	boost::intrusive_ptr<I ## m_kind const>( \
+			make<m_kind ## Impl>(locate(loc), __VA_ARGS__))
+
 // Little macro to initialize the root types.
 #define INIT(m_name) m_name = get_root_term(#m_name);
 
-TermFactoryImpl::TermFactoryImpl() : root_(RootTerm::fetch()) {
+TermFactoryImpl::TermFactoryImpl(RefPolicy policy, LocPolicy locs) :
+		root_(RootTerm::fetch()), table_(new TermTable(policy, locs)),
+		internal_(Loc::get_internal()), locs_(locs) {
 	// Initialize the well-known root terms.
 	ROOT = root_;
 	INIT(SYMBOL);
 	INIT(STRING);
 	INIT(INTEGER);
+
+	// Preallocate the common integer literals, so that asking for them does
+	// not need to build and intern a new term.
+	Locus loc = internal_;
+	small_integers_.reserve(SMALL_TABLE_MAX - SMALL_TABLE_MIN + 1);
+	for (int64_t value = SMALL_TABLE_MIN; value <= SMALL_TABLE_MAX; ++value) {
+		small_integers_.push_back(MAKE(IntegerLiteral, Integer(value),
+				INTEGER));
+	} // Make the table.
+
 	INIT(FLOAT);
 	INIT(BITSTRING);
 	INIT(BOOLEAN);
@@ -117,7 +143,9 @@ TermFactoryImpl::TermFactoryImpl() : root_(RootTerm::fetch()) {
 	INIT(MAP);
 	INIT(SPECIAL_FORM);
 	INIT(PROPERTIES);
+	INIT(BINDING);
 	TERM = get_symbol_literal(Loc::get_internal(), "TERM", SYMBOL);
+	list_ = get_symbol_literal(Loc::get_internal(), "LIST", SYMBOL);
 	TRUE = get_boolean_literal(Loc::get_internal(), true, BOOLEAN);
 	FALSE = get_boolean_literal(Loc::get_internal(), false, BOOLEAN);
 
@@ -128,29 +156,31 @@ TermFactoryImpl::TermFactoryImpl() : root_(RootTerm::fetch()) {
 
 pSymbolLiteral
 TermFactoryImpl::get_root_term(std::string const name) const {
-	// Go and get a pointer from the map.
-	pSymbolLiteral rt = known_roots_[name];
-	if (!rt) {
-		// First time through.  Make a new symbol and store it.
-		pSymbolLiteral nrt =
-				get_symbol_literal(Loc::get_internal(), name, root_);
-		known_roots_[name] = nrt;
-		return nrt;
-	}
-	return rt;
+	// Root terms are interned like any other term, so the table is the
+	// registry of known roots.
+	return get_symbol_literal(Loc::get_internal(), name, root_);
 }
 
-// Shorthand to make a shared pointer of the correct type with the provided
-// arguments.  Depends on names being the "usual" names.
-#define MAKE(m_kind, ...) \
-	std::shared_ptr<I ## m_kind const>(new m_kind ## Impl(loc, __VA_ARGS__))
+thread_local TermFactoryImpl::ArenaScope* TermFactoryImpl::scope_ = nullptr;
+
+TermFactoryImpl::ArenaScope::ArenaScope(TermFactoryImpl const& fact,
+		size_t chunk_size) : fact_(fact),
+		arena_(new Arena(chunk_size, fact.table_->get_ref_policy())),
+		outer_(scope_) {
+	scope_ = this;
+}
+
+TermFactoryImpl::ArenaScope::~ArenaScope() {
+	// The arena itself is freed when the last term in it is released.
+	scope_ = outer_;
+}
 
 pSymbolLiteral
 TermFactoryImpl::get_symbol_literal(
 		Locus loc, std::string const& name, pTerm type) const {
 	NOTNULL(loc);
 	NOTNULL(type);
-	return MAKE(SymbolLiteral, name, type);
+	return MAKE(SymbolLiteral, Atom(name), type);
 }
 
 pStringLiteral
@@ -166,7 +196,14 @@ TermFactoryImpl::get_integer_literal(
 		Locus loc, eint_t value, pTerm type) const {
 	NOTNULL(loc);
 	NOTNULL(type);
-	return MAKE(IntegerLiteral, value, type);
+	Integer compact(value);
+	if (compact.is_small() && locate(loc) == internal_ && type == INTEGER) {
+		int64_t small = compact.get_small();
+		if (small >= SMALL_TABLE_MIN && small <= SMALL_TABLE_MAX) {
+			return small_integers_[small - SMALL_TABLE_MIN];
+		}
+	}
+	return MAKE(IntegerLiteral, std::move(compact), type);
 }
 
 pFloatLiteral
@@ -209,7 +246,7 @@ TermFactoryImpl::get_variable(
 	NOTNULL(loc);
 	NOTNULL(guard);
 	NOTNULL(type);
-	return MAKE(Variable, name, guard, type);
+	return MAKE(Variable, Atom(name), guard, type);
 }
 
 pTermVariable
@@ -217,7 +254,7 @@ TermFactoryImpl::get_term_variable(
 		Locus loc, std::string name, pTerm term_type) const {
 	NOTNULL(loc);
 	NOTNULL(term_type);
-	return MAKE(TermVariable, name, term_type,
+	return MAKE(TermVariable, Atom(name), term_type,
 			get_special_form(Loc::get_internal(), TERM, term_type));
 }
 
@@ -245,6 +282,16 @@ TermFactoryImpl::get_lambda(
 	return MAKE(Lambda, lhs, rhs, guard, type);
 }
 
+pBinding
+TermFactoryImpl::get_binding(Locus loc, IBinding::map_t const& binds) const {
+	NOTNULL(loc);
+
+	// Bindings are never placed in an arena, since their binds are held in
+	// nodes on the heap.
+	return boost::intrusive_ptr<IBinding const>(table_->intern(
+			new BindingImpl(locate(loc), binds, BINDING)));
+}
+
 pSpecialForm
 TermFactoryImpl::get_special_form(Locus loc, pTerm tag, pTerm content) const {
 	NOTNULL(loc);
@@ -255,21 +302,49 @@ TermFactoryImpl::get_special_form(Locus loc, pTerm tag, pTerm content) const {
 
 pList
 TermFactoryImpl::get_list(Locus loc, pPropertySpecification spec,
-		std::vector<pTerm>& elements) const {
+		std::vector<pTerm>&& elements) const {
 	NOTNULL(loc);
 	NOTNULL(spec);
 
-	// Keep this around.
-	static pSymbolLiteral LIST =
-			get_symbol_literal(Loc::get_internal(), "LIST", SYMBOL);
+	return MAKE(List, spec, std::move(elements), get_list_type(loc, spec));
+}
+
+pList
+TermFactoryImpl::catenate(Locus loc, pList first, pList second) const {
+	NOTNULL(loc);
+	NOTNULL(first);
+	NOTNULL(second);
+	auto spec = first->get_property_specification();
+	return MAKE(List, spec, tree_of(*first).catenate(tree_of(*second)),
+			get_list_type(loc, spec));
+}
+
+pList
+TermFactoryImpl::slice(Locus loc, pList list, size_t from, size_t to) const {
+	NOTNULL(loc);
+	NOTNULL(list);
+	auto spec = list->get_property_specification();
+	return MAKE(List, spec, tree_of(*list).slice(from, to),
+			get_list_type(loc, spec));
+}
 
+pTerm
+TermFactoryImpl::get_list_type(Locus loc, pPropertySpecification spec) const {
 	// The real type for the list is deduced from the element specification in
 	// the property specification.
 	boost::optional<pTerm> membership = spec->get_membership();
 	// The method get_value_or causes pain right now, so we avoid it.
 	pTerm element_type = membership ? membership.get() : ANY;
-	pTerm the_type = get_special_form(loc, LIST, element_type);
-	return MAKE(List, spec, elements, the_type);
+	return get_special_form(loc, list_, element_type);
+}
+
+ListImpl::tree_type
+TermFactoryImpl::tree_of(IList const& list) {
+	// Lists held elsewhere are copied into a tree.
+	if (list.get_store() != nullptr) {
+		return ListImpl::tree_type(list.begin(), list.end());
+	}
+	return impl_cast<ListImpl>(list).get_tree();
 }
 
 pTerm
@@ -282,37 +357,38 @@ TermFactoryImpl::apply(Locus loc, pTerm op, pTerm arg) const {
 	switch (op->get_kind()) {
 	case BINDING_KIND: {
 		// Applying a binding replaces bound variables with their bound terms.
-		auto binding = std::dynamic_pointer_cast<IBinding const>(op);
-		auto map = binding->get_map().get();
-		return modifier_->substitute(*map, arg);
+		auto const& binding = kind_cast<IBinding>(*op);
+		return modifier_->substitute(binding.get_map(), arg);
 		break;
 	}
 
 	case LAMBDA_KIND: {
-		// Applying a map pair matches the pattern, checks the guard, and then
-		// yields any replacement.
-//		auto map_pair = std::dynamic_pointer_cast<IMapPair const>(op);
-//		auto result = Matcher::match(map_pair->get_lhs(), argument);
-//		if (result) {
-//			// The match succeeded.  Check the guard.
-//			auto raw = result->next_raw_bindings();
-//			if (map_pair->get_guard()->rewrite(raw) == TRUE) {
-//				// The guard succeeded.  Rewrite the replacement and return it.
-//				return map_pair->get_rhs()->rewrite(raw);
-//			}
-//		}
-//		// If we come here, then either the LHS did not match or the guard
-//		// did not evaluate to true.  In either case, no rewrite happens.
-//		return argument;
+		// Applying a lambda matches the argument against the pattern, checks
+		// the guard, and then yields the rewritten right-hand side.  Matches
+		// are tried in turn until one satisfies the guard.  If there is no
+		// such match, then the argument is returned unchanged.
+		// The pattern of a lambda made here is compiled once and kept.
+		auto const& lambda = kind_cast<ILambda>(*op);
+		match::Matcher matcher(*this);
+		match::Context context;
+		bool matched = op->get_store() == nullptr ?
+				impl_cast<LambdaImpl>(*op).get_program(*this)->run(*this,
+						arg, context) :
+				matcher.try_match(lambda.get_lhs(), arg, context);
+		for (; matched; matched = matcher.next_match(context)) {
+			auto binds = context.get_map();
+			if (modifier_->substitute(binds, lambda.get_guard())->is_true()) {
+				return modifier_->substitute(binds, lambda.get_rhs());
+			}
+		} // Loop over the matches.
+		return arg;
 		break;
 	}
 
 	case LIST_KIND: {
 		// Applying a list concatenates lists.
 		if (arg->get_kind() == LIST_KIND) {
-			auto first = std::dynamic_pointer_cast<IList const>(op);
-			auto second = std::dynamic_pointer_cast<IList const>(arg);
-//			return first->catenate(second);
+			return catenate(loc, kind_cast<IList>(op), kind_cast<IList>(arg));
 		}
 		break;
 	}
@@ -322,21 +398,21 @@ TermFactoryImpl::apply(Locus loc, pTerm op, pTerm arg) const {
 		// and modifies lists.
 		switch (arg->get_kind()) {
 		case LIST_KIND: {
-			auto list = std::dynamic_pointer_cast<IList const>(arg);
-			auto ps = std::dynamic_pointer_cast<IPropertySpecification const>(op);
-			auto psb = get_property_specification_builder();
-			auto newps = psb->override(list->get_property_specification())
-					->override(ps)->get();
-			std::vector<pTerm> elts = list->get_elements();
-			return get_list(op->get_loc(), newps, elts);
+			// The list keeps its elements, and is only rebuilt if the
+			// specification changes.
+			auto const& list = kind_cast<IList>(*arg);
+			auto ps = kind_cast<IPropertySpecification>(op);
+			auto newps = override_properties(list.get_property_specification(),
+					ps);
+			if (newps == list.get_property_specification()) return arg;
+			return MAKE(List, newps, tree_of(list), get_list_type(loc, newps));
 			break;
 		}
 
 		case PROPERTY_SPECIFICATION_KIND: {
-			auto opspec = std::dynamic_pointer_cast<IPropertySpecification const>(op);
-			auto argspec = std::dynamic_pointer_cast<IPropertySpecification const>(arg);
-			auto psb = get_property_specification_builder();
-			return psb->override(argspec)->override(opspec)->get();
+			auto opspec = kind_cast<IPropertySpecification>(op);
+			auto argspec = kind_cast<IPropertySpecification>(arg);
+			return override_properties(argspec, opspec);
 			break;
 		}
 
@@ -360,11 +436,224 @@ TermFactoryImpl::apply(Locus loc, pTerm op, pTerm arg) const {
 	return MAKE(Apply, op, arg, MAP);
 }
 
+pTerm
+TermFactoryImpl::promote(pTerm term) const {
+	NOTNULL(term);
+
+	// Terms made while a scope is open would go straight back into it.
+	if (scope_ != nullptr && &scope_->fact_ == this) {
+		throw std::logic_error("Terms cannot be promoted while an arena "
+				"scope for the factory is open.");
+	}
+	promoted_map done;
+	return promote(term, done);
+}
+
+pTerm
+TermFactoryImpl::promote(pTerm const& term, promoted_map& done) const {
+	// Terms with no part in an arena stay as they are.  This includes the
+	// root and terms made by other factories.  A term shared by several
+	// parents is promoted once.
+	if (!term->get_summary().in_arena()) return term;
+	auto found = done.find(term.get());
+	if (found != done.end()) return found->second;
+	pTerm promoted = rebuild_on_heap(term, done);
+	done.emplace(term.get(), promoted);
+	return promoted;
+}
+
+pTerm
+TermFactoryImpl::rebuild_on_heap(pTerm const& term, promoted_map& done) const {
+	// Promote the parts first, then rebuild this term.  It is in an arena, or
+	// some part is, so the rebuilt term is always new.  The original is
+	// dropped from the table first, so interning the copy never compares it
+	// against the original, which would walk the whole (possibly shared)
+	// structure.  Since no scope is open, MAKE interns on the heap.
+	Locus loc = term->get_loc();
+	table_->evict(term.get());
+	pTerm type = promote(term->get_type(), done);
+	switch (term->get_kind()) {
+	case SYMBOL_LITERAL_KIND: {
+		auto const& lit = kind_cast<ISymbolLiteral>(*term);
+		return MAKE(SymbolLiteral, lit.get_atom(), type);
+	}
+
+	case STRING_LITERAL_KIND: {
+		auto const& lit = kind_cast<IStringLiteral>(*term);
+		return MAKE(StringLiteral, lit.get_value(), type);
+	}
+
+	case INTEGER_LITERAL_KIND: {
+		auto const& lit = kind_cast<IIntegerLiteral>(*term);
+		return MAKE(IntegerLiteral, lit.get_integer(), type);
+	}
+
+	case FLOAT_LITERAL_KIND: {
+		auto const& lit = kind_cast<IFloatLiteral>(*term);
+		return MAKE(FloatLiteral, lit.get_significand(), lit.get_exponent(),
+				lit.get_radix(), type);
+	}
+
+	case BIT_STRING_LITERAL_KIND: {
+		auto const& lit = kind_cast<IBitStringLiteral>(*term);
+		return MAKE(BitStringLiteral, lit.get_bits(), lit.get_length(), type);
+	}
+
+	case BOOLEAN_LITERAL_KIND: {
+		auto const& lit = kind_cast<IBooleanLiteral>(*term);
+		return MAKE(BooleanLiteral, lit.get_value(), type);
+	}
+
+	case TERM_LITERAL_KIND: {
+		auto const& lit = kind_cast<ITermLiteral>(*term);
+		return MAKE(TermLiteral, promote(lit.get_term(), done), type);
+	}
+
+	case VARIABLE_KIND: {
+		auto const& var = kind_cast<IVariable>(*term);
+		return MAKE(Variable, var.get_atom(), promote(var.get_guard(), done),
+				type);
+	}
+
+	case TERM_VARIABLE_KIND: {
+		auto const& var = kind_cast<ITermVariable>(*term);
+		return MAKE(TermVariable, var.get_atom(),
+				promote(var.get_term_type(), done), type);
+	}
+
+	case STATIC_MAP_KIND: {
+		auto const& map = kind_cast<IStaticMap>(*term);
+		return MAKE(StaticMap, promote(map.get_domain(), done),
+				promote(map.get_codomain(), done), type);
+	}
+
+	case LAMBDA_KIND: {
+		auto const& lambda = kind_cast<ILambda>(*term);
+		return MAKE(Lambda, promote(lambda.get_lhs(), done),
+				promote(lambda.get_rhs(), done),
+				promote(lambda.get_guard(), done), type);
+	}
+
+	case SPECIAL_FORM_KIND: {
+		auto const& sf = kind_cast<ISpecialForm>(*term);
+		return MAKE(SpecialForm, promote(sf.get_tag(), done),
+				promote(sf.get_content(), done), type);
+	}
+
+	case APPLY_KIND: {
+		auto const& apply = kind_cast<IApply>(*term);
+		return MAKE(Apply, promote(apply.get_operator(), done),
+				promote(apply.get_argument(), done), type);
+	}
+
+	case LIST_KIND: {
+		auto const& list = kind_cast<IList>(*term);
+		auto spec = kind_cast<IPropertySpecification>(
+				promote(list.get_property_specification(), done));
+		std::vector<pTerm> elements;
+		elements.reserve(list.size());
+		for (auto const& element : list) {
+			elements.push_back(promote(element, done));
+		} // Promote all elements.
+		return MAKE(List, spec, std::move(elements), type);
+	}
+
+	case PROPERTY_SPECIFICATION_KIND: {
+		// Specifications are always on the heap, but their parts may not be.
+		auto const& spec = kind_cast<IPropertySpecification>(*term);
+		auto part = [&](boost::optional<pTerm> value) {
+			if (value) value = promote(*value, done);
+			return value;
+		};
+		return get_property_specification(loc, part(spec.get_associative()),
+				part(spec.get_commutative()), part(spec.get_idempotent()),
+				part(spec.get_absorber()), part(spec.get_identity()),
+				part(spec.get_membership()));
+	}
+
+	case BINDING_KIND: {
+		// Bindings are always on the heap, but the bound terms may not be.
+		auto const& binding = kind_cast<IBinding>(*term);
+		IBinding::map_t binds = binding.get_map();
+		IBinding::map_t moved = binds;
+		for (auto const& bind : binds) {
+			moved = moved.extend(bind.first, promote(bind.second, done));
+		} // Promote all bound terms.
+		return get_binding(loc, moved);
+	}
+
+	case ROOT_KIND:
+	default:
+		break;
+	} // Switch on kind.
+
+	// Nothing else is placed in an arena.
+	return term;
+}
+
 std::unique_ptr<PropertySpecificationBuilder>
 TermFactoryImpl::get_property_specification_builder() const {
 	// Make a new instance and return it.
 	return std::unique_ptr<PropertySpecificationBuilder>(
-			new PropertySpecificationBuilderImpl(TRUE, FALSE, PROPERTIES));
+			new PropertySpecificationBuilderImpl(*this, locs_));
+}
+
+pPropertySpecification
+TermFactoryImpl::override_properties(pPropertySpecification spec,
+		pPropertySpecification by) const {
+	NOTNULL(spec);
+	NOTNULL(by);
+	if (spec == by) return spec;
+
+	// Specifications are interned, so a pair of addresses names a pair of
+	// specifications for as long as the pair is remembered.
+	Override& slot = overrides_[(spec->get_hash() * 31 + by->get_hash()) &
+			(OVERRIDES - 1)];
+	{
+		std::unique_lock<std::mutex> guard(slot.lock, std::defer_lock);
+		if (table_->get_ref_policy() == ATOMIC_COUNT) guard.lock();
+		if (slot.spec == spec && slot.by == by) return slot.result;
+	}
+
+	// Take each property from the overriding specification if it has it.
+	auto pick = [](boost::optional<pTerm> const& first,
+			boost::optional<pTerm> const& second) {
+		return second ? second : first;
+	};
+	auto result = get_property_specification(internal_,
+			pick(spec->get_associative(), by->get_associative()),
+			pick(spec->get_commutative(), by->get_commutative()),
+			pick(spec->get_idempotent(), by->get_idempotent()),
+			pick(spec->get_absorber(), by->get_absorber()),
+			pick(spec->get_identity(), by->get_identity()),
+			pick(spec->get_membership(), by->get_membership()));
+	// The old contents of the slot are released after the lock is, since
+	// releasing them may delete terms.
+	pPropertySpecification old_spec, old_by, old_result;
+	std::unique_lock<std::mutex> guard(slot.lock, std::defer_lock);
+	if (table_->get_ref_policy() == ATOMIC_COUNT) guard.lock();
+	old_spec.swap(slot.spec);
+	old_by.swap(slot.by);
+	old_result.swap(slot.result);
+	slot.spec = spec;
+	slot.by = by;
+	slot.result = result;
+	return result;
+}
+
+pPropertySpecification
+TermFactoryImpl::get_property_specification(Locus loc,
+		boost::optional<pTerm> const& associative,
+		boost::optional<pTerm> const& commutative,
+		boost::optional<pTerm> const& idempotent,
+		boost::optional<pTerm> const& absorber,
+		boost::optional<pTerm> const& identity,
+		boost::optional<pTerm> const& membership) const {
+	NOTNULL(loc);
+	return boost::intrusive_ptr<IPropertySpecification const>(table_->intern(
+			new PropertySpecificationImpl(locate(loc), associative,
+					commutative, idempotent, absorber, identity, membership,
+					PROPERTIES)));
 }
 
 } /* namespace basic */
@@ -23,8 +23,14 @@
 #include "term/TermFactory.h"
 #include "term/TermModifier.h"
 #include "TermImpl.h"
-#include <unordered_map>
+#include "ListImpl.h"
+#include "TermTable.h"
+#include "Arena.h"
+#include <mutex>
+#include <new>
 #include <string>
+#include <unordered_map>
+#include <utility>
 
 namespace elision {
 namespace term {
@@ -35,11 +41,33 @@ using namespace elision::term;
 /**
  * Implement a basic term factory that makes terms using the implementations in
  * the `elision::term::basic` namespace.
+ *
+ * Every term is interned.  A factory that drops locations shares every equal
+ * term, so equal terms are the same instance.  A factory that keeps locations
+ * makes the location part of the key, so that each term reports where it was
+ * made: equal terms made at the same location are shared, while equal terms
+ * made at different locations are distinct instances that compare equal.
+ * A factory may be shared by several threads, which can make terms at the
+ * same time.
+ *
+ * A thread that makes many short-lived terms can open an ArenaScope.  While
+ * the scope is open, new terms made by that thread are placed in an arena and
+ * their memory is released all at once, when the scope is closed and the last
+ * of its terms is released.  Terms that must outlive the scope should be
+ * passed to `promote`, which moves them to the heap.
  */
 class TermFactoryImpl: public TermFactory {
 public:
-	/// Make a new instance.
-	TermFactoryImpl();
+	/**
+	 * Make a new instance.
+	 * @param policy	How references to terms are counted.  Use
+	 * 					`PLAIN_COUNT` only if the factory and all its terms
+	 * 					stay on one thread; this avoids atomic operations when
+	 * 					handles are copied and makes no use of locks.
+	 * @param locs		Whether to record the locations of terms.
+	 */
+	explicit TermFactoryImpl(RefPolicy policy = ATOMIC_COUNT,
+			LocPolicy locs = KEEP_LOCATIONS);
 
 	/// Deallocate this instance.
 	virtual ~TermFactoryImpl() = default;
@@ -50,6 +78,15 @@ public:
 
 	virtual pSymbolLiteral get_root_term(std::string const name) const;
 
+	// Keep the convenience forms from the base class visible.
+	using TermFactory::get_symbol_literal;
+	using TermFactory::get_string_literal;
+	using TermFactory::get_integer_literal;
+	using TermFactory::get_float_literal;
+	using TermFactory::get_bit_string_literal;
+	using TermFactory::get_boolean_literal;
+	using TermFactory::get_term_literal;
+
 	virtual pSymbolLiteral get_symbol_literal(
 			Locus loc, std::string const& name, pTerm type) const;
 	virtual pStringLiteral get_string_literal(
@@ -77,22 +114,207 @@ public:
 	virtual pLambda get_lambda(Locus loc, pTerm lhs, pTerm rhs,
 			pTerm guard) const;
 
+	virtual pBinding get_binding(Locus loc,
+			IBinding::map_t const& binds) const;
+
 	virtual pSpecialForm get_special_form(Locus loc, pTerm tag,
 			pTerm content) const;
 
+	using TermFactory::get_list;
 	virtual pList get_list(Locus loc, pPropertySpecification spec,
-			std::vector<pTerm>& elements) const;
+			std::vector<pTerm>&& elements) const;
+
+	virtual pList catenate(Locus loc, pList first, pList second) const;
+
+	virtual pList slice(Locus loc, pList list, size_t from, size_t to) const;
 
 	virtual pTerm apply(Locus loc, pTerm op, pTerm arg) const;
 
 	virtual std::unique_ptr<PropertySpecificationBuilder>
 	get_property_specification_builder() const;
 
+	virtual pPropertySpecification override_properties(
+			pPropertySpecification spec, pPropertySpecification by) const;
+
+	/**
+	 * Make a property specification.  Property specifications are interned
+	 * on the heap, never in an arena.
+	 * @param loc			The location.
+	 * @param associative	The associativity, if specified.
+	 * @param commutative	The commutativity, if specified.
+	 * @param idempotent	The idempotency, if specified.
+	 * @param absorber		The absorber, if specified.
+	 * @param identity		The identity, if specified.
+	 * @param membership	The membership, if specified.
+	 * @return	The property specification.
+	 */
+	pPropertySpecification get_property_specification(Locus loc,
+			boost::optional<pTerm> const& associative,
+			boost::optional<pTerm> const& commutative,
+			boost::optional<pTerm> const& idempotent,
+			boost::optional<pTerm> const& absorber,
+			boost::optional<pTerm> const& identity,
+			boost::optional<pTerm> const& membership) const;
+
+	/**
+	 * Place the terms made by the current thread in an arena for as long as
+	 * an instance exists.  Scopes may be nested; each has its own arena, and
+	 * only the innermost is used.  If the innermost scope belongs to another
+	 * factory, terms go on the heap.  A scope must be destroyed on the thread
+	 * that made it, and in the reverse order of opening.
+	 */
+	class ArenaScope {
+	public:
+		/**
+		 * Open a scope.
+		 * @param fact			The factory whose terms go into the arena.
+		 * @param chunk_size	The size of each chunk in the arena.
+		 */
+		explicit ArenaScope(TermFactoryImpl const& fact,
+				size_t chunk_size = 64 * 1024);
+
+		/// Close the scope.
+		~ArenaScope();
+
+		ArenaScope(ArenaScope const&) = delete;
+		ArenaScope& operator=(ArenaScope const&) = delete;
+
+		/**
+		 * Get the arena used by this scope.
+		 * @return	The arena.
+		 */
+		inline Arena const& get_arena() const {
+			return *arena_;
+		}
+
+	private:
+		friend class TermFactoryImpl;
+		TermFactoryImpl const& fact_;
+		boost::intrusive_ptr<Arena> arena_;
+		ArenaScope* outer_;
+	};
+
+	/**
+	 * Move a term, and any of its parts, out of an arena and onto the heap.
+	 * The heap copy replaces the arena copy as the unique instance, so that
+	 * later requests for the term yield the heap copy.  Terms that are not in
+	 * an arena, and have no part in one, are returned unchanged.
+	 *
+	 * Property specifications and bindings are never placed in an arena, but
+	 * their parts may be, and then they are rebuilt too.  Each distinct part
+	 * is visited once, however often it is shared, and parts whose summaries
+	 * show that they are wholly on the heap are not visited at all.
+	 *
+	 * @param term	The term to promote.
+	 * @return	The promoted term.
+	 * @throws	std::logic_error	An ArenaScope for this factory is open on
+	 * 			the current thread.
+	 */
+	pTerm promote(pTerm term) const;
+
 private:
+	/// The terms promoted so far by one call, keyed by the original term.
+	typedef std::unordered_map<ITerm const*, pTerm> promoted_map;
+
+	/**
+	 * Promote a term, reusing the result if it was already promoted.
+	 * @param term	The term to promote.
+	 * @param done	The terms promoted so far.
+	 * @return	The promoted term.
+	 */
+	pTerm promote(pTerm const& term, promoted_map& done) const;
+
+	/**
+	 * Promote the parts of a term with some part in an arena, and rebuild
+	 * the term on the heap.
+	 * @param term	The term.
+	 * @param done	The terms promoted so far.
+	 * @return	The promoted term.
+	 */
+	pTerm rebuild_on_heap(pTerm const& term, promoted_map& done) const;
+
+	/**
+	 * Construct and intern a term, placing it in the current thread's arena
+	 * if it has an open scope for this factory.
+	 * @param args	The arguments for the constructor.
+	 * @return	The unique instance of the term.
+	 */
+	template<class Impl, class... Args>
+	boost::intrusive_ptr<Impl const> make(Args&&... args) const {
+		if (scope_ == nullptr || &scope_->fact_ != this) {
+			return table_->intern(new Impl(std::forward<Args>(args)...));
+		}
+		Arena& arena = *scope_->arena_;
+		void* place = arena.allocate(sizeof(Impl), alignof(Impl));
+		Impl* fresh;
+		try {
+			fresh = new (place) Impl(std::forward<Args>(args)...);
+		} catch (...) {
+			arena.rewind(place, sizeof(Impl));
+			throw;
+		}
+		return table_->intern(fresh, arena);
+	}
+
+	/**
+	 * Get the location to record for a new term.
+	 * @param loc	The location given.
+	 * @return	The location to record.
+	 */
+	inline Locus const& locate(Locus const& loc) const {
+		return locs_ == KEEP_LOCATIONS ? loc : internal_;
+	}
+
+	/**
+	 * Get the type of a list with a property specification.
+	 * @param loc	The location.
+	 * @param spec	The property specification.
+	 * @return	The type.
+	 */
+	pTerm get_list_type(Locus loc, pPropertySpecification spec) const;
+
+	/**
+	 * Get the elements of a list as a tree, sharing the list's tree if it
+	 * has one.
+	 * @param list	The list.
+	 * @return	The tree.
+	 */
+	static ListImpl::tree_type tree_of(IList const& list);
+
+	/// The innermost open scope on this thread, if any.
+	static thread_local ArenaScope* scope_;
+
+	/// The smallest integer literal kept in the preallocated table.
+	static constexpr int64_t SMALL_TABLE_MIN = -128;
+
+	/// The largest integer literal kept in the preallocated table.
+	static constexpr int64_t SMALL_TABLE_MAX = 1023;
+
 	pTerm root_;
-	mutable std::unordered_map<std::string, pSymbolLiteral> known_roots_;
+	pSymbolLiteral list_;
+	boost::intrusive_ptr<TermTable> table_;
+	Locus internal_;
+	LocPolicy locs_;
+	std::vector<pIntegerLiteral> small_integers_;
 	std::unique_ptr<TermModifier> modifier_{new TermModifier(*this)};
 
+	/// The number of remembered overrides.  This must be a power of two.
+	static constexpr size_t OVERRIDES = 256;
+
+	/// A remembered override, in the slot picked by the hashes of the two
+	/// specifications.  The slot holds the specifications, so that their
+	/// addresses are not reused while they are remembered.  A new override
+	/// simply replaces the old one in its slot, so few are ever held.
+	struct Override {
+		std::mutex lock;				//< Guard for this slot.
+		pPropertySpecification spec;	//< The specification overridden.
+		pPropertySpecification by;		//< The overriding specification.
+		pPropertySpecification result;	//< The combined specification.
+	};
+
+	/// The remembered overrides.  Each slot has its own lock.
+	mutable Override overrides_[OVERRIDES];
+
 };
 
 } /* namespace basic */
@@ -22,23 +22,16 @@
 
 #include <cstdarg>
 #include "term/ITerm.h"
-#include "Lazy.h"
+#include "Arena.h"
+#include <atomic>
 
 namespace elision {
 namespace term {
 namespace basic {
 
 /**
- * Helper macro to return a pointer to a term formatted as type information
- * (with a leading colon), up to and including the root.  Use
- * `+WITH_TYPE(type_)` in most cases.
- */
-#define WITH_TYPE(item_m) \
-	(std::string(": ") + item_m->to_string())
-
-/**
- * Partial implementation of a term.  This class is abstract; subclasses
- * must implement at least `is_constant` and the `std::string` operator.
+ * Partial implementation of a term.  This class is abstract.  Each subclass
+ * constructor must store the fingerprint and the summary of the term.
  */
 class TermImpl: public virtual elision::term::ITerm {
 public:
@@ -63,25 +56,33 @@ public:
 		return type_;
 	}
 
-	virtual std::string to_string() const = 0;
+	/// Write this term with a `TermPrinter`.  Nothing is cached.
+	std::string to_string() const;
 
 	/// Return the default of zero.  Override if you need to.
 	inline virtual debruijn_type get_de_bruijn_index() const {
 		return 0;
 	}
 
-	/// Subclasses must provide an implementation.
+	/// Return the depth held in the summary.
 	inline depth_type get_depth() const {
-		return depth_;
+		return summary_.get_depth();
 	}
 
-	/// Return the default of false.  Override if you need to.
-	inline virtual bool is_meta_term() const {
-		return false;
+	/// Return whether the summary marks this as a metaterm.
+	inline bool is_meta_term() const {
+		return summary_.is_meta();
 	}
 
-	/// Subclasses must provide an implementation.
-	virtual bool is_constant() const = 0;
+	/// Return whether the summary marks this as constant.
+	inline bool is_constant() const {
+		return summary_.is_constant();
+	}
+
+	/// Return the summary computed during construction.
+	inline TermSummary get_summary() const {
+		return summary_;
+	}
 
 	/// Return the location provided during construction.
 	inline virtual Locus get_loc() const {
@@ -106,68 +107,92 @@ public:
 	/**
 	 * Compare this instance to another instance of the same class.  To
 	 * implement this make sure you first cast `other` to the correct class.
-	 * If the derived class where the implementation lives is `B`, then do
-	 * `dynamic_cast<B const&>(other)` and compare to `*this`.  Types have
-	 * already been checked.
+	 * Kinds and types have already been checked, so use `kind_cast` for
+	 * this rather than `dynamic_cast`.
 	 * @param other	The term to compare to.
 	 * @return	True iff the two are equal.
 	 */
 	virtual bool is_equal(ITerm const& other) const = 0;
 
-	inline size_t get_hash() const {
-		return hash_;
+	/// Return the fingerprint computed during construction.
+	inline Fingerprint const& get_fingerprint() const {
+		return fingerprint_;
+	}
+
+	/// Return the table that interned this term, if any.
+	inline TermTable const* get_table() const {
+		return table_.load(std::memory_order_relaxed);
 	}
 
-	inline size_t get_other_hash() const {
-		return other_hash_;
+	/// Return null, since basic terms are not held by a store.
+	inline store::TermStore const* get_store() const {
+		return nullptr;
+	}
+
+	/// Return whether this term lives in a factory's arena.
+	inline bool is_in_arena() const {
+		return arena_ != nullptr;
 	}
 
 protected:
-	pTerm type_;
-	Locus loc_;
-	Lazy<size_t> hash_;
-	Lazy<size_t> other_hash_;
-	Lazy<depth_type> depth_;
-};
+	/**
+	 * Remove this term from its table, if any, and then destroy it and free
+	 * its memory.
+	 */
+	virtual void dispose() const;
 
-inline size_t hash_value(TermImpl const& term) {
-	return term.get_hash();
-}
+	/**
+	 * Start the fingerprint of this term, with its kind and type.  Each
+	 * subclass constructor adds its own content and stores the result in
+	 * `fingerprint_`.
+	 * @return	The fingerprint builder.
+	 */
+	inline Fingerprinter start_fingerprint() const {
+		Fingerprinter print(get_kind());
+		print.add(type_->get_fingerprint());
+		return print;
+	}
 
-/**
- * Combine the hashes of two terms into a single hash value.
- * @param seed	Initial hash value.
- * @param term	The term to combine.
- * @return	The computed hash value.
- */
-size_t hash_combine(size_t seed, pTerm term);
+	/**
+	 * Start the summary of this term, with its type.  Each subclass
+	 * constructor adds its children and stores the result in `summary_`.
+	 * @return	The summary builder.
+	 */
+	inline TermSummary start_summary() const {
+		return TermSummary().add_type(type_->get_summary());
+	}
 
-/**
- * Combine the other hashes of two terms into a single hash value.
- * @param seed	Initial other hash value.
- * @param term	The term to combine.
- * @return	The computed other hash value.
- */
-size_t other_hash_combine(size_t seed, pTerm term);
+	pTerm type_;
+	Locus loc_;
+	Fingerprint fingerprint_;
+	TermSummary summary_;
+
+private:
+	friend class TermTable;
+	// A term is dropped from its table if it is replaced by a promoted copy.
+	mutable std::atomic<TermTable const*> table_{nullptr};
+	// The table that made this term, which the term keeps alive.
+	TermTable* owner_ = nullptr;
+	// The arena holding this term, which the term keeps alive.
+	Arena* arena_ = nullptr;
+};
 
 /**
- * Combine the hashes of two terms into a single hash value.
- * @param seed	Initial hash value.
- * @param term	The term to combine.
- * @return	The computed hash value.
+ * Cast a term to its implementation class.  Each kind has exactly one
+ * implementation class here, named by the class's `interface_type`, so once
+ * the kind has been checked this is a static cast.  The implementation
+ * classes are final, so calls through the result are not virtual.
+ * @param term	The term, which must have been made by a `TermFactoryImpl`.
+ * @return	The term as its implementation class.
  */
-inline size_t hash_combine(pTerm seed, pTerm term) {
-	return hash_combine(seed->get_hash(), term);
+template<class Impl>
+inline Impl const& impl_cast(ITerm const& term) {
+	return static_cast<Impl const&>(
+			kind_cast<typename Impl::interface_type>(term));
 }
 
-/**
- * Combine the other hashes of two terms into a single hash value.
- * @param seed	Initial other hash value.
- * @param term	The term to combine.
- * @return	The computed other hash value.
- */
-inline size_t other_hash_combine(pTerm seed, pTerm term) {
-	return other_hash_combine(seed->get_hash(), term);
+inline size_t hash_value(TermImpl const& term) {
+	return term.get_hash();
 }
 
 } /* namespace basic */
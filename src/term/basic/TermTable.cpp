@@ -0,0 +1,122 @@
+/**
+ * @file
+ * Implement the table used to intern terms.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "TermTable.h"
+
+namespace elision {
+namespace term {
+namespace basic {
+
+TermTable::TermTable(RefPolicy policy, LocPolicy locs, size_t shards) :
+		RefCounted(policy), locs_(locs) {
+	size_t count = 1;
+	while (count < shards) count <<= 1;
+	mask_ = count - 1;
+	shards_.reset(new Shard[count]);
+}
+
+size_t
+TermTable::size() const {
+	size_t total = 0;
+	for (size_t index = 0; index <= mask_; ++index) {
+		std::unique_lock<std::mutex> guard(shards_[index].lock, std::defer_lock);
+		if (get_ref_policy() == ATOMIC_COUNT) guard.lock();
+		total += shards_[index].entries.size();
+	} // Count all shards.
+	return total;
+}
+
+void
+TermTable::adopt(TermImpl* fresh) {
+	fresh->set_ref_policy(get_ref_policy());
+	fresh->table_ = this;
+	fresh->owner_ = this;
+	retain();
+}
+
+TermImpl const*
+TermTable::find(Shard& shard, size_t hash, TermImpl const& probe,
+		bool evict) {
+	auto range = shard.entries.equal_range(hash);
+	for (auto here = range.first; here != range.second; ++here) {
+		// A term is only deleted after it has been erased, which requires
+		// the shard lock, so the pointer is safe to use here.  The children
+		// of the probe are interned, so unless locations are kept this
+		// comparison stops at the first level below the probe.  The cheap
+		// location check comes first.
+		TermImpl const* term = here->second;
+		if (keeps_locations() && term->get_loc() != probe.get_loc()) continue;
+		if (*term == probe) {
+			if (evict && term->is_in_arena()) {
+				// Drop the term from the table.  It is no longer the unique
+				// instance, so it must not compare by address.
+				term->table_ = nullptr;
+				shard.entries.erase(here);
+				return nullptr;
+			}
+			// The term may be dying on another thread, waiting to erase
+			// itself.  If so, no reference is taken and it is treated as
+			// absent.
+			if (term->retain_if_live()) {
+				return term;
+			}
+		}
+	} // Check all candidates.
+	return nullptr;
+}
+
+void
+TermTable::insert(Shard& shard, size_t hash, TermImpl const* term) {
+	shard.entries.insert(std::make_pair(hash, term));
+}
+
+void
+TermTable::erase(TermImpl const* term) {
+	size_t hash = term->get_hash();
+	Shard& shard = shard_for(hash);
+	std::unique_lock<std::mutex> guard(shard.lock, std::defer_lock);
+	if (get_ref_policy() == ATOMIC_COUNT) guard.lock();
+	auto range = shard.entries.equal_range(hash);
+	for (auto here = range.first; here != range.second; ++here) {
+		if (here->second == term) {
+			shard.entries.erase(here);
+			return;
+		}
+	} // Find the entry for this term.
+}
+
+void
+TermTable::evict(ITerm const* term) {
+	size_t hash = term->get_hash();
+	Shard& shard = shard_for(hash);
+	std::unique_lock<std::mutex> guard(shard.lock, std::defer_lock);
+	if (get_ref_policy() == ATOMIC_COUNT) guard.lock();
+	auto range = shard.entries.equal_range(hash);
+	for (auto here = range.first; here != range.second; ++here) {
+		if (static_cast<ITerm const*>(here->second) == term) {
+			here->second->table_ = nullptr;
+			shard.entries.erase(here);
+			return;
+		}
+	} // Find the entry for this term.
+}
+
+} /* namespace basic */
+} /* namespace term */
+} /* namespace elision */
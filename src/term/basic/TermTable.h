@@ -0,0 +1,249 @@
+#ifndef TERMTABLE_H_
+#define TERMTABLE_H_
+
+/**
+ * @file
+ * Define the table used to intern (hash-cons) terms.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "TermImpl.h"
+#include "Arena.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace elision {
+namespace term {
+namespace basic {
+
+/**
+ * Hold the unique instance of every structurally distinct term made by a
+ * factory.  A freshly constructed term is offered to the table; if an equal
+ * term is already present the fresh one is discarded and the existing one is
+ * returned, so that each distinct term exists exactly once.
+ *
+ * Because every child of an interned term is itself interned, two interned
+ * terms from a table that drops locations are equal if and only if they are
+ * the same instance.  The equality operator uses this to reduce to a pointer
+ * compare.
+ *
+ * The table does not keep terms alive.  It holds uncounted pointers, and a
+ * term removes itself from the table when its last reference is released.
+ * Each interned term keeps the table alive, so the table may outlive its
+ * factory.
+ *
+ * Terms may be interned on the heap or in an arena.  A term interned on the
+ * heap replaces an equal term in an arena, so terms made outside an arena
+ * never depend on one.
+ *
+ * A table that keeps locations makes them part of the key: equal terms made
+ * at different locations are distinct instances, each reporting its own
+ * location, though they still compare equal.  Such a table cannot reduce
+ * equality to a pointer compare.  A table that drops locations shares every
+ * equal term, and an interned term keeps the location it was first made
+ * with, which for a factory that drops locations is always internal.
+ *
+ * A table that counts references atomically is safe to share between
+ * threads.  It is split into shards by hash code, and each shard has its own
+ * lock, so threads interning unrelated terms rarely contend.
+ */
+class TermTable : public RefCounted {
+public:
+	/**
+	 * Make a new, empty table.
+	 * @param policy	How references to the table and its terms are counted.
+	 * 					With `PLAIN_COUNT` the table and its terms must stay
+	 * 					on one thread, and the shards are not locked.
+	 * @param locs		Whether locations are part of the key.
+	 * @param shards	The number of independently locked shards.  This is
+	 * 					rounded up to a power of two.
+	 */
+	explicit TermTable(RefPolicy policy = ATOMIC_COUNT,
+			LocPolicy locs = KEEP_LOCATIONS, size_t shards = 64);
+
+	/// Deallocate this instance.
+	virtual ~TermTable() = default;
+
+	/**
+	 * Intern a freshly constructed term.  The table takes ownership of the
+	 * provided term.  If an equal term is already interned, the fresh term
+	 * is deleted and the existing term is returned.  Otherwise the fresh term
+	 * is added to the table and returned.
+	 *
+	 * If the equal term lives in an arena, it is replaced by the fresh term,
+	 * which then becomes the unique instance.  This is how terms are promoted
+	 * out of an arena.
+	 *
+	 * @param fresh	The freshly constructed term.
+	 * @return	The unique instance of the term.
+	 */
+	template<class Impl>
+	boost::intrusive_ptr<Impl const> intern(Impl* fresh) {
+		// The owner is declared first so that a discarded term is deleted
+		// after the lock is released.  Deleting it releases its children,
+		// which may need to lock this same shard.
+		std::unique_ptr<Impl> owner(fresh);
+		size_t hash = fresh->get_hash();
+		Shard& shard = shard_for(hash);
+		std::unique_lock<std::mutex> guard(shard.lock, std::defer_lock);
+		if (get_ref_policy() == ATOMIC_COUNT) guard.lock();
+		TermImpl const* found = find(shard, hash, *fresh, true);
+		if (found != nullptr) {
+			// Equal terms have the same kind, and so the same implementation.
+			// The reference was taken by find.
+			return boost::intrusive_ptr<Impl const>(
+					static_cast<Impl const*>(found), false);
+		}
+		adopt(fresh);
+		boost::intrusive_ptr<Impl const> term(owner.release());
+		insert(shard, hash, term.get());
+		return term;
+	}
+
+	/**
+	 * Intern a freshly constructed term that lives in an arena.  This works
+	 * as the other form, except that a discarded term is destroyed and its
+	 * memory given back to the arena.  The arena is kept alive as long as any
+	 * term in it is alive.
+	 *
+	 * @param fresh	The freshly constructed term, allocated from the arena.
+	 * @param arena	The arena holding the term.
+	 * @return	The unique instance of the term.
+	 */
+	template<class Impl>
+	boost::intrusive_ptr<Impl const> intern(Impl* fresh, Arena& arena) {
+		// As before, a discarded term is destroyed after the lock is released.
+		Arena* region = &arena;
+		auto discard = [region](Impl* dead) {
+			dead->~Impl();
+			region->rewind(dead, sizeof(Impl));
+		};
+		std::unique_ptr<Impl, decltype(discard)> owner(fresh, discard);
+		size_t hash = fresh->get_hash();
+		Shard& shard = shard_for(hash);
+		std::unique_lock<std::mutex> guard(shard.lock, std::defer_lock);
+		if (get_ref_policy() == ATOMIC_COUNT) guard.lock();
+		TermImpl const* found = find(shard, hash, *fresh, false);
+		if (found != nullptr) {
+			return boost::intrusive_ptr<Impl const>(
+					static_cast<Impl const*>(found), false);
+		}
+		adopt(fresh);
+		fresh->arena_ = region;
+		fresh->summary_.add_arena();
+		arena.retain();
+		boost::intrusive_ptr<Impl const> term(owner.release());
+		insert(shard, hash, term.get());
+		return term;
+	}
+
+	/**
+	 * Get the number of terms currently interned.
+	 * @return	The number of interned terms.
+	 */
+	size_t size() const;
+
+	/**
+	 * Determine whether locations are part of the key, so that distinct
+	 * instances from this table may be equal.
+	 * @return	True iff locations are kept.
+	 */
+	inline bool keeps_locations() const {
+		return locs_ == KEEP_LOCATIONS;
+	}
+
+	/**
+	 * Drop a term from the table, if it is there.  The term lives on, but is
+	 * no longer the unique instance of its value, so it stops comparing by
+	 * address and an equal term can be interned in its place without being
+	 * compared to it.
+	 * @param term	The term to drop.
+	 */
+	void evict(ITerm const* term);
+
+private:
+	friend class TermImpl;
+
+	/// A part of the table, with its own lock.
+	struct Shard {
+		std::mutex lock;	//< Guard for entries.
+		std::unordered_multimap<size_t, TermImpl const*> entries;	//< Terms.
+	};
+
+	/**
+	 * Make a fresh term part of this table.  The term uses the table's
+	 * counting policy, and keeps the table alive.
+	 * @param fresh	The term.
+	 */
+	void adopt(TermImpl* fresh);
+
+	/**
+	 * Find the interned term equal to the given term, if any.  The shard
+	 * must be locked by the caller.
+	 * @param shard	The shard responsible for the hash code.
+	 * @param hash	The hash code of the probe.
+	 * @param probe	The term to find.
+	 * @param evict	If true, an equal term in an arena is removed from the
+	 * 				table and treated as absent.
+	 * @return	The interned term, with a reference taken for the caller, or
+	 * 			null if there is none.
+	 */
+	TermImpl const* find(Shard& shard, size_t hash, TermImpl const& probe,
+			bool evict);
+
+	/**
+	 * Add a term to the table.  No equal term may be present.  The shard must
+	 * be locked by the caller.
+	 * @param shard	The shard responsible for the hash code.
+	 * @param hash	The hash code of the term.
+	 * @param term	The term to add.
+	 */
+	void insert(Shard& shard, size_t hash, TermImpl const* term);
+
+	/**
+	 * Get the shard responsible for a hash code.
+	 * @param hash	The hash code.
+	 * @return	The shard.
+	 */
+	inline Shard& shard_for(size_t hash) const {
+		// The hash is the low half of a fingerprint, so its high bits are
+		// as good as any.
+		return shards_[(static_cast<uint64_t>(hash) >> 48) & mask_];
+	}
+
+	/**
+	 * Remove a term from the table.  This is invoked by the term when its
+	 * last reference is released.
+	 * @param term	The term to remove.
+	 */
+	void erase(TermImpl const* term);
+
+	/// Whether locations are part of the key.
+	LocPolicy locs_;
+
+	/// Mask used to select a shard.
+	size_t mask_;
+
+	/// The shards.  The count is a power of two.
+	std::unique_ptr<Shard[]> shards_;
+};
+
+} /* namespace basic */
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* TERMTABLE_H_ */
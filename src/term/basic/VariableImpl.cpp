@@ -24,45 +24,46 @@ namespace elision {
 namespace term {
 namespace basic {
 
-VariableImpl::VariableImpl(Locus the_loc, std::string the_name,
+VariableImpl::VariableImpl(Locus the_loc, Atom the_name,
 		pTerm the_guard, pTerm the_type) : TermImpl(the_loc, the_type),
 				name_(the_name), guard_(the_guard) {
-	strval_ = [this]() {
-		return std::string("$") + elision::escape(name_, true) +
-				"{ " + guard_->to_string() + " }" +
-				WITH_TYPE(type_);
-	};
-	depth_ = [this]() {
-		return type_->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		size_t hash = boost::hash<std::string>()(name_);
-		return hash_combine(hash, type_);
-	};
-	other_hash_ = [this]() {
-		size_t hash = std::hash<std::string>()(name_);
-		return other_hash_combine(hash, type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
 }
 
-TermVariableImpl::TermVariableImpl(Locus the_loc, std::string the_name,
+Fingerprint
+VariableImpl::compute_fingerprint() const {
+	return start_fingerprint().add(name_).add(guard_->get_fingerprint())
+			.get();
+}
+
+TermSummary
+VariableImpl::compute_summary() const {
+	// Like a literal, a variable is as deep as its type, so that it is never
+	// deeper than a term it matches.  Depth does not depend on the guard.
+	return start_summary().add_variables(guard_->get_summary())
+			.add_variable(name_, false);
+}
+
+TermVariableImpl::TermVariableImpl(Locus the_loc, Atom the_name,
 		pTerm term_type, pTerm the_type) : TermImpl(the_loc, the_type),
 				name_(the_name), term_type_(term_type) {
-	strval_ = [this]() {
-		return std::string("$") + elision::escape(name_, true) +
-				WITH_TYPE(type_);
-	};
-	depth_ = [this]() {
-		return type_->get_depth() + 1;
-	};
-	hash_ = [this]() {
-		size_t hash = boost::hash<std::string>()(name_);
-		return hash_combine(hash, type_);
-	};
-	other_hash_ = [this]() {
-		size_t hash = std::hash<std::string>()(name_);
-		return other_hash_combine(hash, type_);
-	};
+	set_interface(static_cast<interface_type const*>(this));
+	fingerprint_ = compute_fingerprint();
+	summary_ = compute_summary();
+}
+
+Fingerprint
+TermVariableImpl::compute_fingerprint() const {
+	// The term type is not part of equality, so it is not included.
+	return start_fingerprint().add(name_).get();
+}
+
+TermSummary
+TermVariableImpl::compute_summary() const {
+	return start_summary().add_variables(term_type_->get_summary())
+			.add_variable(name_, true);
 }
 
 } /* namespace basic */
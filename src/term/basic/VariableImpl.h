@@ -22,7 +22,6 @@
 
 #include "TermImpl.h"
 #include "term/IVariable.h"
-#include <Lazy.h>
 
 namespace elision {
 namespace term {
@@ -31,11 +30,17 @@ namespace basic {
 using namespace elision;
 using namespace elision::term;
 
-class VariableImpl : public IVariable, public TermImpl {
+class VariableImpl final : public IVariable, public TermImpl {
 public:
+	typedef IVariable interface_type;
+
 	virtual ~VariableImpl() = default;
 
-	inline virtual std::string const get_name() const {
+	inline virtual std::string const& get_name() const {
+		return name_.get_name();
+	}
+
+	inline virtual Atom get_atom() const {
 		return name_;
 	}
 
@@ -43,31 +48,25 @@ public:
 		return guard_;
 	}
 
-	inline virtual bool is_constant() const {
-		return false;
-	}
-
-	inline std::string to_string() const {
-		return strval_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(IVariable, other);
-		return get_name() == oth->get_name() &&
-				get_guard() == oth->get_guard() &&
-				get_type() == oth->get_type();
+		auto const& oth = impl_cast<VariableImpl>(other);
+		return name_ == oth.name_ &&
+				*guard_ == *oth.guard_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(IVariable, other);
-		if (get_name() < oth->get_name()) return true;
-		else if (oth->get_name() < get_name()) return false;
-		else if (get_guard() < oth->get_guard()) return true;
-		else if (oth->get_guard() < get_guard()) return false;
-		else return get_type() < oth->get_type();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<VariableImpl>(other);
+		if (name_less(name_, oth.name_)) return true;
+		else if (name_less(oth.name_, name_)) return false;
+		else if (guard_ < oth.guard_) return true;
+		else if (oth.guard_ < guard_) return false;
+		else return type_ < oth.type_;
 	}
 
 	inline TermKind get_kind() const {
@@ -76,19 +75,26 @@ public:
 
 private:
 	friend class TermFactoryImpl;
-	VariableImpl(Locus the_loc, std::string the_name, pTerm the_guard,
+	VariableImpl(Locus the_loc, Atom the_name, pTerm the_guard,
 			pTerm the_type);
-	std::string const name_;
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
+	Atom const name_;
 	pTerm guard_;
-	Lazy<std::string> strval_;
 };
 
 
-class TermVariableImpl : public ITermVariable, public TermImpl {
+class TermVariableImpl final : public ITermVariable, public TermImpl {
 public:
+	typedef ITermVariable interface_type;
+
 	virtual ~TermVariableImpl() = default;
 
-	inline virtual std::string const get_name() const {
+	inline virtual std::string const& get_name() const {
+		return name_.get_name();
+	}
+
+	inline virtual Atom get_atom() const {
 		return name_;
 	}
 
@@ -96,27 +102,21 @@ public:
 		return term_type_;
 	}
 
-	inline virtual bool is_constant() const {
-		return false;
-	}
-
-	inline std::string to_string() const {
-		return strval_;
-	}
-
 	inline bool is_equal(ITerm const& other) const {
-		auto oth = CAST(ITermVariable, other);
-		return get_name() == oth->get_name() &&
-				get_type() == oth->get_type();
+		auto const& oth = impl_cast<TermVariableImpl>(other);
+		return name_ == oth.name_;
 	}
 
 	inline bool operator<(ITerm const& other) const {
 		if (get_kind() != other.get_kind()) {
 			return get_kind() < other.get_kind();
 		}
-		auto oth = CAST(ITermVariable, other);
-		return get_name() < oth->get_name() &&
-				get_type() < oth->get_type();
+		if (other.get_store() != nullptr) {
+			return get_fingerprint() < other.get_fingerprint();
+		}
+		auto const& oth = impl_cast<TermVariableImpl>(other);
+		return name_less(name_, oth.name_) &&
+				type_ < oth.type_;
 	}
 
 	inline TermKind get_kind() const {
@@ -125,11 +125,12 @@ public:
 
 private:
 	friend class TermFactoryImpl;
-	TermVariableImpl(Locus the_loc, std::string the_name, pTerm term_type,
+	TermVariableImpl(Locus the_loc, Atom the_name, pTerm term_type,
 			pTerm the_type);
-	std::string const name_;
+	Fingerprint compute_fingerprint() const;
+	TermSummary compute_summary() const;
+	Atom const name_;
 	pTerm term_type_;
-	Lazy<std::string> strval_;
 };
 
 } /* namespace basic */
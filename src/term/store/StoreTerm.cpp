@@ -0,0 +1,168 @@
+/**
+ * @file
+ * Implement the views of terms held in a term store.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "StoreTerm.h"
+#include "term/TermPrinter.h"
+#include <stdexcept>
+
+namespace elision {
+namespace term {
+namespace store {
+
+StoreTerm::StoreTerm(TermStore const& store, term_id id) : store_(&store),
+		id_(id), print_(store.get_fingerprint(id)) {
+	// The store and its views stay on one thread.
+	set_ref_policy(PLAIN_COUNT);
+}
+
+std::string
+StoreTerm::to_string() const {
+	return TermPrinter::to_string(*this);
+}
+
+void
+StoreTerm::dispose() const {
+	store_->drop_view(id_);
+	delete this;
+}
+
+// Little macro to define the constructor for a view, which records the
+// interface for its kind.
+#define VIEW(m_kind) \
+	Store ## m_kind::Store ## m_kind(TermStore const& store, term_id id) : \
+			StoreTerm(store, id) { \
+		set_interface(static_cast<interface_type const*>(this)); \
+	}
+
+VIEW(SymbolLiteral)
+VIEW(StringLiteral)
+VIEW(IntegerLiteral)
+VIEW(FloatLiteral)
+VIEW(BitStringLiteral)
+VIEW(BooleanLiteral)
+VIEW(TermLiteral)
+VIEW(Variable)
+VIEW(TermVariable)
+VIEW(Binding)
+VIEW(Lambda)
+VIEW(List)
+VIEW(PropertySpecification)
+VIEW(SpecialForm)
+VIEW(Apply)
+VIEW(StaticMap)
+
+//======================================================================
+// Binding.
+//======================================================================
+
+StoreBinding::map_t
+StoreBinding::get_map() const {
+	map_t map;
+	for (uint32_t index = 0; index < store_->get_arity(id_); ++index) {
+		map = map.extend(store_->get_atom(id_, index), child(index));
+	} // Loop over all binds.
+	return map;
+}
+
+uint32_t
+StoreBinding::find(Atom name) const {
+	// Bindings are small, and comparing atoms is cheap, so just scan.
+	uint32_t arity = store_->get_arity(id_);
+	for (uint32_t index = 0; index < arity; ++index) {
+		if (store_->get_atom(id_, index) == name) return index;
+	} // Loop over all binds.
+	return arity;
+}
+
+pTerm
+StoreBinding::get_bind(std::string const& name) const {
+	// A name that was never interned cannot be bound.
+	Atom atom;
+	if (!Atom::find(name, atom)) {
+		throw std::out_of_range("The name " + name + " is not bound.");
+	}
+	return get_bind(atom);
+}
+
+bool
+StoreBinding::has_bind(std::string const& name) const {
+	Atom atom;
+	return Atom::find(name, atom) && has_bind(atom);
+}
+
+pTerm
+StoreBinding::get_bind(Atom name) const {
+	uint32_t index = find(name);
+	if (index == store_->get_arity(id_)) {
+		throw std::out_of_range("The name " + name.get_name() +
+				" is not bound.");
+	}
+	return child(index);
+}
+
+bool
+StoreBinding::has_bind(Atom name) const {
+	return find(name) != store_->get_arity(id_);
+}
+
+//======================================================================
+// List.
+//======================================================================
+
+ElementSpan
+StoreList::get_chunk(size_t position) const {
+	// The store holds identifiers, so the views of the elements are made
+	// once and kept for the life of this view.
+	std::vector<pTerm> const& elements = elements_.get([this]() {
+		std::vector<pTerm> views;
+		views.reserve(size());
+		for (uint32_t index = 1; index < store_->get_arity(id_); ++index) {
+			views.push_back(child(index));
+		} // Loop over elements.
+		return views;
+	});
+	return ElementSpan(elements.data() + position,
+			elements.data() + elements.size());
+}
+
+//======================================================================
+// Property specification.
+//======================================================================
+
+IPropertySpecification::flags_type
+StorePropertySpecification::get_flags() const {
+	// The flags are read from the columns, without making views of the
+	// parts.  The Boolean properties come in pairs of flags, in order.
+	flags_type flags = 0;
+	for (uint32_t index = 0; index < 3; ++index) {
+		term_id value = store_->get_child(id_, index);
+		if (value != TermStore::NO_ID &&
+				store_->get_kind(value) == BOOLEAN_LITERAL_KIND) {
+			flags |= (store_->get_boolean(value) ? 3 : 1) << (2 * index);
+		}
+	} // Check the Boolean properties.
+	if (store_->get_child(id_, 3) != TermStore::NO_ID) flags |= ABSORBER;
+	if (store_->get_child(id_, 4) != TermStore::NO_ID) flags |= IDENTITY;
+	if (store_->get_child(id_, 5) != TermStore::NO_ID) flags |= MEMBERSHIP;
+	return flags;
+}
+
+} /* namespace store */
+} /* namespace term */
+} /* namespace elision */
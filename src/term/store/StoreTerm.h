@@ -0,0 +1,465 @@
+#ifndef STORETERM_H_
+#define STORETERM_H_
+
+/**
+ * @file
+ * Present terms held in a term store through the term interfaces.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "Cached.h"
+#include "TermStore.h"
+#include "term/Dispatch.h"
+
+namespace elision {
+namespace term {
+namespace store {
+
+/**
+ * A view of a term in a store, so that the term can be used anywhere an
+ * `ITerm` is expected.  The view holds only the store and the identifier;
+ * every property is read from the store's columns, and the parts of the term
+ * are returned as views in turn.  Views keep their store alive.
+ *
+ * Views compare themselves with terms of any implementation.  Two views of
+ * the same store are equal if and only if their identifiers are.
+ */
+class StoreTerm : public virtual ITerm {
+public:
+	/// Deallocate this instance.
+	virtual ~StoreTerm() = default;
+
+	/**
+	 * Get the identifier of this term in its store.
+	 * @return	The identifier.
+	 */
+	inline term_id get_id() const {
+		return id_;
+	}
+
+	inline pTerm get_type() const {
+		return store_->get_term(store_->get_type(id_));
+	}
+
+	std::string to_string() const;
+
+	inline Fingerprint const& get_fingerprint() const {
+		return print_;
+	}
+
+	inline debruijn_type get_de_bruijn_index() const {
+		return 0;
+	}
+
+	inline depth_type get_depth() const {
+		return store_->get_depth(id_);
+	}
+
+	inline bool is_meta_term() const {
+		return store_->get_summary(id_).is_meta();
+	}
+
+	inline bool is_constant() const {
+		return store_->is_constant(id_);
+	}
+
+	inline TermSummary get_summary() const {
+		return store_->get_summary(id_);
+	}
+
+	inline Locus get_loc() const {
+		return store_->get_loc(id_);
+	}
+
+	inline bool is_root() const {
+		return id_ == TermStore::ROOT_ID;
+	}
+
+	inline bool is_true() const {
+		return get_kind() == BOOLEAN_LITERAL_KIND && store_->get_boolean(id_);
+	}
+
+	inline bool is_false() const {
+		return get_kind() == BOOLEAN_LITERAL_KIND && !store_->get_boolean(id_);
+	}
+
+	inline TermKind get_kind() const {
+		return store_->get_kind(id_);
+	}
+
+	inline basic::TermTable const* get_table() const {
+		return nullptr;
+	}
+
+	inline TermStore const* get_store() const {
+		return store_.get();
+	}
+
+	/// Order by kind, and then by fingerprint.
+	inline bool operator<(ITerm const& other) const {
+		if (get_kind() != other.get_kind()) {
+			return get_kind() < other.get_kind();
+		}
+		return print_ < other.get_fingerprint();
+	}
+
+protected:
+	/**
+	 * Make a view.
+	 * @param store	The store holding the term.
+	 * @param id	The identifier of the term.
+	 */
+	StoreTerm(TermStore const& store, term_id id);
+
+	/// Remove this view from its store, and delete it.
+	void dispose() const;
+
+	/**
+	 * Get a view of a child.
+	 * @param index	The index of the child.
+	 * @return	The child.
+	 */
+	inline pTerm child(uint32_t index) const {
+		return store_->get_term(store_->get_child(id_, index));
+	}
+
+	/**
+	 * Get a view of a child that may be absent.
+	 * @param index	The index of the child.
+	 * @return	The child, if present.
+	 */
+	inline boost::optional<pTerm> part(uint32_t index) const {
+		term_id id = store_->get_child(id_, index);
+		if (id == TermStore::NO_ID) return boost::none;
+		return store_->get_term(id);
+	}
+
+	boost::intrusive_ptr<TermStore const> store_;
+	term_id id_;
+
+private:
+	inline bool is_equal(ITerm const& other) const {
+		return store_->equal(id_, other);
+	}
+
+	// The fingerprint is copied, since the store's columns may move.
+	Fingerprint print_;
+};
+
+/// The root of a store.
+class StoreRoot final : public StoreTerm {
+private:
+	friend class TermStore;
+	StoreRoot(TermStore const& store, term_id id) : StoreTerm(store, id) {}
+};
+
+//======================================================================
+// Literals.
+//======================================================================
+
+class StoreSymbolLiteral final : public ISymbolLiteral, public StoreTerm {
+public:
+	typedef ISymbolLiteral interface_type;
+	inline std::string const& get_name() const {
+		return store_->get_atom(id_).get_name();
+	}
+	inline Atom get_atom() const {
+		return store_->get_atom(id_);
+	}
+private:
+	friend class TermStore;
+	StoreSymbolLiteral(TermStore const& store, term_id id);
+};
+
+class StoreStringLiteral final : public IStringLiteral, public StoreTerm {
+public:
+	typedef IStringLiteral interface_type;
+	inline std::string const get_value() const {
+		return store_->get_string(id_);
+	}
+private:
+	friend class TermStore;
+	StoreStringLiteral(TermStore const& store, term_id id);
+};
+
+class StoreIntegerLiteral final : public IIntegerLiteral, public StoreTerm {
+public:
+	typedef IIntegerLiteral interface_type;
+	inline eint_t get_value() const {
+		return store_->get_integer(id_).get();
+	}
+	inline Integer const& get_integer() const {
+		return store_->get_integer(id_);
+	}
+private:
+	friend class TermStore;
+	StoreIntegerLiteral(TermStore const& store, term_id id);
+};
+
+class StoreFloatLiteral final : public IFloatLiteral, public StoreTerm {
+public:
+	typedef IFloatLiteral interface_type;
+	inline eint_t get_significand() const {
+		return store_->get_integer(id_, 0).get();
+	}
+	inline eint_t get_exponent() const {
+		return store_->get_integer(id_, 1).get();
+	}
+	inline uint8_t get_radix() const {
+		return static_cast<uint8_t>(store_->get_integer(id_, 2).get_small());
+	}
+private:
+	friend class TermStore;
+	StoreFloatLiteral(TermStore const& store, term_id id);
+};
+
+class StoreBitStringLiteral final : public IBitStringLiteral,
+public StoreTerm {
+public:
+	typedef IBitStringLiteral interface_type;
+	inline eint_t get_bits() const {
+		return store_->get_integer(id_, 0).get();
+	}
+	inline eint_t get_length() const {
+		return store_->get_integer(id_, 1).get();
+	}
+private:
+	friend class TermStore;
+	StoreBitStringLiteral(TermStore const& store, term_id id);
+};
+
+class StoreBooleanLiteral final : public IBooleanLiteral, public StoreTerm {
+public:
+	typedef IBooleanLiteral interface_type;
+	inline bool get_value() const {
+		return store_->get_boolean(id_);
+	}
+private:
+	friend class TermStore;
+	StoreBooleanLiteral(TermStore const& store, term_id id);
+};
+
+class StoreTermLiteral final : public ITermLiteral, public StoreTerm {
+public:
+	typedef ITermLiteral interface_type;
+	inline pTerm get_term() const {
+		return child(0);
+	}
+private:
+	friend class TermStore;
+	StoreTermLiteral(TermStore const& store, term_id id);
+};
+
+//======================================================================
+// Variables.
+//======================================================================
+
+class StoreVariable final : public IVariable, public StoreTerm {
+public:
+	typedef IVariable interface_type;
+	inline std::string const& get_name() const {
+		return store_->get_atom(id_).get_name();
+	}
+	inline Atom get_atom() const {
+		return store_->get_atom(id_);
+	}
+	inline pTerm get_guard() const {
+		return child(0);
+	}
+private:
+	friend class TermStore;
+	StoreVariable(TermStore const& store, term_id id);
+};
+
+class StoreTermVariable final : public ITermVariable, public StoreTerm {
+public:
+	typedef ITermVariable interface_type;
+	inline std::string const& get_name() const {
+		return store_->get_atom(id_).get_name();
+	}
+	inline Atom get_atom() const {
+		return store_->get_atom(id_);
+	}
+	inline pTerm get_term_type() const {
+		return child(0);
+	}
+private:
+	friend class TermStore;
+	StoreTermVariable(TermStore const& store, term_id id);
+};
+
+//======================================================================
+// Compound terms.
+//======================================================================
+
+class StoreBinding final : public IBinding, public StoreTerm {
+public:
+	typedef IBinding interface_type;
+	map_t get_map() const;
+	pTerm get_bind(std::string const& name) const;
+	bool has_bind(std::string const& name) const;
+	pTerm get_bind(Atom name) const;
+	bool has_bind(Atom name) const;
+private:
+	friend class TermStore;
+	StoreBinding(TermStore const& store, term_id id);
+	/**
+	 * Find the index of a bind by name.
+	 * @param name	The name.
+	 * @return	The index, or the number of binds if there is none.
+	 */
+	uint32_t find(Atom name) const;
+};
+
+class StoreLambda final : public ILambda, public StoreTerm {
+public:
+	typedef ILambda interface_type;
+	inline pTerm get_lhs() const {
+		return child(0);
+	}
+	inline pTerm get_rhs() const {
+		return child(1);
+	}
+	inline pTerm get_guard() const {
+		return child(2);
+	}
+private:
+	friend class TermStore;
+	StoreLambda(TermStore const& store, term_id id);
+};
+
+class StoreList final : public IList, public StoreTerm {
+public:
+	typedef IList interface_type;
+	inline pPropertySpecification get_property_specification() const {
+		return kind_cast<IPropertySpecification>(child(0));
+	}
+	ElementSpan get_chunk(size_t position) const;
+	inline pTerm operator[](size_t position) const {
+		return child(static_cast<uint32_t>(position) + 1);
+	}
+	inline size_t size() const {
+		return store_->get_arity(id_) - 1;
+	}
+private:
+	friend class TermStore;
+	StoreList(TermStore const& store, term_id id);
+	// The views of the elements, made the first time they are read.
+	Cached<std::vector<pTerm>> elements_;
+};
+
+class StorePropertySpecification final : public IPropertySpecification,
+public StoreTerm {
+public:
+	typedef IPropertySpecification interface_type;
+	inline boost::optional<pTerm> get_associative() const {
+		return part(0);
+	}
+	inline boost::optional<pTerm> get_commutative() const {
+		return part(1);
+	}
+	inline boost::optional<pTerm> get_idempotent() const {
+		return part(2);
+	}
+	inline boost::optional<pTerm> get_absorber() const {
+		return part(3);
+	}
+	inline boost::optional<pTerm> get_identity() const {
+		return part(4);
+	}
+	inline boost::optional<pTerm> get_membership() const {
+		return part(5);
+	}
+	flags_type get_flags() const;
+private:
+	friend class TermStore;
+	StorePropertySpecification(TermStore const& store, term_id id);
+};
+
+class StoreSpecialForm final : public ISpecialForm, public StoreTerm {
+public:
+	typedef ISpecialForm interface_type;
+	inline pTerm get_tag() const {
+		return child(0);
+	}
+	inline pTerm get_content() const {
+		return child(1);
+	}
+private:
+	friend class TermStore;
+	StoreSpecialForm(TermStore const& store, term_id id);
+};
+
+class StoreApply final : public IApply, public StoreTerm {
+public:
+	typedef IApply interface_type;
+	inline pTerm get_operator() const {
+		return child(0);
+	}
+	inline pTerm get_argument() const {
+		return child(1);
+	}
+private:
+	friend class TermStore;
+	StoreApply(TermStore const& store, term_id id);
+};
+
+class StoreStaticMap final : public IStaticMap, public StoreTerm {
+public:
+	typedef IStaticMap interface_type;
+	inline pTerm get_domain() const {
+		return child(0);
+	}
+	inline pTerm get_codomain() const {
+		return child(1);
+	}
+private:
+	friend class TermStore;
+	StoreStaticMap(TermStore const& store, term_id id);
+};
+
+/**
+ * Name the view class for each interface.
+ * @param Face	The interface.
+ */
+template<class Face> struct view_of;
+
+// Little macro to name the view class for an interface.
+#define VIEW_OF(m_kind) \
+	template<> struct view_of<I ## m_kind> { typedef Store ## m_kind type; };
+VIEW_OF(SymbolLiteral)
+VIEW_OF(StringLiteral)
+VIEW_OF(IntegerLiteral)
+VIEW_OF(FloatLiteral)
+VIEW_OF(BitStringLiteral)
+VIEW_OF(BooleanLiteral)
+VIEW_OF(TermLiteral)
+VIEW_OF(Variable)
+VIEW_OF(TermVariable)
+VIEW_OF(Binding)
+VIEW_OF(Lambda)
+VIEW_OF(List)
+VIEW_OF(PropertySpecification)
+VIEW_OF(SpecialForm)
+VIEW_OF(Apply)
+VIEW_OF(StaticMap)
+#undef VIEW_OF
+
+} /* namespace store */
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* STORETERM_H_ */
@@ -0,0 +1,805 @@
+/**
+ * @file
+ * Implement the columnar term store.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "TermStore.h"
+#include "StoreTerm.h"
+#include "term/Dispatch.h"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace elision {
+namespace term {
+namespace store {
+
+constexpr term_id TermStore::ROOT_ID;
+constexpr term_id TermStore::NO_ID;
+
+TermStore::TermStore() : RefCounted(PLAIN_COUNT) {
+	// The root is its own type, and has no children.
+	kind_.push_back(ROOT_KIND);
+	type_.push_back(ROOT_ID);
+	payload_.push_back(0);
+	print_.push_back(Fingerprinter(ROOT_KIND).get());
+	summary_.push_back(TermSummary());
+	first_.push_back(0);
+	first_.push_back(0);
+	views_.push_back(nullptr);
+}
+
+//======================================================================
+// Add terms.
+//======================================================================
+
+uint32_t
+TermStore::intern_string(std::string const& text) {
+	auto found = string_index_.find(text);
+	if (found != string_index_.end()) {
+		return found->second;
+	}
+	uint32_t index = static_cast<uint32_t>(strings_.size());
+	strings_.push_back(text);
+	string_index_.emplace(text, index);
+	return index;
+}
+
+void
+TermStore::append(TermKind kind, term_id type, term_id const* begin,
+		term_id const* end, uint32_t payload) {
+	if (size() >= NO_ID) {
+		throw std::length_error("The term store is full.");
+	}
+	kind_.push_back(static_cast<uint8_t>(kind));
+	type_.push_back(type);
+	payload_.push_back(payload);
+	children_.insert(children_.end(), begin, end);
+	first_.push_back(static_cast<uint32_t>(children_.size()));
+	term_id const* children = begin;
+	size_t arity = end - begin;
+
+	// The fingerprint and summary follow the rules used by the basic terms,
+	// so that equal terms of both implementations agree.  Every child and
+	// the type contribute their variables to the summary.
+	Fingerprinter print(kind);
+	print.add(print_[type]);
+	TermSummary summary;
+	summary.add_variables(summary_[type]);
+	if (kind != BINDING_KIND) summary.add_depth(summary_[type]);
+	for (size_t index = 0; index < arity; ++index) {
+		if (children[index] == NO_ID) continue;
+		summary.add_variables(summary_[children[index]]);
+	} // Loop over children.
+	auto deepest = [&](uint32_t from, uint32_t to) {
+		for (size_t index = from; index < to; ++index) {
+			if (children[index] == NO_ID) continue;
+			summary.add_depth(summary_[children[index]]);
+		} // Loop over children.
+	};
+	auto all_constant = [&](uint32_t from, uint32_t to) {
+		for (size_t index = from; index < to; ++index) {
+			if (children[index] == NO_ID) continue;
+			summary.add_constant(summary_[children[index]]);
+		} // Loop over children.
+	};
+	switch (kind) {
+	case SYMBOL_LITERAL_KIND:
+		print.add(Atom::from_id(payload));
+		break;
+	case STRING_LITERAL_KIND:
+		print.add(strings_[payload]);
+		break;
+	case INTEGER_LITERAL_KIND:
+		print.add_integer(integers_[payload]);
+		break;
+	case FLOAT_LITERAL_KIND:
+		print.add_integer(integers_[payload]).add_integer(integers_[payload + 1])
+				.add(static_cast<uint64_t>(integers_[payload + 2].get_small()));
+		break;
+	case BIT_STRING_LITERAL_KIND:
+		print.add_integer(integers_[payload])
+				.add_integer(integers_[payload + 1]);
+		break;
+	case BOOLEAN_LITERAL_KIND:
+		print.add(static_cast<uint64_t>(payload));
+		break;
+	case TERM_LITERAL_KIND:
+		print.add(print_[children[0]]);
+		deepest(0, arity);
+		break;
+	case VARIABLE_KIND:
+		print.add(Atom::from_id(payload)).add(print_[children[0]]);
+		summary.add_variable(Atom::from_id(payload), false);
+		break;
+	case TERM_VARIABLE_KIND:
+		// The term type is not part of equality, so it is not included.
+		print.add(Atom::from_id(payload));
+		summary.add_variable(Atom::from_id(payload), true);
+		break;
+	case BINDING_KIND:
+		print.add(static_cast<uint64_t>(arity));
+		for (size_t index = 0; index < arity; ++index) {
+			print.add(Atom::from_id(names_[payload + index]))
+					.add(print_[children[index]]);
+		} // Loop over all binds.
+		deepest(0, arity);
+		summary.deepen();
+		all_constant(0, arity);
+		break;
+	case LAMBDA_KIND:
+		print.add(print_[children[0]]).add(print_[children[1]])
+				.add(print_[children[2]]);
+		// Depth does not depend on the guard.
+		deepest(0, 2);
+		summary.deepen();
+		all_constant(0, 3);
+		break;
+	case LIST_KIND: {
+		// The elements are added as a sequence print, as for basic lists.
+		SequencePrint elements;
+		for (size_t index = 1; index < arity; ++index) {
+			elements.append(SequencePrint(print_[children[index]]));
+		} // Loop over elements.
+		print.add(print_[children[0]]);
+		print.add(static_cast<uint64_t>(arity - 1));
+		print.add(elements.get());
+		deepest(0, arity);
+		all_constant(1, arity);
+		break;
+	}
+	case PROPERTY_SPECIFICATION_KIND:
+		// Each property is preceded by a flag saying whether it is present.
+		for (size_t index = 0; index < arity; ++index) {
+			term_id part = children[index];
+			print.add(static_cast<uint64_t>(part != NO_ID));
+			if (part != NO_ID) print.add(print_[part]);
+		} // Add all properties.
+		deepest(0, arity);
+		summary.deepen();
+		all_constant(0, arity);
+		break;
+	case SPECIAL_FORM_KIND:
+	case APPLY_KIND:
+	case STATIC_MAP_KIND:
+		print.add(print_[children[0]]).add(print_[children[1]]);
+		deepest(0, 2);
+		summary.deepen();
+		all_constant(0, 2);
+		break;
+	default:
+		break;
+	} // Switch on kind.
+	print_.push_back(print.get());
+	summary_.push_back(summary);
+}
+
+term_id
+TermStore::finish(mark_type before) {
+	term_id id = static_cast<term_id>(size() - 1);
+	auto range = index_.equal_range(print_[id]);
+	for (auto entry = range.first; entry != range.second; ++entry) {
+		term_id old = entry->second;
+		if (kind_[old] != kind_[id] || type_[old] != type_[id] ||
+				get_arity(old) != get_arity(id) ||
+				!std::equal(children_begin(old), children_end(old),
+						children_begin(id)) ||
+				!same_payload(old, *this, id)) {
+			continue;
+		}
+		// The term is already present, so take the new one back out.
+		children_.resize(first_[id]);
+		first_.pop_back();
+		kind_.pop_back();
+		type_.pop_back();
+		payload_.pop_back();
+		print_.pop_back();
+		summary_.pop_back();
+		integers_.resize(before.first);
+		names_.resize(before.second);
+		return old;
+	} // Check every term with the same fingerprint.
+	index_.emplace(print_[id], id);
+	views_.push_back(nullptr);
+	return id;
+}
+
+term_id
+TermStore::add_symbol_literal(Atom name, term_id type) {
+	mark_type before = mark();
+	append(SYMBOL_LITERAL_KIND, type, {}, name.get_id());
+	return finish(before);
+}
+
+term_id
+TermStore::add_string_literal(std::string const& value, term_id type) {
+	mark_type before = mark();
+	append(STRING_LITERAL_KIND, type, {}, intern_string(value));
+	return finish(before);
+}
+
+term_id
+TermStore::add_integer_literal(Integer const& value, term_id type) {
+	mark_type before = mark();
+	integers_.push_back(value);
+	append(INTEGER_LITERAL_KIND, type, {}, before.first);
+	return finish(before);
+}
+
+term_id
+TermStore::add_float_literal(eint_t const& significand,
+		eint_t const& exponent, uint8_t radix, term_id type) {
+	if (radix != 2 && radix != 8 && radix != 10 && radix != 16) {
+		throw std::invalid_argument("The radix is not an allowed value: " +
+				std::to_string(radix));
+	}
+	mark_type before = mark();
+	integers_.emplace_back(significand);
+	integers_.emplace_back(exponent);
+	integers_.emplace_back(static_cast<int64_t>(radix));
+	append(FLOAT_LITERAL_KIND, type, {}, before.first);
+	return finish(before);
+}
+
+term_id
+TermStore::add_bit_string_literal(eint_t const& bits, eint_t const& length,
+		term_id type) {
+	mark_type before = mark();
+	integers_.emplace_back(bits);
+	integers_.emplace_back(length);
+	append(BIT_STRING_LITERAL_KIND, type, {}, before.first);
+	return finish(before);
+}
+
+term_id
+TermStore::add_boolean_literal(bool value, term_id type) {
+	mark_type before = mark();
+	append(BOOLEAN_LITERAL_KIND, type, {}, value ? 1 : 0);
+	return finish(before);
+}
+
+term_id
+TermStore::add_term_literal(term_id term, term_id type) {
+	mark_type before = mark();
+	append(TERM_LITERAL_KIND, type, { term }, 0);
+	return finish(before);
+}
+
+term_id
+TermStore::add_variable(Atom name, term_id guard, term_id type) {
+	mark_type before = mark();
+	append(VARIABLE_KIND, type, { guard }, name.get_id());
+	return finish(before);
+}
+
+term_id
+TermStore::add_term_variable(Atom name, term_id term_type, term_id type) {
+	mark_type before = mark();
+	append(TERM_VARIABLE_KIND, type, { term_type }, name.get_id());
+	return finish(before);
+}
+
+term_id
+TermStore::add_binding(std::map<Atom, term_id> const& binds, term_id type) {
+	// Keep the binds in order by name, so that the fingerprint does not
+	// depend on the order in which names were interned.
+	std::vector<std::pair<Atom, term_id>> sorted(binds.begin(), binds.end());
+	std::sort(sorted.begin(), sorted.end(),
+			[](std::pair<Atom, term_id> const& first,
+					std::pair<Atom, term_id> const& second) {
+		return name_less(first.first, second.first);
+	});
+	mark_type before = mark();
+	std::vector<term_id> children;
+	children.reserve(sorted.size());
+	for (auto const& entry : sorted) {
+		names_.push_back(entry.first.get_id());
+		children.push_back(entry.second);
+	} // Loop over all binds.
+	append(BINDING_KIND, type, children.data(),
+			children.data() + children.size(), before.second);
+	return finish(before);
+}
+
+term_id
+TermStore::add_lambda(term_id lhs, term_id rhs, term_id guard,
+		term_id type) {
+	mark_type before = mark();
+	append(LAMBDA_KIND, type, { lhs, rhs, guard }, 0);
+	return finish(before);
+}
+
+term_id
+TermStore::add_list(term_id spec, std::vector<term_id> const& elements,
+		term_id type) {
+	mark_type before = mark();
+	std::vector<term_id> children;
+	children.reserve(elements.size() + 1);
+	children.push_back(spec);
+	children.insert(children.end(), elements.begin(), elements.end());
+	append(LIST_KIND, type, children.data(),
+			children.data() + children.size(), 0);
+	return finish(before);
+}
+
+term_id
+TermStore::add_property_specification(std::array<term_id, 6> const& parts,
+		term_id type) {
+	mark_type before = mark();
+	append(PROPERTY_SPECIFICATION_KIND, type, parts.data(),
+			parts.data() + parts.size(), 0);
+	return finish(before);
+}
+
+term_id
+TermStore::add_special_form(term_id tag, term_id content, term_id type) {
+	mark_type before = mark();
+	append(SPECIAL_FORM_KIND, type, { tag, content }, 0);
+	return finish(before);
+}
+
+term_id
+TermStore::add_apply(term_id op, term_id arg, term_id type) {
+	mark_type before = mark();
+	append(APPLY_KIND, type, { op, arg }, 0);
+	return finish(before);
+}
+
+term_id
+TermStore::add_static_map(term_id domain, term_id codomain, term_id type) {
+	mark_type before = mark();
+	append(STATIC_MAP_KIND, type, { domain, codomain }, 0);
+	return finish(before);
+}
+
+//======================================================================
+// Import terms.
+//======================================================================
+
+namespace {
+
+/**
+ * Import the parts of a term, and then add the term itself.
+ */
+struct Import {
+	TermStore& store;
+	std::unordered_map<ITerm const*, term_id>& done;
+	term_id type;
+
+	inline term_id sub(pTerm const& part) {
+		return store.import(*part, done);
+	}
+	inline term_id sub(boost::optional<pTerm> const& part) {
+		return part ? sub(part.get()) : TermStore::NO_ID;
+	}
+
+	term_id operator()(ISymbolLiteral const& term) {
+		return store.add_symbol_literal(term.get_atom(), type);
+	}
+	term_id operator()(IStringLiteral const& term) {
+		return store.add_string_literal(term.get_value(), type);
+	}
+	term_id operator()(IIntegerLiteral const& term) {
+		return store.add_integer_literal(term.get_integer(), type);
+	}
+	term_id operator()(IFloatLiteral const& term) {
+		return store.add_float_literal(term.get_significand(),
+				term.get_exponent(), term.get_radix(), type);
+	}
+	term_id operator()(IBitStringLiteral const& term) {
+		return store.add_bit_string_literal(term.get_bits(),
+				term.get_length(), type);
+	}
+	term_id operator()(IBooleanLiteral const& term) {
+		return store.add_boolean_literal(term.get_value(), type);
+	}
+	term_id operator()(ITermLiteral const& term) {
+		return store.add_term_literal(sub(term.get_term()), type);
+	}
+	term_id operator()(IVariable const& term) {
+		return store.add_variable(term.get_atom(), sub(term.get_guard()),
+				type);
+	}
+	term_id operator()(ITermVariable const& term) {
+		return store.add_term_variable(term.get_atom(),
+				sub(term.get_term_type()), type);
+	}
+	term_id operator()(IBinding const& term) {
+		std::map<Atom, term_id> binds;
+		for (auto const& entry : term.get_map()) {
+			binds.emplace(entry.first, sub(entry.second));
+		} // Loop over all binds.
+		return store.add_binding(binds, type);
+	}
+	term_id operator()(ILambda const& term) {
+		return store.add_lambda(sub(term.get_lhs()), sub(term.get_rhs()),
+				sub(term.get_guard()), type);
+	}
+	term_id operator()(IList const& term) {
+		term_id spec = sub(term.get_property_specification());
+		std::vector<term_id> elements;
+		elements.reserve(term.size());
+		for (auto const& elt : term) {
+			elements.push_back(sub(elt));
+		} // Loop over elements.
+		return store.add_list(spec, elements, type);
+	}
+	term_id operator()(IPropertySpecification const& term) {
+		std::array<term_id, 6> parts = {{ sub(term.get_associative()),
+				sub(term.get_commutative()), sub(term.get_idempotent()),
+				sub(term.get_absorber()), sub(term.get_identity()),
+				sub(term.get_membership()) }};
+		return store.add_property_specification(parts, type);
+	}
+	term_id operator()(ISpecialForm const& term) {
+		return store.add_special_form(sub(term.get_tag()),
+				sub(term.get_content()), type);
+	}
+	term_id operator()(IApply const& term) {
+		return store.add_apply(sub(term.get_operator()),
+				sub(term.get_argument()), type);
+	}
+	term_id operator()(IStaticMap const& term) {
+		return store.add_static_map(sub(term.get_domain()),
+				sub(term.get_codomain()), type);
+	}
+	term_id operator()(ITerm const&) {
+		return TermStore::ROOT_ID;
+	}
+};
+
+} /* anonymous namespace */
+
+term_id
+TermStore::import(ITerm const& term) {
+	std::unordered_map<ITerm const*, term_id> done;
+	return import(term, done);
+}
+
+term_id
+TermStore::import(ITerm const& term,
+		std::unordered_map<ITerm const*, term_id>& done) {
+	if (term.is_root()) {
+		return ROOT_ID;
+	}
+	term_id id = id_of(term);
+	if (id != NO_ID) {
+		return id;
+	}
+	auto found = done.find(&term);
+	if (found != done.end()) {
+		return found->second;
+	}
+	term_id type = import(*term.get_type(), done);
+	id = dispatch(term, Import{*this, done, type});
+	done.emplace(&term, id);
+	return id;
+}
+
+//======================================================================
+// Locations.
+//======================================================================
+
+Locus
+TermStore::get_loc(term_id id) const {
+	auto found = locs_.find(id);
+	return found == locs_.end() ? Loc::get_internal() : found->second;
+}
+
+void
+TermStore::set_loc(term_id id, Locus const& loc) {
+	NOTNULL(loc);
+	if (!loc->is_internal()) {
+		locs_.emplace(id, loc);
+	}
+}
+
+//======================================================================
+// Compare terms.
+//======================================================================
+
+bool
+TermStore::same_payload(term_id id, TermStore const& other,
+		term_id oid) const {
+	switch (get_kind(id)) {
+	case STRING_LITERAL_KIND:
+		// Strings are stored once per store.
+		return &other == this ? payload_[id] == payload_[oid] :
+				strings_[payload_[id]] == other.strings_[other.payload_[oid]];
+	case SYMBOL_LITERAL_KIND:
+	case VARIABLE_KIND:
+	case TERM_VARIABLE_KIND:
+		// Names are atoms, which are shared by all stores.
+	case BOOLEAN_LITERAL_KIND:
+		return payload_[id] == other.payload_[oid];
+	case INTEGER_LITERAL_KIND:
+		return get_integer(id) == other.get_integer(oid);
+	case FLOAT_LITERAL_KIND:
+		return get_integer(id) == other.get_integer(oid) &&
+				get_integer(id, 1) == other.get_integer(oid, 1) &&
+				get_integer(id, 2) == other.get_integer(oid, 2);
+	case BIT_STRING_LITERAL_KIND:
+		return get_integer(id) == other.get_integer(oid) &&
+				get_integer(id, 1) == other.get_integer(oid, 1);
+	case BINDING_KIND:
+		for (uint32_t index = 0; index < get_arity(id); ++index) {
+			if (get_atom(id, index) != other.get_atom(oid, index)) {
+				return false;
+			}
+		} // Compare all names.
+		return true;
+	default:
+		return true;
+	} // Switch on kind.
+}
+
+bool
+TermStore::equal(term_id id, TermStore const& other, term_id oid) const {
+	if (&other == this) {
+		return id == oid;
+	}
+	// Walk both terms together.  Each term here remembers the term it was
+	// last matched with, so shared subterms are usually compared once.  Only
+	// the terms reached are remembered, so the cost does not grow with the
+	// size of the store.
+	std::unordered_map<term_id, term_id> matched;
+	std::vector<std::pair<term_id, term_id>> stack(1,
+			std::make_pair(id, oid));
+	while (!stack.empty()) {
+		term_id mine = stack.back().first;
+		term_id theirs = stack.back().second;
+		stack.pop_back();
+		if (mine == NO_ID || theirs == NO_ID) {
+			if (mine != theirs) return false;
+			continue;
+		}
+		auto last = matched.emplace(mine, theirs);
+		if (!last.second) {
+			if (last.first->second == theirs) continue;
+			last.first->second = theirs;
+		}
+		if (print_[mine] != other.print_[theirs] ||
+				kind_[mine] != other.kind_[theirs] ||
+				get_arity(mine) != other.get_arity(theirs) ||
+				!same_payload(mine, other, theirs)) {
+			return false;
+		}
+		if (kind_[mine] == ROOT_KIND) continue;
+		stack.emplace_back(type_[mine], other.type_[theirs]);
+		// The term type of a term variable is not part of equality.
+		if (kind_[mine] == TERM_VARIABLE_KIND) continue;
+		for (uint32_t index = 0; index < get_arity(mine); ++index) {
+			stack.emplace_back(get_child(mine, index),
+					other.get_child(theirs, index));
+		} // Compare all children.
+	} // Loop until all pairs are compared.
+	return true;
+}
+
+namespace {
+
+/**
+ * Compare a term in a store with a term of another implementation, given
+ * that their kinds and types already match.
+ */
+struct Compare {
+	TermStore const& store;
+	term_id id;
+
+	inline bool sub(uint32_t index, pTerm const& part) const {
+		return store.equal(store.get_child(id, index), *part);
+	}
+	inline bool sub(uint32_t index, boost::optional<pTerm> const& part) const {
+		term_id child = store.get_child(id, index);
+		if (!part) return child == TermStore::NO_ID;
+		return child != TermStore::NO_ID && store.equal(child, *part.get());
+	}
+
+	bool operator()(ISymbolLiteral const& term) const {
+		return term.get_atom() == store.get_atom(id);
+	}
+	bool operator()(IStringLiteral const& term) const {
+		return term.get_value() == store.get_string(id);
+	}
+	bool operator()(IIntegerLiteral const& term) const {
+		return term.get_integer() == store.get_integer(id);
+	}
+	bool operator()(IFloatLiteral const& term) const {
+		return Integer(term.get_significand()) == store.get_integer(id) &&
+				Integer(term.get_exponent()) == store.get_integer(id, 1) &&
+				term.get_radix() == store.get_integer(id, 2).get_small();
+	}
+	bool operator()(IBitStringLiteral const& term) const {
+		return Integer(term.get_bits()) == store.get_integer(id) &&
+				Integer(term.get_length()) == store.get_integer(id, 1);
+	}
+	bool operator()(IBooleanLiteral const& term) const {
+		return term.get_value() == store.get_boolean(id);
+	}
+	bool operator()(ITermLiteral const& term) const {
+		return sub(0, term.get_term());
+	}
+	bool operator()(IVariable const& term) const {
+		return term.get_atom() == store.get_atom(id) &&
+				sub(0, term.get_guard());
+	}
+	bool operator()(ITermVariable const& term) const {
+		return term.get_atom() == store.get_atom(id);
+	}
+	bool operator()(IBinding const& term) const {
+		auto map = term.get_map();
+		if (map.size() != store.get_arity(id)) return false;
+		for (uint32_t index = 0; index < store.get_arity(id); ++index) {
+			pTerm const* found = map.find(store.get_atom(id, index));
+			if (found == nullptr || !sub(index, *found)) {
+				return false;
+			}
+		} // Compare all binds.
+		return true;
+	}
+	bool operator()(ILambda const& term) const {
+		return sub(0, term.get_lhs()) && sub(1, term.get_rhs()) &&
+				sub(2, term.get_guard());
+	}
+	bool operator()(IList const& term) const {
+		if (term.size() + 1 != store.get_arity(id) ||
+				!sub(0, term.get_property_specification())) {
+			return false;
+		}
+		for (uint32_t index = 0; index < term.size(); ++index) {
+			if (!sub(index + 1, term[index])) return false;
+		} // Compare all elements.
+		return true;
+	}
+	bool operator()(IPropertySpecification const& term) const {
+		return sub(0, term.get_associative()) &&
+				sub(1, term.get_commutative()) &&
+				sub(2, term.get_idempotent()) &&
+				sub(3, term.get_absorber()) &&
+				sub(4, term.get_identity()) &&
+				sub(5, term.get_membership());
+	}
+	bool operator()(ISpecialForm const& term) const {
+		return sub(0, term.get_tag()) && sub(1, term.get_content());
+	}
+	bool operator()(IApply const& term) const {
+		return sub(0, term.get_operator()) && sub(1, term.get_argument());
+	}
+	bool operator()(IStaticMap const& term) const {
+		return sub(0, term.get_domain()) && sub(1, term.get_codomain());
+	}
+	bool operator()(ITerm const&) const {
+		// Only the root comes here.
+		return true;
+	}
+};
+
+} /* anonymous namespace */
+
+bool
+TermStore::equal(term_id id, ITerm const& other) const {
+	TermStore const* home = other.get_store();
+	if (home != nullptr) {
+		return equal(id, *home, home->id_of(other));
+	}
+	if (print_[id] != other.get_fingerprint() ||
+			get_kind(id) != other.get_kind()) {
+		return false;
+	}
+	if (get_kind(id) == ROOT_KIND) {
+		return true;
+	}
+	return equal(type_[id], *other.get_type()) &&
+			dispatch(other, Compare{*this, id});
+}
+
+//======================================================================
+// Views.
+//======================================================================
+
+pTerm
+TermStore::get_term(term_id id) const {
+	if (views_[id] != nullptr) {
+		return pTerm(views_[id]);
+	}
+	StoreTerm const* view;
+	switch (get_kind(id)) {
+	case SYMBOL_LITERAL_KIND:
+		view = new StoreSymbolLiteral(*this, id);
+		break;
+	case STRING_LITERAL_KIND:
+		view = new StoreStringLiteral(*this, id);
+		break;
+	case INTEGER_LITERAL_KIND:
+		view = new StoreIntegerLiteral(*this, id);
+		break;
+	case FLOAT_LITERAL_KIND:
+		view = new StoreFloatLiteral(*this, id);
+		break;
+	case BIT_STRING_LITERAL_KIND:
+		view = new StoreBitStringLiteral(*this, id);
+		break;
+	case BOOLEAN_LITERAL_KIND:
+		view = new StoreBooleanLiteral(*this, id);
+		break;
+	case TERM_LITERAL_KIND:
+		view = new StoreTermLiteral(*this, id);
+		break;
+	case VARIABLE_KIND:
+		view = new StoreVariable(*this, id);
+		break;
+	case TERM_VARIABLE_KIND:
+		view = new StoreTermVariable(*this, id);
+		break;
+	case BINDING_KIND:
+		view = new StoreBinding(*this, id);
+		break;
+	case LAMBDA_KIND:
+		view = new StoreLambda(*this, id);
+		break;
+	case LIST_KIND:
+		view = new StoreList(*this, id);
+		break;
+	case PROPERTY_SPECIFICATION_KIND:
+		view = new StorePropertySpecification(*this, id);
+		break;
+	case SPECIAL_FORM_KIND:
+		view = new StoreSpecialForm(*this, id);
+		break;
+	case APPLY_KIND:
+		view = new StoreApply(*this, id);
+		break;
+	case STATIC_MAP_KIND:
+		view = new StoreStaticMap(*this, id);
+		break;
+	case ROOT_KIND:
+	default:
+		view = new StoreRoot(*this, id);
+		break;
+	} // Switch on kind.
+	views_[id] = view;
+	return pTerm(view);
+}
+
+namespace {
+
+/**
+ * Find the identifier behind a view, given its interface.
+ */
+struct Identify {
+	template<class Face>
+	inline term_id operator()(Face const& face) const {
+		return static_cast<typename view_of<Face>::type const&>(face).get_id();
+	}
+	inline term_id operator()(ITerm const&) const {
+		return TermStore::ROOT_ID;
+	}
+};
+
+} /* anonymous namespace */
+
+term_id
+TermStore::id_of(ITerm const& term) const {
+	if (term.get_store() != this) {
+		return NO_ID;
+	}
+	return dispatch(term, Identify());
+}
+
+} /* namespace store */
+} /* namespace term */
+} /* namespace elision */
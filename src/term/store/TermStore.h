@@ -0,0 +1,429 @@
+#ifndef TERMSTORE_H_
+#define TERMSTORE_H_
+
+/**
+ * @file
+ * Hold terms in columns, addressed by 32-bit identifiers.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/ITerm.h"
+#include "Atom.h"
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace elision {
+namespace term {
+namespace store {
+
+/// The identifier of a term in a store.
+typedef uint32_t term_id;
+
+class StoreTerm;
+
+/**
+ * Hold the terms of a large knowledge base in a struct-of-arrays layout.
+ * Each term is a 32-bit identifier, and its attributes live at that index in
+ * a set of parallel columns: the kind, the type's identifier, the range of
+ * its children's identifiers (all children are kept in one array), an index
+ * into the payload tables for literal content and names, the fingerprint,
+ * the depth, and a few flags.  There is no per-term object, reference count,
+ * or location, so walking or comparing terms touches contiguous memory.
+ *
+ * Terms are hash-consed.  Adding a term that is already present returns the
+ * existing identifier, so two terms in the same store are equal if and only
+ * if their identifiers are equal.  Terms are never removed.
+ *
+ * The children of each kind are stored in this order:
+ *   - term literal: the term
+ *   - variable: the guard
+ *   - term variable: the term type
+ *   - binding: the bound terms, in order of their names
+ *   - lambda: the left side, right side, and guard
+ *   - list: the property specification, then the elements
+ *   - property specification: the associative, commutative, idempotent,
+ *     absorber, identity, and membership properties, using `NO_ID` for any
+ *     that are absent
+ *   - special form: the tag and content
+ *   - apply: the operator and argument
+ *   - static map: the domain and codomain
+ *
+ * For interoperability, `get_term` returns an `ITerm` view of any term, and
+ * `import` copies a term of any implementation into the store.  Views are
+ * made on demand and shared while they are alive.
+ *
+ * A store, its views, and the terms made from them must stay on one thread.
+ */
+class TermStore : public RefCounted {
+public:
+	/// The identifier of the root, which every store holds.
+	static constexpr term_id ROOT_ID = 0;
+
+	/// Marks an absent child, such as an unset property.
+	static constexpr term_id NO_ID = UINT32_MAX;
+
+	/// Make a new store that holds only the root.
+	TermStore();
+
+	/// Deallocate this instance.
+	virtual ~TermStore() = default;
+
+	//======================================================================
+	// Add terms.  Each returns the identifier of the unique equal term.
+	//======================================================================
+
+	term_id add_symbol_literal(Atom name, term_id type);
+	term_id add_string_literal(std::string const& value, term_id type);
+	term_id add_integer_literal(Integer const& value, term_id type);
+	term_id add_float_literal(eint_t const& significand,
+			eint_t const& exponent, uint8_t radix, term_id type);
+	term_id add_bit_string_literal(eint_t const& bits, eint_t const& length,
+			term_id type);
+	term_id add_boolean_literal(bool value, term_id type);
+	term_id add_term_literal(term_id term, term_id type);
+	term_id add_variable(Atom name, term_id guard, term_id type);
+	term_id add_term_variable(Atom name, term_id term_type, term_id type);
+	term_id add_binding(std::map<Atom, term_id> const& binds, term_id type);
+	term_id add_lambda(term_id lhs, term_id rhs, term_id guard, term_id type);
+	term_id add_list(term_id spec, std::vector<term_id> const& elements,
+			term_id type);
+	term_id add_property_specification(std::array<term_id, 6> const& parts,
+			term_id type);
+	term_id add_special_form(term_id tag, term_id content, term_id type);
+	term_id add_apply(term_id op, term_id arg, term_id type);
+	term_id add_static_map(term_id domain, term_id codomain, term_id type);
+
+	/**
+	 * Add a term of any implementation, along with its type and parts.  If
+	 * the term is a view of a term in this store, nothing is added.
+	 * @param term	The term.
+	 * @return	The identifier of the term.
+	 */
+	term_id import(ITerm const& term);
+
+	/**
+	 * Add a term of any implementation, reusing the identifiers of terms
+	 * already imported.  Pass the same map to import several terms that
+	 * share parts, so that each part is copied once.
+	 * @param term	The term.
+	 * @param done	The terms imported so far.
+	 * @return	The identifier of the term.
+	 */
+	term_id import(ITerm const& term,
+			std::unordered_map<ITerm const*, term_id>& done);
+
+	//======================================================================
+	// Read the columns.
+	//======================================================================
+
+	/**
+	 * Get the number of terms in the store, including the root.
+	 * @return	The number of terms.
+	 */
+	inline size_t size() const {
+		return kind_.size();
+	}
+
+	inline TermKind get_kind(term_id id) const {
+		return static_cast<TermKind>(kind_[id]);
+	}
+
+	inline term_id get_type(term_id id) const {
+		return type_[id];
+	}
+
+	inline Fingerprint const& get_fingerprint(term_id id) const {
+		return print_[id];
+	}
+
+	inline TermSummary get_summary(term_id id) const {
+		return summary_[id];
+	}
+
+	inline ITerm::depth_type get_depth(term_id id) const {
+		return summary_[id].get_depth();
+	}
+
+	inline bool is_constant(term_id id) const {
+		return summary_[id].is_constant();
+	}
+
+	/**
+	 * Get the number of children of a term.
+	 * @param id	The term.
+	 * @return	The number of children.
+	 */
+	inline uint32_t get_arity(term_id id) const {
+		return first_[id + 1] - first_[id];
+	}
+
+	/**
+	 * Get a child of a term.
+	 * @param id	The term.
+	 * @param index	The zero-based index of the child.
+	 * @return	The child, or `NO_ID` for an absent property.
+	 */
+	inline term_id get_child(term_id id, uint32_t index) const {
+		return children_[first_[id] + index];
+	}
+
+	/**
+	 * Get the start of a term's children.  This is invalidated when terms
+	 * are added.
+	 * @param id	The term.
+	 * @return	A pointer to the first child.
+	 */
+	inline term_id const* children_begin(term_id id) const {
+		return children_.data() + first_[id];
+	}
+
+	/**
+	 * Get the end of a term's children.  This is invalidated when terms are
+	 * added.
+	 * @param id	The term.
+	 * @return	A pointer just past the last child.
+	 */
+	inline term_id const* children_end(term_id id) const {
+		return children_.data() + first_[id + 1];
+	}
+
+	/**
+	 * Get the value of a string literal.
+	 * @param id	The term.
+	 * @return	The string.
+	 */
+	inline std::string const& get_string(term_id id) const {
+		return strings_[payload_[id]];
+	}
+
+	/**
+	 * Get the name of a symbol literal, variable, or term variable, or the
+	 * name of the given bind of a binding.  The binds of a binding are in
+	 * order by name.
+	 * @param id	The term.
+	 * @param index	For a binding, the index of the bind.
+	 * @return	The name.
+	 */
+	inline Atom get_atom(term_id id, uint32_t index = 0) const {
+		return Atom::from_id(get_kind(id) == BINDING_KIND ?
+				names_[payload_[id] + index] : payload_[id]);
+	}
+
+	/**
+	 * Get integer content.  This is the value of an integer literal; the
+	 * significand, exponent, and radix of a float literal; or the bits and
+	 * length of a bit string literal.
+	 * @param id	The term.
+	 * @param index	The index of the part.
+	 * @return	The integer.
+	 */
+	inline Integer const& get_integer(term_id id, uint32_t index = 0) const {
+		return integers_[payload_[id] + index];
+	}
+
+	inline bool get_boolean(term_id id) const {
+		return payload_[id] != 0;
+	}
+
+	/**
+	 * Get the location of a term.  Only locations that are not internal are
+	 * kept, and only the first one given for a term.
+	 * @param id	The term.
+	 * @return	The location.
+	 */
+	Locus get_loc(term_id id) const;
+
+	/**
+	 * Give a term a location, unless it already has one.
+	 * @param id	The term.
+	 * @param loc	The location.
+	 */
+	void set_loc(term_id id, Locus const& loc);
+
+	//======================================================================
+	// Traverse and compare.
+	//======================================================================
+
+	/**
+	 * Visit a term and its subterms, not including types, in preorder.  Each
+	 * distinct subterm is visited once.  The function is given the identifier
+	 * and returns whether to visit the children.
+	 * @param id	The term.
+	 * @param visit	The function.
+	 */
+	template<class Visit>
+	void walk(term_id id, Visit&& visit) const {
+		std::vector<bool> seen(size());
+		std::vector<term_id> stack(1, id);
+		while (!stack.empty()) {
+			term_id next = stack.back();
+			stack.pop_back();
+			if (next == NO_ID || seen[next]) continue;
+			seen[next] = true;
+			if (!visit(next)) continue;
+			for (uint32_t at = first_[next + 1]; at > first_[next]; --at) {
+				stack.push_back(children_[at - 1]);
+			} // Push children so that the first is visited first.
+		} // Loop until all reachable terms are visited.
+	}
+
+	/**
+	 * Determine whether a term here is equal to a term in another store.
+	 * This compares the columns directly.
+	 * @param id	The term here.
+	 * @param other	The other store, which may be this one.
+	 * @param oid	The term in the other store.
+	 * @return	True iff the terms are equal.
+	 */
+	bool equal(term_id id, TermStore const& other, term_id oid) const;
+
+	/**
+	 * Determine whether a term here is equal to a term of any
+	 * implementation.
+	 * @param id	The term here.
+	 * @param other	The other term.
+	 * @return	True iff the terms are equal.
+	 */
+	bool equal(term_id id, ITerm const& other) const;
+
+	//======================================================================
+	// Views.
+	//======================================================================
+
+	/**
+	 * Get an `ITerm` view of a term.  While a view is alive, asking again
+	 * returns the same view.
+	 * @param id	The term.
+	 * @return	The view.
+	 */
+	pTerm get_term(term_id id) const;
+
+	/**
+	 * Get the identifier of a term, if it is a view of a term in this store.
+	 * @param term	The term.
+	 * @return	The identifier, or `NO_ID` if the term is not held here.
+	 */
+	term_id id_of(ITerm const& term) const;
+
+private:
+	friend class StoreTerm;
+
+	/// The sizes of the payload tables, to undo an append.
+	typedef std::pair<size_t, size_t> mark_type;
+
+	/**
+	 * Note the sizes of the payload tables.  Take a mark before appending
+	 * any integers or names for a new term.
+	 * @return	The mark to pass to `finish`.
+	 */
+	inline mark_type mark() const {
+		return mark_type(integers_.size(), names_.size());
+	}
+
+	/**
+	 * Append the columns for a new term, computing the fingerprint, depth,
+	 * and flags from the kind, type, children, and payload.  Call `finish`
+	 * next.
+	 * @param kind		The kind.
+	 * @param type		The type.
+	 * @param begin		The start of the children.
+	 * @param end		The end of the children.
+	 * @param payload	The index of the payload in its table, or the value
+	 * 					of a Boolean literal.
+	 */
+	void append(TermKind kind, term_id type, term_id const* begin,
+			term_id const* end, uint32_t payload);
+
+	/**
+	 * Append the columns for a new term with a few children.
+	 * @param kind		The kind.
+	 * @param type		The type.
+	 * @param children	The children.
+	 * @param payload	The payload.
+	 */
+	inline void append(TermKind kind, term_id type,
+			std::initializer_list<term_id> children, uint32_t payload) {
+		append(kind, type, children.begin(), children.end(), payload);
+	}
+
+	/**
+	 * Finish adding the term whose columns have just been appended.  If an
+	 * equal term is already present the new columns are removed again.
+	 * @param before	The mark taken before the append.
+	 * @return	The identifier of the unique equal term.
+	 */
+	term_id finish(mark_type before);
+
+	/**
+	 * Get the index of a string in the string table, adding it if needed.
+	 * @param text	The string.
+	 * @return	The index.
+	 */
+	uint32_t intern_string(std::string const& text);
+
+	/**
+	 * Determine whether a term here and a term of the same kind in another
+	 * store have the same payload.
+	 * @param id	The term here.
+	 * @param other	The other store, which may be this one.
+	 * @param oid	The term in the other store.
+	 * @return	True iff the payloads match.
+	 */
+	bool same_payload(term_id id, TermStore const& other, term_id oid) const;
+
+
+	/// Forget a view that is being disposed of.
+	inline void drop_view(term_id id) const {
+		views_[id] = nullptr;
+	}
+
+	// The columns, indexed by identifier.
+	std::vector<uint8_t> kind_;
+	std::vector<term_id> type_;
+	std::vector<uint32_t> payload_;
+	std::vector<Fingerprint> print_;
+	std::vector<TermSummary> summary_;
+	// The children of term i are children_[first_[i]] to
+	// children_[first_[i+1]].  This has one more entry than the others.
+	std::vector<uint32_t> first_;
+	std::vector<term_id> children_;
+
+	// The payload tables.
+	std::vector<std::string> strings_;
+	std::unordered_map<std::string, uint32_t> string_index_;
+	std::vector<uint32_t> names_;
+	std::vector<Integer> integers_;
+
+	// The terms with each fingerprint.
+	std::unordered_multimap<Fingerprint, term_id> index_;
+
+	// Locations that are not internal.
+	std::unordered_map<term_id, Locus> locs_;
+
+	// The live views, which remove themselves when disposed of.
+	mutable std::vector<StoreTerm const*> views_;
+};
+
+} /* namespace store */
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* TERMSTORE_H_ */
@@ -0,0 +1,377 @@
+/**
+ * @file
+ * Implement the factory for terms held in a columnar term store.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "TermStoreFactory.h"
+#include "StoreTerm.h"
+#include "term/basic/PropertySpecificationBuilderImpl.h"
+#include "term/TermModifier.h"
+#include "match/Matcher.h"
+#include <stdexcept>
+
+namespace elision {
+namespace term {
+namespace store {
+
+namespace {
+
+/**
+ * Build property specifications in a store.  The properties are collected as
+ * for the basic terms, and the result is added to the store.
+ */
+class StorePropertySpecificationBuilder final :
+public basic::PropertySpecificationBuilderImpl {
+public:
+	StorePropertySpecificationBuilder(TermStoreFactory const& fact,
+			TermStore& store, LocPolicy locs) :
+			basic::PropertySpecificationBuilderImpl(fact.TRUE, fact.FALSE,
+					fact.PROPERTIES, locs), store_(&store) {
+		// Nothing to do.
+	}
+
+	pPropertySpecification get() {
+		auto sub = [this](boost::optional<pTerm> const& part) {
+			return part ? store_->import(*part.get()) : TermStore::NO_ID;
+		};
+		std::array<term_id, 6> parts = {{ sub(associative_),
+				sub(commutative_), sub(idempotent_), sub(absorber_),
+				sub(identity_), sub(elements_) }};
+		term_id id = store_->add_property_specification(parts,
+				store_->import(*type_));
+		store_->set_loc(id, loc_);
+		reset();
+		return kind_cast<IPropertySpecification>(store_->get_term(id));
+	}
+
+private:
+	boost::intrusive_ptr<TermStore> store_;
+};
+
+} /* anonymous namespace */
+
+// Little macro to initialize the root types.
+#define INIT(m_name) m_name = get_root_term(#m_name);
+
+TermStoreFactory::TermStoreFactory(LocPolicy locs) : store_(new TermStore()),
+		locs_(locs) {
+	// Initialize the well-known root terms.
+	ROOT = get_root();
+	INIT(SYMBOL);
+	INIT(STRING);
+	INIT(INTEGER);
+	INIT(FLOAT);
+	INIT(BITSTRING);
+	INIT(BOOLEAN);
+	INIT(ANY);
+	INIT(NONE);
+	INIT(MAP);
+	INIT(SPECIAL_FORM);
+	INIT(PROPERTIES);
+	INIT(BINDING);
+	TERM = get_symbol_literal(Loc::get_internal(), "TERM", SYMBOL);
+	list_ = store_->add_symbol_literal(Atom("LIST"), id_of(SYMBOL));
+	TRUE = get_boolean_literal(Loc::get_internal(), true, BOOLEAN);
+	FALSE = get_boolean_literal(Loc::get_internal(), false, BOOLEAN);
+}
+
+pTerm
+TermStoreFactory::get_root() const {
+	return store_->get_term(TermStore::ROOT_ID);
+}
+
+pSymbolLiteral
+TermStoreFactory::get_root_term(std::string const name) const {
+	return get_symbol_literal(Loc::get_internal(), name, get_root());
+}
+
+term_id
+TermStoreFactory::id_of(pTerm const& term) const {
+	NOTNULL(term);
+	return store_->import(*term);
+}
+
+pSymbolLiteral
+TermStoreFactory::get_symbol_literal(
+		Locus loc, std::string const& name, pTerm type) const {
+	NOTNULL(loc);
+	NOTNULL(type);
+	return make<ISymbolLiteral>(loc,
+			store_->add_symbol_literal(Atom(name), id_of(type)));
+}
+
+pStringLiteral
+TermStoreFactory::get_string_literal(
+		Locus loc, std::string const& value, pTerm type) const {
+	NOTNULL(loc);
+	NOTNULL(type);
+	return make<IStringLiteral>(loc,
+			store_->add_string_literal(value, id_of(type)));
+}
+
+pIntegerLiteral
+TermStoreFactory::get_integer_literal(
+		Locus loc, eint_t value, pTerm type) const {
+	NOTNULL(loc);
+	NOTNULL(type);
+	return make<IIntegerLiteral>(loc,
+			store_->add_integer_literal(Integer(value), id_of(type)));
+}
+
+pFloatLiteral
+TermStoreFactory::get_float_literal(
+		Locus loc, eint_t significand, eint_t exponent, uint16_t radix,
+		pTerm type) const {
+	NOTNULL(loc);
+	NOTNULL(type);
+	return make<IFloatLiteral>(loc, store_->add_float_literal(significand,
+			exponent, static_cast<uint8_t>(radix), id_of(type)));
+}
+
+pBitStringLiteral
+TermStoreFactory::get_bit_string_literal(
+		Locus loc, eint_t bits, eint_t length, pTerm type) const {
+	NOTNULL(loc);
+	NOTNULL(type);
+	return make<IBitStringLiteral>(loc,
+			store_->add_bit_string_literal(bits, length, id_of(type)));
+}
+
+pBooleanLiteral
+TermStoreFactory::get_boolean_literal(
+		Locus loc, bool value, pTerm type) const {
+	NOTNULL(loc);
+	NOTNULL(type);
+	return make<IBooleanLiteral>(loc,
+			store_->add_boolean_literal(value, id_of(type)));
+}
+
+pTermLiteral
+TermStoreFactory::get_term_literal(
+		Locus loc, pTerm term) const {
+	NOTNULL(loc);
+	NOTNULL(term);
+	term_id id = id_of(term);
+	term_id type = store_->add_special_form(id_of(TERM),
+			store_->get_type(id), id_of(SPECIAL_FORM));
+	return make<ITermLiteral>(loc, store_->add_term_literal(id, type));
+}
+
+pVariable
+TermStoreFactory::get_variable(
+		Locus loc, std::string name, pTerm guard, pTerm type) const {
+	NOTNULL(loc);
+	NOTNULL(guard);
+	NOTNULL(type);
+	return make<IVariable>(loc,
+			store_->add_variable(Atom(name), id_of(guard), id_of(type)));
+}
+
+pTermVariable
+TermStoreFactory::get_term_variable(
+		Locus loc, std::string name, pTerm term_type) const {
+	NOTNULL(loc);
+	NOTNULL(term_type);
+	term_id id = id_of(term_type);
+	term_id type = store_->add_special_form(id_of(TERM), id,
+			id_of(SPECIAL_FORM));
+	return make<ITermVariable>(loc,
+			store_->add_term_variable(Atom(name), id, type));
+}
+
+pStaticMap
+TermStoreFactory::get_static_map(
+		Locus loc, pTerm domain, pTerm codomain) const {
+	NOTNULL(loc);
+	NOTNULL(domain);
+	NOTNULL(codomain);
+	return make<IStaticMap>(loc, store_->add_static_map(id_of(domain),
+			id_of(codomain), id_of(MAP)));
+}
+
+pLambda
+TermStoreFactory::get_lambda(
+		Locus loc, pTerm lhs, pTerm rhs, pTerm guard) const {
+	NOTNULL(loc);
+	NOTNULL(lhs);
+	NOTNULL(rhs);
+	NOTNULL(guard);
+
+	// The type of the lambda is a static map from the type of the lhs to the
+	// type of the rhs.
+	term_id left = id_of(lhs);
+	term_id right = id_of(rhs);
+	term_id type = store_->add_static_map(store_->get_type(left),
+			store_->get_type(right), id_of(MAP));
+	locate(type, loc);
+	return make<ILambda>(loc,
+			store_->add_lambda(left, right, id_of(guard), type));
+}
+
+pBinding
+TermStoreFactory::get_binding(Locus loc, IBinding::map_t const& binds) const {
+	NOTNULL(loc);
+	std::map<Atom, term_id> ids;
+	for (auto const& entry : binds) {
+		ids.emplace(entry.first, id_of(entry.second));
+	} // Loop over all binds.
+	return make<IBinding>(loc, store_->add_binding(ids, id_of(BINDING)));
+}
+
+pSpecialForm
+TermStoreFactory::get_special_form(Locus loc, pTerm tag, pTerm content) const {
+	NOTNULL(loc);
+	NOTNULL(tag);
+	NOTNULL(content);
+	return make<ISpecialForm>(loc, store_->add_special_form(id_of(tag),
+			id_of(content), id_of(SPECIAL_FORM)));
+}
+
+pList
+TermStoreFactory::get_list(Locus loc, pPropertySpecification spec,
+		std::vector<pTerm>&& elements) const {
+	NOTNULL(loc);
+	NOTNULL(spec);
+
+	// The real type for the list is deduced from the element specification in
+	// the property specification.
+	boost::optional<pTerm> membership = spec->get_membership();
+	term_id element_type = id_of(membership ? membership.get() : ANY);
+	term_id type = store_->add_special_form(list_, element_type,
+			id_of(SPECIAL_FORM));
+	locate(type, loc);
+	std::vector<term_id> ids;
+	ids.reserve(elements.size());
+	for (auto const& elt : elements) {
+		NOTNULL(elt);
+		ids.push_back(id_of(elt));
+	} // Loop over elements.
+	return make<IList>(loc, store_->add_list(id_of(spec), ids, type));
+}
+
+pList
+TermStoreFactory::catenate(Locus loc, pList first, pList second) const {
+	NOTNULL(first);
+	NOTNULL(second);
+	std::vector<pTerm> elements;
+	elements.reserve(first->size() + second->size());
+	elements.insert(elements.end(), first->begin(), first->end());
+	elements.insert(elements.end(), second->begin(), second->end());
+	return get_list(loc, first->get_property_specification(),
+			std::move(elements));
+}
+
+pList
+TermStoreFactory::slice(Locus loc, pList list, size_t from, size_t to) const {
+	NOTNULL(list);
+	if (from > to || to > list->size()) {
+		throw std::out_of_range("The slice is not within the list.");
+	}
+	std::vector<pTerm> elements;
+	elements.reserve(to - from);
+	for (size_t position = from; position < to; ++position) {
+		elements.push_back((*list)[position]);
+	} // Loop over the range.
+	return get_list(loc, list->get_property_specification(),
+			std::move(elements));
+}
+
+pTerm
+TermStoreFactory::apply(Locus loc, pTerm op, pTerm arg) const {
+	NOTNULL(loc);
+	NOTNULL(op);
+	NOTNULL(arg);
+
+	// Applying a binding replaces bound variables with their bound terms.
+	if (op->get_kind() == BINDING_KIND) {
+		return basic::TermModifier(*this).substitute(
+				kind_cast<IBinding>(*op).get_map(), arg);
+	}
+
+	// Applying a lambda rewrites the argument by the first match that
+	// satisfies the guard, and leaves any other argument alone.
+	if (op->get_kind() == LAMBDA_KIND) {
+		auto const& lambda = kind_cast<ILambda>(*op);
+		match::Matcher matcher(*this);
+		match::Context context;
+		basic::TermModifier modifier(*this);
+		bool matched = matcher.try_match(lambda.get_lhs(), arg, context);
+		for (; matched; matched = matcher.next_match(context)) {
+			auto binds = context.get_map();
+			if (modifier.substitute(binds, lambda.get_guard())->is_true()) {
+				return modifier.substitute(binds, lambda.get_rhs());
+			}
+		} // Loop over the matches.
+		return arg;
+	}
+
+	// Applying a list to a list catenates them.
+	if (op->get_kind() == LIST_KIND && arg->get_kind() == LIST_KIND) {
+		return catenate(loc, kind_cast<IList>(op), kind_cast<IList>(arg));
+	}
+
+	// Applying a property specification merges property specifications and
+	// modifies lists.  Everything else is left as an application.
+	if (op->get_kind() == PROPERTY_SPECIFICATION_KIND) {
+		auto opspec = kind_cast<IPropertySpecification>(op);
+		switch (arg->get_kind()) {
+		case LIST_KIND: {
+			auto const& list = kind_cast<IList>(*arg);
+			auto newps = override_properties(list.get_property_specification(),
+					opspec);
+			if (*newps == *list.get_property_specification()) return arg;
+			return get_list(op->get_loc(), newps,
+					std::vector<pTerm>(list.begin(), list.end()));
+		}
+
+		case PROPERTY_SPECIFICATION_KIND: {
+			auto argspec = kind_cast<IPropertySpecification>(arg);
+			return override_properties(argspec, opspec);
+		}
+
+		default:
+			break;
+		} // Switch on argument kind.
+	}
+	return make<IApply>(loc, store_->add_apply(id_of(op), id_of(arg),
+			id_of(MAP)));
+}
+
+std::unique_ptr<PropertySpecificationBuilder>
+TermStoreFactory::get_property_specification_builder() const {
+	return std::unique_ptr<PropertySpecificationBuilder>(
+			new StorePropertySpecificationBuilder(*this, *store_, locs_));
+}
+
+pPropertySpecification
+TermStoreFactory::override_properties(pPropertySpecification spec,
+		pPropertySpecification by) const {
+	NOTNULL(spec);
+	NOTNULL(by);
+	if (spec == by) return spec;
+
+	// The store interns the result, so the builder only collects the parts,
+	// and can live on the stack.
+	StorePropertySpecificationBuilder psb(*this, *store_, locs_);
+	psb.override(spec);
+	psb.override(by);
+	return psb.get();
+}
+
+} /* namespace store */
+} /* namespace term */
+} /* namespace elision */
@@ -0,0 +1,163 @@
+#ifndef TERMSTOREFACTORY_H_
+#define TERMSTOREFACTORY_H_
+
+/**
+ * @file
+ * Make terms held in a columnar term store.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "term/TermFactory.h"
+#include "TermStore.h"
+
+namespace elision {
+namespace term {
+namespace store {
+
+/**
+ * Implement a term factory whose terms are held in a `TermStore`.  This is
+ * meant for large knowledge bases, where a graph of separately allocated
+ * terms spends most of its time on cache misses.  Each term made here is a
+ * view of an identifier in the store; the views can be mixed freely with
+ * terms from other factories, which are copied into the store when they are
+ * used as parts of a new term.
+ *
+ * Code that works on many terms at once can use `get_store` and `id_of` to
+ * work with the identifiers and columns directly.
+ *
+ * The factory, its store, and its terms must stay on one thread.
+ */
+class TermStoreFactory: public TermFactory {
+public:
+	/**
+	 * Make a new instance with an empty store.
+	 * @param locs	Whether to record the locations of terms.
+	 */
+	explicit TermStoreFactory(LocPolicy locs = KEEP_LOCATIONS);
+
+	/// Deallocate this instance.
+	virtual ~TermStoreFactory() = default;
+
+	virtual pTerm get_root() const;
+
+	virtual pSymbolLiteral get_root_term(std::string const name) const;
+
+	// Keep the convenience forms from the base class visible.
+	using TermFactory::get_symbol_literal;
+	using TermFactory::get_string_literal;
+	using TermFactory::get_integer_literal;
+	using TermFactory::get_float_literal;
+	using TermFactory::get_bit_string_literal;
+	using TermFactory::get_boolean_literal;
+	using TermFactory::get_term_literal;
+
+	virtual pSymbolLiteral get_symbol_literal(
+			Locus loc, std::string const& name, pTerm type) const;
+	virtual pStringLiteral get_string_literal(
+			Locus loc, std::string const& value, pTerm type) const;
+	virtual pIntegerLiteral get_integer_literal(
+			Locus loc, eint_t value, pTerm type) const;
+	virtual pFloatLiteral get_float_literal(
+			Locus loc, eint_t significand, eint_t exponent, uint16_t radix,
+			pTerm type) const;
+	virtual pBitStringLiteral get_bit_string_literal(
+			Locus loc, eint_t bits, eint_t length, pTerm type) const;
+	virtual pBooleanLiteral get_boolean_literal(
+			Locus loc, bool value, pTerm type) const;
+	virtual pTermLiteral get_term_literal(
+			Locus loc, pTerm term) const;
+
+	virtual pVariable get_variable(Locus loc, std::string name, pTerm guard,
+			pTerm type) const;
+	virtual pTermVariable get_term_variable(Locus loc, std::string name,
+			pTerm term_type) const;
+
+	virtual pStaticMap get_static_map(Locus loc, pTerm domain,
+			pTerm codomain) const;
+
+	virtual pLambda get_lambda(Locus loc, pTerm lhs, pTerm rhs,
+			pTerm guard) const;
+
+	virtual pBinding get_binding(Locus loc,
+			IBinding::map_t const& binds) const;
+
+	virtual pSpecialForm get_special_form(Locus loc, pTerm tag,
+			pTerm content) const;
+
+	using TermFactory::get_list;
+	virtual pList get_list(Locus loc, pPropertySpecification spec,
+			std::vector<pTerm>&& elements) const;
+
+	virtual pList catenate(Locus loc, pList first, pList second) const;
+
+	virtual pList slice(Locus loc, pList list, size_t from, size_t to) const;
+
+	virtual pTerm apply(Locus loc, pTerm op, pTerm arg) const;
+
+	virtual std::unique_ptr<PropertySpecificationBuilder>
+	get_property_specification_builder() const;
+
+	virtual pPropertySpecification override_properties(
+			pPropertySpecification spec, pPropertySpecification by) const;
+
+	/**
+	 * Get the store holding this factory's terms.
+	 * @return	The store.
+	 */
+	inline TermStore const& get_store() const {
+		return *store_;
+	}
+
+	/**
+	 * Get the identifier of a term in this factory's store, copying the
+	 * term into the store if it came from elsewhere.
+	 * @param term	The term.
+	 * @return	The identifier.
+	 */
+	term_id id_of(pTerm const& term) const;
+
+private:
+	/**
+	 * Record the location of a term and get its view.
+	 * @param loc	The location.
+	 * @param id	The term.
+	 * @return	The view, as the interface for its kind.
+	 */
+	template<class Face>
+	boost::intrusive_ptr<Face const> make(Locus const& loc, term_id id) const {
+		locate(id, loc);
+		return kind_cast<Face>(store_->get_term(id));
+	}
+
+	/**
+	 * Record the location of a term, unless locations are dropped.
+	 * @param id	The term.
+	 * @param loc	The location.
+	 */
+	inline void locate(term_id id, Locus const& loc) const {
+		if (locs_ == KEEP_LOCATIONS) store_->set_loc(id, loc);
+	}
+
+	boost::intrusive_ptr<TermStore> store_;
+	term_id list_;
+	LocPolicy locs_;
+};
+
+} /* namespace store */
+} /* namespace term */
+} /* namespace elision */
+
+#endif /* TERMSTOREFACTORY_H_ */
@@ -21,6 +21,7 @@
 #include <sstream>
 #include <boost/lexical_cast.hpp>
 #include "elision.h"
+#include "Integer.h"
 
 using std::string;
 using std::ios;
@@ -28,6 +29,11 @@ using std::ostringstream;
 
 namespace elision {
 
+// Definitions for the bounds, which are bound to references by the big
+// integer comparisons.
+constexpr int64_t Integer::SMALL_MAX;
+constexpr int64_t Integer::SMALL_MIN;
+
 uint8_t preferred_radix = 10;
 
 std::string const escape(std::string const& original, bool is_symbol) {
@@ -129,7 +135,63 @@ std::string const escape(std::string const& original, bool is_symbol) {
 	return result;
 }
 
+namespace {
+
+/**
+ * Convert a small integer to a string, given its sign and magnitude.  This
+ * writes the digits directly, which is much faster than going through a
+ * stream.
+ * @param negative	Whether the value is negative.
+ * @param magnitude	The absolute value.
+ * @param base		The base, which must be 16, 10, 8, or 2.
+ * @param prefix	Whether or not to include the base prefix in the string.
+ * @return	The string.
+ */
+std::string small_to_string(bool negative, uint64_t magnitude, uint16_t base,
+		bool prefix) {
+	char const* lead;
+	switch (base) {
+	case 2: lead = "0b"; break;
+	case 8: lead = "0o"; break;
+	case 10: lead = ""; break;
+	case 16: lead = "0x"; break;
+	default:
+		throw std::invalid_argument(
+				"Base " + boost::lexical_cast<std::string>(base)
+						+ " is not allowed.");
+	}
+	// Fill a buffer from the end.  Binary needs the most digits.
+	char buffer[64 + 3];
+	char* end = buffer + sizeof(buffer);
+	char* pos = end;
+	do {
+		*--pos = "0123456789ABCDEF"[magnitude % base];
+		magnitude /= base;
+	} while (magnitude != 0);
+	std::string result;
+	result.reserve(end - pos + 3);
+	if (negative) result += '-';
+	if (prefix) result += lead;
+	result.append(pos, end);
+	return result;
+}
+
+} /* anonymous namespace */
+
+std::string eint_to_string(Integer const& value, uint16_t base, bool prefix) {
+	if (value.is_small()) {
+		int64_t small = value.get_small();
+		// Small values are at most 62 bits, so the negation is safe.
+		return small_to_string(small < 0,
+				static_cast<uint64_t>(small < 0 ? -small : small), base, prefix);
+	}
+	return eint_to_string(value.get_big(), base, prefix);
+}
+
 std::string eint_to_string(eint_t value, uint16_t base, bool prefix) {
+	if (value >= Integer::SMALL_MIN && value <= Integer::SMALL_MAX) {
+		return eint_to_string(Integer(value), base, prefix);
+	}
 	std::ostringstream oss;
 	eint_t useval = value;
 	if (value < 0) {
@@ -0,0 +1,171 @@
+/**
+ * @file
+ * Test making terms in an arena and promoting them to the heap.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+
+using namespace elision;
+using namespace elision::term;
+using elision::term::basic::TermFactoryImpl;
+using elision::term::basic::TermImpl;
+
+/**
+ * Determine whether a term lives in an arena.
+ * @param term	The term.
+ * @return	True iff the term is in an arena.
+ */
+static bool in_arena(pTerm term) {
+	auto impl = boost::dynamic_pointer_cast<TermImpl const>(term);
+	return impl && impl->is_in_arena();
+}
+
+START_TEST
+
+// Get a term factory.
+HANG("Making a factory");
+TermFactoryImpl fact;
+ENDL("Done");
+
+START_ITEM(scope)
+
+try {
+	pTerm map;
+	pTerm heap;
+	{
+		HANG("Making terms in a scope");
+		TermFactoryImpl::ArenaScope scope(fact);
+		map = fact.get_static_map(Loc::get_internal(),
+				fact.get_integer_literal(17), fact.get_string_literal("x"));
+		heap = fact.get_boolean_literal(true);
+		ENDL("Done");
+
+		ENDL("Checking placement"); PUSH;
+		MUST_EQUAL(in_arena(map), true, "new term is in the arena");
+		MUST_EQUAL(in_arena(heap), false, "existing term stays on the heap");
+		MUST_EQUAL(scope.get_arena().get_used() > 0, true, "arena is used");
+		MUST_EQUAL(map.get(), fact.get_static_map(Loc::get_internal(),
+				fact.get_integer_literal(17),
+				fact.get_string_literal("x")).get(), "terms are shared");
+		POP;
+	}
+	ENDL("Checking after the scope closed"); PUSH;
+	MUST_EQUAL(in_arena(map), true, "term is still in the arena");
+	pTerm later = fact.get_integer_literal(99);
+	MUST_EQUAL(in_arena(later), false, "new term is on the heap");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(scope, "");
+}
+
+END_ITEM(scope)
+
+START_ITEM(promote)
+
+try {
+	pTerm lambda;
+	{
+		HANG("Making terms in a scope");
+		TermFactoryImpl::ArenaScope scope(fact);
+		pTerm x = fact.get_variable(Loc::get_internal(), "x", fact.TRUE,
+				fact.get_symbol_literal("COLOR"));
+		lambda = fact.get_lambda(Loc::get_internal(), x,
+				fact.get_integer_literal(5), fact.TRUE);
+		ENDL("Done");
+	}
+
+	HANG("Promoting");
+	pTerm promoted = fact.promote(lambda);
+	ENDL("Done");
+
+	ENDL("Checking promotion"); PUSH;
+	MUST_EQUAL(in_arena(promoted), false, "promoted term is on the heap");
+	MUST_EQUAL(in_arena(promoted->get_type()), false, "type is on the heap");
+	MUST_NOT_EQUAL(promoted.get(), lambda.get(), "new instance");
+	MUST_EQUAL(*promoted, *lambda, "same term");
+	MUST_EQUAL(promoted.get(), fact.promote(promoted).get(), "idempotent");
+	pTerm again = fact.get_lambda(Loc::get_internal(),
+			fact.get_variable(Loc::get_internal(), "x", fact.TRUE,
+					fact.get_symbol_literal("COLOR")),
+			fact.get_integer_literal(5), fact.TRUE);
+	MUST_EQUAL(promoted.get(), again.get(), "promoted term is interned");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(promote, "");
+}
+
+END_ITEM(promote)
+
+START_ITEM(parts)
+
+try {
+	Locus loc = Loc::get_internal();
+	pList list;
+	pBinding binding;
+	pTerm dag;
+	{
+		HANG("Making terms in a scope");
+		TermFactoryImpl::ArenaScope scope(fact);
+		pTerm absorber = fact.get_integer_literal(5001);
+		auto spec = fact.get_property_specification_builder()
+				->set_absorber(absorber)->get();
+		pTerm five = fact.get_integer_literal(5002);
+		list = fact.get_list(loc, spec, std::vector<pTerm>{ five, five });
+		binding = fact.get_binding(loc, BindMap().extend(Atom("y"), five));
+
+		// Each level refers to the one below twice.
+		pTerm f = fact.get_symbol_literal("f");
+		dag = fact.get_string_literal("leaf");
+		for (int level = 0; level < 64; ++level) {
+			dag = fact.apply(loc, f, fact.get_list(loc, spec,
+					std::vector<pTerm>{ dag, dag }));
+		} // Build the levels.
+		MUST_THROW(fact.promote(five), std::logic_error);
+		ENDL("Done");
+	}
+
+	ENDL("Checking promotion of parts"); PUSH;
+	auto promoted = kind_cast<IList>(fact.promote(list));
+	MUST_EQUAL(*promoted == *list, true, "same list");
+	MUST_EQUAL(in_arena(promoted->get_property_specification()
+			->get_absorber().get()), false, "absorber is on the heap");
+	MUST_EQUAL(in_arena((*promoted)[0]), false, "element is on the heap");
+	MUST_EQUAL(promoted->get_summary().in_arena(), false, "summary");
+	auto bound = kind_cast<IBinding>(fact.promote(binding));
+	MUST_EQUAL(in_arena(bound->get_bind(Atom("y"))), false,
+			"bound term is on the heap");
+	// Comparing the whole of the shared term would visit every path, so
+	// check that the sharing survives instead.
+	pTerm shared = fact.promote(dag);
+	MUST_EQUAL(shared->get_summary().in_arena(), false, "shared summary");
+	auto pair = kind_cast<IList>(kind_cast<IApply>(shared)->get_argument());
+	MUST_EQUAL((*pair)[0].get(), (*pair)[1].get(), "sharing kept");
+	MUST_EQUAL(shared->get_depth(), dag->get_depth(), "depth");
+	MUST_EQUAL(fact.promote(shared).get(), shared.get(), "heap unchanged");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(parts, "");
+}
+
+END_ITEM(parts)
+
+END_TEST
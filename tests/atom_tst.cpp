@@ -0,0 +1,110 @@
+/**
+ * @file
+ * Test the atom table and the names of symbols and variables.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "Atom.h"
+#include "term/TermFactory.h"
+#include "term/TermModifier.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+#include <thread>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+
+START_TEST
+
+START_ITEM(table)
+
+try {
+	ENDL("Interning names"); PUSH;
+	MUST_EQUAL(Atom().get_name(), std::string(""), "empty name");
+	MUST_EQUAL(Atom("").get_id(), 0u, "empty atom");
+	Atom fred("fred");
+	MUST_EQUAL(fred == Atom(std::string("fr") + "ed"), true, "same atom");
+	MUST_EQUAL(fred != Atom("barney"), true, "different atom");
+	MUST_EQUAL(fred.get_name(), std::string("fred"), "reverse lookup");
+	MUST_EQUAL(Atom::from_id(fred.get_id()) == fred, true, "from id");
+	Atom found;
+	MUST_EQUAL(Atom::find("fred", found), true, "find");
+	MUST_EQUAL(found == fred, true, "found");
+	MUST_EQUAL(Atom::find("never interned", found), false, "not found");
+	MUST_EQUAL(name_less(Atom("b"), Atom("a")), false, "name order");
+	MUST_EQUAL(name_less(Atom("a"), Atom("b")), true, "name order");
+	std::vector<std::thread> workers;
+	std::vector<uint32_t> ids(8);
+	std::vector<unsigned> wrong(ids.size());
+	for (unsigned index = 0; index < ids.size(); ++index) {
+		workers.push_back(std::thread([&ids, &wrong, index]() {
+			// Twice, so the second pass finds the names already there.
+			for (unsigned name = 0; name < 20000; ++name) {
+				std::string text = "name" + std::to_string(name % 10000);
+				if (Atom(text).get_name() != text) ++wrong[index];
+			} // Intern many names.
+			ids[index] = Atom("name17").get_id();
+		}));
+	} // Start all workers.
+	for (auto& worker : workers) worker.join();
+	for (unsigned index = 0; index < ids.size(); ++index) {
+		MUST_EQUAL(ids[index], ids[0], "threads agree");
+		MUST_EQUAL(wrong[index], 0u, "names round trip");
+	} // Check all workers.
+	MUST_EQUAL(Atom::from_id(ids[0]).get_name(), std::string("name17"),
+			"threads name");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(table, "");
+}
+
+END_ITEM(table)
+
+START_ITEM(terms)
+
+try {
+	ENDL("Naming terms with atoms"); PUSH;
+	basic::TermFactoryImpl fact;
+	store::TermStoreFactory other;
+	auto sym = fact.get_symbol_literal("fred");
+	MUST_EQUAL(sym->get_atom() == Atom("fred"), true, "symbol atom");
+	MUST_EQUAL(sym->get_name(), std::string("fred"), "symbol name");
+	auto var = fact.get_variable(Loc::get_internal(), "x", fact.TRUE,
+			fact.INTEGER);
+	auto theirs = other.get_variable(Loc::get_internal(), "x", other.TRUE,
+			other.INTEGER);
+	MUST_EQUAL(var->get_atom() == theirs->get_atom(), true, "same atom");
+	MUST_EQUAL(*var == *theirs, true, "equal variables");
+	MUST_EQUAL(var->get_fingerprint() == theirs->get_fingerprint(), true,
+			"fingerprint");
+	auto binds = BindMap().extend(Atom("x"), fact.get_integer_literal(5));
+	pTerm body = fact.apply(Loc::get_internal(), sym, var);
+	basic::TermModifier modifier(fact);
+	MUST_EQUAL(modifier.substitute(binds, body)->to_string(),
+			fact.apply(Loc::get_internal(), sym, fact.get_integer_literal(5))
+					->to_string(), "substitute");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(terms, "");
+}
+
+END_ITEM(terms)
+
+END_TEST
@@ -0,0 +1,135 @@
+/**
+ * @file
+ * Test bind maps and bindings.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+#include <map>
+
+using namespace elision;
+using namespace elision::term;
+
+START_TEST
+
+START_ITEM(map)
+
+try {
+	ENDL("Extending bind maps"); PUSH;
+	basic::TermFactoryImpl fact;
+	std::vector<Atom> names;
+	for (unsigned index = 0; index < 2000; ++index) {
+		names.push_back(Atom("v" + std::to_string(index)));
+	} // Make the names.
+
+	// Keep every version, and check each against a standard map.
+	std::vector<BindMap> versions(1);
+	std::vector<std::map<Atom, pTerm>> models(1);
+	for (unsigned index = 0; index < 2000; ++index) {
+		Atom name = names[(index * 7919u) % names.size()];
+		pTerm term = fact.get_integer_literal(index);
+		if (index % 5 == 4) name = names[index / 2];
+		versions.push_back(versions.back().extend(name, term));
+		models.push_back(models.back());
+		models.back()[name] = term;
+	} // Extend the map.
+	bool same = true;
+	for (size_t version = 0; version < versions.size(); version += 97) {
+		BindMap const& map = versions[version];
+		auto const& model = models[version];
+		same &= map.size() == model.size();
+		size_t count = 0;
+		for (auto const& entry : map) {
+			auto found = model.find(entry.first);
+			same &= found != model.end() && found->second == entry.second;
+			++count;
+		} // Walk the map.
+		same &= count == model.size();
+		for (Atom name : names) {
+			pTerm const* found = map.find(name);
+			same &= (found != nullptr) == (model.count(name) == 1);
+		} // Look up every name.
+	} // Check the versions.
+	MUST_EQUAL(same, true, "versions");
+	MUST_EQUAL(versions[0].find(names[0]) == nullptr, true, "empty");
+	MUST_EQUAL(versions[0].begin() == versions[0].end(), true, "empty walk");
+	BindMap again = versions.back().extend(names[3],
+			*versions.back().find(names[3]));
+	MUST_EQUAL(again == versions.back(), true, "same bind");
+	MUST_EQUAL(versions[3] == versions[4], false, "different");
+	MUST_EQUAL(versions[3] < versions[4] || versions[4] < versions[3], true,
+			"ordered");
+	auto sorted = versions[20].sorted();
+	bool ordered = true;
+	for (size_t index = 1; index < sorted.size(); ++index) {
+		ordered &= name_less(sorted[index - 1]->first, sorted[index]->first);
+	} // Check the order.
+	MUST_EQUAL(ordered, true, "sorted");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(map, "");
+}
+
+END_ITEM(map)
+
+START_ITEM(binding)
+
+try {
+	ENDL("Making and applying bindings"); PUSH;
+	basic::TermFactoryImpl basic;
+	store::TermStoreFactory stored;
+	std::vector<std::string> shown;
+	std::vector<Fingerprint> prints;
+	for (TermFactory const* fact : { static_cast<TermFactory const*>(&basic),
+			static_cast<TermFactory const*>(&stored) }) {
+		BindMap binds = BindMap()
+				.extend(Atom("x"), fact->get_integer_literal(5))
+				.extend(Atom("y"), fact->get_string_literal("five"));
+		pBinding binding = fact->get_binding(Loc::get_internal(), binds);
+		MUST_EQUAL(binding->get_kind(), BINDING_KIND, "kind");
+		MUST_EQUAL(binding->has_bind("x"), true, "has x");
+		MUST_EQUAL(binding->has_bind("z"), false, "missing z");
+		MUST_THROW(binding->get_bind("z"), std::out_of_range);
+		MUST_EQUAL(*binding->get_bind(Atom("x")) ==
+				*fact->get_integer_literal(5), true, "get x");
+		MUST_EQUAL(binding->get_map().size(), 2u, "size");
+		MUST_EQUAL(binding->get_type() == fact->BINDING, true, "type");
+		pTerm var = fact->get_variable(Loc::get_internal(), "x", fact->TRUE,
+				fact->ANY);
+		pTerm body = fact->apply(Loc::get_internal(),
+				fact->get_symbol_literal("f"), var);
+		pTerm result = fact->apply(Loc::get_internal(), binding, body);
+		MUST_EQUAL(*result == *fact->apply(Loc::get_internal(),
+				fact->get_symbol_literal("f"), fact->get_integer_literal(5)),
+				true, "apply");
+		shown.push_back(binding->to_string());
+		prints.push_back(binding->get_fingerprint());
+	} // Loop over factories.
+	MUST_EQUAL(shown[0], shown[1], "printed");
+	MUST_EQUAL(prints[0] == prints[1], true, "fingerprint");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(binding, "");
+}
+
+END_ITEM(binding)
+
+END_TEST
@@ -0,0 +1,79 @@
+/**
+ * @file
+ * Test the cache for values computed on first use.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "Cached.h"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace elision;
+
+START_TEST
+
+START_ITEM(once)
+
+try {
+	ENDL("Computing a value on several threads"); PUSH;
+	Cached<std::string> cache;
+	std::atomic<int> calls(0);
+	std::vector<std::thread> workers;
+	for (int index = 0; index < 8; ++index) {
+		workers.push_back(std::thread([&cache, &calls]() {
+			cache.get([&calls]() {
+				++calls;
+				std::this_thread::yield();
+				return std::string("computed");
+			});
+		}));
+	} // Start all workers.
+	for (auto& worker : workers) worker.join();
+	MUST_EQUAL(calls.load(), 1, "computed once");
+	MUST_EQUAL(cache.get([]() { return std::string("again"); }),
+			std::string("computed"), "value kept");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(once, "");
+}
+
+END_ITEM(once)
+
+START_ITEM(failure)
+
+try {
+	ENDL("Computing a value that throws"); PUSH;
+	Cached<int> cache;
+	auto fail = []() -> int { throw std::runtime_error("no value"); };
+	MUST_THROW(cache.get(fail), std::runtime_error);
+	MUST_EQUAL(cache.has_value(), false, "still empty");
+	MUST_EQUAL(cache.get([]() { return 17; }), 17, "computed later");
+	Cached<int> preset;
+	preset.set(21);
+	MUST_EQUAL(preset.get([]() { return 0; }), 21, "preset value");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(failure, "");
+}
+
+END_ITEM(failure)
+
+END_TEST
@@ -0,0 +1,101 @@
+/**
+ * @file
+ * Test dispatching on the kind of a term.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/Dispatch.h"
+#include "term/basic/TermFactoryImpl.h"
+
+using namespace elision;
+using namespace elision::term;
+
+// Name the interface a term was passed as.
+struct Name {
+	std::string operator()(ISymbolLiteral const& lit) const {
+		return "symbol " + lit.get_name();
+	}
+	std::string operator()(IApply const&) const {
+		return "apply";
+	}
+	std::string operator()(ITerm const&) const {
+		return "other";
+	}
+};
+
+// Swap the operator and argument of every application at the top.
+class Swap : public KindVisitor<Swap> {
+public:
+	Swap(TermFactory const& fact) : fact_(fact) {}
+	using KindVisitor<Swap>::visit_kind;
+	pTerm visit_kind(pTerm const&, IApply const& apply) {
+		return fact_.apply(apply.get_loc(), apply.get_argument(),
+				apply.get_operator());
+	}
+private:
+	TermFactory const& fact_;
+};
+
+START_TEST
+
+// Get a term factory.
+HANG("Making a factory");
+std::unique_ptr<TermFactory> fact(new elision::term::basic::TermFactoryImpl());
+ENDL("Done");
+
+START_ITEM(dispatch)
+
+try {
+	ENDL("Dispatching on kind"); PUSH;
+	pTerm fred = fact->get_symbol_literal("fred");
+	pTerm app = fact->apply(Loc::get_internal(), fred,
+			fact->get_integer_literal(5));
+	MUST_EQUAL(dispatch(*fred, Name()), "symbol fred", "symbol");
+	MUST_EQUAL(dispatch(*app, Name()), "apply", "apply");
+	MUST_EQUAL(dispatch(*fact->get_root(), Name()), "other", "root");
+	MUST_EQUAL(kind_cast<ISymbolLiteral>(fred)->get_name(), "fred",
+			"cast handle");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(dispatch, "");
+}
+
+END_ITEM(dispatch)
+
+START_ITEM(visitor)
+
+try {
+	ENDL("Visiting by kind"); PUSH;
+	Swap swap(*fact);
+	TermVisitor& visitor = swap;
+	pTerm one = fact->get_integer_literal(1);
+	pTerm two = fact->get_integer_literal(2);
+	pTerm app = fact->apply(Loc::get_internal(), one, two);
+	MUST_EQUAL(*visitor.visit(app),
+			*fact->apply(Loc::get_internal(), two, one), "swapped");
+	MUST_EQUAL(visitor.visit(one).get(), one.get(), "unchanged");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(visitor, "");
+}
+
+END_ITEM(visitor)
+
+END_TEST
@@ -0,0 +1,92 @@
+/**
+ * @file
+ * Test the structural fingerprints of terms.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <unordered_map>
+
+using namespace elision;
+using namespace elision::term;
+
+START_TEST
+
+// Get two term factories.
+HANG("Making factories");
+std::unique_ptr<TermFactory> fact(new elision::term::basic::TermFactoryImpl());
+std::unique_ptr<TermFactory> other(new elision::term::basic::TermFactoryImpl());
+ENDL("Done");
+
+START_ITEM(literals)
+
+try {
+	ENDL("Fingerprinting literals"); PUSH;
+	eint_t big = 1;
+	big <<= 200;
+	MUST_EQUAL(fact->get_integer_literal(big)->feq(
+			*other->get_integer_literal(big)), true, "same big integer");
+	MUST_EQUAL(fact->get_integer_literal(big)->feq(
+			*fact->get_integer_literal(big + 1)), false, "different integers");
+	MUST_EQUAL(fact->get_integer_literal(-5)->feq(
+			*fact->get_integer_literal(5)), false, "sign");
+	MUST_EQUAL(fact->get_symbol_literal("ab")->feq(
+			*fact->get_string_literal("ab")), false, "kind");
+	MUST_EQUAL(fact->get_symbol_literal("ab")->feq(
+			*fact->get_symbol_literal(Loc::get_internal(), "ab",
+					fact->STRING)), false, "type");
+	MUST_EQUAL(fact->get_bit_string_literal(1, 8)->feq(
+			*fact->get_bit_string_literal(18, 0)), false, "framing");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(literals, "");
+}
+
+END_ITEM(literals)
+
+START_ITEM(structure)
+
+try {
+	ENDL("Fingerprinting compound terms"); PUSH;
+	auto make = [](TermFactory const& fact, eint_t value) -> pTerm {
+		return fact.apply(Loc::get_internal(), fact.get_symbol_literal("f"),
+				fact.get_static_map(Loc::get_internal(),
+						fact.get_integer_literal(value), fact.STRING));
+	};
+	pTerm first = make(*fact, 7);
+	pTerm second = make(*other, 7);
+	pTerm third = make(*fact, 8);
+	MUST_EQUAL(first->get_fingerprint() == second->get_fingerprint(), true,
+			"same structure");
+	MUST_EQUAL(first->get_fingerprint() == third->get_fingerprint(), false,
+			"different leaf");
+	MUST_EQUAL(*first == *second, true, "equal");
+	MUST_EQUAL(*first == *third, false, "unequal");
+	std::unordered_map<Fingerprint, pTerm> cache;
+	cache[first->get_fingerprint()] = first;
+	MUST_EQUAL(cache.count(second->get_fingerprint()), 1u, "cache key");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(structure, "");
+}
+
+END_ITEM(structure)
+
+END_TEST
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * Test the compact integers and the preallocated integer literals.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "Integer.h"
+#include "Fingerprint.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+
+using namespace elision;
+using namespace elision::term;
+
+START_TEST
+
+START_ITEM(compact)
+
+try {
+	ENDL("Holding small and big values"); PUSH;
+	MUST_EQUAL(Integer().is_small(), true, "zero");
+	MUST_EQUAL(Integer(Integer::SMALL_MAX).is_small(), true, "largest small");
+	MUST_EQUAL(Integer(Integer::SMALL_MIN).is_small(), true, "smallest small");
+	MUST_EQUAL(Integer(Integer::SMALL_MAX + 1).is_small(), false, "promoted");
+	MUST_EQUAL(Integer(Integer::SMALL_MIN - 1).is_small(), false, "promoted");
+	MUST_EQUAL(Integer(-17).get_small(), -17, "negative");
+	MUST_EQUAL(Integer(-17).sign(), -1, "sign");
+	Integer big(Integer::SMALL_MAX + 1);
+	Integer copy = big;
+	MUST_EQUAL(copy == big, true, "copy");
+	MUST_EQUAL(Integer(5) == Integer(eint_t(5)), true, "from eint");
+	MUST_EQUAL(Integer(5) != big, true, "small and big");
+	MUST_EQUAL(Integer(5) < big, true, "below big");
+	MUST_EQUAL(Integer(Integer::SMALL_MIN - 1) < Integer(-5), true,
+			"above negative big");
+	MUST_EQUAL(Integer(-5) < Integer(3), true, "small order");
+	MUST_EQUAL(big.get() == eint_t(Integer::SMALL_MAX) + 1, true, "value");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(compact, "");
+}
+
+END_ITEM(compact)
+
+START_ITEM(paths)
+
+try {
+	ENDL("Matching the unbounded integer paths"); PUSH;
+	for (int64_t value : { INT64_C(0), INT64_C(-1), INT64_C(666),
+			Integer::SMALL_MIN, Integer::SMALL_MAX }) {
+		eint_t wide = value;
+		eint_t third = wide / 3;
+		MUST_EQUAL(Fingerprinter(0).add_integer(Integer(value)).get() ==
+				Fingerprinter(0).add_integer(wide).get(), true, "fingerprint");
+		for (uint16_t base : { 2, 8, 10, 16 }) {
+			std::ostringstream out;
+			out << eint_to_string(third, base, true);
+			MUST_EQUAL(eint_to_string(Integer(third), base), out.str(),
+					"string");
+		} // Loop over bases.
+	} // Loop over values.
+	MUST_THROW(eint_to_string(Integer(1), 12), std::exception);
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(paths, "");
+}
+
+END_ITEM(paths)
+
+START_ITEM(table)
+
+try {
+	ENDL("Getting the preallocated literals"); PUSH;
+	basic::TermFactoryImpl fact;
+	MUST_EQUAL(fact.get_integer_literal(1).get(),
+			fact.get_integer_literal(1).get(), "same literal");
+	MUST_EQUAL(fact.get_integer_literal(-3)->get_integer().get_small(), -3,
+			"value");
+	auto loc = Loc::get_internal();
+	MUST_EQUAL(*fact.get_integer_literal(loc, 1, fact.ANY) ==
+			*fact.get_integer_literal(1), false, "other type");
+	MUST_EQUAL(*fact.get_integer_literal(5000) ==
+			*fact.get_integer_literal(5000), true, "outside table");
+	store::TermStoreFactory other;
+	MUST_EQUAL(*other.get_integer_literal(7) == *fact.get_integer_literal(7),
+			true, "store view");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(table, "");
+}
+
+END_ITEM(table)
+
+END_TEST
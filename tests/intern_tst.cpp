@@ -0,0 +1,212 @@
+/**
+ * @file
+ * Test that the basic term factory interns terms.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <thread>
+#include <vector>
+
+using namespace elision;
+using namespace elision::term;
+
+START_TEST
+
+// Get a term factory.
+HANG("Making a factory");
+std::unique_ptr<TermFactory> fact(new elision::term::basic::TermFactoryImpl());
+std::unique_ptr<TermFactory> other(new elision::term::basic::TermFactoryImpl());
+ENDL("Done");
+
+START_ITEM(literals)
+
+try {
+	HANG("Making literals");
+	pSymbolLiteral s1 = fact->get_symbol_literal("fred");
+	pSymbolLiteral s2 = fact->get_symbol_literal(Loc::get(17, 21), "fred");
+	pSymbolLiteral s3 = fact->get_symbol_literal(Loc::get_internal(), "fred",
+			fact->STRING);
+	pIntegerLiteral i1 = fact->get_integer_literal(42);
+	pIntegerLiteral i2 = fact->get_integer_literal(42);
+	pIntegerLiteral i3 = fact->get_integer_literal(43);
+	ENDL("Done");
+
+	ENDL("Checking sharing"); PUSH;
+	MUST_NOT_EQUAL(s1.get(), s2.get(), "same symbol, different locus");
+	MUST_EQUAL(s2.get(), fact->get_symbol_literal(Loc::get(17, 21),
+			"fred").get(), "same symbol, same locus");
+	MUST_EQUAL(s2->get_loc() == Loc::get(17, 21), true, "own locus");
+	MUST_NOT_EQUAL(s1.get(), s3.get(), "different types");
+	MUST_EQUAL(i1.get(), i2.get(), "same integer");
+	MUST_NOT_EQUAL(i1.get(), i3.get(), "different integers");
+	MUST_EQUAL(fact->get_root_term("SYMBOL").get(), fact->SYMBOL.get(),
+			"well-known root");
+	POP;
+
+	ENDL("Checking equality"); PUSH;
+	MUST_EQUAL(*s1, *s2, "same symbol");
+	MUST_NOT_EQUAL(*s1, *s3, "different types");
+	MUST_NOT_EQUAL(*i1, *i3, "different integers");
+	POP;
+
+	ENDL("Checking sharing without locations"); PUSH;
+	elision::term::basic::TermFactoryImpl drop(ATOMIC_COUNT, DROP_LOCATIONS);
+	pSymbolLiteral d1 = drop.get_symbol_literal("fred");
+	pSymbolLiteral d2 = drop.get_symbol_literal(Loc::get(17, 21), "fred");
+	MUST_EQUAL(d1.get(), d2.get(), "same symbol, different locus");
+	MUST_EQUAL(d2->get_loc()->is_internal(), true, "internal locus");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(literals, "");
+}
+
+END_ITEM(literals)
+
+START_ITEM(compound)
+
+try {
+	HANG("Making compound terms");
+	pVariable x1 = fact->get_variable(Loc::get_internal(), "x", fact->TRUE,
+			fact->ANY);
+	pVariable x2 = fact->get_variable(Loc::get(1, 2), "x", fact->TRUE,
+			fact->ANY);
+	pLambda l1 = fact->get_lambda(Loc::get_internal(), x1, fact->TRUE,
+			fact->TRUE);
+	pLambda l2 = fact->get_lambda(Loc::get_internal(), x2, fact->TRUE,
+			fact->TRUE);
+	pLambda l3 = fact->get_lambda(Loc::get_internal(), x1, fact->FALSE,
+			fact->TRUE);
+	pStaticMap m1 = fact->get_static_map(Loc::get_internal(), fact->INTEGER,
+			fact->STRING);
+	pStaticMap m2 = fact->get_static_map(Loc::get_internal(), fact->INTEGER,
+			fact->STRING);
+	ENDL("Done");
+
+	ENDL("Checking sharing"); PUSH;
+	MUST_NOT_EQUAL(x1.get(), x2.get(), "same variable, different locus");
+	MUST_EQUAL(*x1, *x2, "same variable");
+	MUST_EQUAL(*l1, *l2, "same lambda");
+	MUST_NOT_EQUAL(l1.get(), l3.get(), "different lambda");
+	MUST_EQUAL(m1.get(), m2.get(), "same static map");
+	MUST_EQUAL(l1->get_type().get(), l3->get_type().get(), "same type");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(compound, "");
+}
+
+END_ITEM(compound)
+
+START_ITEM(release)
+
+try {
+	ENDL("Releasing and rebuilding terms"); PUSH;
+	for (int count = 0; count < 3; ++count) {
+		pStringLiteral s1 = fact->get_string_literal("transient");
+		pStringLiteral s2 = fact->get_string_literal("transient");
+		MUST_EQUAL(s1.get(), s2.get(), "rebuilt string");
+	}
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(release, "");
+}
+
+END_ITEM(release)
+
+START_ITEM(factories)
+
+try {
+	HANG("Making terms in two factories");
+	pSymbolLiteral s1 = fact->get_symbol_literal("fred");
+	pSymbolLiteral s2 = other->get_symbol_literal("fred");
+	pSymbolLiteral s3 = other->get_symbol_literal("barney");
+	ENDL("Done");
+
+	ENDL("Checking equality across factories"); PUSH;
+	MUST_NOT_EQUAL(s1.get(), s2.get(), "different tables");
+	MUST_EQUAL(*s1, *s2, "same symbol");
+	MUST_NOT_EQUAL(*s1, *s3, "different symbols");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(factories, "");
+}
+
+END_ITEM(factories)
+
+START_ITEM(counts)
+
+try {
+	HANG("Making a thread-confined factory");
+	elision::term::basic::TermFactoryImpl local(PLAIN_COUNT);
+	pTerm s1 = local.get_symbol_literal("wilma");
+	ENDL("Done");
+
+	ENDL("Checking reference counts"); PUSH;
+	MUST_EQUAL(s1->get_ref_policy(), PLAIN_COUNT, "policy of new term");
+	MUST_EQUAL(fact->TRUE->get_ref_policy(), ATOMIC_COUNT, "default policy");
+	uint32_t before = s1->get_ref_count();
+	{
+		pTerm s2 = s1;
+		pTerm s3 = local.get_symbol_literal("wilma");
+		MUST_EQUAL(s1->get_ref_count(), before + 2, "after copies");
+	}
+	MUST_EQUAL(s1->get_ref_count(), before, "after release");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(counts, "");
+}
+
+END_ITEM(counts)
+
+START_ITEM(threads)
+
+try {
+	HANG("Making terms on several threads");
+	std::vector<pTerm> made(4);
+	std::vector<std::thread> workers;
+	for (size_t index = 0; index < made.size(); ++index) {
+		workers.push_back(std::thread([&fact, &made, index]() {
+			for (int count = 0; count < 1000; ++count) {
+				pTerm map = fact->get_static_map(Loc::get_internal(),
+						fact->get_integer_literal(count),
+						fact->get_string_literal("shared"));
+				if (count == 999) made[index] = map;
+			} // Make many terms.
+		}));
+	} // Start all workers.
+	for (auto& worker : workers) worker.join();
+	ENDL("Done");
+
+	ENDL("Checking sharing"); PUSH;
+	for (size_t index = 1; index < made.size(); ++index) {
+		MUST_EQUAL(made[0].get(), made[index].get(), "same map");
+	} // Check all threads.
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(threads, "");
+}
+
+END_ITEM(threads)
+
+END_TEST
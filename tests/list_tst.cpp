@@ -0,0 +1,142 @@
+/**
+ * @file
+ * Test reading and building lists.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+
+using namespace elision;
+using namespace elision::term;
+
+// Check that iterating a list visits the same elements as indexing it.
+bool walks(IList const& list) {
+	size_t position = 0;
+	for (auto const& elt : list) {
+		if (position >= list.size() || elt != list[position]) return false;
+		++position;
+	} // Loop over elements.
+	return position == list.size();
+}
+
+START_TEST
+
+START_ITEM(read)
+
+try {
+	ENDL("Reading list elements"); PUSH;
+	basic::TermFactoryImpl basic;
+	store::TermStoreFactory stored;
+	for (TermFactory const* fact : { static_cast<TermFactory const*>(&basic),
+			static_cast<TermFactory const*>(&stored) }) {
+		std::vector<pTerm> elts;
+		for (unsigned index = 0; index < 1000; ++index) {
+			elts.push_back(fact->get_integer_literal(index));
+		} // Make the elements.
+		auto spec = fact->get_property_specification_builder()->get();
+		pList list = fact->get_list(Loc::get_internal(), spec, elts);
+		MUST_EQUAL(list->size(), 1000u, "size");
+		MUST_EQUAL(walks(*list), true, "walk");
+		ElementSpan span = list->get_chunk(10);
+		MUST_EQUAL(span.empty(), false, "chunk");
+		MUST_EQUAL(span[0] == (*list)[10], true, "chunk start");
+		MUST_EQUAL(list->get_elements() == elts, true, "copy");
+		MUST_EQUAL(std::distance(list->begin(), list->end()), 1000, "distance");
+	} // Try both factories.
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(read, "");
+}
+
+END_ITEM(read)
+
+START_ITEM(build)
+
+try {
+	ENDL("Building lists"); PUSH;
+	basic::TermFactoryImpl fact;
+	std::vector<pTerm> elts { fact.get_integer_literal(1),
+		fact.get_integer_literal(2) };
+	pTerm const* data = elts.data();
+	auto spec = fact.get_property_specification_builder()->get();
+	pList list = fact.get_list(Loc::get_internal(), spec, std::move(elts));
+	MUST_EQUAL(list->get_chunk(0).begin(), data, "moved in");
+	auto assoc = fact.get_property_specification_builder()
+			->set_associative(true)->get();
+	pTerm respec = fact.apply(Loc::get_internal(), assoc, list);
+	MUST_EQUAL(respec->get_kind(), LIST_KIND, "kind");
+	auto const& other = kind_cast<IList>(*respec);
+	MUST_EQUAL(other.get_property_specification()->check_associative(false),
+			true, "associative");
+	MUST_EQUAL(other.size(), 2u, "size");
+	MUST_EQUAL(walks(other), true, "walk");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(build, "");
+}
+
+END_ITEM(build)
+
+START_ITEM(catenate)
+
+try {
+	ENDL("Catenating and slicing large lists"); PUSH;
+	basic::TermFactoryImpl basic;
+	store::TermStoreFactory stored;
+	auto spec = basic.get_property_specification_builder()->get();
+	std::vector<pTerm> low, high, all;
+	for (unsigned index = 0; index < 3000; ++index) {
+		pTerm elt = basic.get_integer_literal(index);
+		(index < 1000 ? low : high).push_back(elt);
+		all.push_back(elt);
+	} // Make the elements.
+	pList first = basic.get_list(Loc::get_internal(), spec, low);
+	pList second = basic.get_list(Loc::get_internal(), spec, high);
+	pList whole = basic.get_list(Loc::get_internal(), spec, all);
+	pList joined = basic.catenate(Loc::get_internal(), first, second);
+	MUST_EQUAL(joined.get(), whole.get(), "catenate interns");
+	pTerm applied = basic.apply(Loc::get_internal(), first, second);
+	MUST_EQUAL(applied.get(), whole.get(), "apply catenates");
+	pList part = basic.slice(Loc::get_internal(), whole, 1000, 3000);
+	MUST_EQUAL(part.get(), second.get(), "slice interns");
+	pList small = basic.slice(Loc::get_internal(), whole, 5, 10);
+	MUST_EQUAL(small->size(), 5u, "small slice");
+	MUST_EQUAL(*(*small)[0] == *basic.get_integer_literal(5), true,
+			"small slice start");
+	MUST_EQUAL(walks(*joined), true, "walk");
+	MUST_EQUAL(joined->get_depth(), whole->get_depth(), "depth");
+	pTerm copy = stored.get_list(Loc::get_internal(), spec, all);
+	MUST_EQUAL(copy->get_fingerprint() == whole->get_fingerprint(), true,
+			"store fingerprint");
+	MUST_EQUAL(*copy == *whole, true, "store equal");
+	pList halves = stored.catenate(Loc::get_internal(),
+			stored.slice(Loc::get_internal(), whole, 0, 1000),
+			stored.slice(Loc::get_internal(), whole, 1000, 3000));
+	MUST_EQUAL(halves.get(), copy.get(), "store catenate");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(catenate, "");
+}
+
+END_ITEM(catenate)
+
+END_TEST
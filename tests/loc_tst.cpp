@@ -19,6 +19,9 @@
 
 #include "test_frame.h"
 #include "Loc.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
 
 START_TEST
 
@@ -85,4 +88,50 @@ START_ITEM(simple)
 	}
 END_ITEM(simple)
 
+START_ITEM(packed)
+    namespace et = elision;
+    try {
+        ENDL("Packing locations"); PUSH;
+        et::Locus loc = et::Loc::get("test.eli", 4000000, 12);
+        MUST_EQUAL(sizeof(et::Locus), sizeof(uint64_t), "packed");
+        MUST_EQUAL(loc->get_source(), std::string("test.eli"), "source");
+        MUST_EQUAL(loc->get_line(), 4000000u, "line");
+        MUST_EQUAL(loc->get_column(), 12u, "column");
+        MUST_EQUAL(&loc->get_source(),
+                &et::Loc::get("test.eli", 1, 1)->get_source(), "file table");
+        MUST_EQUAL(et::Loc::get("test.eli", 1, 70000)->get_column(), 65535u,
+                "clamped");
+        MUST_EQUAL(et::Loc::get_internal()->is_internal(), true, "internal");
+        MUST_EQUAL(static_cast<bool>(et::Locus()), false, "null");
+        MUST_EQUAL(et::Locus()->get_source(), std::string(""), "null source");
+        MUST_EQUAL(static_cast<bool>(loc), true, "not null");
+        POP;
+    } catch (std::exception& e) {
+        ENDL("Caught an exception: " << e.what ());
+        FAIL_ITEM(packed, "");
+    }
+END_ITEM(packed)
+
+START_ITEM(dropped)
+    namespace et = elision;
+    try {
+        ENDL("Dropping locations"); PUSH;
+        et::Locus loc = et::Loc::get("test.eli", 17, 21);
+        et::term::basic::TermFactoryImpl keep;
+        et::term::basic::TermFactoryImpl drop(et::ATOMIC_COUNT,
+                et::DROP_LOCATIONS);
+        et::term::store::TermStoreFactory store(et::DROP_LOCATIONS);
+        MUST_EQUAL(keep.get_symbol_literal(loc, "fred")->get_loc() == loc,
+                true, "kept");
+        MUST_EQUAL(drop.get_symbol_literal(loc, "fred")->get_loc()
+                ->is_internal(), true, "dropped");
+        MUST_EQUAL(store.get_symbol_literal(loc, "fred")->get_loc()
+                ->is_internal(), true, "dropped in store");
+        POP;
+    } catch (std::exception& e) {
+        ENDL("Caught an exception: " << e.what ());
+        FAIL_ITEM(dropped, "");
+    }
+END_ITEM(dropped)
+
 END_TEST
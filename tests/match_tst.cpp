@@ -0,0 +1,707 @@
+/**
+ * @file
+ * Test matching.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+#include "match/Matcher.h"
+#include "match/Program.h"
+#include "match/RuleIndex.h"
+#include <algorithm>
+#include <set>
+
+using namespace elision;
+using namespace elision::term;
+using namespace elision::match;
+
+/**
+ * Offer a variable each of a list of terms in turn, and count how many
+ * alternatives were asked for.
+ */
+class Counting : public Choice {
+public:
+	Counting(pTerm var, std::vector<pTerm> const& terms, size_t& calls) :
+		var_(var), terms_(terms), calls_(calls), next_(0) {}
+
+	bool next(Context& context) {
+		++calls_;
+		if (next_ == terms_.size()) return false;
+		context.push(var_, terms_[next_++]);
+		return true;
+	}
+
+private:
+	pTerm var_;
+	std::vector<pTerm> terms_;
+	size_t& calls_;
+	size_t next_;
+};
+
+START_TEST
+
+START_ITEM(syntactic)
+
+try {
+	ENDL("Matching terms"); PUSH;
+	basic::TermFactoryImpl basic;
+	store::TermStoreFactory stored;
+	for (TermFactory const* fact : { static_cast<TermFactory const*>(&basic),
+			static_cast<TermFactory const*>(&stored) }) {
+		Locus loc = Loc::get_internal();
+		Matcher matcher(*fact);
+		auto spec = fact->get_property_specification_builder()->get();
+		pTerm f = fact->get_symbol_literal("f");
+		pTerm x = fact->get_variable(loc, "x", fact->TRUE, fact->ANY);
+		pTerm y = fact->get_variable(loc, "y", fact->TRUE, fact->ANY);
+		pTerm one = fact->get_integer_literal(1);
+		pTerm two = fact->get_integer_literal(2);
+		auto args = [&](pTerm first, pTerm second) {
+			return fact->apply(loc, f, fact->get_list(loc, spec,
+					std::vector<pTerm>{ first, second }));
+		};
+
+		Result result = matcher.match(args(x, y), args(one, two));
+		MUST_EQUAL(result.have_match(), true, "two variables");
+		MUST_EQUAL(*(*result.begin()->find(Atom("y"))) == *two, true,
+				"bound y");
+		MUST_EQUAL(++result.begin() == result.end(), true, "one match");
+		MUST_EQUAL(matcher.match(args(x, x), args(one, one)).have_match(),
+				true, "repeated variable");
+		MUST_EQUAL(matcher.match(args(x, x), args(one, two)).empty(),
+				true, "different binds");
+		MUST_EQUAL(matcher.match(args(x, one), args(one, two)).empty(),
+				true, "constant");
+		MUST_EQUAL(matcher.match(args(x, y), one).empty(), true, "kind");
+		MUST_EQUAL(matcher.match(args(args(x, y), y),
+				args(one, two)).empty(), true, "depth");
+		MUST_EQUAL(matcher.match(x, one,
+				BindMap().extend(Atom("x"), two)).empty(), true, "given bind");
+
+		// A variable in the subject is matched like any other term, even by
+		// the same variable.
+		pTerm a = fact->get_symbol_literal("a");
+		auto pair = [&](pTerm first, pTerm second) {
+			return fact->get_list(loc, spec,
+					std::vector<pTerm>{ first, second });
+		};
+		MUST_EQUAL(matcher.match(pair(x, x), pair(x, a)).empty(), true,
+				"same variable");
+		Result itself = matcher.match(pair(x, x), pair(x, x));
+		MUST_EQUAL(itself.have_match(), true, "itself");
+		MUST_EQUAL(*(*itself.begin()->find(Atom("x"))) == *x, true,
+				"bound to itself");
+
+		// Types and guards restrict what a variable binds.
+		pTerm s = fact->get_variable(loc, "s", fact->TRUE, fact->STRING);
+		MUST_EQUAL(matcher.match(s, one).empty(), true, "type");
+		MUST_EQUAL(matcher.match(s, fact->get_string_literal("one"))
+				.have_match(), true, "typed");
+		pTerm b = fact->get_variable(loc, "g", fact->TRUE, fact->BOOLEAN);
+		pTerm g = fact->get_variable(loc, "g", b, fact->BOOLEAN);
+		MUST_EQUAL(matcher.match(g, fact->TRUE).have_match(), true,
+				"guard true");
+		MUST_EQUAL(matcher.match(g, fact->FALSE).empty(), true,
+				"guard false");
+	} // Loop over factories.
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(syntactic, "");
+}
+
+END_ITEM(syntactic)
+
+START_ITEM(lambda)
+
+try {
+	ENDL("Applying lambdas"); PUSH;
+	basic::TermFactoryImpl basic;
+	store::TermStoreFactory stored;
+	for (TermFactory const* fact : { static_cast<TermFactory const*>(&basic),
+			static_cast<TermFactory const*>(&stored) }) {
+		Locus loc = Loc::get_internal();
+		pTerm f = fact->get_symbol_literal("f");
+		pTerm g = fact->get_symbol_literal("g");
+		pTerm x = fact->get_variable(loc, "x", fact->TRUE, fact->INTEGER);
+		pTerm five = fact->get_integer_literal(5);
+		pLambda lambda = fact->get_lambda(loc, fact->apply(loc, f, x),
+				fact->apply(loc, g, x), fact->TRUE);
+		MUST_EQUAL(*fact->apply(loc, lambda, fact->apply(loc, f, five)) ==
+				*fact->apply(loc, g, five), true, "rewrite");
+		pTerm other = fact->apply(loc, g, five);
+		MUST_EQUAL(*fact->apply(loc, lambda, other) == *other, true,
+				"no match");
+		pTerm word = fact->apply(loc, f, fact->get_string_literal("five"));
+		MUST_EQUAL(*fact->apply(loc, lambda, word) == *word, true,
+				"wrong type");
+		pLambda never = fact->get_lambda(loc, x, x, fact->FALSE);
+		MUST_EQUAL(*fact->apply(loc, never, five) == *five, true, "guard");
+
+		// Variables inside lists and bindings on the right are replaced.
+		auto spec = fact->get_property_specification_builder()->get();
+		pLambda pair = fact->get_lambda(loc, fact->apply(loc, f, x),
+				fact->get_list(loc, spec, std::vector<pTerm>{ x, x }),
+				fact->TRUE);
+		MUST_EQUAL(*fact->apply(loc, pair, fact->apply(loc, f, five)) ==
+				*fact->get_list(loc, spec, std::vector<pTerm>{ five, five }),
+				true, "list");
+		Atom y("y");
+		pLambda bind = fact->get_lambda(loc, fact->apply(loc, f, x),
+				fact->get_binding(loc, BindMap().extend(y, x)), fact->TRUE);
+		MUST_EQUAL(*fact->apply(loc, bind, fact->apply(loc, f, five)) ==
+				*fact->get_binding(loc, BindMap().extend(y, five)), true,
+				"binding");
+
+		// A match that fails the guard gives way to the next match.
+		pTerm a = fact->get_symbol_literal("a");
+		pTerm u = fact->get_variable(loc, "u", fact->TRUE, fact->ANY);
+		pTerm v = fact->get_variable(loc, "v", fact->TRUE, fact->ANY);
+		auto comm = fact->get_property_specification_builder()->
+				set_commutative(true)->get();
+		pTerm uv = fact->get_list(loc, comm, std::vector<pTerm>{ u, v });
+		pTerm subject = fact->get_list(loc, comm,
+				std::vector<pTerm>{ fact->TRUE, a });
+		pLambda take_u = fact->get_lambda(loc, uv, u, v);
+		pLambda take_v = fact->get_lambda(loc, uv, v, u);
+		MUST_EQUAL(*fact->apply(loc, take_u, subject) == *a, true, "next u");
+		MUST_EQUAL(*fact->apply(loc, take_v, subject) == *a, true, "next v");
+	} // Loop over factories.
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(lambda, "");
+}
+
+END_ITEM(lambda)
+
+START_ITEM(lazy)
+
+try {
+	ENDL("Enumerating matches"); PUSH;
+	basic::TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	std::vector<pTerm> terms;
+	for (unsigned index = 0; index < 10; ++index) {
+		terms.push_back(fact.get_integer_literal(index));
+	} // Make the terms.
+
+	// Offer x each term, where x is already bound to 4.
+	auto start = [&](size_t& calls) {
+		Context context(BindMap().extend(Atom("x"), terms[4]));
+		context.choose(std::unique_ptr<Choice>(new Counting(x, terms, calls)));
+		return matcher.match(std::move(context));
+	};
+	size_t calls = 0;
+	Result all = start(calls);
+	MUST_EQUAL(calls, 1u, "lazy start");
+	size_t count = 0;
+	for (auto const& binds : all) {
+		MUST_EQUAL(*(*binds.find(Atom("x"))) == *terms[4], true, "bound");
+		++count;
+	} // Visit every match.
+	MUST_EQUAL(count, 1u, "one match");
+	MUST_EQUAL(calls, 11u, "exhausted");
+
+	// Without the constraint every term matches, and limits stop early.
+	auto loose = [&](size_t& calls) {
+		Context context;
+		context.choose(std::unique_ptr<Choice>(new Counting(x, terms, calls)));
+		return matcher.match(std::move(context));
+	};
+	calls = 0;
+	count = 0;
+	for (auto it = loose(calls).limit(3).begin(); it != Result::const_iterator();
+			++it) {
+		++count;
+	} // Visit the first three matches.
+	MUST_EQUAL(count, 3u, "limit");
+	MUST_EQUAL(calls, 3u, "limit calls");
+	calls = 0;
+	Result first = loose(calls).first();
+	MUST_EQUAL(first.have_match(), true, "first");
+	MUST_EQUAL(calls, 1u, "first calls");
+	MUST_EQUAL(++first.begin() == first.end(), true, "only first");
+	MUST_EQUAL(calls, 1u, "still first calls");
+
+	// The context can also be resumed by hand.
+	calls = 0;
+	Context context;
+	context.choose(std::unique_ptr<Choice>(new Counting(x, terms, calls)));
+	count = 0;
+	for (bool found = matcher.run(context); found;
+			found = matcher.next_match(context)) {
+		++count;
+	} // Visit every match.
+	MUST_EQUAL(count, terms.size(), "resume");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(lazy, "");
+}
+
+END_ITEM(lazy)
+
+START_ITEM(ac)
+
+try {
+	ENDL("Matching associative and commutative lists"); PUSH;
+	basic::TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto spec = fact.get_property_specification_builder()
+			->set_associative(true)->set_commutative(true)->get();
+	auto list = [&](std::vector<pTerm> const& elements) {
+		return fact.get_list(loc, spec, elements);
+	};
+	auto count = [&](pTerm pattern, pTerm subject) {
+		std::set<BindMap> seen;
+		size_t total = 0;
+		for (auto const& binds : matcher.match(pattern, subject)) {
+			seen.insert(binds);
+			++total;
+		} // Count the matches.
+		return total == seen.size() ? total : 0xdead;
+	};
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm y = fact.get_variable(loc, "y", fact.TRUE, fact.ANY);
+	pTerm z = fact.get_variable(loc, "z", fact.TRUE, fact.ANY);
+	std::vector<pTerm> n;
+	for (unsigned index = 0; index < 8; ++index) {
+		n.push_back(fact.get_integer_literal(index));
+	} // Make some integers.
+	pTerm f = fact.get_symbol_literal("f");
+
+	MUST_EQUAL(count(list({ x, y }), list({ n[1], n[2], n[3] })), 6u,
+			"split");
+	MUST_EQUAL(count(list({ n[1], x }), list({ n[3], n[1], n[2] })), 1u,
+			"constant");
+	MUST_EQUAL(count(list({ n[7], x }), list({ n[1], n[2] })), 0u,
+			"missing constant");
+	MUST_EQUAL(count(list({ x, x }), list({ n[1], n[2], n[2], n[1] })), 1u,
+			"repeated");
+	MUST_EQUAL(count(list({ x, x }), list({ n[1], n[2], n[1] })), 0u,
+			"odd repeat");
+	MUST_EQUAL(count(list({ fact.apply(loc, f, x), y }), list({
+			fact.apply(loc, f, n[1]), fact.apply(loc, f, n[2]), n[3] })), 2u,
+			"application");
+	MUST_EQUAL(count(list({ fact.apply(loc, f, x), x }), list({
+			fact.apply(loc, f, n[2]), n[2] })), 1u, "shared variable");
+	MUST_EQUAL(count(list({ fact.apply(loc, f, x), x }), list({
+			fact.apply(loc, f, n[1]), fact.apply(loc, f, n[2]), n[2] })), 0u,
+			"shared variable left over");
+	Result result = matcher.match(list({ n[1], x }), list({ n[2], n[1] }));
+	MUST_EQUAL(*(*result.begin()->find(Atom("x"))) == *n[2], true,
+			"single element");
+	Result nested = matcher.match(list({ n[1], x }), list({ n[3],
+			list({ n[1], n[2] }) }));
+	MUST_EQUAL(*(*nested.begin()->find(Atom("x"))) == *list({ n[2], n[3] }),
+			true, "flattened");
+
+	// Compare against every way to hand the elements to three variables.
+	std::vector<unsigned> values = { 1, 1, 2, 3, 3 };
+	std::set<std::vector<std::vector<unsigned>>> ways;
+	unsigned total = 1;
+	for (size_t index = 0; index < values.size(); ++index) total *= 3;
+	for (unsigned code = 0; code < total; ++code) {
+		std::vector<std::vector<unsigned>> way(3);
+		unsigned rest = code;
+		for (unsigned value : values) {
+			way[rest % 3].push_back(value);
+			rest /= 3;
+		} // Hand out the elements.
+		if (!way[0].empty() && !way[1].empty() && !way[2].empty()) {
+			ways.insert(way);
+		}
+	} // Try every way.
+	std::vector<pTerm> subject;
+	for (unsigned value : values) subject.push_back(n[value]);
+	MUST_EQUAL(count(list({ x, y, z }), list(subject)), ways.size(),
+			"every way");
+
+	// An identity lets a variable take nothing.
+	auto unit = fact.get_property_specification_builder()
+			->set_associative(true)->set_commutative(true)
+			->set_identity(n[0])->get();
+	MUST_EQUAL(count(fact.get_list(loc, unit, std::vector<pTerm>{ x, y }),
+			fact.get_list(loc, unit, std::vector<pTerm>{ n[5] })), 2u,
+			"identity");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(ac, "");
+}
+
+END_ITEM(ac)
+
+START_ITEM(sequence)
+
+try {
+	ENDL("Matching associative lists"); PUSH;
+	basic::TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto spec = fact.get_property_specification_builder()
+			->set_associative(true)->get();
+	auto list = [&](std::vector<pTerm> const& elements) {
+		return fact.get_list(loc, spec, elements);
+	};
+	auto count = [&](pTerm pattern, pTerm subject) {
+		std::set<BindMap> seen;
+		size_t total = 0;
+		for (auto const& binds : matcher.match(pattern, subject)) {
+			seen.insert(binds);
+			++total;
+		} // Count the matches.
+		return total == seen.size() ? total : 0xdead;
+	};
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm y = fact.get_variable(loc, "y", fact.TRUE, fact.ANY);
+	pTerm z = fact.get_variable(loc, "z", fact.TRUE, fact.ANY);
+	std::vector<pTerm> n;
+	for (unsigned index = 0; index < 8; ++index) {
+		n.push_back(fact.get_integer_literal(index));
+	} // Make some integers.
+	pTerm f = fact.get_symbol_literal("f");
+
+	MUST_EQUAL(count(list({ x, y }), list({ n[1], n[2], n[3] })), 2u,
+			"split");
+	MUST_EQUAL(count(list({ x, y, z }), list({ n[1], n[2], n[3], n[4],
+			n[5], n[6] })), 10u, "three ways");
+	MUST_EQUAL(count(list({ x, n[2], y }), list({ n[1], n[2], n[3], n[2],
+			n[4] })), 2u, "fixed element");
+	MUST_EQUAL(count(list({ n[2], x }), list({ n[1], n[2] })), 0u,
+			"order");
+	MUST_EQUAL(count(list({ x, x }), list({ n[1], n[2], n[1], n[2] })), 1u,
+			"repeated");
+	MUST_EQUAL(count(list({ x, x }), list({ n[1], n[2], n[1] })), 0u,
+			"odd repeat");
+	MUST_EQUAL(count(list({ x, fact.apply(loc, f, z), y }), list({ n[1],
+			fact.apply(loc, f, n[2]), n[3], fact.apply(loc, f, n[4]),
+			n[5] })), 2u, "application");
+	Result result = matcher.match(list({ n[1], x }), list({ n[1], n[2],
+			n[3] }));
+	MUST_EQUAL(*(*result.begin()->find(Atom("x"))) == *list({ n[2], n[3] }),
+			true, "run");
+	Result nested = matcher.match(list({ n[1], x }), list({ n[1],
+			list({ n[2], n[3] }) }));
+	MUST_EQUAL(*(*nested.begin()->find(Atom("x"))) == *list({ n[2], n[3] }),
+			true, "flattened");
+
+	// A long list is held in a tree, and its runs are slices of it.
+	std::vector<pTerm> elements;
+	for (unsigned index = 0; index < 1000; ++index) {
+		elements.push_back(fact.get_integer_literal(index));
+	} // Make the elements.
+	Result middle = matcher.match(list({ x, elements[500], y }),
+			list(elements));
+	MUST_EQUAL(kind_cast<IList>(**middle.begin()->find(Atom("x"))).size(),
+			500u, "long list");
+
+	// An identity lets a variable take nothing.
+	auto unit = fact.get_property_specification_builder()
+			->set_associative(true)->set_identity(n[0])->get();
+	MUST_EQUAL(count(fact.get_list(loc, unit, std::vector<pTerm>{ x, y }),
+			fact.get_list(loc, unit, std::vector<pTerm>{ n[5] })), 2u,
+			"identity");
+	MUST_EQUAL(count(fact.get_list(loc, unit, std::vector<pTerm>{ x, y, z }),
+			fact.get_list(loc, unit, std::vector<pTerm>{ n[1], n[2], n[3],
+			n[4], n[5], n[6] })), 28u, "identity three ways");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(sequence, "");
+}
+
+END_ITEM(sequence)
+
+START_ITEM(commutative)
+
+try {
+	ENDL("Matching commutative lists"); PUSH;
+	basic::TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto spec = fact.get_property_specification_builder()
+			->set_commutative(true)->get();
+	auto list = [&](std::vector<pTerm> const& elements) {
+		return fact.get_list(loc, spec, elements);
+	};
+	auto count = [&](pTerm pattern, pTerm subject) {
+		std::set<BindMap> seen;
+		size_t total = 0;
+		for (auto const& binds : matcher.match(pattern, subject)) {
+			seen.insert(binds);
+			++total;
+		} // Count the matches.
+		return total == seen.size() ? total : 0xdead;
+	};
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm y = fact.get_variable(loc, "y", fact.TRUE, fact.ANY);
+	pTerm z = fact.get_variable(loc, "z", fact.TRUE, fact.ANY);
+	pTerm i = fact.get_variable(loc, "i", fact.TRUE, fact.INTEGER);
+	pTerm s = fact.get_variable(loc, "s", fact.TRUE, fact.STRING);
+	std::vector<pTerm> n;
+	for (unsigned index = 0; index < 8; ++index) {
+		n.push_back(fact.get_integer_literal(index));
+	} // Make some integers.
+	pTerm f = fact.get_symbol_literal("f");
+	pTerm g = fact.get_symbol_literal("g");
+
+	MUST_EQUAL(count(list({ x, n[2] }), list({ n[2], n[3] })), 1u,
+			"constant");
+	MUST_EQUAL(count(list({ x, n[4] }), list({ n[2], n[3] })), 0u,
+			"missing constant");
+	MUST_EQUAL(count(list({ x }), list({ n[2], n[3] })), 0u, "length");
+	MUST_EQUAL(count(list({ x, y }), list({ n[1], n[2] })), 2u, "swap");
+	MUST_EQUAL(count(list({ x, y }), list({ n[1], n[1] })), 1u,
+			"equal elements");
+	MUST_EQUAL(count(list({ x, x }), list({ n[1], n[1] })), 1u,
+			"repeated");
+	MUST_EQUAL(count(list({ x, x }), list({ n[1], n[2] })), 0u,
+			"unequal repeat");
+	MUST_EQUAL(count(list({ x, y, z }), list({ n[1], n[2], n[3] })), 6u,
+			"permutations");
+	MUST_EQUAL(count(list({ s, i }), list({ n[1],
+			fact.get_string_literal("a") })), 1u, "types");
+	MUST_EQUAL(count(list({ x, list({ y, n[1] }) }), list({
+			list({ n[1], n[2] }), n[3] })), 1u, "nested");
+	Result result = matcher.match(list({ fact.apply(loc, f, x),
+			fact.apply(loc, g, y) }), list({ fact.apply(loc, g, n[1]),
+			fact.apply(loc, f, n[2]) }));
+	MUST_EQUAL(*(*result.begin()->find(Atom("x"))) == *n[2], true,
+			"applications");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(commutative, "");
+}
+
+END_ITEM(commutative)
+
+START_ITEM(index)
+
+try {
+	ENDL("Indexing lambdas"); PUSH;
+	basic::TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	RuleIndex index;
+	auto plain = fact.get_property_specification_builder()->get();
+	auto ac = fact.get_property_specification_builder()
+			->set_associative(true)->set_commutative(true)->get();
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm f = fact.get_symbol_literal("f");
+	pTerm g = fact.get_symbol_literal("g");
+	pTerm h = fact.get_symbol_literal("h");
+	std::vector<pTerm> n;
+	for (unsigned at = 0; at < 6; ++at) {
+		n.push_back(fact.get_integer_literal(at));
+	} // Make some integers.
+	auto pair = [&](pPropertySpecification spec, pTerm first, pTerm second) {
+		return fact.get_list(loc, spec, std::vector<pTerm>{ first, second });
+	};
+	std::vector<pLambda> rules = {
+		fact.get_lambda(loc, fact.apply(loc, f, x), n[0], fact.TRUE),
+		fact.get_lambda(loc, fact.apply(loc, f, n[1]), n[0], fact.TRUE),
+		fact.get_lambda(loc, fact.apply(loc, g, x), n[0], fact.TRUE),
+		fact.get_lambda(loc, x, n[0], fact.TRUE),
+		fact.get_lambda(loc, fact.apply(loc, f, pair(plain, x, n[2])), n[0],
+				fact.TRUE),
+		fact.get_lambda(loc, fact.apply(loc, f, pair(ac, x, n[1])), n[0],
+				fact.TRUE),
+	};
+	for (auto const& rule : rules) index.insert(rule);
+	MUST_EQUAL(index.size(), 6u, "size");
+
+	// Describe the candidates by their positions in the rules.
+	auto which = [&](pTerm subject) {
+		std::string found;
+		for (auto const& rule : index.candidates(subject)) {
+			found += std::to_string(std::find(rules.begin(), rules.end(),
+					rule) - rules.begin());
+		} // Find each candidate.
+		return found;
+	};
+	std::vector<pTerm> subjects = {
+		fact.apply(loc, f, n[1]),
+		fact.apply(loc, f, n[2]),
+		fact.apply(loc, h, n[1]),
+		fact.apply(loc, f, pair(plain, n[3], n[2])),
+		fact.apply(loc, f, pair(plain, n[3], n[3])),
+		fact.apply(loc, f, pair(ac, n[1], n[5])),
+	};
+	std::vector<std::string> expected = {
+		"013", "03", "3", "034", "03", "035",
+	};
+	for (size_t at = 0; at < subjects.size(); ++at) {
+		MUST_EQUAL(which(subjects[at]), expected[at], "subject " << at);
+	} // Check each subject.
+
+	// Every lambda that matches must be a candidate.
+	for (auto const& subject : subjects) {
+		std::string matching;
+		for (size_t at = 0; at < rules.size(); ++at) {
+			if (matcher.match(rules[at]->get_lhs(), subject).have_match()) {
+				matching += std::to_string(at);
+			}
+		} // Try every lambda.
+		std::string found = which(subject);
+		bool covered = std::all_of(matching.begin(), matching.end(),
+				[&found](char at) { return found.find(at) != found.npos; });
+		MUST_EQUAL(covered, true, "covered " << matching);
+	} // Check each subject.
+
+	// Remove lambdas.
+	MUST_EQUAL(index.erase(rules[0]), true, "erase");
+	MUST_EQUAL(index.erase(rules[0]), false, "erase again");
+	MUST_EQUAL(index.size(), 5u, "size after erase");
+	MUST_EQUAL(which(subjects[1]), "3", "after erase");
+	index.insert(rules[0]);
+	MUST_EQUAL(which(subjects[1]), "30", "inserted last");
+	for (auto const& rule : rules) index.erase(rule);
+	MUST_EQUAL(index.empty(), true, "empty");
+	MUST_EQUAL(which(subjects[0]), "", "nothing left");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(index, "");
+}
+
+END_ITEM(index)
+
+START_ITEM(program)
+
+try {
+	ENDL("Running compiled patterns"); PUSH;
+	basic::TermFactoryImpl fact;
+	Locus loc = Loc::get_internal();
+	Matcher matcher(fact);
+	auto plain = fact.get_property_specification_builder()->get();
+	auto ac = fact.get_property_specification_builder()
+			->set_associative(true)->set_commutative(true)->get();
+	auto list = [&](pPropertySpecification spec,
+			std::vector<pTerm> const& elements) {
+		return fact.get_list(loc, spec, elements);
+	};
+	pTerm x = fact.get_variable(loc, "x", fact.TRUE, fact.ANY);
+	pTerm y = fact.get_variable(loc, "y", fact.TRUE, fact.ANY);
+	pTerm i = fact.get_variable(loc, "i", fact.TRUE, fact.INTEGER);
+	pTerm b = fact.get_variable(loc, "g", fact.TRUE, fact.BOOLEAN);
+	pTerm g = fact.get_variable(loc, "g", b, fact.BOOLEAN);
+	pTerm f = fact.get_symbol_literal("f");
+	pTerm h = fact.get_symbol_literal("h");
+	std::vector<pTerm> n;
+	for (unsigned at = 0; at < 4; ++at) {
+		n.push_back(fact.get_integer_literal(at));
+	} // Make some integers.
+	pTerm word = fact.get_string_literal("word");
+	auto fx = [&](pTerm arg) { return fact.apply(loc, f, arg); };
+
+	std::vector<pTerm> patterns = {
+		x,
+		fx(x),
+		fx(i),
+		fx(list(plain, { x, y })),
+		fx(list(plain, { x, x })),
+		fx(list(plain, { x, n[3] })),
+		fx(list(plain, { fx(x), fx(fx(y)) })),
+		fx(g),
+		fx(list(ac, { x, n[1] })),
+		fx(list(plain, { list(ac, { x, n[1] }), x })),
+	};
+	std::vector<pTerm> subjects = {
+		n[1],
+		word,
+		fx(n[1]),
+		fx(word),
+		fact.apply(loc, h, n[1]),
+		fx(list(plain, { n[1], n[2] })),
+		fx(list(plain, { n[2], n[2] })),
+		fx(list(plain, { n[2], n[3] })),
+		fx(list(plain, { n[1], n[2], n[3] })),
+		fx(list(plain, { fx(n[1]), fx(fx(n[2])) })),
+		fx(list(plain, { fx(n[1]), fx(n[2]) })),
+		fx(fact.TRUE),
+		fx(fact.FALSE),
+		fx(list(ac, { n[2], n[1] })),
+		fx(list(plain, { list(ac, { n[2], n[1] }), n[2] })),
+		fx(list(plain, { list(ac, { n[2], n[1] }), n[3] })),
+	};
+
+	// Every program must agree with the matcher.
+	size_t matches = 0;
+	for (auto const& pattern : patterns) {
+		Program program(fact, pattern);
+		for (auto const& subject : subjects) {
+			Context compiled, interpreted;
+			bool ran = program.run(fact, subject, compiled);
+			bool tried = matcher.try_match(pattern, subject, interpreted);
+			{ MUST_EQUAL(ran, tried, pattern->to_string() << " against "
+					<< subject->to_string()); }
+			if (ran && tried) {
+				++matches;
+				{ MUST_EQUAL(compiled.get_map() == interpreted.get_map(), true,
+						"binds"); }
+			}
+		} // Try every subject.
+	} // Try every pattern.
+	MUST_EQUAL(matches, 44u, "matches");
+
+	// Only the parts that need it are deferred.
+	MUST_EQUAL(Program(fact, fx(list(plain, { x, y }))).deferred(), 0u,
+			"syntactic");
+	MUST_EQUAL(Program(fact, patterns[9]).deferred(), 2u, "shared name");
+
+	// A lambda's program does not keep the factory that first applied it.
+	pLambda rule;
+	pTerm subject;
+	{
+		basic::TermFactoryImpl first;
+		auto fplain = first.get_property_specification_builder()->get();
+		auto fac = first.get_property_specification_builder()
+				->set_associative(true)->set_commutative(true)->get();
+		pTerm fb = first.get_variable(loc, "g", first.TRUE, first.BOOLEAN);
+		pTerm fg = first.get_variable(loc, "g", fb, first.BOOLEAN);
+		pTerm fx = first.get_variable(loc, "x", first.TRUE, first.ANY);
+		pTerm ff = first.get_symbol_literal("f");
+		pTerm one = first.get_integer_literal(1);
+		rule = first.get_lambda(loc, first.apply(loc, ff,
+				first.get_list(loc, fplain, std::vector<pTerm>{ fg,
+				first.get_list(loc, fac, std::vector<pTerm>{ fx, one }) })),
+				fx, first.TRUE);
+		subject = first.apply(loc, ff, first.get_list(loc, fplain,
+				std::vector<pTerm>{ first.TRUE, first.get_list(loc, fac,
+				std::vector<pTerm>{ first.get_integer_literal(5), one }) }));
+		MUST_EQUAL(*first.apply(loc, rule, subject) ==
+				*first.get_integer_literal(5), true, "first factory");
+	}
+	MUST_EQUAL(*fact.apply(loc, rule, subject) == *fact.get_integer_literal(5),
+			true, "later factory");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(program, "");
+}
+
+END_ITEM(program)
+
+END_TEST
@@ -19,6 +19,45 @@
 
 #include "test_frame.h"
 #include <Seq.h>
+#include <stdexcept>
+
+/// The number of objects allocated by CountingAlloc and not given back.
+static long outstanding = 0;
+
+/// An allocator that counts what it hands out.
+template<typename T>
+struct CountingAlloc {
+	typedef T value_type;
+	CountingAlloc() = default;
+	template<typename U> CountingAlloc(CountingAlloc<U> const&) {}
+	T* allocate(size_t count) {
+		outstanding += count;
+		return std::allocator<T>().allocate(count);
+	}
+	void deallocate(T* place, size_t count) {
+		outstanding -= count;
+		std::allocator<T>().deallocate(place, count);
+	}
+};
+
+template<typename T, typename U>
+bool operator==(CountingAlloc<T> const&, CountingAlloc<U> const&) {
+	return true;
+}
+
+template<typename T, typename U>
+bool operator!=(CountingAlloc<T> const&, CountingAlloc<U> const&) {
+	return false;
+}
+
+/// An element whose copy fails if it is negative.
+struct Fragile {
+	int value;
+	Fragile(int value) : value(value) {}
+	Fragile(Fragile const& other) : value(other.value) {
+		if (value < 0) throw std::runtime_error("Cannot copy.");
+	}
+};
 
 START_TEST
 
@@ -93,25 +132,101 @@ END_ITEM(build)
 
 START_ITEM(omit)
 
-//try {
-//	ENDL("Omitting second element"); PUSH;
-//	auto s1 = os1.omit(1);
-//	for (auto here : s1) FLUSH(here << " "); ENDL("");
-//	MUST_THROW(os2.omit(1), std::range_error);
-//	auto s3 = os3.omit(1);
-//	for (auto here : s3) FLUSH(here << " "); ENDL("");
-//	MUST_THROW(os4.omit(1), std::range_error);
-//	POP;
-//	ENDL("Done");
-//} catch (std::exception& e) {
-//	ENDL("Caught an exception: " << e.what());
-//	FAIL_ITEM(omit, "");
-//}
+try {
+	ENDL("Omitting second element"); PUSH;
+	auto s1 = os1.omit(1);
+	for (auto here : s1) FLUSH(here << " "); ENDL("");
+	MUST_EQUAL(s1.elements() == (std::vector<int>{1,3,4,5,6}), true, "omit");
+	MUST_THROW(os2.omit(1), std::range_error);
+	auto s3 = os3.omit(1);
+	for (auto here : s3) FLUSH(here << " "); ENDL("");
+	MUST_EQUAL(s3.at(1), 5, "at");
+	MUST_THROW(os4.omit(1), std::range_error);
+	auto s4 = os4.omit(0);
+	MUST_EQUAL(s4.empty(), true, "empty");
+	MUST_EQUAL(s4.begin() == s4.end(), true, "empty walk");
+	MUST_EQUAL(os1.size(), 6u, "unchanged");
+	POP;
+	ENDL("Done");
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(omit, "");
+}
 
 END_ITEM(omit)
 
 START_ITEM(mix)
 
+try {
+	ENDL("Mixing omits and inserts"); PUSH;
+	auto s1 = os1.insert(2, os3).insert(0, os4).insert(10, os4);
+	for (auto here : s1) FLUSH(here << " "); ENDL("");
+	MUST_EQUAL(s1.elements() == (std::vector<int>{7,1,2,3,4,5,3,4,5,6,7}),
+			true, "insert");
+	MUST_THROW(os1.insert(7, os4), std::range_error);
+	MUST_EQUAL(os1.insert(3, os2).size(), 6u, "insert empty");
+
+	// Check a long run of edits against a vector.
+	std::vector<int> model(v16);
+	auto seq = os1;
+	std::vector<int> kept_model;
+	Seq<int> kept;
+	unsigned state = 12345;
+	for (int round = 0; round < 2000; ++round) {
+		if (round == 1000) {
+			kept_model = model;
+			kept = seq;
+		}
+		state = state * 1103515245u + 12345u;
+		size_t pick = (state >> 8);
+		if (model.size() > 2 && (state & 1)) {
+			pick %= model.size();
+			model.erase(model.begin() + pick);
+			seq = seq.omit(pick);
+		} else {
+			pick %= model.size() + 1;
+			model.insert(model.begin() + pick, v35.begin(), v35.end());
+			seq = seq.insert(pick, os3);
+		}
+		if (round % 100 == 0) {
+			MUST_EQUAL(seq.elements() == model, true, "round " << round);
+			MUST_EQUAL(std::vector<int>(seq.begin(), seq.end()) == model, true,
+					"walk");
+			{ MUST_EQUAL(seq.at(model.size() / 2), model[model.size() / 2],
+					"at"); }
+		}
+	} // Edit the sequence.
+
+	// Later edits share nodes with the kept sequence but do not change it.
+	MUST_EQUAL(kept.elements() == kept_model, true, "kept");
+	MUST_EQUAL(std::vector<int>(kept.begin(), kept.end()) == kept_model, true,
+			"kept walk");
+	POP;
+	ENDL("Done");
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(mix, "");
+}
+
 END_ITEM(mix)
 
+START_ITEM(throwing)
+
+try {
+	ENDL("Failing to copy elements"); PUSH;
+	std::vector<Fragile> backing;
+	backing.reserve(5);
+	for (int value : { 1, 2, -3, 4, 5 }) backing.emplace_back(value);
+	MUST_THROW((Seq<Fragile, CountingAlloc<Fragile>>(backing)),
+			std::runtime_error);
+	MUST_EQUAL(outstanding, 0L, "all memory given back");
+	POP;
+	ENDL("Done");
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(throwing, "");
+}
+
+END_ITEM(throwing)
+
 END_TEST
@@ -0,0 +1,83 @@
+/**
+ * @file
+ * Test writing terms to streams.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/TermPrinter.h"
+#include "term/basic/TermFactoryImpl.h"
+#include <sstream>
+
+using namespace elision;
+using namespace elision::term;
+
+START_TEST
+
+// Get a term factory.
+HANG("Making a factory");
+std::unique_ptr<TermFactory> fact(new elision::term::basic::TermFactoryImpl());
+ENDL("Done");
+
+START_ITEM(stream)
+
+try {
+	ENDL("Writing terms to a stream"); PUSH;
+	pTerm fred = fact->get_symbol_literal("fred");
+	pTerm app = fact->apply(Loc::get_internal(), fred,
+			fact->get_static_map(Loc::get_internal(),
+					fact->get_integer_literal(5), fact->STRING));
+	std::ostringstream out;
+	out << *app;
+	MUST_EQUAL(out.str(),
+			"fred: SYMBOL: ^ROOT.5: INTEGER: ^ROOT=>STRING: ^ROOT",
+			"operator");
+	MUST_EQUAL(app->to_string(), out.str(), "to_string");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(stream, "");
+}
+
+END_ITEM(stream)
+
+START_ITEM(sharing)
+
+try {
+	ENDL("Writing shared subterms once"); PUSH;
+	pTerm op = fact->get_symbol_literal("f");
+	pTerm term = fact->get_symbol_literal("x");
+	for (int depth = 0; depth < 3; ++depth) {
+		term = fact->apply(Loc::get_internal(), op,
+				fact->get_static_map(Loc::get_internal(), term, term));
+	} // Build a term whose expansion doubles at each level.
+	std::string shared = TermPrinter::to_string(*term, true);
+	MUST_EQUAL(shared, "f: SYMBOL: ^ROOT.#1=f: SYMBOL: ^ROOT.#2=f: SYMBOL: "
+			"^ROOT.x: SYMBOL: ^ROOT=>x: SYMBOL: ^ROOT=>#2#=>#1#", "labels");
+	MUST_EQUAL(shared.size() < term->to_string().size(), true, "shorter");
+	std::ostringstream out;
+	TermPrinter(out).print(*op);
+	MUST_EQUAL(out.str(), "f: SYMBOL: ^ROOT", "leaf unlabeled");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(sharing, "");
+}
+
+END_ITEM(sharing)
+
+END_TEST
@@ -0,0 +1,127 @@
+/**
+ * @file
+ * Test property specifications.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+
+using namespace elision;
+using namespace elision::term;
+
+START_TEST
+
+START_ITEM(flags)
+
+try {
+	ENDL("Checking flags"); PUSH;
+	basic::TermFactoryImpl basic;
+	store::TermStoreFactory stored;
+	for (TermFactory const* fact : { static_cast<TermFactory const*>(&basic),
+			static_cast<TermFactory const*>(&stored) }) {
+		auto psb = fact->get_property_specification_builder();
+		pTerm var = fact->get_variable(Loc::get_internal(), "a", fact->TRUE,
+				fact->BOOLEAN);
+		auto spec = psb->set_associative(true)->set_commutative(false)
+				->set_idempotent(var)->set_identity(
+						fact->get_integer_literal(0))->get();
+		MUST_EQUAL(spec->check_associative(false), true, "associative");
+		MUST_EQUAL(spec->check_commutative(true), false, "commutative");
+		MUST_EQUAL(spec->check_idempotent(true), true, "idempotent default");
+		MUST_EQUAL(spec->check_idempotent(false), false, "idempotent default");
+		MUST_EQUAL(spec->has_identity(), true, "identity");
+		MUST_EQUAL(spec->has_absorber(), false, "absorber");
+		MUST_EQUAL(spec->has_flags(IPropertySpecification::ASSOCIATIVE |
+				IPropertySpecification::COMMUTATIVE_KNOWN), true, "flags");
+		MUST_EQUAL(spec->has_flags(IPropertySpecification::COMMUTATIVE),
+				false, "not commutative");
+		auto idem = psb->set_commutative(false)->set_idempotent(true)->get();
+		MUST_EQUAL(idem->check_idempotent(false), true, "only idempotent");
+		MUST_EQUAL(idem->check_commutative(true), false, "not commutative");
+	} // Loop over factories.
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(flags, "");
+}
+
+END_ITEM(flags)
+
+START_ITEM(override)
+
+try {
+	ENDL("Interning and overriding"); PUSH;
+	basic::TermFactoryImpl fact;
+	auto psb = fact.get_property_specification_builder();
+	auto assoc = psb->set_associative(true)->get();
+	MUST_EQUAL(assoc.get(), psb->set_associative(true)->get().get(),
+			"interned");
+	auto comm = psb->set_commutative(true)->set_associative(false)->get();
+	auto merged = fact.override_properties(assoc, comm);
+	MUST_EQUAL(merged.get(), fact.override_properties(assoc, comm).get(),
+			"remembered");
+	MUST_EQUAL(merged->check_associative(true), false, "overridden");
+	MUST_EQUAL(merged->check_commutative(false), true, "added");
+	auto back = fact.override_properties(comm, assoc);
+	MUST_EQUAL(back->check_associative(false), true, "other way");
+	MUST_EQUAL(back->check_commutative(false), true, "kept");
+	MUST_EQUAL(fact.apply(Loc::get_internal(), comm, assoc).get(),
+			fact.override_properties(assoc, comm).get(), "apply to spec");
+
+	// Only a few overrides are remembered; the rest are made again.
+	for (unsigned index = 0; index < 2000; ++index) {
+		auto absorbs = psb->set_associative(true)->set_commutative(false)
+				->set_absorber(fact.get_integer_literal(5000 + index))->get();
+		auto both = fact.override_properties(absorbs, comm);
+		MUST_EQUAL(both->check_commutative(false), true, "many overrides");
+	} // Override many specifications.
+	MUST_EQUAL(fact.override_properties(assoc, comm).get(), merged.get(),
+			"made again");
+
+	// Applying a specification to a list keeps the elements.
+	std::vector<pTerm> elts;
+	for (unsigned index = 0; index < 500; ++index) {
+		elts.push_back(fact.get_integer_literal(index));
+	} // Make the elements.
+	pList list = fact.get_list(Loc::get_internal(), assoc, elts);
+	auto result = kind_cast<IList>(fact.apply(Loc::get_internal(), comm,
+			list));
+	MUST_EQUAL(result->get_property_specification().get(), merged.get(),
+			"list spec");
+	MUST_EQUAL(result->get_elements() == elts, true, "list elements");
+	MUST_EQUAL(fact.apply(Loc::get_internal(), assoc, list).get(),
+			list.get(), "unchanged list");
+
+	// The store agrees.
+	store::TermStoreFactory stored;
+	auto copy = stored.override_properties(
+			stored.get_property_specification_builder()
+					->override(assoc)->get(),
+			stored.get_property_specification_builder()
+					->override(comm)->get());
+	MUST_EQUAL(*copy == *merged, true, "store override");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(override, "");
+}
+
+END_ITEM(override)
+
+END_TEST
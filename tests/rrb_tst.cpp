@@ -0,0 +1,169 @@
+/**
+ * @file
+ * Test the persistent vector.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "RrbVector.h"
+#include <random>
+#include <vector>
+
+using namespace elision;
+
+// Keep the sum of the elements in each node.
+struct Sum {
+	typedef long value_type;
+	static long identity() { return 0; }
+	static long of(int value) { return value; }
+	static long combine(long first, long second) { return first + second; }
+};
+
+typedef RrbVector<int, Sum> vec_t;
+
+// Check a vector against the expected elements.
+bool same(vec_t const& vec, std::vector<int> const& expect) {
+	if (vec.size() != expect.size()) return false;
+	long sum = 0;
+	for (size_t index = 0; index < expect.size(); ++index) {
+		if (vec[index] != expect[index]) return false;
+		sum += expect[index];
+	} // Check by position.
+	if (vec.get_measure() != sum) return false;
+	return std::equal(vec.begin(), vec.end(), expect.begin());
+}
+
+// Make a vector of consecutive values.
+std::vector<int> count(int from, int to) {
+	std::vector<int> values;
+	for (int value = from; value < to; ++value) values.push_back(value);
+	return values;
+}
+
+START_TEST
+
+START_ITEM(build)
+
+try {
+	ENDL("Building vectors"); PUSH;
+	MUST_EQUAL(vec_t().size(), 0u, "empty");
+	for (int size : { 1, 31, 32, 33, 1024, 1025, 40000 }) {
+		auto values = count(0, size);
+		vec_t vec(values.begin(), values.end());
+		MUST_EQUAL(same(vec, values), true, "size " << size);
+	} // Try several sizes.
+	auto values = count(0, 40000);
+	MUST_EQUAL(vec_t(values.begin(), values.end()).get_height(), 3u,
+			"height");
+	MUST_THROW(vec_t().at(0), std::out_of_range);
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(build, "");
+}
+
+END_ITEM(build)
+
+START_ITEM(edit)
+
+try {
+	ENDL("Catenating and slicing"); PUSH;
+	auto left = count(0, 5000);
+	auto right = count(5000, 5077);
+	vec_t first(left.begin(), left.end());
+	vec_t second(right.begin(), right.end());
+	auto both = count(0, 5077);
+	MUST_EQUAL(same(first.catenate(second), both), true, "catenate");
+	MUST_EQUAL(same(second.catenate(first).slice(77, 5077), left), true,
+			"catenate and slice");
+	MUST_EQUAL(same(first, left), true, "original kept");
+	auto middle = count(1000, 1040);
+	MUST_EQUAL(same(first.slice(1000, 1040), middle), true, "slice");
+	MUST_EQUAL(first.slice(3, 3).empty(), true, "empty slice");
+	MUST_THROW(first.slice(10, 5001), std::out_of_range);
+	std::vector<int> edited(left);
+	edited.insert(edited.begin() + 1234, -1);
+	MUST_EQUAL(same(first.insert(1234, -1), edited), true, "insert");
+	edited.erase(edited.begin() + 17);
+	MUST_EQUAL(same(first.insert(1234, -1).omit(17), edited), true, "omit");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(edit, "");
+}
+
+END_ITEM(edit)
+
+START_ITEM(random)
+
+try {
+	ENDL("Editing at random"); PUSH;
+	std::mt19937 gen(17);
+	vec_t vec;
+	std::vector<int> expect;
+	bool good = true;
+	for (int step = 0; step < 3000 && good; ++step) {
+		size_t size = expect.size();
+		switch (gen() % 4) {
+		case 0: {
+			// Catenate a piece on either side.
+			auto piece = count(step, step + gen() % 100);
+			vec_t other(piece.begin(), piece.end());
+			if (gen() % 2) {
+				vec = vec.catenate(other);
+				expect.insert(expect.end(), piece.begin(), piece.end());
+			} else {
+				vec = other.catenate(vec);
+				expect.insert(expect.begin(), piece.begin(), piece.end());
+			}
+			break;
+		}
+		case 1: {
+			// Slice, keeping most of the vector.
+			size_t from = size ? gen() % (size / 8 + 1) : 0;
+			size_t to = size - (size ? gen() % (size / 8 + 1) : 0);
+			if (to < from) to = from;
+			vec = vec.slice(from, to);
+			expect = std::vector<int>(expect.begin() + from,
+					expect.begin() + to);
+			break;
+		}
+		case 2: {
+			size_t position = gen() % (size + 1);
+			vec = vec.insert(position, step);
+			expect.insert(expect.begin() + position, step);
+			break;
+		}
+		default:
+			if (size == 0) break;
+			size_t position = gen() % size;
+			vec = vec.omit(position);
+			expect.erase(expect.begin() + position);
+			break;
+		} // Pick an edit.
+		good = same(vec, expect);
+	} // Edit many times.
+	MUST_EQUAL(good, true, "all edits");
+	MUST_EQUAL(vec.get_height() < 8, true, "height " << vec.get_height());
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(random, "");
+}
+
+END_ITEM(random)
+
+END_TEST
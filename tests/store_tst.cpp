@@ -0,0 +1,134 @@
+/**
+ * @file
+ * Test the columnar term store and its factory.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+
+using namespace elision;
+using namespace elision::term;
+using namespace elision::term::store;
+
+// Make the same term with any factory.
+pTerm make(TermFactory const& fact, eint_t value) {
+	auto spec = fact.get_property_specification_builder()
+			->set_associative(true)->set_identity(fact.get_integer_literal(0))
+			->get();
+	std::vector<pTerm> elts { fact.get_integer_literal(value),
+		fact.get_variable(Loc::get_internal(), "x", fact.TRUE, fact.INTEGER),
+		fact.get_float_literal(15, -2, 16) };
+	pTerm list = fact.get_list(Loc::get_internal(), spec, elts);
+	pTerm body = fact.get_lambda(Loc::get_internal(),
+			fact.get_term_variable(Loc::get_internal(), "y", fact.ANY),
+			fact.get_term_literal(list), fact.TRUE);
+	return fact.apply(Loc::get_internal(), fact.get_symbol_literal("f"),
+			fact.get_static_map(Loc::get_internal(), body,
+					fact.get_string_literal("z")));
+}
+
+START_TEST
+
+// Get the factories.
+HANG("Making factories");
+std::unique_ptr<TermFactory> basic(new elision::term::basic::TermFactoryImpl());
+std::unique_ptr<TermStoreFactory> fact(new TermStoreFactory());
+ENDL("Done");
+
+START_ITEM(intern)
+
+try {
+	ENDL("Interning terms in the store"); PUSH;
+	pTerm first = make(*fact, 7);
+	size_t size = fact->get_store().size();
+	pTerm second = make(*fact, 7);
+	MUST_EQUAL(fact->get_store().size(), size, "nothing added");
+	MUST_EQUAL(first.get(), second.get(), "same view");
+	term_id id = fact->id_of(first);
+	MUST_EQUAL(id, fact->id_of(second), "same id");
+	MUST_NOT_EQUAL(id, fact->id_of(make(*fact, 8)), "different id");
+	MUST_EQUAL(fact->get_store().get_kind(id), APPLY_KIND, "kind column");
+	MUST_EQUAL(fact->get_store().get_arity(id), 2u, "arity");
+	size_t count = 0;
+	fact->get_store().walk(id, [&](term_id) { ++count; return true; });
+	MUST_EQUAL(count > 10, true, "walk");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(intern, "");
+}
+
+END_ITEM(intern)
+
+START_ITEM(views)
+
+try {
+	ENDL("Mixing views with basic terms"); PUSH;
+	pTerm mine = make(*fact, 7);
+	pTerm theirs = make(*basic, 7);
+	MUST_EQUAL(mine->to_string(), theirs->to_string(), "string");
+	MUST_EQUAL(mine->get_fingerprint() == theirs->get_fingerprint(), true,
+			"fingerprint");
+	MUST_EQUAL(mine->get_depth(), theirs->get_depth(), "depth");
+	MUST_EQUAL(mine->is_constant(), theirs->is_constant(), "constant");
+	MUST_EQUAL(*mine == *theirs, true, "view equals basic");
+	MUST_EQUAL(*theirs == *mine, true, "basic equals view");
+	MUST_EQUAL(*theirs == *make(*fact, 8), false, "basic differs");
+	MUST_EQUAL(fact->id_of(theirs), fact->id_of(mine), "import");
+	pTerm mixed = fact->apply(Loc::get_internal(),
+			basic->get_symbol_literal("f"), kind_cast<IApply>(mine)
+					->get_argument());
+	MUST_EQUAL(mixed.get(), mine.get(), "mixed parts");
+	auto list = kind_cast<IList>(kind_cast<ITermLiteral>(
+			kind_cast<ILambda>(kind_cast<IStaticMap>(kind_cast<IApply>(mine)
+					->get_argument())->get_domain())->get_rhs())->get_term());
+	MUST_EQUAL(list->size(), 3u, "list size");
+	MUST_EQUAL(list->get_property_specification()->check_associative(false),
+			true, "associative");
+	MUST_EQUAL(*(*list)[0] == *basic->get_integer_literal(7), true, "element");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(views, "");
+}
+
+END_ITEM(views)
+
+START_ITEM(stores)
+
+try {
+	ENDL("Comparing terms in different stores"); PUSH;
+	TermStoreFactory other;
+	term_id mine = fact->id_of(make(*fact, 7));
+	term_id theirs = other.id_of(make(other, 7));
+	MUST_EQUAL(fact->get_store().equal(mine, other.get_store(), theirs), true,
+			"equal");
+	MUST_EQUAL(fact->get_store().equal(mine, other.get_store(),
+			other.id_of(make(other, 8))), false, "unequal");
+	MUST_EQUAL(*fact->get_store().get_term(mine) ==
+			*other.get_store().get_term(theirs), true, "views");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(stores, "");
+}
+
+END_ITEM(stores)
+
+END_TEST
@@ -0,0 +1,122 @@
+/**
+ * @file
+ * Test the summary computed for each term.
+ *
+ * @author sprowell@gmail.com
+ *
+ * @verbatim
+ *       _ _     _
+ *   ___| (_)___(_) ___  _ __
+ *  / _ \ | / __| |/ _ \| '_ \
+ * |  __/ | \__ \ | (_) | | | |
+ *  \___|_|_|___/_|\___/|_| |_|
+ * The Elision Term Rewriter
+ *
+ * Copyright (c) 2014 by Stacy Prowell (sprowell@gmail.com)
+ * All rights reserved.
+ * @endverbatim
+ */
+
+#include "test_frame.h"
+#include "term/TermFactory.h"
+#include "term/TermModifier.h"
+#include "term/basic/TermFactoryImpl.h"
+#include "term/store/TermStoreFactory.h"
+
+using namespace elision;
+using namespace elision::term;
+
+// Make the same term with any factory: f({$x: INTEGER -> 1}, [\$$y, 2]).
+pTerm make(TermFactory const& fact) {
+	pTerm map = fact.get_static_map(Loc::get_internal(),
+			fact.get_variable(Loc::get_internal(), "x", fact.TRUE,
+					fact.INTEGER),
+			fact.get_integer_literal(1));
+	auto spec = fact.get_property_specification_builder()->get();
+	std::vector<pTerm> elts { fact.get_term_literal(
+			fact.get_term_variable(Loc::get_internal(), "y", fact.ANY)),
+			fact.get_integer_literal(2) };
+	return fact.apply(Loc::get_internal(), fact.get_symbol_literal("f"),
+			fact.get_static_map(Loc::get_internal(), map,
+					fact.get_list(Loc::get_internal(), spec, elts)));
+}
+
+START_TEST
+
+START_ITEM(flags)
+
+try {
+	ENDL("Summarizing terms"); PUSH;
+	basic::TermFactoryImpl fact;
+	TermSummary leaf = fact.get_integer_literal(7)->get_summary();
+	MUST_EQUAL(leaf.is_constant(), true, "literal constant");
+	MUST_EQUAL(leaf.has_variables(), false, "literal variables");
+	MUST_EQUAL(leaf.get_signature(), 0u, "literal signature");
+	pTerm var = fact.get_variable(Loc::get_internal(), "x", fact.TRUE,
+			fact.INTEGER);
+	MUST_EQUAL(var->is_constant(), false, "variable constant");
+	MUST_EQUAL(var->is_meta_term(), false, "variable meta");
+	MUST_EQUAL(var->get_summary().may_contain(
+			TermSummary::signature_of(Atom("x"))), true, "variable signature");
+	pTerm term = make(fact);
+	TermSummary summary = term->get_summary();
+	MUST_EQUAL(summary.get_depth(), term->get_depth(), "depth");
+	MUST_EQUAL(summary.is_constant(), false, "constant");
+	MUST_EQUAL(summary.is_meta(), true, "meta");
+	MUST_EQUAL(summary.has_variables(), true, "variables");
+	MUST_EQUAL(summary.get_signature(),
+			TermSummary::signature_of(Atom("x")) |
+			TermSummary::signature_of(Atom("y")), "signature");
+	TermSummary deep;
+	for (unsigned index = 0; index < TermSummary::MAX_DEPTH + 5; ++index) {
+		deep.deepen();
+	} // Go past the largest depth.
+	MUST_EQUAL(deep.get_depth(), TermSummary::MAX_DEPTH, "clamped depth");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(flags, "");
+}
+
+END_ITEM(flags)
+
+START_ITEM(agree)
+
+try {
+	ENDL("Comparing basic and store summaries"); PUSH;
+	basic::TermFactoryImpl basic;
+	store::TermStoreFactory stored;
+	MUST_EQUAL(make(basic)->get_summary() == make(stored)->get_summary(), true,
+			"same summary");
+	MUST_EQUAL(make(stored)->is_meta_term(), true, "store meta");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(agree, "");
+}
+
+END_ITEM(agree)
+
+START_ITEM(prune)
+
+try {
+	ENDL("Substituting with pruning"); PUSH;
+	basic::TermFactoryImpl fact;
+	basic::TermModifier modifier(fact);
+	pTerm term = make(fact);
+	auto binds = BindMap().extend(Atom("z"), fact.get_integer_literal(3));
+	MUST_EQUAL(modifier.substitute(binds, term).get(), term.get(), "unchanged");
+	binds = binds.extend(Atom("x"), fact.get_integer_literal(4));
+	pTerm result = modifier.substitute(binds, term);
+	MUST_EQUAL(result->to_string().find("$x"), std::string::npos, "replaced");
+	MUST_EQUAL(result->get_summary().get_signature(),
+			TermSummary::signature_of(Atom("y")), "remaining signature");
+	POP;
+} catch (std::exception& e) {
+	ENDL("Caught an exception: " << e.what());
+	FAIL_ITEM(prune, "");
+}
+
+END_ITEM(prune)
+
+END_TEST